@@ -1,14 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-
-// Structure for random access demonstration
-typedef struct {
-    int id;
-    char name[32];
-    float salary;
-    int department;
-} Employee;
+#include "recstore.h"
 
 // Function prototypes
 void demonstrate_basic_positioning(void);
@@ -18,6 +11,7 @@ void demonstrate_reverse_reading(void);
 void demonstrate_status_functions(void);
 void demonstrate_practical_examples(void);
 void demonstrate_error_handling(void);
+void demonstrate_memory_mapped_records(void);
 
 // Utility functions
 void create_sample_files(void);
@@ -41,6 +35,7 @@ int main(void) {
     demonstrate_status_functions();
     demonstrate_practical_examples();
     demonstrate_error_handling();
+    demonstrate_memory_mapped_records();
     
     // Clean up test files
     cleanup_test_files();
@@ -689,6 +684,79 @@ void demonstrate_error_handling(void) {
     printf("\n");
 }
 
+void demonstrate_memory_mapped_records(void) {
+    printf("8. MEMORY-MAPPED RECORD STORE\n");
+    printf("----------------------------------------\n");
+    
+    RecordStore *store = record_store_open("employees.bin", true);
+    if (!store) {
+        printf("Error opening employee database\n");
+        return;
+    }
+    printf("Mapped %zu records (%zu bytes each)\n\n", store->count, sizeof(Employee));
+    
+    // Same lookups as section 3, without fseek or fread
+    printf("1. Reading records as an array:\n");
+    record_store_advise(store, RECORD_ACCESS_RANDOM);
+    size_t indices[] = {0, 2, 4, 1, 3};
+    for (int i = 0; i < 5; i++) {
+        Employee *emp = record_store_get(store, indices[i]);
+        if (emp) {
+            printf("   Record %zu: ID=%d, Name=%s, Salary=$%.2f\n",
+                   indices[i], emp->id, emp->name, emp->salary);
+        }
+    }
+    
+    // Updates land in the mapped file; msync writes them back in batches
+    printf("\n2. Updating records in place:\n");
+    store->sync_batch = 64;
+    for (size_t i = 0; i < store->count; i++) {
+        store->records[i].salary *= 1.03f;
+        record_store_mark_dirty(store, i);
+    }
+    record_store_sync(store, true);
+    printf("   Gave %zu employees a 3%% raise with %zu msync call(s)\n",
+           store->count, store->syncs);
+    
+    // Appends extend the file by a whole chunk, not one record at a time
+    printf("\n3. Appending records:\n");
+    Employee hires[] = {
+        {1007, "Grace Lee", 81000.0, 1},
+        {1008, "Henry Clark", 69000.0, 3}
+    };
+    for (int i = 0; i < 2; i++) {
+        record_store_append(store, &hires[i]);
+    }
+    printf("   %zu records in use, file holds %zu (grows by at least %d)\n",
+           store->count, store->capacity, RECORD_STORE_CHUNK);
+    
+    size_t count = store->count;
+    if (!record_store_close(store)) {
+        printf("Error closing employee database\n");
+        return;
+    }
+    
+    // The file is trimmed on close and reads back through stdio
+    printf("\n4. Reading back with fseek/fread:\n");
+    FILE *file = fopen("employees.bin", "rb");
+    if (file) {
+        long size = get_file_size(file);
+        printf("   File size: %ld bytes (%zu records)\n", size, count);
+        Employee emp;
+        fseek(file, (long)(count - 1) * (long)sizeof(Employee), SEEK_SET);
+        if (fread(&emp, sizeof(Employee), 1, file) == 1) {
+            printf("   Last record: %s (ID: %d)\n", emp.name, emp.id);
+        }
+        fseek(file, 2 * (long)sizeof(Employee), SEEK_SET);
+        if (fread(&emp, sizeof(Employee), 1, file) == 1) {
+            printf("   Record 2 salary after raise: $%.2f\n", emp.salary);
+        }
+        fclose(file);
+    }
+    
+    printf("\n");
+}
+
 // Utility function implementations
 void create_sample_files(void) {
     // Create sample text file
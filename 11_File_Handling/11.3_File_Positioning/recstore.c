@@ -0,0 +1,167 @@
+// mremap and the madvise flags are Linux extensions
+#define _GNU_SOURCE
+
+#include "recstore.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Maps (or extends the mapping to) capacity records of the file
+static bool map_records(RecordStore *store, size_t capacity) {
+    size_t length = capacity * sizeof(Employee);
+    void *mapped;
+    if (store->records == NULL) {
+        int prot = PROT_READ | (store->writable ? PROT_WRITE : 0);
+        mapped = mmap(NULL, length, prot, MAP_SHARED, store->fd, 0);
+    } else {
+        mapped = mremap(store->records, store->capacity * sizeof(Employee), length, MREMAP_MAYMOVE);
+    }
+    if (mapped == MAP_FAILED) {
+        perror("Failed to map records");
+        return false;
+    }
+    store->records = mapped;
+    store->capacity = capacity;
+    return true;
+}
+
+RecordStore *record_store_open(const char *path, bool writable) {
+    RecordStore *store = calloc(1, sizeof(RecordStore));
+    if (store == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    store->writable = writable;
+    store->fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (store->fd == -1) {
+        perror("Failed to open record store");
+        free(store);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(store->fd, &st) != 0) {
+        perror("Failed to stat record store");
+        close(store->fd);
+        free(store);
+        return NULL;
+    }
+    size_t records = (size_t)st.st_size / sizeof(Employee);
+    if (records > 0 && !map_records(store, records)) {
+        close(store->fd);
+        free(store);
+        return NULL;
+    }
+
+    // Zeroed records at the end were reserved but never written
+    store->count = records;
+    while (store->count > 0 && store->records[store->count - 1].id == 0) {
+        store->count--;
+    }
+    return store;
+}
+
+bool record_store_close(RecordStore *store) {
+    if (store == NULL) return true;
+    bool ok = true;
+    if (store->writable) ok = record_store_sync(store, true);
+    if (store->records != NULL) munmap(store->records, store->capacity * sizeof(Employee));
+    if (store->writable) {
+        // The records are on disk; make the new file size durable too
+        if (ftruncate(store->fd, (off_t)(store->count * sizeof(Employee))) != 0 ||
+            fdatasync(store->fd) != 0) {
+            perror("Failed to trim record store");
+            ok = false;
+        }
+    }
+    if (close(store->fd) != 0) ok = false;
+    free(store);
+    return ok;
+}
+
+// ---------------------------------------------------------------------
+// Updates
+
+// Grows [*begin, *end) to cover [first, last); empty when begin == end
+static void extend_range(size_t *begin, size_t *end, size_t first, size_t last) {
+    if (*begin == *end) {
+        *begin = first;
+        *end = last;
+        return;
+    }
+    if (first < *begin) *begin = first;
+    if (last > *end) *end = last;
+}
+
+void record_store_mark_dirty(RecordStore *store, size_t index) {
+    if (!store->writable || index >= store->count) return;
+    extend_range(&store->dirty_begin, &store->dirty_end, index, index + 1);
+    if (store->sync_batch > 0 && ++store->dirty_marks >= store->sync_batch) {
+        record_store_sync(store, false);
+    }
+}
+
+// The kernel already tracks dirty pages; msync only has to walk the
+// range, so one call per batch replaces a write per record. MS_ASYNC
+// only schedules the write-back, so those records stay pending until a
+// waiting sync covers them too. Nothing is forgotten when msync fails.
+bool record_store_sync(RecordStore *store, bool wait) {
+    size_t begin = store->dirty_begin;
+    size_t end = store->dirty_end;
+    if (wait) extend_range(&begin, &end, store->pending_begin, store->pending_end);
+    if (begin == end) return true;
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t start = begin * sizeof(Employee) / page * page;
+    size_t length = end * sizeof(Employee) - start;
+    store->syncs++;
+    if (msync((char *)store->records + start, length, wait ? MS_SYNC : MS_ASYNC) != 0) {
+        perror("Failed to sync records");
+        return false;
+    }
+
+    if (wait) {
+        store->pending_begin = store->pending_end = 0;
+    } else {
+        extend_range(&store->pending_begin, &store->pending_end, begin, end);
+    }
+    store->dirty_begin = store->dirty_end = 0;
+    store->dirty_marks = 0;
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// Growth
+
+bool record_store_reserve(RecordStore *store, size_t capacity) {
+    if (capacity <= store->capacity) return true;
+    if (!store->writable) return false;
+    if (ftruncate(store->fd, (off_t)(capacity * sizeof(Employee))) != 0) {
+        perror("Failed to extend record store");
+        return false;
+    }
+    return map_records(store, capacity);
+}
+
+Employee *record_store_append(RecordStore *store, const Employee *employee) {
+    if (store->count == store->capacity) {
+        size_t grow = store->capacity / 2 > RECORD_STORE_CHUNK ? store->capacity / 2 : RECORD_STORE_CHUNK;
+        if (!record_store_reserve(store, store->capacity + grow)) return NULL;
+    }
+    Employee *record = &store->records[store->count++];
+    *record = *employee;
+    record_store_mark_dirty(store, store->count - 1);
+    return record;
+}
+
+bool record_store_advise(RecordStore *store, RecordAccess access) {
+    if (store->records == NULL) return true;
+    int advice = MADV_NORMAL;
+    if (access == RECORD_ACCESS_RANDOM) advice = MADV_RANDOM;
+    if (access == RECORD_ACCESS_SEQUENTIAL) advice = MADV_SEQUENTIAL;
+    return madvise(store->records, store->capacity * sizeof(Employee), advice) == 0;
+}
@@ -0,0 +1,76 @@
+#ifndef RECSTORE_H
+#define RECSTORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Structure for random access demonstration
+typedef struct {
+    int id;
+    char name[32];
+    float salary;
+    int department;
+} Employee;
+
+// Memory-mapped Employee file. The file stays a plain array of records,
+// readable with fseek/fread, and is mapped MAP_SHARED so the records can
+// be used as an ordinary array:
+//   reads      records[i], no system call and no copy
+//   updates    change records[i] in place, then record_store_mark_dirty;
+//              every sync_batch marks the dirty range is handed to msync
+//              (MS_ASYNC), and record_store_sync(store, true) waits for
+//              everything marked so far, batched or not
+//   appends    the file grows with ftruncate a chunk at a time and the
+//              mapping is extended with mremap, so most appends are a
+//              plain store; appending may move the array
+//   hints      record_store_advise passes the access pattern to madvise
+// The file is trimmed to the records in use on close. Ids are nonzero:
+// zeroed records past the end, left by a crash during growth, are
+// dropped on open.
+
+#define RECORD_STORE_CHUNK 65536    // records added per growth, at least
+
+typedef enum {
+    RECORD_ACCESS_NORMAL,
+    RECORD_ACCESS_RANDOM,       // no read-ahead
+    RECORD_ACCESS_SEQUENTIAL    // aggressive read-ahead, pages dropped behind
+} RecordAccess;
+
+typedef struct {
+    int fd;
+    Employee *records;          // NULL while nothing is mapped
+    size_t count;               // records in use
+    size_t capacity;            // records the file and mapping hold
+    bool writable;
+    size_t dirty_begin;         // dirty records, empty when equal
+    size_t dirty_end;
+    size_t pending_begin;       // written back with MS_ASYNC, not yet waited for
+    size_t pending_end;
+    size_t dirty_marks;
+    size_t sync_batch;          // marks per automatic msync, 0 for manual
+    size_t syncs;
+} RecordStore;
+
+// Opens (writable: creates) the file; NULL on failure
+RecordStore *record_store_open(const char *path, bool writable);
+// Syncs, trims the file to count records and unmaps; false on error
+bool record_store_close(RecordStore *store);
+
+static inline Employee *record_store_get(RecordStore *store, size_t index) {
+    return index < store->count ? &store->records[index] : NULL;
+}
+
+// Call after changing records[index] in place
+void record_store_mark_dirty(RecordStore *store, size_t index);
+// Writes the dirty range back; wait also covers earlier asynchronous
+// batches and blocks until all of it is on disk. On failure the ranges
+// are kept for the next call.
+bool record_store_sync(RecordStore *store, bool wait);
+
+// Returns the stored copy, or NULL on failure
+Employee *record_store_append(RecordStore *store, const Employee *employee);
+bool record_store_reserve(RecordStore *store, size_t capacity);
+
+bool record_store_advise(RecordStore *store, RecordAccess access);
+
+#endif /* RECSTORE_H */
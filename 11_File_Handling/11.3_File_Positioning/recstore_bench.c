@@ -0,0 +1,297 @@
+// fileno and fsync need POSIX
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "recstore.h"
+
+// Record store against the fseek/fread path of the demo, on a file of
+// 10^7 Employee records (about 440 MB) in the page cache:
+//   build        write every record and sync: fwrite + fsync vs
+//                record_store_append + close
+//   scan         read every record in order: fread one at a time vs the
+//                mapped array with RECORD_ACCESS_SEQUENTIAL
+//   reads        10^6 random lookups: fseek + fread vs records[i] with
+//                RECORD_ACCESS_RANDOM
+//   updates      10^6 random read-modify-writes, synced at the end:
+//                fseek/fread/fseek/fwrite + fsync vs an in-place update,
+//                record_store_mark_dirty (msync every 4096) + MS_SYNC
+//   msync        1000 durable updates: MS_SYNC after each one vs one
+//                batched MS_SYNC
+// Every path's result is checked against the others. The argument is
+// the record count (default 10^7).
+static int failed = 0;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *name, double ops, double seconds, double baseline) {
+    printf("  %-28s %12.0f ops/s  %8.1f ns/op", name, ops / seconds, seconds * 1e9 / ops);
+    if (baseline > 0) printf("  %6.2fx", baseline / seconds);
+    printf("\n");
+}
+
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static Employee make_employee(size_t i) {
+    Employee emp;
+    memset(&emp, 0, sizeof(emp));
+    emp.id = (int)(i + 1);
+    snprintf(emp.name, sizeof(emp.name), "Employee %zu", i);
+    emp.salary = 50000.0f + (float)(i % 1000) * 50.0f;
+    emp.department = (int)(i % 10);
+    return emp;
+}
+
+// Sum over ids and departments, so every record and update counts
+static uint64_t record_checksum(const Employee *emp) {
+    return (uint64_t)emp->id * 31 + (uint64_t)emp->department;
+}
+
+static FILE *open_stdio(const char *path) {
+    FILE *file = fopen(path, "r+b");
+    if (!file) {
+        perror("fopen");
+        exit(1);
+    }
+    return file;
+}
+
+static RecordStore *open_store(const char *path) {
+    RecordStore *store = record_store_open(path, true);
+    if (!store) exit(1);
+    return store;
+}
+
+// ---------------------------------------------------------------------
+// Workloads
+
+static void bench_build(const char *path, size_t count) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror("fopen");
+        exit(1);
+    }
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        Employee emp = make_employee(i);
+        fwrite(&emp, sizeof(Employee), 1, file);
+    }
+    fflush(file);
+    fsync(fileno(file));
+    fclose(file);
+    double baseline = now_seconds() - start;
+    remove(path);
+
+    RecordStore *store = open_store(path);
+    start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        Employee emp = make_employee(i);
+        if (!record_store_append(store, &emp)) failed = 1;
+    }
+    size_t appended = store->count;
+    record_store_close(store);
+    double seconds = now_seconds() - start;
+
+    report("fwrite append", (double)count, baseline, 0);
+    report("record_store_append", (double)count, seconds, baseline);
+    failed |= appended != count;
+}
+
+static void bench_scan(const char *path, size_t count) {
+    FILE *file = open_stdio(path);
+    uint64_t expected = 0;
+    double start = now_seconds();
+    Employee emp;
+    while (fread(&emp, sizeof(Employee), 1, file) == 1) {
+        expected += record_checksum(&emp);
+    }
+    double baseline = now_seconds() - start;
+    fclose(file);
+
+    RecordStore *store = open_store(path);
+    uint64_t checksum = 0;
+    start = now_seconds();
+    record_store_advise(store, RECORD_ACCESS_SEQUENTIAL);
+    for (size_t i = 0; i < store->count; i++) {
+        checksum += record_checksum(&store->records[i]);
+    }
+    double seconds = now_seconds() - start;
+    failed |= store->count != count || checksum != expected;
+    record_store_close(store);
+
+    uint64_t built = 0;
+    for (size_t i = 0; i < count; i++) {
+        Employee made = make_employee(i);
+        built += record_checksum(&made);
+    }
+    failed |= built != expected;
+
+    report("fread scan", (double)count, baseline, 0);
+    report("mapped scan", (double)count, seconds, baseline);
+}
+
+static void bench_reads(const char *path, const size_t *indices, size_t ops) {
+    FILE *file = open_stdio(path);
+    uint64_t expected = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        Employee emp;
+        fseek(file, (long)(indices[i] * sizeof(Employee)), SEEK_SET);
+        if (fread(&emp, sizeof(Employee), 1, file) == 1) expected += record_checksum(&emp);
+    }
+    double baseline = now_seconds() - start;
+    fclose(file);
+
+    RecordStore *store = open_store(path);
+    record_store_advise(store, RECORD_ACCESS_RANDOM);
+    uint64_t checksum = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        checksum += record_checksum(record_store_get(store, indices[i]));
+    }
+    double seconds = now_seconds() - start;
+    record_store_close(store);
+
+    report("fseek + fread", (double)ops, baseline, 0);
+    report("mapped read", (double)ops, seconds, baseline);
+    failed |= checksum != expected;
+}
+
+static uint64_t department_total(const char *path) {
+    RecordStore *store = open_store(path);
+    uint64_t total = 0;
+    for (size_t i = 0; i < store->count; i++) {
+        total += (uint64_t)store->records[i].department;
+    }
+    record_store_close(store);
+    return total;
+}
+
+static void bench_updates(const char *path, const size_t *indices, size_t ops) {
+    uint64_t before = department_total(path);
+
+    FILE *file = open_stdio(path);
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        Employee emp;
+        long offset = (long)(indices[i] * sizeof(Employee));
+        fseek(file, offset, SEEK_SET);
+        if (fread(&emp, sizeof(Employee), 1, file) != 1) failed = 1;
+        emp.department++;
+        fseek(file, offset, SEEK_SET);
+        fwrite(&emp, sizeof(Employee), 1, file);
+    }
+    fflush(file);
+    fsync(fileno(file));
+    double baseline = now_seconds() - start;
+    fclose(file);
+
+    RecordStore *store = open_store(path);
+    record_store_advise(store, RECORD_ACCESS_RANDOM);
+    store->sync_batch = 4096;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        store->records[indices[i]].department++;
+        record_store_mark_dirty(store, indices[i]);
+    }
+    record_store_sync(store, true);
+    double seconds = now_seconds() - start;
+    record_store_close(store);
+
+    report("fseek/fread/fwrite update", (double)ops, baseline, 0);
+    report("in-place update + msync", (double)ops, seconds, baseline);
+    failed |= department_total(path) != before + 2 * ops;
+}
+
+static void bench_msync(const char *path, const size_t *indices, size_t ops) {
+    uint64_t before = department_total(path);
+    RecordStore *store = open_store(path);
+
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        store->records[indices[i]].department++;
+        record_store_mark_dirty(store, indices[i]);
+        record_store_sync(store, true);
+    }
+    double baseline = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        store->records[indices[i]].department++;
+        record_store_mark_dirty(store, indices[i]);
+    }
+    record_store_sync(store, true);
+    double seconds = now_seconds() - start;
+    record_store_close(store);
+
+    report("MS_SYNC per update", (double)ops, baseline, 0);
+    report("one batched MS_SYNC", (double)ops, seconds, baseline);
+    failed |= department_total(path) != before + 2 * ops;
+}
+
+int main(int argc, char *argv[]) {
+    long records = argc > 1 ? atol(argv[1]) : 10000000;
+    if (records < 1000 || records > 100000000) {
+        fprintf(stderr, "Usage: %s [records, 1000 .. 100000000]\n", argv[0]);
+        return 1;
+    }
+    size_t count = (size_t)records;
+    size_t ops = count < 1000000 ? count : 1000000;
+
+    char path[] = "/tmp/recstore_benchXXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        perror("mkstemp");
+        return 1;
+    }
+    close(fd);
+
+    size_t *indices = malloc(ops * sizeof(size_t));
+    if (!indices) {
+        fprintf(stderr, "Memory allocation failed\n");
+        remove(path);
+        return 1;
+    }
+    for (size_t i = 0; i < ops; i++) {
+        indices[i] = (size_t)(next_random() % count);
+    }
+
+    printf("=== Record Store Benchmark ===\n\n");
+    printf("%zu records, %zu bytes each\n", count, sizeof(Employee));
+    printf("Build:\n");
+    bench_build(path, count);
+    printf("Sequential scan:\n");
+    bench_scan(path, count);
+    printf("Random reads:\n");
+    bench_reads(path, indices, ops);
+    printf("Random updates:\n");
+    bench_updates(path, indices, ops);
+    printf("Durable updates:\n");
+    bench_msync(path, indices, 1000);
+    printf("\n");
+
+    free(indices);
+    remove(path);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
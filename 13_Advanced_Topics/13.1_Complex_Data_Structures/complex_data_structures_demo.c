@@ -2,6 +2,10 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include "graph.h"
+#include "graph_traversal.h"
+#include "graph_snapshot.h"
+#include "shortest_path.h"
 
 // Function prototypes
 void demonstrate_linked_lists(void);
@@ -10,6 +14,9 @@ void demonstrate_queues(void);
 void demonstrate_binary_trees(void);
 void demonstrate_hash_tables(void);
 void demonstrate_graphs(void);
+void demonstrate_shortest_paths(void);
+void demonstrate_graph_algorithms(void);
+void demonstrate_graph_snapshots(void);
 
 // Linked List structures
 typedef struct Node {
@@ -76,21 +83,6 @@ typedef struct {
     HashNode* buckets[HASH_SIZE];
 } HashTable;
 
-// Graph structures
-typedef struct AdjNode {
-    int dest;
-    struct AdjNode* next;
-} AdjNode;
-
-typedef struct {
-    AdjNode* head;
-} AdjList;
-
-typedef struct {
-    int vertices;
-    AdjList* array;
-} Graph;
-
 // Linked List functions
 Node* create_node(int data) {
     Node* new_node = malloc(sizeof(Node));
@@ -451,71 +443,24 @@ void free_hash_table(HashTable* ht) {
     }
 }
 
-// Graph functions
-Graph* create_graph(int vertices) {
-    Graph* graph = malloc(sizeof(Graph));
-    if (graph == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        exit(1);
-    }
-    
-    graph->vertices = vertices;
-    graph->array = malloc(vertices * sizeof(AdjList));
-    if (graph->array == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        exit(1);
-    }
-    
-    for (int i = 0; i < vertices; i++) {
-        graph->array[i].head = NULL;
-    }
-    
-    return graph;
-}
-
-void add_edge(Graph* graph, int src, int dest) {
-    AdjNode* new_node = malloc(sizeof(AdjNode));
-    if (new_node == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        return;
-    }
-    new_node->dest = dest;
-    new_node->next = graph->array[src].head;
-    graph->array[src].head = new_node;
-    
-    // For undirected graph, add reverse edge
-    new_node = malloc(sizeof(AdjNode));
-    if (new_node == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
-        return;
-    }
-    new_node->dest = src;
-    new_node->next = graph->array[dest].head;
-    graph->array[dest].head = new_node;
-}
-
-void dfs_util(Graph* graph, int vertex, bool visited[]) {
-    visited[vertex] = true;
+// Graph traversals (construction lives in graph.c)
+DfsAction print_vertex_visitor(int vertex, int parent, void* context) {
+    (void)parent;
+    (void)context;
     printf("%d ", vertex);
-    
-    AdjNode* temp = graph->array[vertex].head;
-    while (temp) {
-        if (!visited[temp->dest]) {
-            dfs_util(graph, temp->dest, visited);
-        }
-        temp = temp->next;
-    }
+    return DFS_CONTINUE;
 }
 
 void dfs(Graph* graph, int start) {
-    bool* visited = calloc(graph->vertices, sizeof(bool));
-    if (visited == NULL) {
-        fprintf(stderr, "Memory allocation failed\n");
+    // Explicit-stack DFS: no recursion, so long paths cannot overflow the stack
+    CSRGraph* csr = csr_from_graph(graph);
+    if (csr == NULL) {
         return;
     }
     
-    dfs_util(graph, start, visited);
-    free(visited);
+    DfsVisitor visitor = {print_vertex_visitor, NULL, NULL, NULL};
+    dfs_traverse(csr, start, &visitor, NULL);
+    free_csr_graph(csr);
 }
 
 void bfs(Graph* graph, int start) {
@@ -562,19 +507,6 @@ void print_graph(Graph* graph) {
     }
 }
 
-void free_graph(Graph* graph) {
-    for (int v = 0; v < graph->vertices; v++) {
-        AdjNode* current = graph->array[v].head;
-        while (current) {
-            AdjNode* temp = current;
-            current = current->next;
-            free(temp);
-        }
-    }
-    free(graph->array);
-    free(graph);
-}
-
 int main(void) {
     printf("=== Complex Data Structures Demo ===\n\n");
     
@@ -584,6 +516,9 @@ int main(void) {
     demonstrate_binary_trees();
     demonstrate_hash_tables();
     demonstrate_graphs();
+    demonstrate_shortest_paths();
+    demonstrate_graph_algorithms();
+    demonstrate_graph_snapshots();
     
     printf("=== Demo Complete ===\n");
     return 0;
@@ -801,3 +736,153 @@ void demonstrate_graphs(void) {
     free_graph(graph);
     printf("\n");
 }
+
+void demonstrate_shortest_paths(void) {
+    printf("7. WEIGHTED SHORTEST PATHS\n");
+    printf("----------------------------------------\n");
+    
+    Graph* graph = create_graph(6);
+    
+    printf("Creating weighted graph (src-dest:weight):\n");
+    printf("  0-1:7 0-2:9 0-5:14 1-2:10 1-3:15 2-3:11 2-5:2 3-4:6 4-5:9\n");
+    add_weighted_edge(graph, 0, 1, 7);
+    add_weighted_edge(graph, 0, 2, 9);
+    add_weighted_edge(graph, 0, 5, 14);
+    add_weighted_edge(graph, 1, 2, 10);
+    add_weighted_edge(graph, 1, 3, 15);
+    add_weighted_edge(graph, 2, 3, 11);
+    add_weighted_edge(graph, 2, 5, 2);
+    add_weighted_edge(graph, 3, 4, 6);
+    add_weighted_edge(graph, 4, 5, 9);
+    
+    // Algorithms run on the compact CSR form of the same graph
+    CSRGraph* csr = csr_from_graph(graph);
+    ShortestPathResult* result = sp_result_create(csr->vertices);
+    
+    dijkstra(csr, 0, SP_HEAP_BINARY, result);
+    printf("Dijkstra from vertex 0:\n");
+    for (int v = 0; v < result->vertices; v++) {
+        printf("  vertex %d: dist %2llu, parent %2d\n",
+               v, (unsigned long long)result->dist[v], result->parent[v]);
+    }
+    
+    int path[6];
+    int length = sp_path_to(result, 4, path, 6);
+    printf("Path 0 -> 4: ");
+    for (int i = 0; i < length; i++) {
+        printf("%d%s", path[i], i + 1 < length ? " -> " : "\n");
+    }
+    
+    delta_stepping(csr, 0, 5, 2, result);
+    printf("Delta-stepping (delta 5, 2 threads) dist to 4: %llu\n",
+           (unsigned long long)result->dist[4]);
+    
+    dijkstra(csr, 0, SP_HEAP_PAIRING, result);
+    printf("Pairing-heap Dijkstra dist to 4: %llu\n",
+           (unsigned long long)result->dist[4]);
+    
+    sp_result_free(result);
+    free_csr_graph(csr);
+    free_graph(graph);
+    printf("\n");
+}
+
+void demonstrate_graph_algorithms(void) {
+    printf("8. DFS-BASED GRAPH ALGORITHMS\n");
+    printf("----------------------------------------\n");
+    
+    // Directed acyclic graph: build order of a small project
+    Graph* dag = create_graph(6);
+    add_directed_edge(dag, 5, 2, 1);
+    add_directed_edge(dag, 5, 0, 1);
+    add_directed_edge(dag, 4, 0, 1);
+    add_directed_edge(dag, 4, 1, 1);
+    add_directed_edge(dag, 2, 3, 1);
+    add_directed_edge(dag, 3, 1, 1);
+    
+    CSRGraph* csr = csr_from_graph(dag);
+    int order[6];
+    printf("DAG edges: 5->2 5->0 4->0 4->1 2->3 3->1\n");
+    if (topological_sort(csr, order)) {
+        printf("  Topological order: ");
+        for (int i = 0; i < csr->vertices; i++) {
+            printf("%d ", order[i]);
+        }
+        printf("\n");
+    }
+    printf("  Has cycle: %s\n", graph_has_cycle(csr) ? "yes" : "no");
+    printf("  Shortest hop count 5 -> 1 (iterative deepening): %d\n",
+           iterative_deepening_search(csr, 5, 1, 10));
+    free_csr_graph(csr);
+    free_graph(dag);
+    
+    // Directed graph with cycles: {0,1,2} and {3,4} are strongly connected
+    Graph* directed = create_graph(6);
+    add_directed_edge(directed, 0, 1, 1);
+    add_directed_edge(directed, 1, 2, 1);
+    add_directed_edge(directed, 2, 0, 1);
+    add_directed_edge(directed, 2, 3, 1);
+    add_directed_edge(directed, 3, 4, 1);
+    add_directed_edge(directed, 4, 3, 1);
+    add_directed_edge(directed, 4, 5, 1);
+    
+    csr = csr_from_graph(directed);
+    int component[6];
+    printf("Directed edges: 0->1 1->2 2->0 2->3 3->4 4->3 4->5\n");
+    printf("  Has cycle: %s\n", graph_has_cycle(csr) ? "yes" : "no");
+    int count = strongly_connected_components(csr, component);
+    printf("  Strongly connected components: %d\n", count);
+    for (int v = 0; v < csr->vertices; v++) {
+        printf("    vertex %d -> component %d\n", v, component[v]);
+    }
+    free_csr_graph(csr);
+    free_graph(directed);
+    
+    // Undirected graph with two islands
+    Graph* undirected = create_graph(5);
+    add_edge(undirected, 0, 1);
+    add_edge(undirected, 1, 2);
+    add_edge(undirected, 3, 4);
+    
+    csr = csr_from_graph(undirected);
+    printf("Undirected edges: 0-1 1-2 3-4\n");
+    printf("  Connected components: %d\n", connected_components(csr, component));
+    free_csr_graph(csr);
+    free_graph(undirected);
+    printf("\n");
+}
+
+void demonstrate_graph_snapshots(void) {
+    printf("9. GRAPH SNAPSHOTS (MMAP)\n");
+    printf("----------------------------------------\n");
+    
+    Edge edges[] = {
+        {0, 1, 4}, {0, 2, 1}, {2, 1, 2}, {1, 3, 1}, {2, 3, 5}, {3, 4, 3}
+    };
+    CSRGraph* built = csr_from_edges(5, edges, 6, false);
+    
+    printf("Writing 5-vertex weighted graph to demo_graph.csr\n");
+    if (!graph_snapshot_write(built, "demo_graph.csr", true)) {
+        free_csr_graph(built);
+        return;
+    }
+    free_csr_graph(built);
+    
+    // No parsing: the arrays are used straight out of the mapped file
+    CSRGraph* mapped = graph_snapshot_open("demo_graph.csr");
+    if (mapped == NULL) {
+        return;
+    }
+    printf("Mapped snapshot: %d vertices, %lld edges, %s\n", mapped->vertices,
+           (long long)mapped->edges, mapped->weights ? "weighted" : "unweighted");
+    
+    ShortestPathResult* result = sp_result_create(mapped->vertices);
+    dijkstra(mapped, 0, SP_HEAP_BINARY, result);
+    printf("Dijkstra on mapped graph, dist 0 -> 4: %llu\n",
+           (unsigned long long)result->dist[4]);
+    
+    sp_result_free(result);
+    free_csr_graph(mapped);
+    remove("demo_graph.csr");
+    printf("\n");
+}
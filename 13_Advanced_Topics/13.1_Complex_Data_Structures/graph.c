@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "graph.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+Graph* create_graph(int vertices) {
+    Graph* graph = malloc(sizeof(Graph));
+    if (graph == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
+    graph->vertices = vertices;
+    graph->array = malloc(vertices * sizeof(AdjList));
+    if (graph->array == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < vertices; i++) {
+        graph->array[i].head = NULL;
+    }
+
+    return graph;
+}
+
+void add_directed_edge(Graph* graph, int src, int dest, uint32_t weight) {
+    AdjNode* new_node = malloc(sizeof(AdjNode));
+    if (new_node == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return;
+    }
+    new_node->dest = dest;
+    new_node->weight = weight;
+    new_node->next = graph->array[src].head;
+    graph->array[src].head = new_node;
+}
+
+void add_weighted_edge(Graph* graph, int src, int dest, uint32_t weight) {
+    add_directed_edge(graph, src, dest, weight);
+
+    // For undirected graph, add reverse edge
+    add_directed_edge(graph, dest, src, weight);
+}
+
+void add_edge(Graph* graph, int src, int dest) {
+    add_weighted_edge(graph, src, dest, 1);
+}
+
+void free_graph(Graph* graph) {
+    for (int v = 0; v < graph->vertices; v++) {
+        AdjNode* current = graph->array[v].head;
+        while (current) {
+            AdjNode* temp = current;
+            current = current->next;
+            free(temp);
+        }
+    }
+    free(graph->array);
+    free(graph);
+}
+
+static CSRGraph* alloc_csr_graph(int vertices, int64_t edges) {
+    CSRGraph* csr = malloc(sizeof(CSRGraph));
+    if (csr == NULL) {
+        return NULL;
+    }
+
+    csr->vertices = vertices;
+    csr->edges = edges;
+    csr->mapping = NULL;
+    csr->mapping_size = 0;
+    csr->offsets = calloc((size_t)vertices + 1, sizeof(int64_t));
+    csr->targets = malloc((size_t)(edges > 0 ? edges : 1) * sizeof(int32_t));
+    csr->weights = malloc((size_t)(edges > 0 ? edges : 1) * sizeof(uint32_t));
+
+    if (csr->offsets == NULL || csr->targets == NULL || csr->weights == NULL) {
+        free_csr_graph(csr);
+        return NULL;
+    }
+
+    return csr;
+}
+
+CSRGraph* csr_from_graph(const Graph* graph) {
+    int64_t edges = 0;
+    for (int v = 0; v < graph->vertices; v++) {
+        for (AdjNode* node = graph->array[v].head; node; node = node->next) {
+            edges++;
+        }
+    }
+
+    CSRGraph* csr = alloc_csr_graph(graph->vertices, edges);
+    if (csr == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    int64_t e = 0;
+    for (int v = 0; v < graph->vertices; v++) {
+        csr->offsets[v] = e;
+        for (AdjNode* node = graph->array[v].head; node; node = node->next) {
+            csr->targets[e] = node->dest;
+            csr->weights[e] = node->weight;
+            e++;
+        }
+    }
+    csr->offsets[graph->vertices] = e;
+
+    return csr;
+}
+
+CSRGraph* csr_from_edges(int vertices, const Edge* edges, int64_t count, bool undirected) {
+    int64_t total = undirected ? count * 2 : count;
+    CSRGraph* csr = alloc_csr_graph(vertices, total);
+    if (csr == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    // Counting sort by source: degrees, prefix sums, then scatter
+    for (int64_t i = 0; i < count; i++) {
+        csr->offsets[edges[i].src + 1]++;
+        if (undirected) {
+            csr->offsets[edges[i].dest + 1]++;
+        }
+    }
+    for (int v = 0; v < vertices; v++) {
+        csr->offsets[v + 1] += csr->offsets[v];
+    }
+
+    int64_t* cursor = malloc(((size_t)vertices + 1) * sizeof(int64_t));
+    if (cursor == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free_csr_graph(csr);
+        return NULL;
+    }
+    for (int v = 0; v < vertices; v++) {
+        cursor[v] = csr->offsets[v];
+    }
+
+    for (int64_t i = 0; i < count; i++) {
+        int64_t slot = cursor[edges[i].src]++;
+        csr->targets[slot] = edges[i].dest;
+        csr->weights[slot] = edges[i].weight;
+
+        if (undirected) {
+            slot = cursor[edges[i].dest]++;
+            csr->targets[slot] = edges[i].src;
+            csr->weights[slot] = edges[i].weight;
+        }
+    }
+
+    free(cursor);
+    return csr;
+}
+
+void free_csr_graph(CSRGraph* csr) {
+    if (csr && csr->mapping) {
+        munmap(csr->mapping, csr->mapping_size);
+        free(csr);
+    } else if (csr) {
+        free(csr->offsets);
+        free(csr->targets);
+        free(csr->weights);
+        free(csr);
+    }
+}
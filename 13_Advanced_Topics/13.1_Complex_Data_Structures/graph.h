@@ -0,0 +1,61 @@
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Adjacency list representation (one heap node per edge)
+typedef struct AdjNode {
+    int dest;
+    uint32_t weight;
+    struct AdjNode* next;
+} AdjNode;
+
+typedef struct {
+    AdjNode* head;
+} AdjList;
+
+typedef struct {
+    int vertices;
+    AdjList* array;
+} Graph;
+
+// Compressed sparse row representation: the out-edges of vertex v are
+// targets[offsets[v]] .. targets[offsets[v + 1] - 1]. weights may be NULL,
+// in which case every edge has weight 1. A graph opened from a snapshot
+// points into a read-only mapping (mapping != NULL) and must not be written.
+typedef struct {
+    int vertices;
+    int64_t edges;
+    int64_t* offsets;
+    int32_t* targets;
+    uint32_t* weights;
+    void* mapping;
+    size_t mapping_size;
+} CSRGraph;
+
+// Edge list entry used to build a CSRGraph without going through Graph
+typedef struct {
+    int32_t src;
+    int32_t dest;
+    uint32_t weight;
+} Edge;
+
+// Adjacency list graph
+Graph* create_graph(int vertices);
+void add_edge(Graph* graph, int src, int dest);
+void add_weighted_edge(Graph* graph, int src, int dest, uint32_t weight);
+void add_directed_edge(Graph* graph, int src, int dest, uint32_t weight);
+void free_graph(Graph* graph);
+
+// CSR graph
+CSRGraph* csr_from_graph(const Graph* graph);
+CSRGraph* csr_from_edges(int vertices, const Edge* edges, int64_t count, bool undirected);
+void free_csr_graph(CSRGraph* csr);
+
+static inline uint32_t csr_weight(const CSRGraph* csr, int64_t edge) {
+    return csr->weights ? csr->weights[edge] : 1u;
+}
+
+#endif /* GRAPH_H */
@@ -0,0 +1,321 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "graph_snapshot.h"
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static uint64_t align_up(uint64_t pos) {
+    return (pos + SNAPSHOT_ALIGNMENT - 1) & ~(uint64_t)(SNAPSHOT_ALIGNMENT - 1);
+}
+
+static bool write_section(FILE* file, uint64_t* pos, uint64_t section_pos,
+                          const void* data, size_t bytes) {
+    static const char padding[SNAPSHOT_ALIGNMENT];
+
+    if (section_pos > *pos && fwrite(padding, 1, section_pos - *pos, file) != section_pos - *pos) {
+        return false;
+    }
+    if (bytes > 0 && fwrite(data, 1, bytes, file) != bytes) {
+        return false;
+    }
+    *pos = section_pos + bytes;
+    return true;
+}
+
+bool graph_snapshot_write(const CSRGraph* graph, const char* path, bool with_weights) {
+    with_weights = with_weights && graph->weights != NULL;
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.flags = with_weights ? SNAPSHOT_FLAG_WEIGHTS : 0;
+    header.vertices = (uint64_t)graph->vertices;
+    header.edges = (uint64_t)graph->edges;
+    header.offsets_pos = align_up(sizeof(SnapshotHeader));
+    header.targets_pos = align_up(header.offsets_pos + (header.vertices + 1) * sizeof(int64_t));
+    uint64_t end = header.targets_pos + header.edges * sizeof(int32_t);
+    if (with_weights) {
+        header.weights_pos = align_up(end);
+        end = header.weights_pos + header.edges * sizeof(uint32_t);
+    }
+    header.file_size = end;
+
+    // Write beside the destination and rename, so readers never map a
+    // half-written snapshot
+    char temp_path[PATH_MAX];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", path) >= (int)sizeof(temp_path)) {
+        fprintf(stderr, "Snapshot path too long: %s\n", path);
+        return false;
+    }
+
+    FILE* file = fopen(temp_path, "wb");
+    if (file == NULL) {
+        perror("Error opening snapshot");
+        return false;
+    }
+
+    uint64_t pos = 0;
+    bool ok = write_section(file, &pos, 0, &header, sizeof(header)) &&
+              write_section(file, &pos, header.offsets_pos, graph->offsets,
+                            (size_t)(header.vertices + 1) * sizeof(int64_t)) &&
+              write_section(file, &pos, header.targets_pos, graph->targets,
+                            (size_t)header.edges * sizeof(int32_t));
+    if (ok && with_weights) {
+        ok = write_section(file, &pos, header.weights_pos, graph->weights,
+                           (size_t)header.edges * sizeof(uint32_t));
+    }
+
+    if (fclose(file) != 0) {
+        ok = false;
+    }
+    if (!ok || rename(temp_path, path) != 0) {
+        perror("Error writing snapshot");
+        remove(temp_path);
+        return false;
+    }
+    return true;
+}
+
+static bool header_is_valid(const SnapshotHeader* header, uint64_t file_size) {
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        fprintf(stderr, "Snapshot: bad magic (not a snapshot or wrong byte order)\n");
+        return false;
+    }
+    if (header->version != SNAPSHOT_VERSION) {
+        fprintf(stderr, "Snapshot: unsupported version %u\n", header->version);
+        return false;
+    }
+    if (header->file_size != file_size || header->vertices > INT_MAX) {
+        fprintf(stderr, "Snapshot: truncated or oversized file\n");
+        return false;
+    }
+
+    // Counts and positions are checked against the file before they become
+    // byte sizes, so a crafted header cannot wrap the sums below
+    if (header->vertices + 1 > file_size / sizeof(int64_t) || header->edges > file_size / sizeof(int32_t) ||
+        header->offsets_pos > file_size || header->targets_pos > file_size ||
+        header->weights_pos > file_size) {
+        fprintf(stderr, "Snapshot: section table out of bounds\n");
+        return false;
+    }
+
+    uint64_t offsets_end = header->offsets_pos + (header->vertices + 1) * sizeof(int64_t);
+    uint64_t targets_end = header->targets_pos + header->edges * sizeof(int32_t);
+    bool weighted = (header->flags & SNAPSHOT_FLAG_WEIGHTS) != 0;
+    uint64_t weights_end = header->weights_pos + header->edges * sizeof(uint32_t);
+
+    if (header->offsets_pos % SNAPSHOT_ALIGNMENT || header->targets_pos % SNAPSHOT_ALIGNMENT ||
+        header->weights_pos % SNAPSHOT_ALIGNMENT ||
+        header->offsets_pos < sizeof(SnapshotHeader) || offsets_end > header->targets_pos ||
+        targets_end > file_size || (weighted && (header->weights_pos < targets_end ||
+                                                 weights_end > file_size))) {
+        fprintf(stderr, "Snapshot: section table out of bounds\n");
+        return false;
+    }
+    return true;
+}
+
+CSRGraph* graph_snapshot_open(const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Error opening snapshot");
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (uint64_t)info.st_size < sizeof(SnapshotHeader)) {
+        fprintf(stderr, "Snapshot: %s is too small\n", path);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)info.st_size;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        perror("Error mapping snapshot");
+        return NULL;
+    }
+
+    const SnapshotHeader* header = mapping;
+    CSRGraph* graph = malloc(sizeof(CSRGraph));
+    if (graph == NULL || !header_is_valid(header, size)) {
+        if (graph == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+        }
+        free(graph);
+        munmap(mapping, size);
+        return NULL;
+    }
+
+    char* base = mapping;
+    graph->vertices = (int)header->vertices;
+    graph->edges = (int64_t)header->edges;
+    graph->offsets = (int64_t*)(base + header->offsets_pos);
+    graph->targets = (int32_t*)(base + header->targets_pos);
+    graph->weights = (header->flags & SNAPSHOT_FLAG_WEIGHTS)
+        ? (uint32_t*)(base + header->weights_pos) : NULL;
+    graph->mapping = mapping;
+    graph->mapping_size = size;
+
+    // Cheap consistency check: touches one page at each end of offsets
+    if (graph->offsets[0] != 0 || graph->offsets[graph->vertices] != graph->edges) {
+        fprintf(stderr, "Snapshot: offsets do not match edge count\n");
+        free_csr_graph(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+bool graph_snapshot_validate(const CSRGraph* graph) {
+    if (graph->offsets[0] != 0 || graph->offsets[graph->vertices] != graph->edges) {
+        fprintf(stderr, "Snapshot: offsets do not match edge count\n");
+        return false;
+    }
+    for (int v = 0; v < graph->vertices; v++) {
+        if (graph->offsets[v + 1] < graph->offsets[v]) {
+            fprintf(stderr, "Snapshot: offsets decrease at vertex %d\n", v);
+            return false;
+        }
+    }
+    for (int64_t e = 0; e < graph->edges; e++) {
+        if ((uint32_t)graph->targets[e] >= (uint32_t)graph->vertices) {
+            fprintf(stderr, "Snapshot: edge %lld targets vertex %d of %d\n",
+                    (long long)e, (int)graph->targets[e], graph->vertices);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Edge list parsing works directly on a private mapping of the text file
+static const char* skip_blanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+static const char* parse_number(const char* p, const char* end, uint64_t* value, bool* ok) {
+    uint64_t result = 0;
+    const char* start = p;
+    bool overflow = false;
+    while (p < end && *p >= '0' && *p <= '9') {
+        uint64_t digit = (uint64_t)(*p - '0');
+        if (result > (UINT64_MAX - digit) / 10) {
+            overflow = true;
+        } else {
+            result = result * 10 + digit;
+        }
+        p++;
+    }
+    *ok = p > start && !overflow && result <= UINT32_MAX;
+    *value = result;
+    return p;
+}
+
+CSRGraph* graph_load_edge_list(const char* path, bool undirected) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror("Error opening edge list");
+        return NULL;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        perror("Error reading edge list");
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t)info.st_size;
+    const char* text = size > 0 ? mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0) : "";
+    close(fd);
+    if (text == MAP_FAILED) {
+        perror("Error mapping edge list");
+        return NULL;
+    }
+    if (size > 0) {
+        posix_madvise((void*)text, size, POSIX_MADV_SEQUENTIAL);
+    }
+
+    Edge* edges = NULL;
+    int64_t count = 0;
+    int64_t capacity = 0;
+    uint64_t max_vertex = 0;
+    int64_t line = 0;
+    bool ok = true;
+
+    const char* p = text;
+    const char* end = text + size;
+    while (p < end && ok) {
+        line++;
+        p = skip_blanks(p, end);
+        if (p == end) {
+            break;
+        }
+        if (*p == '\n' || *p == '#' || *p == '%') {
+            while (p < end && *p != '\n') {
+                p++;
+            }
+            p++;
+            continue;
+        }
+
+        uint64_t fields[3] = {0, 0, 1};
+        int parsed = 0;
+        while (parsed < 3 && p < end && *p != '\n') {
+            bool number_ok;
+            p = parse_number(p, end, &fields[parsed], &number_ok);
+            if (!number_ok) {
+                ok = false;
+                break;
+            }
+            parsed++;
+            p = skip_blanks(p, end);
+        }
+        if (!ok || parsed < 2 || (p < end && *p != '\n') ||
+            fields[0] >= INT_MAX || fields[1] >= INT_MAX) {
+            fprintf(stderr, "Edge list %s: bad line %lld\n", path, (long long)line);
+            ok = false;
+            break;
+        }
+        p++;
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : 1 << 16;
+            Edge* grown = realloc(edges, (size_t)capacity * sizeof(Edge));
+            if (grown == NULL) {
+                fprintf(stderr, "Memory allocation failed\n");
+                ok = false;
+                break;
+            }
+            edges = grown;
+        }
+        edges[count].src = (int32_t)fields[0];
+        edges[count].dest = (int32_t)fields[1];
+        edges[count].weight = (uint32_t)fields[2];
+        count++;
+
+        if (fields[0] > max_vertex) max_vertex = fields[0];
+        if (fields[1] > max_vertex) max_vertex = fields[1];
+    }
+
+    if (size > 0) {
+        munmap((void*)text, size);
+    }
+
+    CSRGraph* graph = NULL;
+    if (ok) {
+        graph = csr_from_edges(count > 0 ? (int)max_vertex + 1 : 0, edges, count, undirected);
+    }
+    free(edges);
+    return graph;
+}
@@ -0,0 +1,53 @@
+#ifndef GRAPH_SNAPSHOT_H
+#define GRAPH_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "graph.h"
+
+// On-disk CSR snapshot, native byte order:
+//
+//   [header 64 B][offsets (vertices + 1) x int64][targets edges x int32]
+//   [weights edges x uint32, optional]
+//
+// Every section starts on a 64-byte boundary, so once the file is mapped
+// the arrays are used in place with no parsing or copying.
+#define SNAPSHOT_MAGIC "CSRGRAPH"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ALIGNMENT 64
+
+#define SNAPSHOT_FLAG_WEIGHTS 0x1u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t vertices;
+    uint64_t edges;
+    uint64_t offsets_pos;
+    uint64_t targets_pos;
+    uint64_t weights_pos;   // 0 when the snapshot has no weights
+    uint64_t file_size;
+} SnapshotHeader;
+
+// Writes graph to path; weights are dropped when with_weights is false
+bool graph_snapshot_write(const CSRGraph* graph, const char* path, bool with_weights);
+
+// Maps a snapshot read-only and returns a CSRGraph viewing it; release
+// with free_csr_graph. Returns NULL on I/O error or a malformed header.
+// Only the header and the two ends of offsets are checked, so opening
+// stays O(1): the arrays themselves are trusted. Call
+// graph_snapshot_validate before traversing a file from an untrusted
+// source, or corrupt offsets and targets make traversals read out of
+// bounds.
+CSRGraph* graph_snapshot_open(const char* path);
+
+// Full linear check of the CSR arrays: offsets start at 0, never
+// decrease and end at the edge count, and every target is a vertex id
+bool graph_snapshot_validate(const CSRGraph* graph);
+
+// Text edge list: one "src dest [weight]" per line, '#' or '%' comments.
+// Vertex count is the largest id + 1.
+CSRGraph* graph_load_edge_list(const char* path, bool undirected);
+
+#endif /* GRAPH_SNAPSHOT_H */
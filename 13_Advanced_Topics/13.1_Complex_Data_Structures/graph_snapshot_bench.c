@@ -0,0 +1,238 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "graph.h"
+#include "graph_snapshot.h"
+
+// Startup cost of the three ways to get a graph into memory:
+//   1. fscanf + add_directed_edge (one malloc per edge, the original path)
+//   2. graph_load_edge_list (mapped text, one bulk CSR build)
+//   3. graph_snapshot_open (mmap, no parsing), then the full
+//      graph_snapshot_validate pass for files that are not trusted
+#define EDGE_FILE "snapshot_bench_edges.txt"
+#define SNAPSHOT_FILE "snapshot_bench.csr"
+#define AVERAGE_DEGREE 10
+
+static uint64_t rng_state = 0xD1B54A32D192ED03ull;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static bool write_edge_list(int vertices, int64_t edges) {
+    FILE* file = fopen(EDGE_FILE, "w");
+    if (file == NULL) {
+        perror("Error creating edge list");
+        return false;
+    }
+
+    fprintf(file, "# src dest weight\n");
+    for (int64_t i = 0; i < edges; i++) {
+        fprintf(file, "%u %u %u\n", next_random() % (uint32_t)vertices,
+                next_random() % (uint32_t)vertices, 1 + next_random() % 100);
+    }
+    return fclose(file) == 0;
+}
+
+static Graph* load_with_fscanf(int vertices) {
+    FILE* file = fopen(EDGE_FILE, "r");
+    if (file == NULL) {
+        perror("Error opening edge list");
+        return NULL;
+    }
+
+    Graph* graph = create_graph(vertices);
+    char line[128];
+    while (fgets(line, sizeof(line), file)) {
+        int src, dest;
+        unsigned weight;
+        if (sscanf(line, "%d %d %u", &src, &dest, &weight) == 3) {
+            add_directed_edge(graph, src, dest, weight);
+        }
+    }
+    fclose(file);
+    return graph;
+}
+
+// Touch every edge so the snapshot timing includes paging the data in
+static uint64_t scan_edges(const CSRGraph* graph) {
+    uint64_t sum = 0;
+    for (int64_t e = 0; e < graph->edges; e++) {
+        sum += (uint64_t)graph->targets[e] + csr_weight(graph, e);
+    }
+    return sum;
+}
+
+// A snapshot whose edge count wraps when scaled to bytes (with offsets
+// to match) and an edge list with a 20-digit vertex id both pass naive
+// checks; each must be rejected
+static bool check_malformed_inputs(void) {
+    FILE* file = fopen(SNAPSHOT_FILE, "r+b");
+    SnapshotHeader header;
+    if (file == NULL || fread(&header, sizeof(header), 1, file) != 1) {
+        if (file) fclose(file);
+        return false;
+    }
+    int64_t wrapped = (int64_t)(header.edges + (1ull << 62));
+    header.edges = (uint64_t)wrapped;
+    bool written = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   fseek(file, (long)(header.offsets_pos + header.vertices * sizeof(int64_t)), SEEK_SET) == 0 &&
+                   fwrite(&wrapped, sizeof(wrapped), 1, file) == 1;
+    if (fclose(file) != 0 || !written) {
+        return false;
+    }
+    CSRGraph* graph = graph_snapshot_open(SNAPSHOT_FILE);
+    bool rejected = graph == NULL;
+    free_csr_graph(graph);
+
+    file = fopen(EDGE_FILE, "w");
+    if (file == NULL) {
+        return false;
+    }
+    fprintf(file, "1 2\n18446744073709551621 3\n");   // 2^64 + 5
+    fclose(file);
+    graph = graph_load_edge_list(EDGE_FILE, false);
+    rejected = rejected && graph == NULL;
+    free_csr_graph(graph);
+    return rejected;
+}
+
+// Writes a fresh snapshot of graph, then overwrites size bytes at position
+static bool write_corrupt_snapshot(const CSRGraph* graph, uint64_t position, const void* value, size_t size) {
+    if (!graph_snapshot_write(graph, SNAPSHOT_FILE, true)) {
+        return false;
+    }
+    FILE* file = fopen(SNAPSHOT_FILE, "r+b");
+    if (file == NULL) {
+        return false;
+    }
+    bool written = fseek(file, (long)position, SEEK_SET) == 0 && fwrite(value, size, 1, file) == 1;
+    return fclose(file) == 0 && written;
+}
+
+// Offsets that decrease mid-array and a target past the last vertex both
+// open, since open only checks the ends of offsets; validate must reject them
+static bool check_corrupt_arrays(void) {
+    Edge edges[] = {{0, 1, 1}, {1, 2, 1}, {2, 3, 1}, {3, 0, 1}};
+    CSRGraph* graph = csr_from_edges(4, edges, 4, false);
+    if (graph == NULL) {
+        return false;
+    }
+    SnapshotHeader header;
+    FILE* file = NULL;
+    bool ok = graph_snapshot_write(graph, SNAPSHOT_FILE, true) && (file = fopen(SNAPSHOT_FILE, "rb")) != NULL &&
+              fread(&header, sizeof(header), 1, file) == 1;
+    if (file != NULL) {
+        fclose(file);
+    }
+
+    CSRGraph* opened = ok ? graph_snapshot_open(SNAPSHOT_FILE) : NULL;
+    ok = opened != NULL && graph_snapshot_validate(opened);
+    free_csr_graph(opened);
+
+    // offsets[2] = 4 > offsets[3] = 3
+    int64_t bad_offset = 4;
+    ok = ok && write_corrupt_snapshot(graph, header.offsets_pos + 2 * sizeof(int64_t), &bad_offset,
+                                      sizeof(bad_offset));
+    opened = ok ? graph_snapshot_open(SNAPSHOT_FILE) : NULL;
+    ok = opened != NULL && !graph_snapshot_validate(opened);
+    free_csr_graph(opened);
+
+    int32_t bad_target = 4;
+    ok = ok && write_corrupt_snapshot(graph, header.targets_pos + 2 * sizeof(int32_t), &bad_target,
+                                      sizeof(bad_target));
+    opened = ok ? graph_snapshot_open(SNAPSHOT_FILE) : NULL;
+    ok = opened != NULL && !graph_snapshot_validate(opened);
+    free_csr_graph(opened);
+
+    free_csr_graph(graph);
+    return ok;
+}
+
+int main(int argc, char* argv[]) {
+    int64_t edges = argc > 1 ? atoll(argv[1]) : 20000000;
+    if (edges < 1) {
+        fprintf(stderr, "Usage: %s [edges >= 1]\n", argv[0]);
+        return 1;
+    }
+    int vertices = (int)(edges / AVERAGE_DEGREE > 1 ? edges / AVERAGE_DEGREE : 2);
+
+    printf("=== Graph Snapshot Benchmark ===\n");
+    printf("%d vertices, %lld edges\n\n", vertices, (long long)edges);
+
+    double start = now_seconds();
+    if (!write_edge_list(vertices, edges)) {
+        return 1;
+    }
+    printf("  %-36s %10.1f ms\n", "write text edge list", (now_seconds() - start) * 1e3);
+
+    start = now_seconds();
+    CSRGraph* parsed = graph_load_edge_list(EDGE_FILE, false);
+    double parse_time = now_seconds() - start;
+    if (parsed == NULL) {
+        return 1;
+    }
+    printf("  %-36s %10.1f ms\n", "graph_load_edge_list (mapped text)", parse_time * 1e3);
+
+    start = now_seconds();
+    if (!graph_snapshot_write(parsed, SNAPSHOT_FILE, true)) {
+        return 1;
+    }
+    printf("  %-36s %10.1f ms\n", "graph_snapshot_write", (now_seconds() - start) * 1e3);
+    uint64_t expected = scan_edges(parsed);
+    free_csr_graph(parsed);
+
+    start = now_seconds();
+    CSRGraph* mapped = graph_snapshot_open(SNAPSHOT_FILE);
+    double open_time = now_seconds() - start;
+    if (mapped == NULL) {
+        return 1;
+    }
+    printf("  %-36s %10.3f ms\n", "graph_snapshot_open (mmap)", open_time * 1e3);
+
+    start = now_seconds();
+    uint64_t sum = scan_edges(mapped);
+    double scan_time = now_seconds() - start;
+    printf("  %-36s %10.1f ms  %s\n", "first full scan of mapped edges", scan_time * 1e3,
+           sum == expected ? "(matches)" : "(MISMATCH)");
+
+    // After the scan, so the scan still pays for paging the file in
+    start = now_seconds();
+    bool valid = graph_snapshot_validate(mapped);
+    printf("  %-36s %10.1f ms  %s\n", "graph_snapshot_validate (warm)", (now_seconds() - start) * 1e3,
+           valid ? "(valid)" : "(INVALID)");
+    free_csr_graph(mapped);
+
+    // Last, so its millions of freed nodes do not skew the other timings
+    start = now_seconds();
+    Graph* list_graph = load_with_fscanf(vertices);
+    double fscanf_time = now_seconds() - start;
+    if (list_graph == NULL) {
+        return 1;
+    }
+    printf("  %-36s %10.1f ms\n", "fscanf + add_directed_edge", fscanf_time * 1e3);
+    free_graph(list_graph);
+
+    printf("\nStartup speedup vs fscanf: %.0fx to open, %.1fx including first scan\n",
+           fscanf_time / open_time, fscanf_time / (open_time + scan_time));
+
+    printf("\nMalformed inputs (expect four errors):\n");
+    fflush(stdout);
+    bool rejected = check_corrupt_arrays() && check_malformed_inputs();
+    printf("  %s\n", rejected ? "all rejected" : "ACCEPTED");
+
+    remove(EDGE_FILE);
+    remove(SNAPSHOT_FILE);
+    return sum == expected && valid && rejected ? 0 : 1;
+}
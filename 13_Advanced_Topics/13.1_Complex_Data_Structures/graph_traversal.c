@@ -0,0 +1,382 @@
+#include "graph_traversal.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+enum {
+    WHITE,  // not discovered
+    GRAY,   // on the DFS stack
+    BLACK   // finished
+};
+
+// One frame per vertex on the current DFS path: the vertex and the next
+// out-edge still to be examined
+typedef struct {
+    int vertex;
+    int64_t next_edge;
+} DfsFrame;
+
+typedef struct {
+    DfsFrame* frames;
+    int64_t count;
+    int64_t capacity;
+} DfsStack;
+
+static bool stack_push(DfsStack* stack, const CSRGraph* graph, int vertex) {
+    if (stack->count == stack->capacity) {
+        int64_t new_capacity = stack->capacity ? stack->capacity * 2 : 256;
+        DfsFrame* frames = realloc(stack->frames, (size_t)new_capacity * sizeof(DfsFrame));
+        if (frames == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return false;
+        }
+        stack->frames = frames;
+        stack->capacity = new_capacity;
+    }
+    stack->frames[stack->count].vertex = vertex;
+    stack->frames[stack->count].next_edge = graph->offsets[vertex];
+    stack->count++;
+    return true;
+}
+
+// Core explicit-stack DFS from one root. Edges are examined in CSR order,
+// which gives the same visiting order as the recursive version.
+static bool dfs_run(const CSRGraph* graph, int start, const DfsVisitor* visitor,
+                    unsigned char* color, DfsStack* stack) {
+    if (color[start] != WHITE) {
+        return true;
+    }
+
+    DfsAction action = visitor->pre_visit
+        ? visitor->pre_visit(start, DFS_NO_PARENT, visitor->context) : DFS_CONTINUE;
+    if (action == DFS_STOP) {
+        return false;
+    }
+    if (action == DFS_SKIP) {
+        color[start] = BLACK;
+        return true;
+    }
+
+    color[start] = GRAY;
+    stack->count = 0;
+    if (!stack_push(stack, graph, start)) {
+        return false;
+    }
+
+    while (stack->count > 0) {
+        DfsFrame* top = &stack->frames[stack->count - 1];
+        int u = top->vertex;
+
+        if (top->next_edge < graph->offsets[u + 1]) {
+            int v = graph->targets[top->next_edge++];
+
+            if (color[v] == WHITE) {
+                action = visitor->pre_visit
+                    ? visitor->pre_visit(v, u, visitor->context) : DFS_CONTINUE;
+                if (action == DFS_STOP) {
+                    return false;
+                }
+                if (action == DFS_SKIP) {
+                    color[v] = BLACK;
+                    continue;
+                }
+                color[v] = GRAY;
+                if (!stack_push(stack, graph, v)) {
+                    return false;
+                }
+            } else if (color[v] == GRAY && visitor->back_edge) {
+                if (visitor->back_edge(u, v, visitor->context) == DFS_STOP) {
+                    return false;
+                }
+            }
+        } else {
+            color[u] = BLACK;
+            stack->count--;
+            int parent = stack->count > 0 ? stack->frames[stack->count - 1].vertex : DFS_NO_PARENT;
+            if (visitor->post_visit &&
+                visitor->post_visit(u, parent, visitor->context) == DFS_STOP) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool dfs_traverse(const CSRGraph* graph, int start, const DfsVisitor* visitor,
+                  unsigned char* visited) {
+    if (start < 0 || start >= graph->vertices) {
+        fprintf(stderr, "DFS: start vertex %d out of range\n", start);
+        return false;
+    }
+
+    unsigned char* color = visited ? visited : calloc((size_t)graph->vertices, 1);
+    if (color == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    DfsStack stack = {NULL, 0, 0};
+    bool completed = dfs_run(graph, start, visitor, color, &stack);
+
+    free(stack.frames);
+    if (visited == NULL) {
+        free(color);
+    }
+    return completed;
+}
+
+bool dfs_all(const CSRGraph* graph, const DfsVisitor* visitor) {
+    unsigned char* color = calloc((size_t)graph->vertices, 1);
+    if (color == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    DfsStack stack = {NULL, 0, 0};
+    bool completed = true;
+    for (int v = 0; v < graph->vertices && completed; v++) {
+        completed = dfs_run(graph, v, visitor, color, &stack);
+    }
+
+    free(stack.frames);
+    free(color);
+    return completed;
+}
+
+// Topological sort: reverse post-order, aborted by the first back edge
+typedef struct {
+    int* order;
+    int next;
+    bool cyclic;
+} TopoContext;
+
+static DfsAction topo_post_visit(int vertex, int parent, void* context) {
+    TopoContext* ctx = context;
+    (void)parent;
+    ctx->order[ctx->next--] = vertex;
+    return DFS_CONTINUE;
+}
+
+static DfsAction stop_on_back_edge(int from, int to, void* context) {
+    (void)from;
+    (void)to;
+    *(bool*)context = true;
+    return DFS_STOP;
+}
+
+static DfsAction topo_back_edge(int from, int to, void* context) {
+    TopoContext* ctx = context;
+    return stop_on_back_edge(from, to, &ctx->cyclic);
+}
+
+bool topological_sort(const CSRGraph* graph, int* order) {
+    TopoContext ctx = {order, graph->vertices - 1, false};
+    DfsVisitor visitor = {NULL, topo_post_visit, topo_back_edge, &ctx};
+
+    return dfs_all(graph, &visitor) && !ctx.cyclic;
+}
+
+bool graph_has_cycle(const CSRGraph* graph) {
+    bool cyclic = false;
+    DfsVisitor visitor = {NULL, NULL, stop_on_back_edge, &cyclic};
+
+    dfs_all(graph, &visitor);
+    return cyclic;
+}
+
+// Connected components: every DFS tree is one component
+typedef struct {
+    int* component;
+    int current;
+} ComponentContext;
+
+static DfsAction label_pre_visit(int vertex, int parent, void* context) {
+    ComponentContext* ctx = context;
+    (void)parent;
+    ctx->component[vertex] = ctx->current;
+    return DFS_CONTINUE;
+}
+
+int connected_components(const CSRGraph* graph, int* component) {
+    unsigned char* color = calloc((size_t)graph->vertices, 1);
+    if (color == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return -1;
+    }
+
+    ComponentContext ctx = {component, 0};
+    DfsVisitor visitor = {label_pre_visit, NULL, NULL, &ctx};
+    DfsStack stack = {NULL, 0, 0};
+
+    for (int v = 0; v < graph->vertices; v++) {
+        if (color[v] != WHITE) {
+            continue;
+        }
+        if (!dfs_run(graph, v, &visitor, color, &stack)) {
+            ctx.current = -1;
+            break;
+        }
+        ctx.current++;
+    }
+
+    free(stack.frames);
+    free(color);
+    return ctx.current;
+}
+
+// Tarjan's SCC with the recursion unrolled onto DfsStack. low[] is folded
+// into the parent when a frame is popped, which is where the recursive
+// version would return.
+int strongly_connected_components(const CSRGraph* graph, int* component) {
+    int n = graph->vertices;
+    int* index = malloc((size_t)n * sizeof(int));
+    int* low = malloc((size_t)n * sizeof(int));
+    int* members = malloc((size_t)n * sizeof(int));
+    unsigned char* on_stack = calloc((size_t)n, 1);
+    DfsStack stack = {NULL, 0, 0};
+
+    if (index == NULL || low == NULL || members == NULL || on_stack == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(index);
+        free(low);
+        free(members);
+        free(on_stack);
+        return -1;
+    }
+
+    for (int v = 0; v < n; v++) {
+        index[v] = -1;
+    }
+
+    int counter = 0;
+    int member_count = 0;
+    int components = 0;
+
+    for (int root = 0; root < n && components >= 0; root++) {
+        if (index[root] != -1) {
+            continue;
+        }
+
+        index[root] = low[root] = counter++;
+        members[member_count++] = root;
+        on_stack[root] = 1;
+        stack.count = 0;
+        if (!stack_push(&stack, graph, root)) {
+            components = -1;
+            break;
+        }
+
+        while (stack.count > 0) {
+            DfsFrame* top = &stack.frames[stack.count - 1];
+            int u = top->vertex;
+
+            if (top->next_edge < graph->offsets[u + 1]) {
+                int v = graph->targets[top->next_edge++];
+                if (index[v] == -1) {
+                    index[v] = low[v] = counter++;
+                    members[member_count++] = v;
+                    on_stack[v] = 1;
+                    if (!stack_push(&stack, graph, v)) {
+                        components = -1;
+                        break;
+                    }
+                } else if (on_stack[v] && index[v] < low[u]) {
+                    low[u] = index[v];
+                }
+                continue;
+            }
+
+            stack.count--;
+            if (low[u] == index[u]) {
+                int w;
+                do {
+                    w = members[--member_count];
+                    on_stack[w] = 0;
+                    component[w] = components;
+                } while (w != u);
+                components++;
+            }
+            if (stack.count > 0) {
+                int parent = stack.frames[stack.count - 1].vertex;
+                if (low[u] < low[parent]) {
+                    low[parent] = low[u];
+                }
+            }
+        }
+    }
+
+    free(stack.frames);
+    free(index);
+    free(low);
+    free(members);
+    free(on_stack);
+    return components;
+}
+
+// Depth-limited DFS for each limit in turn. best[] keeps the shallowest
+// depth a vertex was reached at, so a vertex is only re-expanded when a
+// shorter path to it turns up.
+int iterative_deepening_search(const CSRGraph* graph, int source, int target, int max_depth) {
+    if (source < 0 || source >= graph->vertices || target < 0 || target >= graph->vertices) {
+        fprintf(stderr, "IDDFS: vertex out of range\n");
+        return -1;
+    }
+    if (source == target) {
+        return 0;
+    }
+
+    int* best = malloc((size_t)graph->vertices * sizeof(int));
+    if (best == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return -1;
+    }
+
+    DfsStack stack = {NULL, 0, 0};
+    int found = -1;
+
+    for (int limit = 1; limit <= max_depth && found < 0; limit++) {
+        bool cut_off = false;
+        for (int v = 0; v < graph->vertices; v++) {
+            best[v] = limit + 1;
+        }
+
+        best[source] = 0;
+        stack.count = 0;
+        if (!stack_push(&stack, graph, source)) {
+            break;
+        }
+
+        while (stack.count > 0 && found < 0) {
+            DfsFrame* top = &stack.frames[stack.count - 1];
+            int u = top->vertex;
+            int depth = (int)stack.count;   // depth of u's children
+
+            if (top->next_edge >= graph->offsets[u + 1]) {
+                stack.count--;
+                continue;
+            }
+
+            int v = graph->targets[top->next_edge++];
+            if (v == target) {
+                found = depth;
+            } else if (depth >= limit) {
+                cut_off = true;
+            } else if (depth < best[v]) {
+                best[v] = depth;
+                if (!stack_push(&stack, graph, v)) {
+                    stack.count = 0;
+                    cut_off = false;
+                }
+            }
+        }
+
+        // Nothing was pruned by the limit: a deeper pass cannot find more
+        if (!cut_off) {
+            break;
+        }
+    }
+
+    free(stack.frames);
+    free(best);
+    return found;
+}
@@ -0,0 +1,50 @@
+#ifndef GRAPH_TRAVERSAL_H
+#define GRAPH_TRAVERSAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "graph.h"
+
+// All traversals below keep their own explicit stack on the heap, so path
+// length is bounded by memory rather than by the call stack.
+
+#define DFS_NO_PARENT (-1)
+
+// Returned by visitor callbacks
+typedef enum {
+    DFS_CONTINUE,   // keep going
+    DFS_SKIP,       // pre_visit only: do not descend into this vertex
+    DFS_STOP        // abandon the whole traversal
+} DfsAction;
+
+// Any callback may be NULL. back_edge fires for an edge whose target is
+// still on the DFS stack (a cycle in a directed graph).
+typedef struct {
+    DfsAction (*pre_visit)(int vertex, int parent, void* context);
+    DfsAction (*post_visit)(int vertex, int parent, void* context);
+    DfsAction (*back_edge)(int from, int to, void* context);
+    void* context;
+} DfsVisitor;
+
+// Depth-first search from start; visited (vertices bytes, may be NULL)
+// carries state across calls so several roots can share one forest.
+// Returns false if a callback stopped the traversal or allocation failed.
+bool dfs_traverse(const CSRGraph* graph, int start, const DfsVisitor* visitor,
+                  unsigned char* visited);
+
+// DFS forest over every vertex, roots taken in increasing order
+bool dfs_all(const CSRGraph* graph, const DfsVisitor* visitor);
+
+// Directed-graph algorithms
+bool topological_sort(const CSRGraph* graph, int* order);
+bool graph_has_cycle(const CSRGraph* graph);
+int strongly_connected_components(const CSRGraph* graph, int* component);
+
+// Undirected graphs (both edge directions present, as add_edge builds)
+int connected_components(const CSRGraph* graph, int* component);
+
+// Iterative deepening: depth of the shallowest path from source to target
+// using at most max_depth edges, or -1 if there is none
+int iterative_deepening_search(const CSRGraph* graph, int source, int target, int max_depth);
+
+#endif /* GRAPH_TRAVERSAL_H */
@@ -0,0 +1,143 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "graph.h"
+#include "graph_traversal.h"
+
+// Every graph is a chain 0 -> 1 -> ... -> n-1 plus random forward edges,
+// so DFS from vertex 0 goes n levels deep: a recursive DFS would need
+// n stack frames.
+#define EXTRA_EDGES_PER_VERTEX 2
+
+static uint64_t rng_state = 0x2545F4914F6CDD1Dull;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static CSRGraph* build_chain_graph(int n, bool close_cycle, bool undirected) {
+    int64_t capacity = (int64_t)n * (1 + EXTRA_EDGES_PER_VERTEX) + 1;
+    Edge* edges = malloc((size_t)capacity * sizeof(Edge));
+    if (edges == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    int64_t count = 0;
+    for (int v = 0; v + 1 < n; v++) {
+        edges[count++] = (Edge){v, v + 1, 1};
+        for (int k = 0; k < EXTRA_EDGES_PER_VERTEX; k++) {
+            // Forward edges only, so the directed graph stays acyclic
+            int dest = v + 1 + (int)(next_random() % (uint32_t)(n - v - 1));
+            edges[count++] = (Edge){v, dest, 1};
+        }
+    }
+    if (close_cycle) {
+        edges[count++] = (Edge){n - 1, 0, 1};
+    }
+
+    CSRGraph* graph = csr_from_edges(n, edges, count, undirected);
+    free(edges);
+    return graph;
+}
+
+static DfsAction count_visit(int vertex, int parent, void* context) {
+    (void)vertex;
+    (void)parent;
+    (*(int64_t*)context)++;
+    return DFS_CONTINUE;
+}
+
+static void report(const char* name, double seconds, int vertices, const char* outcome) {
+    printf("  %-26s %9.1f ms  %7.1f M vertices/s  %s\n",
+           name, seconds * 1e3, vertices / seconds / 1e6, outcome);
+}
+
+int main(int argc, char* argv[]) {
+    int n = argc > 1 ? atoi(argv[1]) : 10000000;
+    if (n < 2) {
+        fprintf(stderr, "Usage: %s [vertices >= 2]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== Iterative DFS Benchmark ===\n");
+    printf("Chain of %d vertices + %d random forward edges per vertex\n\n",
+           n, EXTRA_EDGES_PER_VERTEX);
+
+    int* scratch = malloc((size_t)n * sizeof(int));
+    if (scratch == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+    char outcome[64];
+
+    printf("Directed acyclic:\n");
+    CSRGraph* graph = build_chain_graph(n, false, false);
+    if (graph == NULL) {
+        return 1;
+    }
+
+    int64_t visited = 0;
+    DfsVisitor counter = {count_visit, NULL, NULL, &visited};
+    double start = now_seconds();
+    dfs_all(graph, &counter);
+    snprintf(outcome, sizeof(outcome), "%lld visited", (long long)visited);
+    report("dfs_all (pre-order)", now_seconds() - start, n, outcome);
+
+    start = now_seconds();
+    bool sorted = topological_sort(graph, scratch);
+    snprintf(outcome, sizeof(outcome), "%s, first %d", sorted ? "ok" : "FAILED", scratch[0]);
+    report("topological_sort", now_seconds() - start, n, outcome);
+
+    start = now_seconds();
+    bool cyclic = graph_has_cycle(graph);
+    report("graph_has_cycle", now_seconds() - start, n, cyclic ? "cycle" : "acyclic");
+
+    start = now_seconds();
+    int components = strongly_connected_components(graph, scratch);
+    snprintf(outcome, sizeof(outcome), "%d components", components);
+    report("strongly_connected_comps", now_seconds() - start, n, outcome);
+    free_csr_graph(graph);
+
+    printf("\nDirected with back edge n-1 -> 0:\n");
+    graph = build_chain_graph(n, true, false);
+    if (graph == NULL) {
+        return 1;
+    }
+
+    start = now_seconds();
+    cyclic = graph_has_cycle(graph);
+    report("graph_has_cycle", now_seconds() - start, n, cyclic ? "cycle" : "acyclic");
+
+    start = now_seconds();
+    components = strongly_connected_components(graph, scratch);
+    snprintf(outcome, sizeof(outcome), "%d components", components);
+    report("strongly_connected_comps", now_seconds() - start, n, outcome);
+    free_csr_graph(graph);
+
+    printf("\nUndirected:\n");
+    graph = build_chain_graph(n, false, true);
+    if (graph == NULL) {
+        return 1;
+    }
+
+    start = now_seconds();
+    components = connected_components(graph, scratch);
+    snprintf(outcome, sizeof(outcome), "%d components", components);
+    report("connected_components", now_seconds() - start, n, outcome);
+    free_csr_graph(graph);
+
+    free(scratch);
+    return 0;
+}
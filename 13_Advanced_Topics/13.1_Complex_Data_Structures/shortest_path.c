@@ -0,0 +1,736 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "shortest_path.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Growable vertex list (buckets, frontiers, per-thread outputs)
+typedef struct {
+    int* items;
+    int64_t count;
+    int64_t capacity;
+} VertexBuffer;
+
+static bool buffer_push(VertexBuffer* buf, int vertex) {
+    if (buf->count == buf->capacity) {
+        int64_t new_capacity = buf->capacity ? buf->capacity * 2 : 64;
+        int* items = realloc(buf->items, (size_t)new_capacity * sizeof(int));
+        if (items == NULL) {
+            return false;
+        }
+        buf->items = items;
+        buf->capacity = new_capacity;
+    }
+    buf->items[buf->count++] = vertex;
+    return true;
+}
+
+// Result lifetime
+ShortestPathResult* sp_result_create(int vertices) {
+    ShortestPathResult* result = malloc(sizeof(ShortestPathResult));
+    if (result == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    result->vertices = vertices;
+    result->dist = malloc((size_t)vertices * sizeof(uint64_t));
+    result->parent = malloc((size_t)vertices * sizeof(int));
+    if (result->dist == NULL || result->parent == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        sp_result_free(result);
+        return NULL;
+    }
+
+    for (int v = 0; v < vertices; v++) {
+        result->dist[v] = SP_INFINITY;
+        result->parent[v] = SP_NO_PARENT;
+    }
+    return result;
+}
+
+void sp_result_free(ShortestPathResult* result) {
+    if (result) {
+        free(result->dist);
+        free(result->parent);
+        free(result);
+    }
+}
+
+static void reset_result(ShortestPathResult* result) {
+    for (int v = 0; v < result->vertices; v++) {
+        result->dist[v] = SP_INFINITY;
+        result->parent[v] = SP_NO_PARENT;
+    }
+}
+
+static bool check_query(const CSRGraph* graph, int source, const ShortestPathResult* result) {
+    if (graph == NULL || result == NULL || result->vertices != graph->vertices) {
+        fprintf(stderr, "Shortest path: result does not match graph\n");
+        return false;
+    }
+    if (source < 0 || source >= graph->vertices) {
+        fprintf(stderr, "Shortest path: source %d out of range\n", source);
+        return false;
+    }
+    return true;
+}
+
+// Binary min-heap with lazy deletion: stale entries are skipped on pop
+// instead of paying for decrease-key
+typedef struct {
+    uint64_t key;
+    int vertex;
+} HeapEntry;
+
+typedef struct {
+    HeapEntry* entries;
+    int64_t count;
+    int64_t capacity;
+} BinaryHeap;
+
+static bool heap_push(BinaryHeap* heap, uint64_t key, int vertex) {
+    if (heap->count == heap->capacity) {
+        int64_t new_capacity = heap->capacity ? heap->capacity * 2 : 1024;
+        HeapEntry* entries = realloc(heap->entries, (size_t)new_capacity * sizeof(HeapEntry));
+        if (entries == NULL) {
+            return false;
+        }
+        heap->entries = entries;
+        heap->capacity = new_capacity;
+    }
+
+    int64_t i = heap->count++;
+    while (i > 0) {
+        int64_t parent = (i - 1) / 2;
+        if (heap->entries[parent].key <= key) {
+            break;
+        }
+        heap->entries[i] = heap->entries[parent];
+        i = parent;
+    }
+    heap->entries[i].key = key;
+    heap->entries[i].vertex = vertex;
+    return true;
+}
+
+static HeapEntry heap_pop(BinaryHeap* heap) {
+    HeapEntry top = heap->entries[0];
+    HeapEntry last = heap->entries[--heap->count];
+
+    int64_t i = 0;
+    for (;;) {
+        int64_t child = 2 * i + 1;
+        if (child >= heap->count) {
+            break;
+        }
+        if (child + 1 < heap->count && heap->entries[child + 1].key < heap->entries[child].key) {
+            child++;
+        }
+        if (last.key <= heap->entries[child].key) {
+            break;
+        }
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    if (heap->count > 0) {
+        heap->entries[i] = last;
+    }
+    return top;
+}
+
+static bool dijkstra_binary(const CSRGraph* graph, int source, ShortestPathResult* result) {
+    BinaryHeap heap = {NULL, 0, 0};
+    uint64_t* dist = result->dist;
+
+    dist[source] = 0;
+    if (!heap_push(&heap, 0, source)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    while (heap.count > 0) {
+        HeapEntry top = heap_pop(&heap);
+        int u = top.vertex;
+        if (top.key > dist[u]) {
+            continue;
+        }
+
+        for (int64_t e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int v = graph->targets[e];
+            uint64_t candidate = top.key + csr_weight(graph, e);
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                result->parent[v] = u;
+                if (!heap_push(&heap, candidate, v)) {
+                    fprintf(stderr, "Memory allocation failed\n");
+                    free(heap.entries);
+                    return false;
+                }
+            }
+        }
+    }
+
+    free(heap.entries);
+    return true;
+}
+
+// Pairing heap with true decrease-key. Nodes are preallocated per vertex
+// and linked by index; prev is the parent for a leftmost child and the
+// left sibling otherwise.
+typedef struct {
+    int child;
+    int sibling;
+    int prev;
+} PairingNode;
+
+typedef struct {
+    PairingNode* nodes;
+    const uint64_t* key;
+    int* scratch;
+    int root;
+} PairingHeap;
+
+static int pairing_meld(PairingHeap* heap, int a, int b) {
+    if (a < 0) return b;
+    if (b < 0) return a;
+
+    if (heap->key[b] < heap->key[a]) {
+        int temp = a;
+        a = b;
+        b = temp;
+    }
+
+    PairingNode* nodes = heap->nodes;
+    nodes[b].prev = a;
+    nodes[b].sibling = nodes[a].child;
+    if (nodes[a].child >= 0) {
+        nodes[nodes[a].child].prev = b;
+    }
+    nodes[a].child = b;
+    return a;
+}
+
+static void pairing_insert(PairingHeap* heap, int vertex) {
+    heap->nodes[vertex].child = -1;
+    heap->nodes[vertex].sibling = -1;
+    heap->nodes[vertex].prev = -1;
+    heap->root = pairing_meld(heap, heap->root, vertex);
+}
+
+// Call after key[vertex] has been lowered
+static void pairing_decrease_key(PairingHeap* heap, int vertex) {
+    if (vertex == heap->root) {
+        return;
+    }
+
+    PairingNode* nodes = heap->nodes;
+    int prev = nodes[vertex].prev;
+    int sibling = nodes[vertex].sibling;
+
+    if (nodes[prev].child == vertex) {
+        nodes[prev].child = sibling;
+    } else {
+        nodes[prev].sibling = sibling;
+    }
+    if (sibling >= 0) {
+        nodes[sibling].prev = prev;
+    }
+
+    nodes[vertex].sibling = -1;
+    nodes[vertex].prev = -1;
+    heap->root = pairing_meld(heap, heap->root, vertex);
+}
+
+static int pairing_pop(PairingHeap* heap) {
+    PairingNode* nodes = heap->nodes;
+    int min = heap->root;
+    int count = 0;
+
+    for (int c = nodes[min].child; c >= 0;) {
+        int next = nodes[c].sibling;
+        nodes[c].sibling = -1;
+        nodes[c].prev = -1;
+        heap->scratch[count++] = c;
+        c = next;
+    }
+
+    // Two-pass pairing: meld neighbours left to right, then fold right to left
+    int pairs = 0;
+    for (int i = 0; i + 1 < count; i += 2) {
+        heap->scratch[pairs++] = pairing_meld(heap, heap->scratch[i], heap->scratch[i + 1]);
+    }
+    if (count % 2) {
+        heap->scratch[pairs++] = heap->scratch[count - 1];
+    }
+
+    int root = -1;
+    for (int i = pairs - 1; i >= 0; i--) {
+        root = pairing_meld(heap, root, heap->scratch[i]);
+    }
+    heap->root = root;
+    return min;
+}
+
+static bool dijkstra_pairing(const CSRGraph* graph, int source, ShortestPathResult* result) {
+    int n = graph->vertices;
+    uint64_t* dist = result->dist;
+    PairingHeap heap;
+    heap.nodes = malloc((size_t)n * sizeof(PairingNode));
+    heap.scratch = malloc((size_t)n * sizeof(int));
+    unsigned char* state = calloc((size_t)n, 1);  // 0 = unseen, 1 = queued, 2 = settled
+    heap.key = dist;
+    heap.root = -1;
+
+    if (heap.nodes == NULL || heap.scratch == NULL || state == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(heap.nodes);
+        free(heap.scratch);
+        free(state);
+        return false;
+    }
+
+    dist[source] = 0;
+    pairing_insert(&heap, source);
+    state[source] = 1;
+
+    while (heap.root >= 0) {
+        int u = pairing_pop(&heap);
+        state[u] = 2;
+
+        for (int64_t e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int v = graph->targets[e];
+            if (state[v] == 2) {
+                continue;
+            }
+
+            uint64_t candidate = dist[u] + csr_weight(graph, e);
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                result->parent[v] = u;
+                if (state[v] == 0) {
+                    pairing_insert(&heap, v);
+                    state[v] = 1;
+                } else {
+                    pairing_decrease_key(&heap, v);
+                }
+            }
+        }
+    }
+
+    free(heap.nodes);
+    free(heap.scratch);
+    free(state);
+    return true;
+}
+
+bool dijkstra(const CSRGraph* graph, int source, HeapKind heap, ShortestPathResult* result) {
+    if (!check_query(graph, source, result)) {
+        return false;
+    }
+
+    reset_result(result);
+    if (heap == SP_HEAP_PAIRING) {
+        return dijkstra_pairing(graph, source, result);
+    }
+    return dijkstra_binary(graph, source, result);
+}
+
+bool astar(const CSRGraph* graph, int source, int target, HeuristicFn heuristic,
+           void* context, ShortestPathResult* result) {
+    if (!check_query(graph, source, result)) {
+        return false;
+    }
+    if (target < 0 || target >= graph->vertices || heuristic == NULL) {
+        fprintf(stderr, "A*: invalid target or heuristic\n");
+        return false;
+    }
+
+    reset_result(result);
+    BinaryHeap heap = {NULL, 0, 0};
+    uint64_t* dist = result->dist;
+
+    dist[source] = 0;
+    if (!heap_push(&heap, heuristic(source, target, context), source)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    while (heap.count > 0) {
+        HeapEntry top = heap_pop(&heap);
+        int u = top.vertex;
+        if (u == target) {
+            break;
+        }
+        if (top.key > dist[u] + heuristic(u, target, context)) {
+            continue;
+        }
+
+        for (int64_t e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int v = graph->targets[e];
+            uint64_t candidate = dist[u] + csr_weight(graph, e);
+            if (candidate < dist[v]) {
+                dist[v] = candidate;
+                result->parent[v] = u;
+                if (!heap_push(&heap, candidate + heuristic(v, target, context), v)) {
+                    fprintf(stderr, "Memory allocation failed\n");
+                    free(heap.entries);
+                    return false;
+                }
+            }
+        }
+    }
+
+    free(heap.entries);
+    return true;
+}
+
+// Delta-stepping. Tentative distances live in buckets of width delta;
+// each bucket is settled by repeated rounds of light-edge (w <= delta)
+// relaxation, followed by one round of heavy-edge relaxation. Every round
+// is split across threads that lower dist[] with an atomic compare-and-swap
+// minimum; thread 0 merges the improved vertices back into buckets between
+// barriers.
+typedef enum {
+    PHASE_LIGHT,
+    PHASE_HEAVY,
+    PHASE_DONE
+} DeltaPhase;
+
+typedef struct {
+    const CSRGraph* graph;
+    uint64_t* dist;
+    uint64_t delta;
+    int threads;                 // threads actually running
+    pthread_barrier_t barrier;
+    pthread_mutex_t start_lock;  // held until the barrier is sized
+
+    DeltaPhase phase;
+    VertexBuffer frontier;
+    VertexBuffer settled;
+    VertexBuffer* outputs;
+
+    VertexBuffer* buckets;       // cyclic, indexed by bucket % bucket_count
+    int64_t bucket_count;
+    int64_t current;
+    uint32_t* round_mark;        // dedupes frontier entries within a round
+    uint32_t round;
+    int64_t* settled_mark;       // bucket in which a vertex joined settled
+    bool failed;
+} DeltaContext;
+
+typedef struct {
+    DeltaContext* ctx;
+    int id;
+} DeltaWorker;
+
+static void atomic_min_relax(DeltaContext* ctx, VertexBuffer* out, int v, uint64_t candidate) {
+    uint64_t seen = __atomic_load_n(&ctx->dist[v], __ATOMIC_RELAXED);
+    while (candidate < seen) {
+        if (__atomic_compare_exchange_n(&ctx->dist[v], &seen, candidate, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            if (!buffer_push(out, v)) {
+                __atomic_store_n(&ctx->failed, true, __ATOMIC_RELAXED);
+            }
+            return;
+        }
+    }
+}
+
+static void relax_slice(DeltaContext* ctx, int id) {
+    const CSRGraph* graph = ctx->graph;
+    VertexBuffer* out = &ctx->outputs[id];
+    int64_t count = ctx->frontier.count;
+    int64_t chunk = (count + ctx->threads - 1) / ctx->threads;
+    int64_t begin = chunk * id;
+    int64_t end = begin + chunk < count ? begin + chunk : count;
+    bool light = ctx->phase == PHASE_LIGHT;
+
+    for (int64_t i = begin; i < end; i++) {
+        int u = ctx->frontier.items[i];
+        uint64_t du = __atomic_load_n(&ctx->dist[u], __ATOMIC_RELAXED);
+
+        for (int64_t e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            uint64_t w = csr_weight(graph, e);
+            if ((w <= ctx->delta) == light) {
+                atomic_min_relax(ctx, out, graph->targets[e], du + w);
+            }
+        }
+    }
+}
+
+// Moves the live entries of the current bucket into the frontier; returns
+// false once the bucket is empty
+static bool take_current_bucket(DeltaContext* ctx) {
+    VertexBuffer* bucket = &ctx->buckets[ctx->current % ctx->bucket_count];
+    ctx->frontier.count = 0;
+    ctx->round++;
+
+    for (int64_t i = 0; i < bucket->count; i++) {
+        int v = bucket->items[i];
+        if ((int64_t)(ctx->dist[v] / ctx->delta) != ctx->current || ctx->round_mark[v] == ctx->round) {
+            continue;
+        }
+        ctx->round_mark[v] = ctx->round;
+        if (!buffer_push(&ctx->frontier, v)) {
+            ctx->failed = true;
+        }
+        if (ctx->settled_mark[v] != ctx->current) {
+            ctx->settled_mark[v] = ctx->current;
+            if (!buffer_push(&ctx->settled, v)) {
+                ctx->failed = true;
+            }
+        }
+    }
+    bucket->count = 0;
+    return ctx->frontier.count > 0;
+}
+
+static void merge_outputs(DeltaContext* ctx) {
+    for (int t = 0; t < ctx->threads; t++) {
+        VertexBuffer* out = &ctx->outputs[t];
+        for (int64_t i = 0; i < out->count; i++) {
+            int v = out->items[i];
+            int64_t b = (int64_t)(ctx->dist[v] / ctx->delta);
+            if (!buffer_push(&ctx->buckets[b % ctx->bucket_count], v)) {
+                ctx->failed = true;
+            }
+        }
+        out->count = 0;
+    }
+}
+
+// Runs on thread 0 between barriers: decides what the next round relaxes
+static void delta_schedule(DeltaContext* ctx) {
+    merge_outputs(ctx);
+    if (ctx->failed) {
+        ctx->phase = PHASE_DONE;
+        return;
+    }
+
+    if (ctx->phase == PHASE_LIGHT && take_current_bucket(ctx)) {
+        return;
+    }
+
+    if (ctx->phase == PHASE_LIGHT) {
+        // Bucket settled: relax heavy edges of everything it contained
+        VertexBuffer temp = ctx->frontier;
+        ctx->frontier = ctx->settled;
+        ctx->settled = temp;
+        ctx->settled.count = 0;
+        ctx->phase = PHASE_HEAVY;
+        return;
+    }
+
+    // Advance to the next non-empty bucket
+    for (int64_t step = 0; step < ctx->bucket_count; step++) {
+        ctx->current++;
+        if (take_current_bucket(ctx)) {
+            ctx->phase = PHASE_LIGHT;
+            return;
+        }
+    }
+    ctx->phase = PHASE_DONE;
+}
+
+static void* delta_worker(void* arg) {
+    DeltaWorker* worker = arg;
+    DeltaContext* ctx = worker->ctx;
+    if (worker->id != 0) {
+        pthread_mutex_lock(&ctx->start_lock);
+        pthread_mutex_unlock(&ctx->start_lock);
+    }
+
+    for (;;) {
+        pthread_barrier_wait(&ctx->barrier);
+        if (ctx->phase == PHASE_DONE) {
+            break;
+        }
+        relax_slice(ctx, worker->id);
+        pthread_barrier_wait(&ctx->barrier);
+        if (worker->id == 0) {
+            delta_schedule(ctx);
+        }
+    }
+    return NULL;
+}
+
+// Parents are assigned in BFS order over tight edges from the source, so
+// every parent was reached before its child. Scanning vertices in index
+// order instead can close a cycle through zero-weight edges of equal
+// distance, and a path walk from there never reaches the source.
+static bool fill_parents(const CSRGraph* graph, int source, ShortestPathResult* result) {
+    int* queue = malloc((size_t)graph->vertices * sizeof(int));
+    if (queue == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    int head = 0, tail = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int u = queue[head++];
+        for (int64_t e = graph->offsets[u]; e < graph->offsets[u + 1]; e++) {
+            int v = graph->targets[e];
+            if (v != source && result->parent[v] == SP_NO_PARENT &&
+                result->dist[u] + csr_weight(graph, e) == result->dist[v]) {
+                result->parent[v] = u;
+                queue[tail++] = v;
+            }
+        }
+    }
+    free(queue);
+    return true;
+}
+
+static void free_delta_context(DeltaContext* ctx) {
+    if (ctx->buckets) {
+        for (int64_t b = 0; b < ctx->bucket_count; b++) {
+            free(ctx->buckets[b].items);
+        }
+    }
+    if (ctx->outputs) {
+        for (int t = 0; t < ctx->threads; t++) {
+            free(ctx->outputs[t].items);
+        }
+    }
+    free(ctx->buckets);
+    free(ctx->outputs);
+    free(ctx->frontier.items);
+    free(ctx->settled.items);
+    free(ctx->round_mark);
+    free(ctx->settled_mark);
+}
+
+bool delta_stepping(const CSRGraph* graph, int source, uint32_t delta, int threads,
+                    ShortestPathResult* result) {
+    if (!check_query(graph, source, result)) {
+        return false;
+    }
+    reset_result(result);
+
+    uint64_t max_weight = 1;
+    uint64_t total_weight = 0;
+    for (int64_t e = 0; e < graph->edges; e++) {
+        uint64_t w = csr_weight(graph, e);
+        total_weight += w;
+        if (w > max_weight) {
+            max_weight = w;
+        }
+    }
+    if (delta == 0) {
+        // Mean edge weight keeps light rounds short without too many buckets
+        delta = graph->edges ? (uint32_t)(total_weight / (uint64_t)graph->edges) : 1;
+        if (delta == 0) {
+            delta = 1;
+        }
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+    // Buckets are cyclic over max_weight / delta + 2 slots; with a small
+    // delta and heavy edges, widen the buckets rather than allocate more
+    // of them than there are vertices
+    uint64_t bucket_limit = (uint64_t)graph->vertices + 2;
+    uint64_t width = delta;
+    if (max_weight / width + 2 > bucket_limit) {
+        width = max_weight / (bucket_limit - 2) + 1;
+    }
+
+    DeltaContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.graph = graph;
+    ctx.dist = result->dist;
+    ctx.delta = width;
+    ctx.threads = threads;
+    ctx.bucket_count = (int64_t)(max_weight / width) + 2;
+    ctx.buckets = calloc((size_t)ctx.bucket_count, sizeof(VertexBuffer));
+    ctx.outputs = calloc((size_t)threads, sizeof(VertexBuffer));
+    ctx.round_mark = calloc((size_t)graph->vertices, sizeof(uint32_t));
+    ctx.settled_mark = malloc((size_t)graph->vertices * sizeof(int64_t));
+
+    if (ctx.buckets == NULL || ctx.outputs == NULL || ctx.round_mark == NULL ||
+        ctx.settled_mark == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free_delta_context(&ctx);
+        return false;
+    }
+    for (int v = 0; v < graph->vertices; v++) {
+        ctx.settled_mark[v] = -1;
+    }
+
+    result->dist[source] = 0;
+    buffer_push(&ctx.buckets[0], source);
+    ctx.current = 0;
+    ctx.phase = PHASE_LIGHT;
+    take_current_bucket(&ctx);
+
+    pthread_t* handles = malloc((size_t)threads * sizeof(pthread_t));
+    DeltaWorker* workers = malloc((size_t)threads * sizeof(DeltaWorker));
+    if (handles == NULL || workers == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(handles);
+        free(workers);
+        free_delta_context(&ctx);
+        return false;
+    }
+
+    for (int t = 0; t < threads; t++) {
+        workers[t].ctx = &ctx;
+        workers[t].id = t;
+    }
+    // Workers wait on start_lock, so if a spawn fails the barrier can
+    // still be sized for the threads that did start
+    pthread_mutex_init(&ctx.start_lock, NULL);
+    pthread_mutex_lock(&ctx.start_lock);
+    int started = 1;
+    while (started < threads &&
+           pthread_create(&handles[started], NULL, delta_worker, &workers[started]) == 0) {
+        started++;
+    }
+    ctx.threads = started;
+    pthread_barrier_init(&ctx.barrier, NULL, (unsigned)started);
+    pthread_mutex_unlock(&ctx.start_lock);
+
+    delta_worker(&workers[0]);
+    for (int t = 1; t < started; t++) {
+        pthread_join(handles[t], NULL);
+    }
+
+    pthread_barrier_destroy(&ctx.barrier);
+    pthread_mutex_destroy(&ctx.start_lock);
+    free(handles);
+    free(workers);
+
+    bool ok = !ctx.failed;
+    free_delta_context(&ctx);
+    if (!ok) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    return fill_parents(graph, source, result);
+}
+
+int sp_path_to(const ShortestPathResult* result, int target, int* path, int capacity) {
+    if (target < 0 || target >= result->vertices || result->dist[target] == SP_INFINITY) {
+        return 0;
+    }
+
+    int length = 0;
+    for (int v = target; v != SP_NO_PARENT; v = result->parent[v]) {
+        if (length == capacity) {
+            return 0;
+        }
+        path[length++] = v;
+    }
+
+    // Collected target..source, reverse in place
+    for (int i = 0; i < length / 2; i++) {
+        int temp = path[i];
+        path[i] = path[length - 1 - i];
+        path[length - 1 - i] = temp;
+    }
+    return length;
+}
@@ -0,0 +1,47 @@
+#ifndef SHORTEST_PATH_H
+#define SHORTEST_PATH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "graph.h"
+
+#define SP_INFINITY UINT64_MAX
+#define SP_NO_PARENT (-1)
+
+// Per-query output: dist[v] is SP_INFINITY and parent[v] is SP_NO_PARENT
+// for every vertex that was not reached
+typedef struct {
+    int vertices;
+    uint64_t* dist;
+    int* parent;
+} ShortestPathResult;
+
+typedef enum {
+    SP_HEAP_BINARY,
+    SP_HEAP_PAIRING
+} HeapKind;
+
+// A* heuristic: must never overestimate the remaining distance to target
+typedef uint64_t (*HeuristicFn)(int vertex, int target, void* context);
+
+// Result lifetime (reuse one result across queries to avoid reallocation)
+ShortestPathResult* sp_result_create(int vertices);
+void sp_result_free(ShortestPathResult* result);
+
+// Single-source shortest paths over non-negative integer weights.
+// delta_stepping: delta 0 picks the mean edge weight, and delta is raised
+// when it would need more buckets than vertices + 2. If fewer threads can
+// be started than requested, it runs with those that did.
+bool dijkstra(const CSRGraph* graph, int source, HeapKind heap, ShortestPathResult* result);
+bool delta_stepping(const CSRGraph* graph, int source, uint32_t delta, int threads,
+                    ShortestPathResult* result);
+
+// Point-to-point search; stops as soon as target is settled
+bool astar(const CSRGraph* graph, int source, int target, HeuristicFn heuristic,
+           void* context, ShortestPathResult* result);
+
+// Writes the source..target path into path (capacity entries), returns its
+// length, or 0 if target is unreachable or the path does not fit
+int sp_path_to(const ShortestPathResult* result, int target, int* path, int capacity);
+
+#endif /* SHORTEST_PATH_H */
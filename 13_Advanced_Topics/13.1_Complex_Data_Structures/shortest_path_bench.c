@@ -0,0 +1,217 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "graph.h"
+#include "shortest_path.h"
+
+// Synthetic road network: a side x side grid with 4-neighbour streets,
+// a few percent of blocks closed, and travel times between MIN_WEIGHT and
+// MIN_WEIGHT + 89 so Manhattan distance * MIN_WEIGHT stays admissible
+#define MIN_WEIGHT 10
+
+typedef struct {
+    int side;
+} GridContext;
+
+static uint64_t rng_state = 0x9E3779B97F4A7C15ull;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static CSRGraph* build_road_graph(int side) {
+    int64_t max_edges = 2LL * side * side;
+    Edge* edges = malloc((size_t)max_edges * sizeof(Edge));
+    if (edges == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    int64_t count = 0;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            int v = y * side + x;
+            // Keep row 0 and column 0 intact so the grid stays connected
+            if (x + 1 < side && (y == 0 || next_random() % 100 >= 3)) {
+                edges[count++] = (Edge){v, v + 1, MIN_WEIGHT + next_random() % 90};
+            }
+            if (y + 1 < side && (x == 0 || next_random() % 100 >= 3)) {
+                edges[count++] = (Edge){v, v + side, MIN_WEIGHT + next_random() % 90};
+            }
+        }
+    }
+
+    CSRGraph* graph = csr_from_edges(side * side, edges, count, true);
+    free(edges);
+    return graph;
+}
+
+// Zero-weight edges give 1, 2 and 3 the same distance; every path must
+// still lead back to the source (0 -> 3 -> 2 -> 1)
+static bool check_zero_weight_parents(void) {
+    Edge edges[] = {{0, 3, 1}, {3, 2, 0}, {2, 1, 0}};
+    CSRGraph* graph = csr_from_edges(4, edges, 3, true);
+    ShortestPathResult* result = sp_result_create(4);
+    int path[4];
+    bool ok = graph != NULL && result != NULL && delta_stepping(graph, 0, 0, 1, result) &&
+              sp_path_to(result, 1, path, 4) == 4 && path[1] == 3 && path[2] == 2;
+    sp_result_free(result);
+    free_csr_graph(graph);
+    return ok;
+}
+
+// Four-billion weights with delta 1 would ask for one bucket per unit of
+// weight; delta-stepping must widen the buckets and still match dijkstra
+static bool check_heavy_weights(void) {
+    Edge edges[] = {{0, 1, 4000000000u}, {1, 2, 7}, {0, 2, 4000000009u}, {2, 3, 1}};
+    CSRGraph* graph = csr_from_edges(4, edges, 4, true);
+    ShortestPathResult* expected = sp_result_create(4);
+    ShortestPathResult* result = sp_result_create(4);
+    bool ok = graph != NULL && expected != NULL && result != NULL &&
+              dijkstra(graph, 0, SP_HEAP_BINARY, expected) && delta_stepping(graph, 0, 1, 2, result);
+    for (int v = 0; ok && v < 4; v++) {
+        ok = result->dist[v] == expected->dist[v];
+    }
+    sp_result_free(expected);
+    sp_result_free(result);
+    free_csr_graph(graph);
+    return ok;
+}
+
+static uint64_t manhattan(int vertex, int target, void* context) {
+    int side = ((GridContext*)context)->side;
+    int dx = vertex % side - target % side;
+    int dy = vertex / side - target / side;
+    return (uint64_t)((dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy)) * MIN_WEIGHT;
+}
+
+static uint64_t checksum(const ShortestPathResult* result) {
+    uint64_t sum = 0;
+    for (int v = 0; v < result->vertices; v++) {
+        if (result->dist[v] != SP_INFINITY) {
+            sum += result->dist[v];
+        }
+    }
+    return sum;
+}
+
+static void report(const char* name, int queries, double seconds, uint64_t check) {
+    printf("  %-28s %8.2f queries/s  (%.3f s, checksum %llu)\n",
+           name, queries / seconds, seconds, (unsigned long long)check);
+}
+
+int main(int argc, char* argv[]) {
+    int side = argc > 1 ? atoi(argv[1]) : 1000;
+    int queries = argc > 2 ? atoi(argv[2]) : 5;
+    int threads = argc > 3 ? atoi(argv[3]) : 4;
+    if (side < 2 || queries < 1) {
+        fprintf(stderr, "Usage: %s [side >= 2] [queries >= 1] [threads]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== Shortest Path Benchmark ===\n");
+    double start = now_seconds();
+    CSRGraph* graph = build_road_graph(side);
+    if (graph == NULL) {
+        return 1;
+    }
+    printf("Road grid: %d vertices, %lld directed edges (built in %.2f s)\n\n",
+           graph->vertices, (long long)graph->edges, now_seconds() - start);
+
+    ShortestPathResult* result = sp_result_create(graph->vertices);
+    int* sources = malloc((size_t)queries * sizeof(int));
+    int* targets = malloc((size_t)queries * sizeof(int));
+    if (result == NULL || sources == NULL || targets == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+    for (int q = 0; q < queries; q++) {
+        sources[q] = (int)(next_random() % (uint32_t)graph->vertices);
+        targets[q] = (int)(next_random() % (uint32_t)graph->vertices);
+    }
+
+    printf("Single-source (full graph):\n");
+    uint64_t reference = 0;
+
+    start = now_seconds();
+    for (int q = 0; q < queries; q++) {
+        dijkstra(graph, sources[q], SP_HEAP_BINARY, result);
+        reference += checksum(result);
+    }
+    report("dijkstra (binary heap)", queries, now_seconds() - start, reference);
+
+    uint64_t check = 0;
+    start = now_seconds();
+    for (int q = 0; q < queries; q++) {
+        dijkstra(graph, sources[q], SP_HEAP_PAIRING, result);
+        check += checksum(result);
+    }
+    report("dijkstra (pairing heap)", queries, now_seconds() - start, check);
+    if (check != reference) {
+        fprintf(stderr, "Mismatch: pairing heap disagrees with binary heap\n");
+        return 1;
+    }
+
+    for (int t = 1; t <= threads; t *= 2) {
+        char name[64];
+        snprintf(name, sizeof(name), "delta-stepping (%d thread%s)", t, t == 1 ? "" : "s");
+        check = 0;
+        start = now_seconds();
+        for (int q = 0; q < queries; q++) {
+            delta_stepping(graph, sources[q], 0, t, result);
+            check += checksum(result);
+        }
+        report(name, queries, now_seconds() - start, check);
+        if (check != reference) {
+            fprintf(stderr, "Mismatch: delta-stepping disagrees with dijkstra\n");
+            return 1;
+        }
+    }
+
+    if (!check_zero_weight_parents()) {
+        fprintf(stderr, "Mismatch: delta-stepping parents do not lead to the source\n");
+        return 1;
+    }
+    if (!check_heavy_weights()) {
+        fprintf(stderr, "Mismatch: delta-stepping fails on heavy weights with a small delta\n");
+        return 1;
+    }
+
+    printf("\nPoint-to-point:\n");
+    GridContext grid = {side};
+    uint64_t astar_total = 0;
+    uint64_t dijkstra_total = 0;
+
+    start = now_seconds();
+    for (int q = 0; q < queries; q++) {
+        astar(graph, sources[q], targets[q], manhattan, &grid, result);
+        astar_total += result->dist[targets[q]];
+    }
+    report("A* (manhattan heuristic)", queries, now_seconds() - start, astar_total);
+
+    for (int q = 0; q < queries; q++) {
+        dijkstra(graph, sources[q], SP_HEAP_BINARY, result);
+        dijkstra_total += result->dist[targets[q]];
+    }
+    if (astar_total != dijkstra_total) {
+        fprintf(stderr, "Mismatch: A* disagrees with dijkstra\n");
+        return 1;
+    }
+
+    free(sources);
+    free(targets);
+    sp_result_free(result);
+    free_csr_graph(graph);
+    return 0;
+}
@@ -4,6 +4,13 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
+#include "event_bus.h"
+#include "generic_array.h"
+#include "linked_list.h"
+#include "memory_pool.h"
+#include "thread_cache.h"
+#include "ref_count.h"
+#include "lockfree.h"
 
 // Function prototypes
 void demonstrate_multi_level_pointers(void);
@@ -15,34 +22,6 @@ void demonstrate_pointer_algorithms(void);
 void demonstrate_memory_management(void);
 void demonstrate_pointer_safety(void);
 
-// Structures for demonstrations
-typedef struct Node {
-    int data;
-    struct Node* next;
-} Node;
-
-typedef struct {
-    void* data;
-    size_t size;
-    size_t capacity;
-    size_t element_size;
-} GenericArray;
-
-typedef struct RefCountedData {
-    int ref_count;
-    void* data;
-    void (*destructor)(void*);
-} RefCountedData;
-
-#define POOL_SIZE 1024
-typedef struct {
-    char pool[POOL_SIZE];
-    size_t offset;
-} MemoryPool;
-
-// Callback function type
-typedef void (*EventCallback)(int event_type, void* data);
-
 // Mathematical operations for function pointers
 int add(int a, int b) { return a + b; }
 int subtract(int a, int b) { return a - b; }
@@ -87,171 +66,18 @@ void swap(void* a, void* b, size_t size) {
     free(temp);
 }
 
-// Generic array functions
-GenericArray* create_generic_array(size_t element_size) {
-    GenericArray* arr = malloc(sizeof(GenericArray));
-    if (arr == NULL) return NULL;
-    
-    arr->data = malloc(element_size * 2);
-    if (arr->data == NULL) {
-        free(arr);
-        return NULL;
-    }
-    
-    arr->size = 0;
-    arr->capacity = 2;
-    arr->element_size = element_size;
-    return arr;
-}
-
-void* get_element(GenericArray* arr, size_t index) {
-    if (index >= arr->size) return NULL;
-    return (char*)arr->data + (index * arr->element_size);
-}
-
-bool add_element(GenericArray* arr, void* element) {
-    if (arr->size >= arr->capacity) {
-        arr->capacity *= 2;
-        void* new_data = realloc(arr->data, arr->capacity * arr->element_size);
-        if (new_data == NULL) return false;
-        arr->data = new_data;
-    }
-    
-    void* dest = (char*)arr->data + (arr->size * arr->element_size);
-    memcpy(dest, element, arr->element_size);
-    arr->size++;
-    return true;
-}
-
-void free_generic_array(GenericArray* arr) {
-    if (arr) {
-        free(arr->data);
-        free(arr);
-    }
-}
-
-// Linked list functions
-Node* create_node(int data) {
-    Node* node = malloc(sizeof(Node));
-    if (node == NULL) return NULL;
-    node->data = data;
-    node->next = NULL;
-    return node;
-}
-
-Node* reverse_list(Node* head) {
-    Node* prev = NULL;
-    Node* current = head;
-    Node* next = NULL;
-    
-    while (current != NULL) {
-        next = current->next;
-        current->next = prev;
-        prev = current;
-        current = next;
-    }
-    
-    return prev;
+// Comparator for generic_array_sort / generic_array_binary_search
+int compare_ints(const void* a, const void* b) {
+    int x = *(const int*)a;
+    int y = *(const int*)b;
+    return (x > y) - (x < y);
 }
 
-bool has_cycle(Node* head) {
-    if (head == NULL) return false;
-    
-    Node* slow = head;
-    Node* fast = head;
-    
-    while (fast != NULL && fast->next != NULL) {
-        slow = slow->next;
-        fast = fast->next->next;
-        
-        if (slow == fast) {
-            return true;
-        }
-    }
-    
-    return false;
-}
-
-Node* find_middle(Node* head) {
-    if (head == NULL) return NULL;
-    
-    Node* slow = head;
-    Node* fast = head;
-    
-    while (fast->next != NULL && fast->next->next != NULL) {
-        slow = slow->next;
-        fast = fast->next->next;
-    }
-    
-    return slow;
-}
-
-void print_list(Node* head) {
-    Node* current = head;
-    while (current != NULL) {
-        printf("%d ", current->data);
-        current = current->next;
-    }
-    printf("\n");
-}
-
-void free_list(Node* head) {
-    while (head != NULL) {
-        Node* temp = head;
-        head = head->next;
-        free(temp);
-    }
-}
-
-// Memory pool functions
-void init_pool(MemoryPool* pool) {
-    pool->offset = 0;
-}
-
-void* pool_alloc(MemoryPool* pool, size_t size) {
-    if (pool->offset + size > POOL_SIZE) {
-        return NULL;
-    }
-    
-    void* ptr = pool->pool + pool->offset;
-    pool->offset += size;
-    return ptr;
-}
-
-void pool_reset(MemoryPool* pool) {
-    pool->offset = 0;
-}
-
-// Reference counting functions
+// Destructor for reference-counted demo data (see ref_count.h)
 void simple_destructor(void* data) {
     free(data);
 }
 
-RefCountedData* create_ref_data(void* data, void (*destructor)(void*)) {
-    RefCountedData* ref_data = malloc(sizeof(RefCountedData));
-    if (ref_data == NULL) return NULL;
-    
-    ref_data->ref_count = 1;
-    ref_data->data = data;
-    ref_data->destructor = destructor;
-    return ref_data;
-}
-
-void retain(RefCountedData* ref_data) {
-    if (ref_data) {
-        ref_data->ref_count++;
-    }
-}
-
-void release(RefCountedData* ref_data) {
-    if (ref_data && --ref_data->ref_count == 0) {
-        if (ref_data->destructor && ref_data->data) {
-            ref_data->destructor(ref_data->data);
-        }
-        free(ref_data);
-    }
-}
-
 // Safety functions
 int safe_access(int* ptr) {
     if (ptr == NULL) {
@@ -383,6 +209,21 @@ void demonstrate_function_pointers(void) {
     callbacks[0](1, "Button1");
     callbacks[1](2, "Element1");
     
+    // Event bus: handlers looked up by event type, events queued and
+    // delivered in batches (here drained on this thread)
+    printf("\nEvent bus:\n");
+    EventBus bus;
+    if (event_bus_init(&bus, 16, false)) {
+        event_bus_register(&bus, 1, button_click_handler, "button");
+        event_bus_register(&bus, 2, mouse_hover_handler, "hover");
+        
+        event_bus_dispatch(&bus, 1, "Button2");
+        event_bus_post(&bus, 2, "Element2");
+        event_bus_post(&bus, 1, "Button3");
+        printf("  Delivered %zu queued event(s)\n", event_bus_drain(&bus));
+        event_bus_destroy(&bus);
+    }
+    
     printf("\n");
 }
 
@@ -458,6 +299,31 @@ void demonstrate_void_pointers(void) {
     }
     printf("\n");
     
+    // Bulk append, then sort and search with a comparator
+    int more[] = {250, 50, 150, 350};
+    add_elements(int_array, more, 4);
+    generic_array_sort(int_array, compare_ints);
+    
+    printf("  After add_elements + sort: ");
+    GenericArrayIter it = generic_array_iter(int_array, 0, 1);
+    for (int* p; (p = generic_array_next(&it)) != NULL; ) {
+        printf("%d ", *p);
+    }
+    printf("\n");
+    
+    printf("  Every other element: ");
+    it = generic_array_iter(int_array, 0, 2);
+    for (int* p; (p = generic_array_next(&it)) != NULL; ) {
+        printf("%d ", *p);
+    }
+    printf("\n");
+    
+    int key = 250;
+    printf("  binary_search(250): index %zu\n",
+           generic_array_binary_search(int_array, &key, compare_ints));
+    printf("  Storage is %d-byte aligned: %s\n", GENERIC_ARRAY_ALIGNMENT,
+           ((uintptr_t)int_array->data % GENERIC_ARRAY_ALIGNMENT == 0) ? "yes" : "no");
+    
     free_generic_array(int_array);
     
     printf("\n");
@@ -533,11 +399,28 @@ void demonstrate_pointer_algorithms(void) {
     
     printf("After creating cycle, has cycle: %s\n", 
            has_cycle(head) ? "Yes" : "No");
+    printf("Brent's algorithm agrees: %s\n", has_cycle_brent(head) ? "Yes" : "No");
     
     // Break cycle to free memory safely
     tail->next = NULL;
+    
+    // Round trip through a contiguous array: reverse the values there
+    int values[5];
+    size_t count = list_to_array(head, values, 5);
+    reverse_array(values, count);
+    list_copy_from_array(head, values, count);
+    printf("Values reversed via array: ");
+    print_list(head);
     free_list(head);
     
+    // A list built from an array sits in one block, in list order
+    Node* compact = list_from_array(values, count);
+    printf("Contiguous list: ");
+    print_list(compact);
+    printf("Nodes adjacent in memory: %s\n",
+           compact && compact->next == compact + 1 ? "yes" : "no");
+    free_list_block(compact);
+    
     printf("\n");
 }
 
@@ -561,11 +444,59 @@ void demonstrate_memory_management(void) {
         
         printf("  Pool allocated values: %d, %d, '%s'\n", 
                *pool_int1, *pool_int2, pool_str);
-        printf("  Pool offset: %zu bytes\n", pool.offset);
+        printf("  Blocks are %d-byte aligned: %s\n", POOL_ALIGNMENT,
+               ((uintptr_t)pool_str % POOL_ALIGNMENT == 0) ? "yes" : "no");
+        printf("  20-byte request uses the %zu-byte size class\n", pool_size_class(20));
+    }
+    
+    // Individual free: the block goes on its size-class free list
+    pool_free(&pool, pool_int2, sizeof(int));
+    int* reused = (int*)pool_alloc(&pool, sizeof(int));
+    printf("  Freed and reallocated an int: %s block\n",
+           reused == pool_int2 ? "same" : "different");
+    
+    // Scope: everything allocated after the mark goes away on rewind
+    PoolMark mark = pool_mark(&pool);
+    for (int i = 0; i < 1000; i++) {
+        pool_alloc(&pool, 100);     // grows past the first chunk
     }
+    PoolStats stats = pool_get_stats(&pool);
+    printf("  Inside scope: %zu bytes in use, %zu chunk(s)\n",
+           stats.bytes_in_use, stats.chunk_count);
+    
+    pool_rewind(&pool, mark);
+    stats = pool_get_stats(&pool);
+    printf("  After rewind: %zu bytes in use, high-water %zu bytes, "
+           "fragmentation %.1f%%\n",
+           stats.bytes_in_use, stats.high_water_bytes, stats.fragmentation * 100.0);
     
     pool_reset(&pool);
-    printf("  Pool reset, offset: %zu bytes\n", pool.offset);
+    printf("  Pool reset, bytes in use: %zu\n", pool_get_stats(&pool).bytes_in_use);
+    pool_destroy(&pool);
+    
+    // Thread cache: per-thread magazines in front of a shared pool
+    printf("\nThread-cached pool:\n");
+    SharedPool shared;
+    if (shared_pool_init(&shared)) {
+        ThreadCache* cache = thread_cache_create(&shared);
+        if (cache) {
+            void* blocks[100];
+            for (int i = 0; i < 100; i++) {
+                blocks[i] = cache_alloc(cache, 48);
+            }
+            for (int i = 0; i < 100; i++) {
+                cache_free(cache, blocks[i], 48);
+            }
+            void* again = cache_alloc(cache, 48);
+            printf("  100 allocs + 100 frees: %zu shared-pool refill(s), %zu lock-free hit(s)\n",
+                   cache->stats.pool_refills, cache->stats.hits);
+            printf("  Next alloc reuses the last freed block: %s\n",
+                   again == blocks[99] ? "yes" : "no");
+            cache_free(cache, again, 48);
+            thread_cache_destroy(cache);
+        }
+        shared_pool_destroy(&shared);
+    }
     
     // Reference counting
     printf("\nReference counting:\n");
@@ -573,20 +504,43 @@ void demonstrate_memory_management(void) {
     *shared_data = 42;
     
     RefCountedData* ref1 = create_ref_data(shared_data, simple_destructor);
-    printf("  Created ref_data, ref_count: %d\n", ref1->ref_count);
+    printf("  Created ref_data, ref_count: %d\n", ref_count_get(ref1));
     
     retain(ref1);
-    printf("  After retain, ref_count: %d\n", ref1->ref_count);
+    printf("  After retain, ref_count: %d\n", ref_count_get(ref1));
     
     RefCountedData* ref2 = ref1;
     retain(ref2);
-    printf("  After second retain, ref_count: %d\n", ref1->ref_count);
+    printf("  After second retain, ref_count: %d\n", ref_count_get(ref1));
+    
+    weak_retain(ref1);
+    printf("  Weak reference taken, ref_count still: %d\n", ref_count_get(ref1));
     
     release(ref1);
-    printf("  After first release, ref_count: %d\n", ref2->ref_count);
+    printf("  After first release, ref_count: %d\n", ref_count_get(ref2));
+    
+    RefCountedData* locked = weak_lock(ref1);
+    printf("  weak_lock while alive: %s\n", locked ? "got a strong reference" : "NULL");
+    release(locked);
     
     release(ref2);
+    printf("  After second release, ref_count: %d\n", ref_count_get(ref1));
+    
+    release(ref1);
     printf("  After final release, data freed\n");
+    printf("  weak_lock after release: %s\n", weak_lock(ref1) ? "unexpected" : "NULL");
+    weak_release(ref1);
+    
+    // Deferred destruction: the last release only queues the block
+    ReleaseQueue queue;
+    release_queue_init(&queue);
+    int* deferred_data = malloc(sizeof(int));
+    RefCountedData* deferred = create_ref_data_deferred(deferred_data, simple_destructor, &queue);
+    release(deferred);
+    bool queued = !release_queue_empty(&queue);
+    size_t drained = release_queue_drain(&queue);
+    printf("  Deferred release queued: %s, drained %zu block(s)\n",
+           queued ? "yes" : "no", drained);
     
     printf("\n");
 }
@@ -613,6 +567,33 @@ void demonstrate_pointer_safety(void) {
     safe_free((void**)&dynamic_ptr);
     printf("  After safe_free: ptr = %p\n", (void*)dynamic_ptr);
     
+    // Deferred free: a popped node may still be read by another thread
+    printf("\nEpoch-based reclamation:\n");
+    EpochDomain domain;
+    epoch_domain_init(&domain);
+    EpochThread* thread = epoch_register(&domain);
+    LockFreeStack stack;
+    lf_stack_init(&stack);
+    int stack_values[3] = {1, 2, 3};
+    
+    if (thread) {
+        for (int i = 0; i < 3; i++) {
+            lf_stack_push(&stack, &stack_values[i]);
+        }
+        void* popped;
+        while (lf_stack_pop(&stack, thread, &popped)) {
+            printf("  Popped %d, node retired\n", *(int*)popped);
+        }
+        printf("  Retired %zu node(s), freed so far: %zu\n",
+               thread->stats.retired, thread->stats.freed);
+        epoch_collect(thread);
+        epoch_collect(thread);
+        printf("  After two epoch advances, freed: %zu\n", thread->stats.freed);
+        epoch_unregister(thread);
+    }
+    lf_stack_destroy(&stack);
+    epoch_domain_destroy(&domain);
+    
     // Pointer validation
     printf("\nPointer validation:\n");
     printf("  is_valid_pointer(NULL): %s\n", 
@@ -0,0 +1,159 @@
+#include "epoch.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void epoch_domain_init(EpochDomain* domain) {
+    domain->global_epoch = 0;
+    domain->threads = NULL;
+}
+
+static size_t free_list(RetireList* list) {
+    size_t count = list->count;
+    for (size_t i = 0; i < count; i++) {
+        RetiredNode* node = &list->nodes[i];
+        if (node->free_fn) {
+            node->free_fn(node->ptr);
+        } else {
+            free(node->ptr);
+        }
+    }
+    list->count = 0;
+    return count;
+}
+
+void epoch_domain_destroy(EpochDomain* domain) {
+    EpochThread* thread = domain->threads;
+    while (thread != NULL) {
+        EpochThread* next = thread->next;
+        for (int b = 0; b < EPOCH_BUCKETS; b++) {
+            free_list(&thread->lists[b]);
+            free(thread->lists[b].nodes);
+        }
+        free(thread);
+        thread = next;
+    }
+    domain->threads = NULL;
+}
+
+EpochThread* epoch_register(EpochDomain* domain) {
+    // Reuse a released slot first: its pending nodes stay with it
+    EpochThread* thread = __atomic_load_n(&domain->threads, __ATOMIC_ACQUIRE);
+    for (; thread != NULL; thread = thread->next) {
+        bool expected = false;
+        if (!__atomic_load_n(&thread->in_use, __ATOMIC_RELAXED) &&
+            __atomic_compare_exchange_n(&thread->in_use, &expected, true, false,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return thread;
+        }
+    }
+
+    thread = calloc(1, sizeof(EpochThread));
+    if (thread == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    thread->domain = domain;
+    thread->local_epoch = EPOCH_INACTIVE;
+    thread->in_use = true;
+
+    EpochThread* head = __atomic_load_n(&domain->threads, __ATOMIC_RELAXED);
+    do {
+        thread->next = head;
+    } while (!__atomic_compare_exchange_n(&domain->threads, &head, thread, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    return thread;
+}
+
+void epoch_unregister(EpochThread* thread) {
+    if (thread == NULL) {
+        return;
+    }
+    epoch_collect(thread);
+    __atomic_store_n(&thread->in_use, false, __ATOMIC_RELEASE);
+}
+
+void epoch_enter(EpochThread* thread) {
+    if (thread->nesting++ > 0) {
+        return;
+    }
+    uint64_t epoch = __atomic_load_n(&thread->domain->global_epoch, __ATOMIC_RELAXED);
+    __atomic_store_n(&thread->local_epoch, epoch, __ATOMIC_RELAXED);
+    // Publish the epoch before any shared pointer is read; pairs with the
+    // sequentially consistent scan in try_advance
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+void epoch_exit(EpochThread* thread) {
+    if (--thread->nesting > 0) {
+        return;
+    }
+    __atomic_store_n(&thread->local_epoch, EPOCH_INACTIVE, __ATOMIC_RELEASE);
+}
+
+// The epoch moves on only when no critical section is still in an older one
+static bool try_advance(EpochDomain* domain, uint64_t epoch) {
+    EpochThread* thread = __atomic_load_n(&domain->threads, __ATOMIC_ACQUIRE);
+    for (; thread != NULL; thread = thread->next) {
+        uint64_t local = __atomic_load_n(&thread->local_epoch, __ATOMIC_SEQ_CST);
+        if (local != EPOCH_INACTIVE && local != epoch) {
+            return false;
+        }
+    }
+    return __atomic_compare_exchange_n(&domain->global_epoch, &epoch, epoch + 1, false,
+                                       __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+}
+
+size_t epoch_collect(EpochThread* thread) {
+    EpochDomain* domain = thread->domain;
+    uint64_t epoch = __atomic_load_n(&domain->global_epoch, __ATOMIC_SEQ_CST);
+    if (try_advance(domain, epoch)) {
+        thread->stats.advances++;
+    }
+    epoch = __atomic_load_n(&domain->global_epoch, __ATOMIC_SEQ_CST);
+
+    size_t freed = 0;
+    for (int b = 0; b < EPOCH_BUCKETS; b++) {
+        RetireList* list = &thread->lists[b];
+        if (list->count > 0 && list->epoch + 2 <= epoch) {
+            freed += free_list(list);
+        }
+    }
+    thread->pending -= freed;
+    thread->stats.freed += freed;
+    return freed;
+}
+
+void epoch_retire(EpochThread* thread, void* ptr, EpochFreeFn free_fn) {
+    uint64_t epoch = __atomic_load_n(&thread->domain->global_epoch, __ATOMIC_SEQ_CST);
+    RetireList* list = &thread->lists[epoch % EPOCH_BUCKETS];
+
+    // A bucket still holding an older epoch is at least 3 epochs behind
+    if (list->count > 0 && list->epoch != epoch) {
+        size_t freed = free_list(list);
+        thread->pending -= freed;
+        thread->stats.freed += freed;
+    }
+    list->epoch = epoch;
+
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : EPOCH_BATCH;
+        RetiredNode* grown = realloc(list->nodes, capacity * sizeof(RetiredNode));
+        if (grown == NULL) {
+            // Freeing now could pull the node from under a reader
+            fprintf(stderr, "Memory allocation failed, retired node leaked\n");
+            return;
+        }
+        list->nodes = grown;
+        list->capacity = capacity;
+    }
+
+    list->nodes[list->count].ptr = ptr;
+    list->nodes[list->count].free_fn = free_fn;
+    list->count++;
+    thread->pending++;
+    thread->stats.retired++;
+
+    if (thread->stats.retired % EPOCH_BATCH == 0) {
+        epoch_collect(thread);
+    }
+}
@@ -0,0 +1,80 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Epoch-based reclamation (Fraser, 2004).
+//
+// Readers bracket every access to shared nodes with epoch_enter/exit.
+// A writer that unlinks a node calls epoch_retire instead of free. The
+// global epoch only advances once every thread inside a critical section
+// has seen the current one, so a node retired in epoch e can no longer be
+// referenced when the global epoch reaches e + 2 and is then freed.
+//
+// Readers pay two stores and a fence per critical section, never a write
+// to the shared nodes themselves.
+#define EPOCH_BUCKETS 3
+#define EPOCH_BATCH 64      // retired nodes before trying to advance
+
+typedef void (*EpochFreeFn)(void* ptr);
+
+typedef struct {
+    void* ptr;
+    EpochFreeFn free_fn;
+} RetiredNode;
+
+typedef struct {
+    RetiredNode* nodes;
+    size_t count;
+    size_t capacity;
+    uint64_t epoch;         // epoch the nodes were retired in
+} RetireList;
+
+typedef struct EpochThread EpochThread;
+
+typedef struct {
+    uint64_t global_epoch;
+    EpochThread* threads;   // registered participants, push-only list
+} EpochDomain;
+
+typedef struct {
+    size_t retired;
+    size_t freed;
+    size_t advances;        // successful global epoch advances
+} EpochStats;
+
+struct EpochThread {
+    EpochDomain* domain;
+    EpochThread* next;
+    uint64_t local_epoch;   // epoch seen on entry; EPOCH_INACTIVE outside
+    int nesting;
+    bool in_use;            // false once unregistered, slot is reusable
+    size_t pending;
+    RetireList lists[EPOCH_BUCKETS];
+    EpochStats stats;
+};
+
+#define EPOCH_INACTIVE UINT64_MAX
+
+void epoch_domain_init(EpochDomain* domain);
+// All threads must be unregistered; frees whatever is still retired
+void epoch_domain_destroy(EpochDomain* domain);
+
+// Per-thread handle, reusing a slot released by epoch_unregister
+EpochThread* epoch_register(EpochDomain* domain);
+void epoch_unregister(EpochThread* thread);
+
+// Critical sections nest
+void epoch_enter(EpochThread* thread);
+void epoch_exit(EpochThread* thread);
+
+// Frees ptr with free_fn (NULL means free) once no reader can hold it
+void epoch_retire(EpochThread* thread, void* ptr, EpochFreeFn free_fn);
+
+// Tries to advance the epoch and frees every list that has become safe;
+// called automatically every EPOCH_BATCH retires. Returns nodes freed.
+size_t epoch_collect(EpochThread* thread);
+
+#endif /* EPOCH_H */
@@ -0,0 +1,484 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "lockfree.h"
+
+// Read-mostly hash map: KEYS keys are always present; each operation is a
+// lookup, or with probability write_percent a replacement of the value.
+// The epoch map is compared with the same map protected by an atomic
+// reference count per node, the textbook alternative: a reader pins the
+// node (under the bucket lock, since the count itself lives in memory that
+// may be freed) and unpins it when done.
+//
+// Queue: every thread enqueues a value and dequeues one, over and over, so
+// both ends are contended. The Michael-Scott queue is compared with a
+// linked queue under one mutex; the values dequeued must add up to the
+// values enqueued.
+#define KEYS (1 << 16)
+#define MAX_THREADS 8
+
+typedef struct RcNode {
+    struct RcNode* next;
+    uint64_t key;
+    uint64_t value;
+    int refs;
+} RcNode;
+
+typedef struct {
+    size_t bucket_count;
+    RcNode** buckets;
+    char* locks;
+} RcMap;
+
+typedef struct {
+    LockFreeMap* map;
+    RcMap* rc_map;
+    EpochDomain* domain;
+    long operations;
+    int write_percent;
+    uint64_t seed;
+    pthread_barrier_t* barrier;
+    long misses;
+    uint64_t checksum;
+} Worker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (uint32_t)(*state >> 32);
+}
+
+static size_t rc_bucket(const RcMap* map, uint64_t key) {
+    return (key * 0x9E3779B97F4A7C15ull >> 32) & (map->bucket_count - 1);
+}
+
+static void rc_lock(char* lock) {
+    while (__atomic_test_and_set(lock, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+static void rc_release(RcNode* node) {
+    if (__atomic_sub_fetch(&node->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(node);
+    }
+}
+
+static bool rc_get(RcMap* map, uint64_t key, uint64_t* value) {
+    size_t index = rc_bucket(map, key);
+    rc_lock(&map->locks[index]);
+    RcNode* node = map->buckets[index];
+    while (node != NULL && node->key != key) {
+        node = node->next;
+    }
+    if (node != NULL) {
+        __atomic_fetch_add(&node->refs, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_clear(&map->locks[index], __ATOMIC_RELEASE);
+
+    if (node == NULL) {
+        return false;
+    }
+    *value = node->value;
+    rc_release(node);
+    return true;
+}
+
+static void rc_put(RcMap* map, uint64_t key, uint64_t value) {
+    RcNode* node = malloc(sizeof(RcNode));
+    if (node == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    node->key = key;
+    node->value = value;
+    node->refs = 1;     // held by the map
+
+    size_t index = rc_bucket(map, key);
+    rc_lock(&map->locks[index]);
+    RcNode** link = &map->buckets[index];
+    while (*link != NULL && (*link)->key != key) {
+        link = &(*link)->next;
+    }
+    RcNode* old = *link;
+    node->next = old ? old->next : NULL;
+    *link = node;
+    __atomic_clear(&map->locks[index], __ATOMIC_RELEASE);
+
+    if (old != NULL) {
+        rc_release(old);
+    }
+}
+
+typedef struct MutexQueueNode {
+    struct MutexQueueNode* next;
+    void* value;
+} MutexQueueNode;
+
+typedef struct {
+    pthread_mutex_t lock;
+    MutexQueueNode* head;
+    MutexQueueNode* tail;
+} MutexQueue;
+
+static void mutex_enqueue(MutexQueue* queue, void* value) {
+    MutexQueueNode* node = malloc(sizeof(MutexQueueNode));
+    if (node == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    node->next = NULL;
+    node->value = value;
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail != NULL) {
+        queue->tail->next = node;
+    } else {
+        queue->head = node;
+    }
+    queue->tail = node;
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static bool mutex_dequeue(MutexQueue* queue, void** value) {
+    pthread_mutex_lock(&queue->lock);
+    MutexQueueNode* node = queue->head;
+    if (node != NULL) {
+        queue->head = node->next;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+    }
+    pthread_mutex_unlock(&queue->lock);
+    if (node == NULL) {
+        return false;
+    }
+    *value = node->value;
+    free(node);
+    return true;
+}
+
+typedef struct {
+    LockFreeQueue* queue;
+    MutexQueue* mutex_queue;
+    EpochDomain* domain;
+    long operations;
+    uintptr_t first_value;
+    pthread_barrier_t* barrier;
+    uint64_t sum;           // of values dequeued
+    long empty;             // dequeues that found nothing
+} QueueWorker;
+
+static void* lf_queue_worker(void* arg) {
+    QueueWorker* worker = arg;
+    EpochThread* thread = epoch_register(worker->domain);
+    if (thread == NULL) {
+        exit(1);
+    }
+
+    pthread_barrier_wait(worker->barrier);
+    for (long i = 0; i < worker->operations; i++) {
+        void* value;
+        if (!lf_queue_enqueue(worker->queue, thread, (void*)(worker->first_value + (uintptr_t)i))) {
+            exit(1);
+        }
+        if (lf_queue_dequeue(worker->queue, thread, &value)) {
+            worker->sum += (uintptr_t)value;
+        } else {
+            worker->empty++;
+        }
+    }
+    pthread_barrier_wait(worker->barrier);
+    epoch_unregister(thread);
+    return NULL;
+}
+
+static void* mutex_queue_worker(void* arg) {
+    QueueWorker* worker = arg;
+
+    pthread_barrier_wait(worker->barrier);
+    for (long i = 0; i < worker->operations; i++) {
+        void* value;
+        mutex_enqueue(worker->mutex_queue, (void*)(worker->first_value + (uintptr_t)i));
+        if (mutex_dequeue(worker->mutex_queue, &value)) {
+            worker->sum += (uintptr_t)value;
+        } else {
+            worker->empty++;
+        }
+    }
+    pthread_barrier_wait(worker->barrier);
+    return NULL;
+}
+
+static void* epoch_worker(void* arg) {
+    Worker* worker = arg;
+    EpochThread* thread = epoch_register(worker->domain);
+    uint64_t state = worker->seed;
+    if (thread == NULL) {
+        exit(1);
+    }
+
+    pthread_barrier_wait(worker->barrier);
+    for (long i = 0; i < worker->operations; i++) {
+        uint64_t key = next_random(&state) % KEYS;
+        if ((int)(next_random(&state) % 100) < worker->write_percent) {
+            lf_map_put(worker->map, thread, key, key + (uint64_t)i);
+        } else {
+            uint64_t value;
+            if (lf_map_get(worker->map, thread, key, &value)) {
+                worker->checksum += value;
+            } else {
+                worker->misses++;
+            }
+        }
+    }
+    pthread_barrier_wait(worker->barrier);
+    epoch_unregister(thread);
+    return NULL;
+}
+
+static void* rc_worker(void* arg) {
+    Worker* worker = arg;
+    uint64_t state = worker->seed;
+
+    pthread_barrier_wait(worker->barrier);
+    for (long i = 0; i < worker->operations; i++) {
+        uint64_t key = next_random(&state) % KEYS;
+        if ((int)(next_random(&state) % 100) < worker->write_percent) {
+            rc_put(worker->rc_map, key, key + (uint64_t)i);
+        } else {
+            uint64_t value;
+            if (rc_get(worker->rc_map, key, &value)) {
+                worker->checksum += value;
+            } else {
+                worker->misses++;
+            }
+        }
+    }
+    pthread_barrier_wait(worker->barrier);
+    return NULL;
+}
+
+// Returns aggregate M ops/s; *misses counts lookups that lost a key
+static double run(bool use_epoch, int threads, long operations, int write_percent,
+                  long* misses) {
+    EpochDomain domain;
+    LockFreeMap map;
+    RcMap rc_map;
+    epoch_domain_init(&domain);
+
+    if (use_epoch) {
+        if (!lf_map_init(&map, KEYS)) {
+            exit(1);
+        }
+        EpochThread* loader = epoch_register(&domain);
+        for (uint64_t key = 0; key < KEYS; key++) {
+            lf_map_put(&map, loader, key, key);
+        }
+        epoch_unregister(loader);
+    } else {
+        rc_map.bucket_count = KEYS;
+        rc_map.buckets = calloc(KEYS, sizeof(RcNode*));
+        rc_map.locks = calloc(KEYS, sizeof(char));
+        if (rc_map.buckets == NULL || rc_map.locks == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+        for (uint64_t key = 0; key < KEYS; key++) {
+            rc_put(&rc_map, key, key);
+        }
+    }
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+    Worker workers[MAX_THREADS];
+    pthread_t ids[MAX_THREADS];
+    for (int t = 0; t < threads; t++) {
+        workers[t].map = &map;
+        workers[t].rc_map = &rc_map;
+        workers[t].domain = &domain;
+        workers[t].operations = operations;
+        workers[t].write_percent = write_percent;
+        workers[t].seed = 0x853C49E6748FEA9Bull + (uint64_t)t * 0x9E3779B97F4A7C15ull;
+        workers[t].barrier = &barrier;
+        workers[t].misses = 0;
+        workers[t].checksum = 0;
+        pthread_create(&ids[t], NULL, use_epoch ? epoch_worker : rc_worker, &workers[t]);
+    }
+
+    pthread_barrier_wait(&barrier);
+    double start = now_seconds();
+    pthread_barrier_wait(&barrier);
+    double seconds = now_seconds() - start;
+
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        *misses += workers[t].misses;
+    }
+    pthread_barrier_destroy(&barrier);
+
+    if (use_epoch) {
+        lf_map_destroy(&map);
+        epoch_domain_destroy(&domain);
+    } else {
+        for (size_t b = 0; b < rc_map.bucket_count; b++) {
+            RcNode* node = rc_map.buckets[b];
+            while (node != NULL) {
+                RcNode* next = node->next;
+                free(node);
+                node = next;
+            }
+        }
+        free(rc_map.buckets);
+        free(rc_map.locks);
+    }
+    return threads * operations / seconds / 1e6;
+}
+
+// Returns aggregate M enqueue/dequeue pairs per second; clears *ok if a
+// dequeue found the queue empty or the values do not add up
+static double run_queue(bool lock_free, int threads, long operations, bool* ok) {
+    EpochDomain domain;
+    LockFreeQueue queue;
+    MutexQueue mutex_queue = {PTHREAD_MUTEX_INITIALIZER, NULL, NULL};
+    epoch_domain_init(&domain);
+    if (lock_free && !lf_queue_init(&queue)) {
+        exit(1);
+    }
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+    QueueWorker workers[MAX_THREADS];
+    pthread_t ids[MAX_THREADS];
+    uint64_t expected = 0;
+    for (int t = 0; t < threads; t++) {
+        workers[t].queue = &queue;
+        workers[t].mutex_queue = &mutex_queue;
+        workers[t].domain = &domain;
+        workers[t].operations = operations;
+        workers[t].first_value = (uintptr_t)t * (uintptr_t)operations + 1;
+        workers[t].barrier = &barrier;
+        workers[t].sum = 0;
+        workers[t].empty = 0;
+        for (long i = 0; i < operations; i++) {
+            expected += workers[t].first_value + (uint64_t)i;
+        }
+        if (pthread_create(&ids[t], NULL, lock_free ? lf_queue_worker : mutex_queue_worker,
+                           &workers[t]) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(1);
+        }
+    }
+
+    pthread_barrier_wait(&barrier);
+    double start = now_seconds();
+    pthread_barrier_wait(&barrier);
+    double seconds = now_seconds() - start;
+
+    uint64_t sum = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        sum += workers[t].sum;
+        if (workers[t].empty != 0) {
+            *ok = false;
+        }
+    }
+    pthread_barrier_destroy(&barrier);
+
+    // Each thread dequeues right after its own enqueue, so nothing is left
+    void* value;
+    if (lock_free) {
+        EpochThread* drain = epoch_register(&domain);
+        while (drain != NULL && lf_queue_dequeue(&queue, drain, &value)) {
+            *ok = false;
+        }
+        epoch_unregister(drain);
+        lf_queue_destroy(&queue);
+        epoch_domain_destroy(&domain);
+    } else {
+        while (mutex_dequeue(&mutex_queue, &value)) {
+            *ok = false;
+        }
+        pthread_mutex_destroy(&mutex_queue.lock);
+    }
+    if (sum != expected) {
+        *ok = false;
+    }
+    return threads * operations / seconds / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    long operations = argc > 1 ? atol(argv[1]) : 5000000;
+    if (operations < 1) {
+        fprintf(stderr, "Usage: %s [operations per thread >= 1]\n", argv[0]);
+        return 1;
+    }
+    static const int thread_counts[] = {1, 2, 4, MAX_THREADS};
+    static const int write_percents[] = {1, 10};
+
+    printf("=== Epoch Reclamation Benchmark ===\n");
+    printf("%d keys, %ld operations per thread (aggregate M ops/s)\n\n", KEYS, operations);
+
+    long misses = 0;
+    for (int w = 0; w < 2; w++) {
+        printf("%d%% writes:\n", write_percents[w]);
+        printf("  %-26s", "threads");
+        for (int i = 0; i < 4; i++) {
+            printf("  %8d", thread_counts[i]);
+        }
+        printf("\n");
+
+        for (int variant = 0; variant < 2; variant++) {
+            bool use_epoch = variant == 1;
+            printf("  %-26s", use_epoch ? "epoch reclamation" : "atomic refcount per node");
+            for (int i = 0; i < 4; i++) {
+                printf("  %8.2f", run(use_epoch, thread_counts[i], operations,
+                                      write_percents[w], &misses));
+                fflush(stdout);
+            }
+            printf("\n");
+        }
+        printf("\n");
+    }
+
+    bool queue_ok = true;
+    long queue_operations = operations / 4 > 0 ? operations / 4 : 1;
+    printf("Queue, enqueue + dequeue pairs (aggregate M pairs/s):\n");
+    printf("  %-26s", "threads");
+    for (int i = 0; i < 4; i++) {
+        printf("  %8d", thread_counts[i]);
+    }
+    printf("\n");
+    for (int variant = 0; variant < 2; variant++) {
+        bool lock_free = variant == 1;
+        printf("  %-26s", lock_free ? "Michael-Scott queue" : "mutex queue");
+        for (int i = 0; i < 4; i++) {
+            printf("  %8.2f", run_queue(lock_free, thread_counts[i], queue_operations, &queue_ok));
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+    printf("\n");
+
+    if (misses != 0) {
+        printf("FAILED: %ld lookups missed a key that is always present\n", misses);
+        return 1;
+    }
+    if (!queue_ok) {
+        printf("FAILED: dequeued values do not match the values enqueued\n");
+        return 1;
+    }
+    printf("All lookups found their key; all queued values were dequeued once\n");
+    return 0;
+}
@@ -0,0 +1,351 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "event_bus.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Empty polls before a dispatcher goes to sleep
+#define DISPATCH_SPIN 256
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void record_latency(LatencyStats* stats, uint64_t ns) {
+    int bucket = ns ? 63 - __builtin_clzll(ns) : 0;
+    if (bucket >= EVENT_LATENCY_BUCKETS) {
+        bucket = EVENT_LATENCY_BUCKETS - 1;
+    }
+    __atomic_fetch_add(&stats->calls, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->total_ns, ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats->histogram[bucket], 1, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&stats->max_ns, __ATOMIC_RELAXED);
+    while (ns > max && !__atomic_compare_exchange_n(&stats->max_ns, &max, ns, true,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+uint64_t latency_percentile(const LatencyStats* stats, double percentile) {
+    uint64_t calls = __atomic_load_n(&stats->calls, __ATOMIC_RELAXED);
+    uint64_t target = (uint64_t)(calls * percentile);
+    uint64_t seen = 0;
+
+    for (int b = 0; b < EVENT_LATENCY_BUCKETS; b++) {
+        seen += __atomic_load_n(&stats->histogram[b], __ATOMIC_RELAXED);
+        if (seen > target || seen == calls) {
+            return (uint64_t)1 << (b + 1);      // bucket upper bound
+        }
+    }
+    return 0;
+}
+
+bool event_bus_init(EventBus* bus, size_t queue_capacity, bool instrument) {
+    memset(bus, 0, sizeof(*bus));
+    size_t capacity = 2;
+    while (capacity < queue_capacity) {
+        capacity *= 2;
+    }
+
+    bus->ring = malloc(capacity * sizeof(EventSlot));
+    if (bus->ring == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    for (size_t i = 0; i < capacity; i++) {
+        bus->ring[i].sequence = i;
+    }
+    bus->mask = capacity - 1;
+    bus->instrument = instrument;
+    pthread_mutex_init(&bus->lock, NULL);
+    pthread_cond_init(&bus->wakeup, NULL);
+    return true;
+}
+
+void event_bus_destroy(EventBus* bus) {
+    if (bus->running) {
+        event_bus_stop(bus);
+    }
+    free(bus->ring);
+    bus->ring = NULL;
+    pthread_mutex_destroy(&bus->lock);
+    pthread_cond_destroy(&bus->wakeup);
+}
+
+bool event_bus_register(EventBus* bus, int event_type, EventCallback callback,
+                        const char* name) {
+    if (event_type < 0 || event_type >= EVENT_BUS_MAX_TYPES || callback == NULL) {
+        fprintf(stderr, "Invalid event type %d\n", event_type);
+        return false;
+    }
+
+    pthread_mutex_lock(&bus->lock);
+    int count = bus->handler_count[event_type];
+    if (count == EVENT_BUS_MAX_HANDLERS) {
+        pthread_mutex_unlock(&bus->lock);
+        fprintf(stderr, "Too many handlers for event type %d\n", event_type);
+        return false;
+    }
+    HandlerEntry* entry = &bus->handlers[event_type][count];
+    memset(entry, 0, sizeof(*entry));
+    entry->callback = callback;
+    entry->name = name;
+    __atomic_store_n(&bus->handler_count[event_type], count + 1, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&bus->lock);
+    return true;
+}
+
+static void deliver(EventBus* bus, int event_type, void* data) {
+    int count = __atomic_load_n(&bus->handler_count[event_type], __ATOMIC_ACQUIRE);
+    HandlerEntry* entries = bus->handlers[event_type];
+
+    if (!bus->instrument) {
+        for (int h = 0; h < count; h++) {
+            entries[h].callback(event_type, data);
+        }
+        return;
+    }
+    uint64_t start = now_ns();
+    for (int h = 0; h < count; h++) {
+        entries[h].callback(event_type, data);
+        uint64_t end = now_ns();
+        record_latency(&entries[h].stats, end - start);
+        start = end;
+    }
+}
+
+void event_bus_dispatch(EventBus* bus, int event_type, void* data) {
+    if (event_type >= 0 && event_type < EVENT_BUS_MAX_TYPES) {
+        deliver(bus, event_type, data);
+        __atomic_fetch_add(&bus->delivered, 1, __ATOMIC_RELAXED);
+    }
+}
+
+// Claims up to count consecutive free slots with one CAS
+static size_t enqueue_batch(EventBus* bus, const Event* events, size_t count) {
+    uint64_t pos = __atomic_load_n(&bus->enqueue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        size_t free_slots = 0;
+        int64_t diff = 0;
+        while (free_slots < count) {
+            EventSlot* slot = &bus->ring[(pos + free_slots) & bus->mask];
+            uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            diff = (int64_t)(sequence - (pos + free_slots));
+            if (diff != 0) {
+                break;
+            }
+            free_slots++;
+        }
+
+        if (free_slots == 0) {
+            if (diff < 0) {
+                return 0;       // full: the slot still holds an undelivered event
+            }
+            pos = __atomic_load_n(&bus->enqueue_pos, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&bus->enqueue_pos, &pos, pos + free_slots, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            for (size_t i = 0; i < free_slots; i++) {
+                EventSlot* slot = &bus->ring[(pos + i) & bus->mask];
+                slot->event = events[i];
+                __atomic_store_n(&slot->sequence, pos + i + 1, __ATOMIC_RELEASE);
+            }
+            return free_slots;
+        }
+    }
+}
+
+static size_t dequeue_batch(EventBus* bus, Event* events, size_t max) {
+    uint64_t pos = __atomic_load_n(&bus->dequeue_pos, __ATOMIC_RELAXED);
+    for (;;) {
+        size_t ready = 0;
+        int64_t diff = 0;
+        while (ready < max) {
+            EventSlot* slot = &bus->ring[(pos + ready) & bus->mask];
+            uint64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+            diff = (int64_t)(sequence - (pos + ready + 1));
+            if (diff != 0) {
+                break;
+            }
+            ready++;
+        }
+
+        if (ready == 0) {
+            if (diff < 0) {
+                return 0;       // empty
+            }
+            pos = __atomic_load_n(&bus->dequeue_pos, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&bus->dequeue_pos, &pos, pos + ready, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            for (size_t i = 0; i < ready; i++) {
+                EventSlot* slot = &bus->ring[(pos + i) & bus->mask];
+                events[i] = slot->event;
+                __atomic_store_n(&slot->sequence, pos + i + bus->mask + 1, __ATOMIC_RELEASE);
+            }
+            return ready;
+        }
+    }
+}
+
+static void wake_dispatchers(EventBus* bus) {
+    // Pairs with the sleepers increment and queue recheck in dispatch_loop
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&bus->sleepers, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&bus->lock);
+        pthread_cond_broadcast(&bus->wakeup);
+        pthread_mutex_unlock(&bus->lock);
+    }
+}
+
+size_t event_bus_post_batch(EventBus* bus, const Event* events, size_t count) {
+    // Only the valid prefix is posted
+    for (size_t i = 0; i < count; i++) {
+        if (events[i].type < 0 || events[i].type >= EVENT_BUS_MAX_TYPES) {
+            fprintf(stderr, "Invalid event type %d\n", events[i].type);
+            count = i;
+            break;
+        }
+    }
+
+    Event stamped[EVENT_BUS_BATCH];
+    size_t posted = 0;
+    while (posted < count) {
+        size_t chunk = count - posted < EVENT_BUS_BATCH ? count - posted : EVENT_BUS_BATCH;
+        const Event* source = events + posted;
+        if (bus->instrument) {
+            uint64_t now = now_ns();
+            for (size_t i = 0; i < chunk; i++) {
+                stamped[i] = source[i];
+                stamped[i].posted_ns = now;
+            }
+            source = stamped;
+        }
+
+        size_t accepted = enqueue_batch(bus, source, chunk);
+        if (accepted == 0) {
+            __atomic_fetch_add(&bus->rejected, count - posted, __ATOMIC_RELAXED);
+            break;
+        }
+        posted += accepted;
+    }
+
+    if (posted > 0) {
+        wake_dispatchers(bus);
+    }
+    return posted;
+}
+
+bool event_bus_post(EventBus* bus, int event_type, void* data) {
+    Event event = {event_type, data, 0};
+    return event_bus_post_batch(bus, &event, 1) == 1;
+}
+
+static size_t drain_once(EventBus* bus) {
+    Event batch[EVENT_BUS_BATCH];
+    size_t count = dequeue_batch(bus, batch, EVENT_BUS_BATCH);
+    if (count == 0) {
+        return 0;
+    }
+
+    if (bus->instrument) {
+        uint64_t now = now_ns();
+        for (size_t i = 0; i < count; i++) {
+            record_latency(&bus->queue_latency, now - batch[i].posted_ns);
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        deliver(bus, batch[i].type, batch[i].data);
+    }
+    __atomic_fetch_add(&bus->delivered, count, __ATOMIC_RELAXED);
+    return count;
+}
+
+size_t event_bus_drain(EventBus* bus) {
+    size_t total = 0;
+    size_t count;
+    while ((count = drain_once(bus)) > 0) {
+        total += count;
+    }
+    return total;
+}
+
+static bool queue_has_events(EventBus* bus) {
+    uint64_t pos = __atomic_load_n(&bus->dequeue_pos, __ATOMIC_SEQ_CST);
+    EventSlot* slot = &bus->ring[pos & bus->mask];
+    return __atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST) == pos + 1;
+}
+
+static void* dispatch_loop(void* arg) {
+    EventBus* bus = arg;
+    int idle = 0;
+
+    for (;;) {
+        if (drain_once(bus) > 0) {
+            idle = 0;
+            continue;
+        }
+        if (!__atomic_load_n(&bus->running, __ATOMIC_ACQUIRE)) {
+            if (event_bus_drain(bus) == 0) {
+                break;
+            }
+            continue;
+        }
+        if (++idle < DISPATCH_SPIN) {
+            continue;
+        }
+
+        pthread_mutex_lock(&bus->lock);
+        __atomic_fetch_add(&bus->sleepers, 1, __ATOMIC_SEQ_CST);
+        if (!queue_has_events(bus) && __atomic_load_n(&bus->running, __ATOMIC_ACQUIRE)) {
+            pthread_cond_wait(&bus->wakeup, &bus->lock);
+        }
+        __atomic_fetch_sub(&bus->sleepers, 1, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&bus->lock);
+        idle = 0;
+    }
+    return NULL;
+}
+
+bool event_bus_start(EventBus* bus, int threads) {
+    if (bus->running || threads < 1) {
+        return false;
+    }
+    bus->threads = malloc((size_t)threads * sizeof(pthread_t));
+    if (bus->threads == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    __atomic_store_n(&bus->running, 1, __ATOMIC_RELEASE);
+    for (int t = 0; t < threads; t++) {
+        if (pthread_create(&bus->threads[t], NULL, dispatch_loop, bus) != 0) {
+            fprintf(stderr, "Failed to start dispatcher thread\n");
+            bus->thread_count = t;
+            event_bus_stop(bus);
+            return false;
+        }
+    }
+    bus->thread_count = threads;
+    return true;
+}
+
+void event_bus_stop(EventBus* bus) {
+    pthread_mutex_lock(&bus->lock);
+    __atomic_store_n(&bus->running, 0, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&bus->wakeup);
+    pthread_mutex_unlock(&bus->lock);
+
+    for (int t = 0; t < bus->thread_count; t++) {
+        pthread_join(bus->threads[t], NULL);
+    }
+    free(bus->threads);
+    bus->threads = NULL;
+    bus->thread_count = 0;
+}
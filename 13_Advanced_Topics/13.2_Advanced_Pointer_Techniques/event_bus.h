@@ -0,0 +1,98 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef void (*EventCallback)(int event_type, void* data);
+
+// Event bus: handlers are registered per event type in a flat table
+// indexed by type, events travel from any number of posting threads to a
+// pool of dispatcher threads through a bounded lock-free ring (Vyukov's
+// MPMC queue), and both sides move events in batches.
+//
+// Events of one type may be delivered out of order and concurrently when
+// the pool has more than one thread.
+#define EVENT_BUS_MAX_TYPES 64
+#define EVENT_BUS_MAX_HANDLERS 8    // per event type
+#define EVENT_BUS_BATCH 64          // events taken from the ring at once
+#define EVENT_LATENCY_BUCKETS 32    // log2 nanosecond histogram
+
+typedef struct {
+    int type;
+    void* data;
+    uint64_t posted_ns;             // set when instrumentation is on
+} Event;
+
+typedef struct {
+    uint64_t sequence;
+    Event event;
+} EventSlot;
+
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t histogram[EVENT_LATENCY_BUCKETS];  // bucket b: [2^b, 2^(b+1)) ns
+} LatencyStats;
+
+typedef struct {
+    EventCallback callback;
+    const char* name;
+    LatencyStats stats;
+} HandlerEntry;
+
+typedef struct {
+    // Dispatch table; handler_count is published after the entry is written
+    HandlerEntry handlers[EVENT_BUS_MAX_TYPES][EVENT_BUS_MAX_HANDLERS];
+    int handler_count[EVENT_BUS_MAX_TYPES];
+
+    EventSlot* ring;
+    size_t mask;                    // capacity - 1
+    char pad0[64];
+    uint64_t enqueue_pos;           // posters and dispatchers on separate lines
+    char pad1[64];
+    uint64_t dequeue_pos;
+    char pad2[64];
+
+    pthread_t* threads;
+    int thread_count;
+    int running;
+    int sleepers;                   // dispatchers waiting on wakeup
+    pthread_mutex_t lock;
+    pthread_cond_t wakeup;
+
+    bool instrument;
+    uint64_t delivered;
+    uint64_t rejected;              // posts refused because the ring was full
+    LatencyStats queue_latency;     // post to dispatch
+} EventBus;
+
+// queue_capacity is rounded up to a power of two
+bool event_bus_init(EventBus* bus, size_t queue_capacity, bool instrument);
+void event_bus_destroy(EventBus* bus);
+
+// Handlers may be added while the bus runs; names are used for reports
+bool event_bus_register(EventBus* bus, int event_type, EventCallback callback,
+                        const char* name);
+
+// Calls every handler for the event on the calling thread
+void event_bus_dispatch(EventBus* bus, int event_type, void* data);
+
+// Queue for the dispatcher pool. Returns false (or the number accepted)
+// when the ring is full; callers decide whether to retry or drop.
+bool event_bus_post(EventBus* bus, int event_type, void* data);
+size_t event_bus_post_batch(EventBus* bus, const Event* events, size_t count);
+
+// Dispatcher pool; stop delivers everything already queued, then joins
+bool event_bus_start(EventBus* bus, int threads);
+void event_bus_stop(EventBus* bus);
+
+// Delivers queued events on the calling thread (no pool needed)
+size_t event_bus_drain(EventBus* bus);
+
+uint64_t latency_percentile(const LatencyStats* stats, double percentile);
+
+#endif /* EVENT_BUS_H */
@@ -0,0 +1,214 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "event_bus.h"
+
+// Events of EVENT_TYPES types, two handlers per type, each handler just
+// accumulates the payload. Posters retry when the ring is full, so every
+// run must deliver exactly what was posted.
+#define EVENT_TYPES 16
+#define MAX_POSTERS 4
+#define QUEUE_CAPACITY 65536
+
+typedef struct {
+    EventBus* bus;
+    long events;
+    int index;
+    bool batched;
+    pthread_barrier_t* barrier;
+} Poster;
+
+static uint64_t handler_sum;
+static uint64_t handler_calls;
+
+static void count_handler(int event_type, void* data) {
+    (void)event_type;
+    __atomic_fetch_add(&handler_sum, (uint64_t)(uintptr_t)data, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&handler_calls, 1, __ATOMIC_RELAXED);
+}
+
+static void audit_handler(int event_type, void* data) {
+    (void)event_type;
+    (void)data;
+    __atomic_fetch_add(&handler_calls, 1, __ATOMIC_RELAXED);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void register_handlers(EventBus* bus) {
+    for (int type = 0; type < EVENT_TYPES; type++) {
+        event_bus_register(bus, type, count_handler, "count");
+        event_bus_register(bus, type, audit_handler, "audit");
+    }
+}
+
+static void* poster_thread(void* arg) {
+    Poster* poster = arg;
+    Event batch[EVENT_BUS_BATCH];
+
+    pthread_barrier_wait(poster->barrier);
+    long i = 0;
+    while (i < poster->events) {
+        if (!poster->batched) {
+            Event event = {(int)(i % EVENT_TYPES), (void*)(uintptr_t)(i & 0xFF), 0};
+            if (event_bus_post(poster->bus, event.type, event.data)) {
+                i++;
+            } else {
+                sched_yield();      // ring full: let the dispatchers run
+            }
+            continue;
+        }
+
+        size_t count = 0;
+        for (long j = i; j < poster->events && count < EVENT_BUS_BATCH; j++, count++) {
+            batch[count].type = (int)(j % EVENT_TYPES);
+            batch[count].data = (void*)(uintptr_t)(j & 0xFF);
+            batch[count].posted_ns = 0;
+        }
+        size_t posted = event_bus_post_batch(poster->bus, batch, count);
+        i += (long)posted;
+        if (posted < count) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static uint64_t expected_sum(long events) {
+    uint64_t sum = 0;
+    for (long i = 0; i < events; i++) {
+        sum += (uint64_t)(i & 0xFF);
+    }
+    return sum;
+}
+
+// Posts from `posters` threads into a pool of `dispatchers`; returns M events/s
+static double run_queued(int posters, int dispatchers, long events, bool batched,
+                         bool instrument, EventBus* keep) {
+    EventBus local;
+    EventBus* bus = keep ? keep : &local;
+    if (!event_bus_init(bus, QUEUE_CAPACITY, instrument)) {
+        exit(1);
+    }
+    register_handlers(bus);
+    handler_sum = 0;
+    handler_calls = 0;
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned)posters + 1);
+    Poster workers[MAX_POSTERS];
+    pthread_t ids[MAX_POSTERS];
+    long per_poster = events / posters;
+
+    event_bus_start(bus, dispatchers);
+    for (int p = 0; p < posters; p++) {
+        workers[p].bus = bus;
+        workers[p].events = per_poster;
+        workers[p].index = p;
+        workers[p].batched = batched;
+        workers[p].barrier = &barrier;
+        pthread_create(&ids[p], NULL, poster_thread, &workers[p]);
+    }
+
+    pthread_barrier_wait(&barrier);
+    double start = now_seconds();
+    for (int p = 0; p < posters; p++) {
+        pthread_join(ids[p], NULL);
+    }
+    event_bus_stop(bus);
+    double seconds = now_seconds() - start;
+    pthread_barrier_destroy(&barrier);
+
+    uint64_t total = (uint64_t)per_poster * (uint64_t)posters;
+    if (bus->delivered != total || handler_calls != 2 * total ||
+        handler_sum != expected_sum(per_poster) * (uint64_t)posters) {
+        printf("  Delivery mismatch: %llu of %llu events, %llu handler calls\n",
+               (unsigned long long)bus->delivered, (unsigned long long)total,
+               (unsigned long long)handler_calls);
+        exit(1);
+    }
+    if (keep == NULL) {
+        event_bus_destroy(bus);
+    }
+    return total / seconds / 1e6;
+}
+
+static void print_latency(const char* name, const LatencyStats* stats) {
+    printf("  %-22s p50 <= %6llu ns  p99 <= %7llu ns  max %8llu ns  mean %6.0f ns\n", name,
+           (unsigned long long)latency_percentile(stats, 0.50),
+           (unsigned long long)latency_percentile(stats, 0.99),
+           (unsigned long long)stats->max_ns,
+           stats->calls ? (double)stats->total_ns / stats->calls : 0.0);
+}
+
+int main(int argc, char* argv[]) {
+    long events = argc > 1 ? atol(argv[1]) : 10000000;
+    if (events < MAX_POSTERS) {
+        fprintf(stderr, "Usage: %s [events >= %d]\n", argv[0], MAX_POSTERS);
+        return 1;
+    }
+
+    printf("=== Event Bus Benchmark ===\n");
+    printf("%ld events over %d types, 2 handlers each\n\n", events, EVENT_TYPES);
+
+    EventBus bus;
+    event_bus_init(&bus, QUEUE_CAPACITY, false);
+    register_handlers(&bus);
+    EventCallback direct[2] = {count_handler, audit_handler};
+    handler_sum = 0;
+
+    printf("Synchronous:\n");
+    double start = now_seconds();
+    for (long i = 0; i < events; i++) {
+        direct[0]((int)(i % EVENT_TYPES), (void*)(uintptr_t)(i & 0xFF));
+        direct[1]((int)(i % EVENT_TYPES), (void*)(uintptr_t)(i & 0xFF));
+    }
+    printf("  %-34s %8.2f M events/s\n", "direct callback calls", events / (now_seconds() - start) / 1e6);
+
+    start = now_seconds();
+    for (long i = 0; i < events; i++) {
+        event_bus_dispatch(&bus, (int)(i % EVENT_TYPES), (void*)(uintptr_t)(i & 0xFF));
+    }
+    printf("  %-34s %8.2f M events/s\n", "event_bus_dispatch (table)", events / (now_seconds() - start) / 1e6);
+    event_bus_destroy(&bus);
+
+    printf("\nQueued (posters x dispatchers):\n");
+    static const int configs[][2] = {{1, 1}, {2, 1}, {4, 1}, {1, 2}, {4, 2}, {4, 4}};
+    for (size_t c = 0; c < sizeof(configs) / sizeof(configs[0]); c++) {
+        int posters = configs[c][0];
+        int dispatchers = configs[c][1];
+        double single = run_queued(posters, dispatchers, events, false, false, NULL);
+        double batched = run_queued(posters, dispatchers, events, true, false, NULL);
+        printf("  %d x %d   post %8.2f M events/s   post_batch %8.2f M events/s\n",
+               posters, dispatchers, single, batched);
+    }
+
+    printf("\nInstrumented (4 x 2, batched):\n");
+    double rate = run_queued(4, 2, events, true, true, &bus);
+    printf("  %-22s %8.2f M events/s\n", "throughput", rate);
+    print_latency("queue (post->dispatch)", &bus.queue_latency);
+    for (int h = 0; h < 2; h++) {
+        LatencyStats merged = {0, 0, 0, {0}};
+        for (int type = 0; type < EVENT_TYPES; type++) {
+            const LatencyStats* stats = &bus.handlers[type][h].stats;
+            merged.calls += stats->calls;
+            merged.total_ns += stats->total_ns;
+            merged.max_ns = stats->max_ns > merged.max_ns ? stats->max_ns : merged.max_ns;
+            for (int b = 0; b < EVENT_LATENCY_BUCKETS; b++) {
+                merged.histogram[b] += stats->histogram[b];
+            }
+        }
+        print_latency(bus.handlers[0][h].name, &merged);
+    }
+    event_bus_destroy(&bus);
+    return 0;
+}
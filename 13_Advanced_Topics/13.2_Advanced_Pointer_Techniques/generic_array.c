@@ -0,0 +1,238 @@
+#include "generic_array.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Below this many elements sorting falls back to insertion sort
+#define INSERTION_SORT_THRESHOLD 16
+
+GenericArray* create_generic_array(size_t element_size) {
+    if (element_size == 0) {
+        return NULL;
+    }
+    GenericArray* arr = malloc(sizeof(GenericArray));
+    if (arr == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    arr->data = NULL;
+    arr->allocation = NULL;
+    arr->size = 0;
+    arr->capacity = 0;
+    arr->element_size = element_size;
+    return arr;
+}
+
+void free_generic_array(GenericArray* arr) {
+    if (arr) {
+        free(arr->allocation);
+        free(arr);
+    }
+}
+
+bool generic_array_reserve(GenericArray* arr, size_t capacity) {
+    if (capacity <= arr->capacity) {
+        return true;
+    }
+    if (capacity > SIZE_MAX / arr->element_size) {
+        return false;
+    }
+
+    // realloc keeps growth in place (or remaps pages) for large arrays but
+    // only guarantees malloc alignment: over-allocate and shift the data
+    // back onto a boundary when the block moved to a different offset
+    size_t bytes = capacity * arr->element_size;
+    size_t used = arr->size * arr->element_size;
+    size_t old_offset = arr->data ? (size_t)((char*)arr->data - (char*)arr->allocation) : 0;
+    char* allocation = realloc(arr->allocation, bytes + GENERIC_ARRAY_ALIGNMENT);
+    if (allocation == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    uintptr_t address = (uintptr_t)allocation;
+    size_t offset = (GENERIC_ARRAY_ALIGNMENT - (address & (GENERIC_ARRAY_ALIGNMENT - 1))) &
+                    (GENERIC_ARRAY_ALIGNMENT - 1);
+    if (offset != old_offset && used > 0) {
+        memmove(allocation + offset, allocation + old_offset, used);
+    }
+    arr->allocation = allocation;
+    arr->data = allocation + offset;
+    arr->capacity = capacity;
+    return true;
+}
+
+static bool grow_for(GenericArray* arr, size_t extra) {
+    size_t needed = arr->size + extra;
+    if (needed <= arr->capacity) {
+        return true;
+    }
+    size_t capacity = arr->capacity ? arr->capacity * 2 : GENERIC_ARRAY_MIN_BYTES / arr->element_size;
+    if (capacity < needed) {
+        capacity = needed;
+    }
+    return generic_array_reserve(arr, capacity);
+}
+
+bool add_element(GenericArray* arr, const void* element) {
+    if (arr->size == arr->capacity && !grow_for(arr, 1)) {
+        return false;
+    }
+
+    // Constant-size copies compile to a single load and store
+    char* dest = (char*)arr->data + arr->size * arr->element_size;
+    switch (arr->element_size) {
+    case 4:
+        memcpy(dest, element, 4);
+        break;
+    case 8:
+        memcpy(dest, element, 8);
+        break;
+    default:
+        memcpy(dest, element, arr->element_size);
+        break;
+    }
+    arr->size++;
+    return true;
+}
+
+bool add_elements(GenericArray* arr, const void* elements, size_t count) {
+    if (count == 0) {
+        return true;
+    }
+    if (count > SIZE_MAX - arr->size || !grow_for(arr, count)) {
+        return false;
+    }
+    memcpy((char*)arr->data + arr->size * arr->element_size, elements,
+           count * arr->element_size);
+    arr->size += count;
+    return true;
+}
+
+void* get_element(const GenericArray* arr, size_t index) {
+    if (index >= arr->size) return NULL;
+    return generic_array_at(arr, index);
+}
+
+// Quicksort over word-sized elements: elements move as fixed-size memcpy
+// (a single load and store) rather than memcpy of an unknown size, and
+// only the comparisons go through the caller's function. The pivot stays
+// in the array, parked at last - 1, so the comparator is only ever handed
+// the caller's own elements, never a copy read through another type.
+#define WORD_SWAP(type, a, b)                                                     \
+    do {                                                                          \
+        type swap_temp;                                                           \
+        memcpy(&swap_temp, (a), sizeof(type));                                    \
+        memcpy((a), (b), sizeof(type));                                           \
+        memcpy((b), &swap_temp, sizeof(type));                                    \
+    } while (0)
+
+#define DEFINE_WORD_SORT(name, type)                                              \
+    static void name(type* items, size_t count, ElementCompare compare) {         \
+        while (count > INSERTION_SORT_THRESHOLD) {                                \
+            size_t mid = count / 2;                                               \
+            size_t last = count - 1;                                              \
+            /* Median of three: items[0] <= items[mid] <= items[last] */          \
+            if (compare(&items[mid], &items[0]) < 0) {                            \
+                WORD_SWAP(type, &items[mid], &items[0]);                          \
+            }                                                                     \
+            if (compare(&items[last], &items[mid]) < 0) {                         \
+                WORD_SWAP(type, &items[last], &items[mid]);                       \
+                if (compare(&items[mid], &items[0]) < 0) {                        \
+                    WORD_SWAP(type, &items[mid], &items[0]);                      \
+                }                                                                 \
+            }                                                                     \
+            /* items[0] and the pivot stop both scans without bounds checks */   \
+            size_t pivot = last - 1;                                              \
+            WORD_SWAP(type, &items[mid], &items[pivot]);                          \
+            size_t i = 0;                                                         \
+            size_t j = pivot;                                                     \
+            for (;;) {                                                            \
+                while (compare(&items[++i], &items[pivot]) < 0) {}                \
+                while (compare(&items[pivot], &items[--j]) < 0) {}                \
+                if (i >= j) break;                                                \
+                WORD_SWAP(type, &items[i], &items[j]);                            \
+            }                                                                     \
+            WORD_SWAP(type, &items[i], &items[pivot]);                            \
+            /* items[i] is final: recurse into the smaller side */               \
+            size_t right = count - i - 1;                                         \
+            if (i < right) {                                                      \
+                name(items, i, compare);                                          \
+                items += i + 1;                                                   \
+                count = right;                                                    \
+            } else {                                                              \
+                name(items + i + 1, right, compare);                              \
+                count = i;                                                        \
+            }                                                                     \
+        }                                                                         \
+        for (size_t i = 1; i < count; i++) {                                      \
+            size_t k = i;                                                         \
+            while (k > 0 && compare(&items[k], &items[k - 1]) < 0) {              \
+                WORD_SWAP(type, &items[k], &items[k - 1]);                        \
+                k--;                                                              \
+            }                                                                     \
+        }                                                                         \
+    }
+
+DEFINE_WORD_SORT(sort_words32, uint32_t)
+DEFINE_WORD_SORT(sort_words64, uint64_t)
+
+void generic_array_sort(GenericArray* arr, ElementCompare compare) {
+    if (arr->size < 2) {
+        return;
+    }
+    switch (arr->element_size) {
+    case 4:
+        sort_words32(arr->data, arr->size, compare);
+        break;
+    case 8:
+        sort_words64(arr->data, arr->size, compare);
+        break;
+    default:
+        qsort(arr->data, arr->size, arr->element_size, compare);
+        break;
+    }
+}
+
+size_t generic_array_binary_search(const GenericArray* arr, const void* key,
+                                   ElementCompare compare) {
+    // Lower bound with a fixed number of halvings; the element address is
+    // base + index * size, which for sizes 4 and 8 becomes a shift
+    const char* base = arr->data;
+    size_t size = arr->element_size;
+    size_t low = 0;
+    size_t count = arr->size;
+
+    if (size == 4 || size == 8) {
+        unsigned shift = size == 4 ? 2 : 3;
+        while (count > 0) {
+            size_t half = count / 2;
+            if (compare(base + ((low + half) << shift), key) < 0) {
+                low += half + 1;
+                count -= half + 1;
+            } else {
+                count = half;
+            }
+        }
+        if (low < arr->size && compare(base + (low << shift), key) == 0) {
+            return low;
+        }
+        return GENERIC_ARRAY_NOT_FOUND;
+    }
+
+    while (count > 0) {
+        size_t half = count / 2;
+        if (compare(base + (low + half) * size, key) < 0) {
+            low += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    if (low < arr->size && compare(base + low * size, key) == 0) {
+        return low;
+    }
+    return GENERIC_ARRAY_NOT_FOUND;
+}
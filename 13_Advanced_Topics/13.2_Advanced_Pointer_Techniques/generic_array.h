@@ -0,0 +1,80 @@
+#ifndef GENERIC_ARRAY_H
+#define GENERIC_ARRAY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Type-erased dynamic array. Storage is GENERIC_ARRAY_ALIGNMENT-aligned so
+// element 0 starts on a cache line and vector loads over the data never
+// straddle one needlessly. Element sizes 4 and 8 take word-sized fast
+// paths for append, sort and search.
+#define GENERIC_ARRAY_ALIGNMENT 64
+#define GENERIC_ARRAY_MIN_BYTES 256     // first allocation
+#define GENERIC_ARRAY_NOT_FOUND ((size_t)-1)
+
+typedef struct {
+    void* data;             // aligned, inside allocation
+    size_t size;
+    size_t capacity;
+    size_t element_size;
+    void* allocation;       // what malloc/realloc returned
+} GenericArray;
+
+// Same contract as qsort/bsearch comparators
+typedef int (*ElementCompare)(const void* a, const void* b);
+
+GenericArray* create_generic_array(size_t element_size);
+void free_generic_array(GenericArray* arr);
+
+// Grows capacity to at least the given number of elements
+bool generic_array_reserve(GenericArray* arr, size_t capacity);
+
+bool add_element(GenericArray* arr, const void* element);
+bool add_elements(GenericArray* arr, const void* elements, size_t count);
+
+// Bounds-checked; NULL past the end
+void* get_element(const GenericArray* arr, size_t index);
+
+// Unchecked access for loops that already know the bounds
+static inline void* generic_array_at(const GenericArray* arr, size_t index) {
+    return (char*)arr->data + index * arr->element_size;
+}
+
+// Walks every step-th element from start without recomputing offsets:
+//
+//   GenericArrayIter it = generic_array_iter(arr, 0, 2);
+//   for (int* p; (p = generic_array_next(&it)) != NULL; ) ...
+typedef struct {
+    char* base;
+    size_t offset;          // byte offset of the next element
+    size_t end;             // byte offset one past the last element
+    size_t stride;          // bytes between visited elements
+} GenericArrayIter;
+
+static inline GenericArrayIter generic_array_iter(const GenericArray* arr, size_t start,
+                                                  size_t step) {
+    GenericArrayIter iter;
+    iter.base = arr->data;
+    iter.offset = start * arr->element_size;
+    iter.end = arr->size * arr->element_size;
+    iter.stride = (step ? step : 1) * arr->element_size;
+    return iter;
+}
+
+static inline void* generic_array_next(GenericArrayIter* iter) {
+    if (iter->offset >= iter->end) {
+        return NULL;
+    }
+    void* element = iter->base + iter->offset;
+    iter->offset += iter->stride;
+    return element;
+}
+
+void generic_array_sort(GenericArray* arr, ElementCompare compare);
+
+// Array must be sorted by compare. Returns the index of a matching element
+// or GENERIC_ARRAY_NOT_FOUND.
+size_t generic_array_binary_search(const GenericArray* arr, const void* key,
+                                   ElementCompare compare);
+
+#endif /* GENERIC_ARRAY_H */
@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "generic_array.h"
+
+// Compares GenericArray with the implementation it replaced (capacity 2,
+// unaligned realloc, memcpy per element, qsort/bsearch over raw data),
+// for 4-, 8- and 24-byte elements (the 8-byte sort also over doubles)
+typedef struct {
+    uint64_t key;
+    double weight;
+    uint32_t tag;
+} Record;
+
+typedef struct {
+    void* data;
+    size_t size;
+    size_t capacity;
+    size_t element_size;
+} LegacyArray;
+
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static LegacyArray* legacy_create(size_t element_size) {
+    LegacyArray* arr = malloc(sizeof(LegacyArray));
+    arr->data = malloc(element_size * 2);
+    arr->size = 0;
+    arr->capacity = 2;
+    arr->element_size = element_size;
+    return arr;
+}
+
+static void* legacy_get(LegacyArray* arr, size_t index) {
+    if (index >= arr->size) return NULL;
+    return (char*)arr->data + (index * arr->element_size);
+}
+
+static int legacy_add(LegacyArray* arr, void* element) {
+    if (arr->size >= arr->capacity) {
+        arr->capacity *= 2;
+        void* new_data = realloc(arr->data, arr->capacity * arr->element_size);
+        if (new_data == NULL) return 0;
+        arr->data = new_data;
+    }
+    memcpy((char*)arr->data + (arr->size * arr->element_size), element, arr->element_size);
+    arr->size++;
+    return 1;
+}
+
+static void legacy_free(LegacyArray* arr) {
+    free(arr->data);
+    free(arr);
+}
+
+static int compare_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static int compare_record(const void* a, const void* b) {
+    return compare_u64(&((const Record*)a)->key, &((const Record*)b)->key);
+}
+
+static void report(const char* name, double legacy, double current) {
+    printf("  %-22s %8.3f s  %8.3f s  %6.2fx\n", name, legacy, current, legacy / current);
+}
+
+// Runs every workload for one element type; source holds count elements
+static int run(const char* title, const void* source, size_t count, size_t element_size,
+               ElementCompare compare, size_t searches) {
+    const char* bytes = source;
+    double start;
+    double legacy_time;
+    uint64_t legacy_check = 0;
+    uint64_t check = 0;
+
+    printf("%s (%zu elements of %zu bytes):\n", title, count, element_size);
+    printf("  %-22s %10s  %10s  %7s\n", "", "legacy", "current", "speedup");
+
+    // Append one at a time
+    start = now_seconds();
+    LegacyArray* legacy = legacy_create(element_size);
+    for (size_t i = 0; i < count; i++) {
+        legacy_add(legacy, (void*)(bytes + i * element_size));
+    }
+    legacy_time = now_seconds() - start;
+
+    start = now_seconds();
+    GenericArray* arr = create_generic_array(element_size);
+    for (size_t i = 0; i < count; i++) {
+        add_element(arr, bytes + i * element_size);
+    }
+    report("add_element", legacy_time, now_seconds() - start);
+    free_generic_array(arr);
+
+    // Bulk append (the legacy array can only loop)
+    start = now_seconds();
+    arr = create_generic_array(element_size);
+    add_elements(arr, source, count);
+    report("add_elements (bulk)", legacy_time, now_seconds() - start);
+
+    // Full scan: checked get_element vs iterator, summing the first word
+    start = now_seconds();
+    for (size_t i = 0; i < legacy->size; i++) {
+        legacy_check += *(const uint32_t*)legacy_get(legacy, i);
+    }
+    legacy_time = now_seconds() - start;
+
+    start = now_seconds();
+    GenericArrayIter it = generic_array_iter(arr, 0, 1);
+    for (const void* p; (p = generic_array_next(&it)) != NULL; ) {
+        check += *(const uint32_t*)p;
+    }
+    report("scan (iterator)", legacy_time, now_seconds() - start);
+
+    // Sort
+    start = now_seconds();
+    qsort(legacy->data, legacy->size, element_size, compare);
+    legacy_time = now_seconds() - start;
+
+    start = now_seconds();
+    generic_array_sort(arr, compare);
+    report("sort", legacy_time, now_seconds() - start);
+
+    if (memcmp(legacy->data, arr->data, count * element_size) != 0) {
+        printf("  Sorted arrays differ!\n");
+        return 1;
+    }
+    for (size_t i = 1; i < count; i++) {
+        if (compare(generic_array_at(arr, i - 1), generic_array_at(arr, i)) > 0) {
+            printf("  Array not sorted at %zu!\n", i);
+            return 1;
+        }
+    }
+
+    // Binary search for existing keys
+    size_t legacy_found = 0;
+    size_t found = 0;
+    start = now_seconds();
+    for (size_t s = 0; s < searches; s++) {
+        const void* key = bytes + (s * 7919 % count) * element_size;
+        legacy_found += bsearch(key, legacy->data, legacy->size, element_size, compare) != NULL;
+    }
+    legacy_time = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t s = 0; s < searches; s++) {
+        const void* key = bytes + (s * 7919 % count) * element_size;
+        found += generic_array_binary_search(arr, key, compare) != GENERIC_ARRAY_NOT_FOUND;
+    }
+    report("binary_search", legacy_time, now_seconds() - start);
+
+    int failed = legacy_check != check || found != searches || legacy_found != searches;
+    printf("  checks: scan %s, %zu/%zu keys found\n\n",
+           legacy_check == check ? "ok" : "MISMATCH", found, searches);
+    legacy_free(legacy);
+    free_generic_array(arr);
+    return failed;
+}
+
+int main(int argc, char* argv[]) {
+    long count = argc > 1 ? atol(argv[1]) : 10000000;
+    if (count < 1) {
+        fprintf(stderr, "Usage: %s [elements >= 1]\n", argv[0]);
+        return 1;
+    }
+    size_t n = (size_t)count;
+    size_t searches = n < 1000000 ? n : 1000000;
+
+    uint32_t* words32 = malloc(n * sizeof(uint32_t));
+    uint64_t* words64 = malloc(n * sizeof(uint64_t));
+    double* reals = malloc(n * sizeof(double));
+    size_t records_n = n / 4 ? n / 4 : 1;
+    Record* records = malloc(records_n * sizeof(Record));
+    if (words32 == NULL || words64 == NULL || reals == NULL || records == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < n; i++) {
+        words64[i] = next_random();
+        words32[i] = (uint32_t)words64[i];
+        reals[i] = (double)(int64_t)words64[i] / 4096.0;
+    }
+    for (size_t i = 0; i < records_n; i++) {
+        memset(&records[i], 0, sizeof(Record));
+        records[i].key = next_random();
+        records[i].tag = (uint32_t)i;
+    }
+
+    printf("=== Generic Array Benchmark ===\n\n");
+    int failed = run("uint32_t", words32, n, sizeof(uint32_t), compare_u32, searches);
+    failed |= run("uint64_t", words64, n, sizeof(uint64_t), compare_u64, searches);
+    failed |= run("double", reals, n, sizeof(double), compare_double, searches);
+    failed |= run("Record", records, records_n, sizeof(Record), compare_record,
+                  searches < records_n ? searches : records_n);
+
+    free(words32);
+    free(words64);
+    free(reals);
+    free(records);
+    return failed;
+}
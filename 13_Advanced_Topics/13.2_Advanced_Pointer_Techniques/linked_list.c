@@ -0,0 +1,158 @@
+#include "linked_list.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+Node* create_node(int data) {
+    Node* node = malloc(sizeof(Node));
+    if (node == NULL) return NULL;
+    node->data = data;
+    node->next = NULL;
+    return node;
+}
+
+Node* reverse_list(Node* head) {
+    Node* prev = NULL;
+    Node* current = head;
+    Node* next = NULL;
+
+    while (current != NULL) {
+        next = current->next;
+        current->next = prev;
+        prev = current;
+        current = next;
+    }
+
+    return prev;
+}
+
+bool has_cycle(Node* head) {
+    if (head == NULL) return false;
+
+    Node* slow = head;
+    Node* fast = head;
+
+    while (fast != NULL && fast->next != NULL) {
+        slow = slow->next;
+        fast = fast->next->next;
+
+        if (slow == fast) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool has_cycle_brent(Node* head) {
+    if (head == NULL) return false;
+
+    Node* tortoise = head;
+    Node* hare = head->next;
+    size_t power = 1;
+    size_t length = 1;
+
+    while (hare != NULL) {
+        if (tortoise == hare) {
+            return true;
+        }
+        if (length == power) {
+            tortoise = hare;
+            power *= 2;
+            length = 0;
+        }
+        hare = hare->next;
+        length++;
+    }
+
+    return false;
+}
+
+Node* find_middle(Node* head) {
+    if (head == NULL) return NULL;
+
+    Node* slow = head;
+    Node* fast = head;
+
+    while (fast->next != NULL && fast->next->next != NULL) {
+        slow = slow->next;
+        fast = fast->next->next;
+    }
+
+    return slow;
+}
+
+void print_list(Node* head) {
+    Node* current = head;
+    while (current != NULL) {
+        printf("%d ", current->data);
+        current = current->next;
+    }
+    printf("\n");
+}
+
+void free_list(Node* head) {
+    while (head != NULL) {
+        Node* temp = head;
+        head = head->next;
+        free(temp);
+    }
+}
+
+size_t list_length(const Node* head) {
+    size_t count = 0;
+    for (; head != NULL; head = head->next) {
+        count++;
+    }
+    return count;
+}
+
+size_t list_to_array(const Node* head, int* values, size_t capacity) {
+    size_t count = 0;
+    while (head != NULL && count < capacity) {
+        values[count++] = head->data;
+        head = head->next;
+    }
+    return count;
+}
+
+size_t list_copy_from_array(Node* head, const int* values, size_t count) {
+    size_t copied = 0;
+    while (head != NULL && copied < count) {
+        head->data = values[copied++];
+        head = head->next;
+    }
+    return copied;
+}
+
+Node* list_from_array(const int* values, size_t count) {
+    if (count == 0) {
+        return NULL;
+    }
+    Node* nodes = malloc(count * sizeof(Node));
+    if (nodes == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        nodes[i].data = values[i];
+        nodes[i].next = &nodes[i + 1];
+    }
+    nodes[count - 1].next = NULL;
+    return nodes;
+}
+
+void free_list_block(Node* head) {
+    free(head);
+}
+
+void reverse_array(int* values, size_t count) {
+    if (count < 2) {
+        return;
+    }
+    for (size_t i = 0, j = count - 1; i < j; i++, j--) {
+        int temp = values[i];
+        values[i] = values[j];
+        values[j] = temp;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef LINKED_LIST_H
+#define LINKED_LIST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct Node {
+    int data;
+    struct Node* next;
+} Node;
+
+// Classic pointer-chasing algorithms; each step waits for the previous
+// node's cache miss. A node's address is only known one hop ahead, so
+// there is nothing to prefetch; compact long lists with list_from_array.
+Node* create_node(int data);
+Node* reverse_list(Node* head);
+bool has_cycle(Node* head);             // Floyd: three node loads per step
+Node* find_middle(Node* head);
+void print_list(Node* head);
+void free_list(Node* head);             // nodes from create_node
+
+// Brent: one pointer walks, the other teleports to it at powers of two;
+// one node load per step and no second trip over the list
+bool has_cycle_brent(Node* head);
+
+// Bulk conversion. A list built by list_from_array occupies one
+// contiguous block in list order: traversals stream through memory.
+size_t list_length(const Node* head);
+size_t list_to_array(const Node* head, int* values, size_t capacity);
+size_t list_copy_from_array(Node* head, const int* values, size_t count);
+Node* list_from_array(const int* values, size_t count);
+void free_list_block(Node* head);       // nodes from list_from_array
+
+// Array counterparts for data that was converted out of a list
+void reverse_array(int* values, size_t count);
+
+#endif /* LINKED_LIST_H */
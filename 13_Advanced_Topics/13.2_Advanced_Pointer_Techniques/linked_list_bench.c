@@ -0,0 +1,177 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "linked_list.h"
+
+// A list of n separately malloc'd nodes linked in random heap order, so
+// every hop is a cache (and usually TLB) miss. The same algorithms then
+// run on a copy built by list_from_array, where the list is contiguous.
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char* name, size_t nodes, double seconds) {
+    printf("  %-34s %8.3f s  %6.1f ns/node\n", name, seconds, seconds * 1e9 / nodes);
+}
+
+static long long checksum(const Node* head) {
+    long long sum = 0;
+    long long position = 1;
+    for (; head != NULL; head = head->next, position++) {
+        sum += position * head->data;
+    }
+    return sum;
+}
+
+static Node* build_shuffled_list(size_t n) {
+    Node** nodes = malloc(n * sizeof(Node*));
+    if (nodes == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < n; i++) {
+        nodes[i] = create_node(0);
+        if (nodes[i] == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            exit(1);
+        }
+    }
+    for (size_t i = n - 1; i > 0; i--) {
+        size_t j = next_random() % (i + 1);
+        Node* temp = nodes[i];
+        nodes[i] = nodes[j];
+        nodes[j] = temp;
+    }
+    for (size_t i = 0; i < n; i++) {
+        nodes[i]->data = (int)i;
+        nodes[i]->next = i + 1 < n ? nodes[i + 1] : NULL;
+    }
+    Node* head = nodes[0];
+    free(nodes);
+    return head;
+}
+
+static Node* nth_node(Node* head, size_t index) {
+    while (index-- > 0) {
+        head = head->next;
+    }
+    return head;
+}
+
+// Runs reverse, cycle detection and middle-finding on one list layout
+static int run_algorithms(const char* layout, Node** head, size_t n) {
+    double start;
+    int failed = 0;
+    printf("%s:\n", layout);
+
+    start = now_seconds();
+    *head = reverse_list(*head);
+    report("reverse_list", n, now_seconds() - start);
+    *head = reverse_list(*head);
+
+    Node* expected_middle = nth_node(*head, (n - 1) / 2);
+    start = now_seconds();
+    Node* middle = find_middle(*head);
+    report("find_middle (Floyd)", n, now_seconds() - start);
+    failed |= middle != expected_middle;
+
+    start = now_seconds();
+    bool cycle = has_cycle(*head);
+    report("has_cycle (Floyd), no cycle", n, now_seconds() - start);
+    failed |= cycle;
+    start = now_seconds();
+    cycle = has_cycle_brent(*head);
+    report("has_cycle_brent, no cycle", n, now_seconds() - start);
+    failed |= cycle;
+
+    // Tail back to the middle: a cycle of n / 2 nodes
+    Node* tail = nth_node(*head, n - 1);
+    tail->next = expected_middle;
+    start = now_seconds();
+    cycle = has_cycle(*head);
+    report("has_cycle (Floyd), cycle", n, now_seconds() - start);
+    failed |= !cycle;
+    start = now_seconds();
+    cycle = has_cycle_brent(*head);
+    report("has_cycle_brent, cycle", n, now_seconds() - start);
+    failed |= !cycle;
+    tail->next = NULL;
+
+    printf("\n");
+    return failed;
+}
+
+int main(int argc, char* argv[]) {
+    long count = argc > 1 ? atol(argv[1]) : 10000000;
+    if (count < 2) {
+        fprintf(stderr, "Usage: %s [nodes >= 2]\n", argv[0]);
+        return 1;
+    }
+    size_t n = (size_t)count;
+
+    printf("=== Linked List Benchmark ===\n");
+    printf("%zu nodes\n\n", n);
+
+    Node* head = build_shuffled_list(n);
+    long long original = checksum(head);
+    int failed = run_algorithms("Random heap order", &head, n);
+
+    // Value reversal: in place on the list vs out to an array and back
+    printf("Reverse the values (nodes stay put):\n");
+    int* values = malloc(n * sizeof(int));
+    if (values == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+    double start = now_seconds();
+    size_t copied = list_to_array(head, values, n);
+    double to_array = now_seconds() - start;
+    start = now_seconds();
+    reverse_array(values, copied);
+    double reverse = now_seconds() - start;
+    start = now_seconds();
+    list_copy_from_array(head, values, copied);
+    double back = now_seconds() - start;
+    report("list_to_array", n, to_array);
+    report("reverse_array", n, reverse);
+    report("list_copy_from_array", n, back);
+    reverse_array(values, copied);
+    list_copy_from_array(head, values, copied);
+    failed |= checksum(head) != original;
+
+    // Compact once, then every pass streams through memory
+    start = now_seconds();
+    Node* compact = list_from_array(values, copied);
+    report("list_from_array (compaction)", n, now_seconds() - start);
+    printf("\n");
+    if (compact == NULL) {
+        return 1;
+    }
+    failed |= run_algorithms("Contiguous (after list_from_array)", &compact, n);
+    failed |= checksum(compact) != original;
+
+    free_list(head);
+    free_list_block(compact);
+    free(values);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
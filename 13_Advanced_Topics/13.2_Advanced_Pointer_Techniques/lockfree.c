@@ -0,0 +1,267 @@
+#include "lockfree.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+void lf_stack_init(LockFreeStack* stack) {
+    stack->head = NULL;
+}
+
+void lf_stack_destroy(LockFreeStack* stack) {
+    StackNode* node = stack->head;
+    while (node != NULL) {
+        StackNode* next = node->next;
+        free(node);
+        node = next;
+    }
+    stack->head = NULL;
+}
+
+bool lf_stack_push(LockFreeStack* stack, void* value) {
+    StackNode* node = malloc(sizeof(StackNode));
+    if (node == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    node->value = value;
+
+    StackNode* head = __atomic_load_n(&stack->head, __ATOMIC_RELAXED);
+    do {
+        node->next = head;
+    } while (!__atomic_compare_exchange_n(&stack->head, &head, node, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    return true;
+}
+
+bool lf_stack_pop(LockFreeStack* stack, EpochThread* thread, void** value) {
+    // Reading head->next is only safe because head cannot be freed while
+    // we are in the critical section; for the same reason a popped node's
+    // address cannot be reused under us, which rules out ABA
+    epoch_enter(thread);
+    StackNode* head = __atomic_load_n(&stack->head, __ATOMIC_ACQUIRE);
+    while (head != NULL &&
+           !__atomic_compare_exchange_n(&stack->head, &head, head->next, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)) {
+    }
+    epoch_exit(thread);
+
+    if (head == NULL) {
+        return false;
+    }
+    *value = head->value;
+    epoch_retire(thread, head, NULL);
+    return true;
+}
+
+static QueueNode* queue_node(void* value) {
+    QueueNode* node = malloc(sizeof(QueueNode));
+    if (node == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    node->next = NULL;
+    node->value = value;
+    return node;
+}
+
+bool lf_queue_init(LockFreeQueue* queue) {
+    QueueNode* dummy = queue_node(NULL);
+    queue->head = dummy;
+    queue->tail = dummy;
+    return dummy != NULL;
+}
+
+void lf_queue_destroy(LockFreeQueue* queue) {
+    QueueNode* node = queue->head;
+    while (node != NULL) {
+        QueueNode* next = node->next;
+        free(node);
+        node = next;
+    }
+    queue->head = NULL;
+    queue->tail = NULL;
+}
+
+bool lf_queue_enqueue(LockFreeQueue* queue, EpochThread* thread, void* value) {
+    QueueNode* node = queue_node(value);
+    if (node == NULL) {
+        return false;
+    }
+
+    // tail may be dequeued and retired by now, but not freed while we are
+    // in the critical section
+    epoch_enter(thread);
+    for (;;) {
+        QueueNode* tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        QueueNode* next = __atomic_load_n(&tail->next, __ATOMIC_ACQUIRE);
+        if (next != NULL) {
+            // Another enqueue linked its node but has not swung tail yet
+            __atomic_compare_exchange_n(&queue->tail, &tail, next, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&tail->next, &next, node, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+            // Failure is fine: someone else already moved tail past tail
+            __atomic_compare_exchange_n(&queue->tail, &tail, node, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    epoch_exit(thread);
+    return true;
+}
+
+bool lf_queue_dequeue(LockFreeQueue* queue, EpochThread* thread, void** value) {
+    QueueNode* head;
+    epoch_enter(thread);
+    for (;;) {
+        head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        QueueNode* tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        QueueNode* next = __atomic_load_n(&head->next, __ATOMIC_ACQUIRE);
+        if (next == NULL) {
+            epoch_exit(thread);
+            return false;
+        }
+        if (head == tail) {
+            // Never let head pass tail, or tail could point at a freed node
+            __atomic_compare_exchange_n(&queue->tail, &tail, next, false,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&queue->head, &head, next, false,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            // next is the dummy now; another consumer may retire it, but
+            // it is not freed before we leave the critical section
+            *value = next->value;
+            break;
+        }
+    }
+    epoch_exit(thread);
+    epoch_retire(thread, head, NULL);
+    return true;
+}
+
+static uint64_t hash_key(uint64_t key) {
+    // splitmix64 finalizer
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ull;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBull;
+    return key ^ (key >> 31);
+}
+
+bool lf_map_init(LockFreeMap* map, size_t min_buckets) {
+    size_t count = 16;
+    while (count < min_buckets) {
+        count *= 2;
+    }
+    map->bucket_count = count;
+    map->buckets = calloc(count, sizeof(MapNode*));
+    map->locks = calloc(count, sizeof(char));
+    if (map->buckets == NULL || map->locks == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(map->buckets);
+        free(map->locks);
+        return false;
+    }
+    return true;
+}
+
+void lf_map_destroy(LockFreeMap* map) {
+    for (size_t b = 0; b < map->bucket_count; b++) {
+        MapNode* node = map->buckets[b];
+        while (node != NULL) {
+            MapNode* next = node->next;
+            free(node);
+            node = next;
+        }
+    }
+    free(map->buckets);
+    free(map->locks);
+    map->buckets = NULL;
+    map->locks = NULL;
+}
+
+bool lf_map_get(LockFreeMap* map, EpochThread* thread, uint64_t key, uint64_t* value) {
+    MapNode** bucket = &map->buckets[hash_key(key) & (map->bucket_count - 1)];
+    bool found = false;
+
+    epoch_enter(thread);
+    MapNode* node = __atomic_load_n(bucket, __ATOMIC_ACQUIRE);
+    while (node != NULL) {
+        if (node->key == key) {
+            *value = node->value;
+            found = true;
+            break;
+        }
+        node = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+    }
+    epoch_exit(thread);
+    return found;
+}
+
+static void lock_bucket(char* lock) {
+    while (__atomic_test_and_set(lock, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+        }
+    }
+}
+
+static void unlock_bucket(char* lock) {
+    __atomic_clear(lock, __ATOMIC_RELEASE);
+}
+
+// Link holding key in a locked bucket, or the NULL link at its end
+static MapNode** find_link(MapNode** link, uint64_t key) {
+    while (*link != NULL && (*link)->key != key) {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+bool lf_map_put(LockFreeMap* map, EpochThread* thread, uint64_t key, uint64_t value) {
+    size_t index = hash_key(key) & (map->bucket_count - 1);
+    MapNode* node = malloc(sizeof(MapNode));
+    if (node == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    node->key = key;
+    node->value = value;
+
+    lock_bucket(&map->locks[index]);
+    MapNode** link = find_link(&map->buckets[index], key);
+    MapNode* old = *link;
+    if (old != NULL) {
+        node->next = old->next;
+        __atomic_store_n(link, node, __ATOMIC_RELEASE);
+    } else {
+        node->next = map->buckets[index];
+        __atomic_store_n(&map->buckets[index], node, __ATOMIC_RELEASE);
+    }
+    unlock_bucket(&map->locks[index]);
+
+    if (old != NULL) {
+        epoch_retire(thread, old, NULL);
+    }
+    return true;
+}
+
+bool lf_map_remove(LockFreeMap* map, EpochThread* thread, uint64_t key) {
+    size_t index = hash_key(key) & (map->bucket_count - 1);
+
+    lock_bucket(&map->locks[index]);
+    MapNode** link = find_link(&map->buckets[index], key);
+    MapNode* old = *link;
+    if (old != NULL) {
+        // Readers already on old still follow its next pointer safely
+        __atomic_store_n(link, old->next, __ATOMIC_RELEASE);
+    }
+    unlock_bucket(&map->locks[index]);
+
+    if (old == NULL) {
+        return false;
+    }
+    epoch_retire(thread, old, NULL);
+    return true;
+}
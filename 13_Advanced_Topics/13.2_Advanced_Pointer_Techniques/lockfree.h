@@ -0,0 +1,72 @@
+#ifndef LOCKFREE_H
+#define LOCKFREE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "epoch.h"
+
+// Concurrent containers whose removed nodes are freed through epoch.h.
+// Every call takes the calling thread's EpochThread and enters its own
+// critical section, so readers never touch a reference count.
+
+// Treiber stack: push and pop are lock-free
+typedef struct StackNode {
+    struct StackNode* next;
+    void* value;
+} StackNode;
+
+typedef struct {
+    StackNode* head;
+} LockFreeStack;
+
+void lf_stack_init(LockFreeStack* stack);
+void lf_stack_destroy(LockFreeStack* stack);   // no concurrent users left
+bool lf_stack_push(LockFreeStack* stack, void* value);
+bool lf_stack_pop(LockFreeStack* stack, EpochThread* thread, void** value);
+
+// Michael-Scott queue: enqueue and dequeue are lock-free. head always
+// points at a dummy node; a dequeue moves head to the next node, takes
+// its value and retires the old dummy. head and tail sit on separate
+// cache lines so producers and consumers do not share one.
+typedef struct QueueNode {
+    struct QueueNode* next;
+    void* value;
+} QueueNode;
+
+typedef struct {
+    QueueNode* head;
+    char head_pad[64 - sizeof(QueueNode*)];
+    QueueNode* tail;
+    char tail_pad[64 - sizeof(QueueNode*)];
+} LockFreeQueue;
+
+bool lf_queue_init(LockFreeQueue* queue);
+void lf_queue_destroy(LockFreeQueue* queue);   // no concurrent users left
+bool lf_queue_enqueue(LockFreeQueue* queue, EpochThread* thread, void* value);
+bool lf_queue_dequeue(LockFreeQueue* queue, EpochThread* thread, void** value);
+
+// Read-mostly hash map from uint64_t keys to uint64_t values. Only lookups
+// are lock-free; writers to the same bucket serialize on a spinlock. Nodes are
+// never modified once published: an update links in a copy and retires
+// the old node, so a reader always sees a consistent key/value pair.
+typedef struct MapNode {
+    struct MapNode* next;
+    uint64_t key;
+    uint64_t value;
+} MapNode;
+
+typedef struct {
+    size_t bucket_count;        // power of two
+    MapNode** buckets;
+    char* locks;
+} LockFreeMap;
+
+bool lf_map_init(LockFreeMap* map, size_t min_buckets);
+void lf_map_destroy(LockFreeMap* map);         // no concurrent users left
+bool lf_map_get(LockFreeMap* map, EpochThread* thread, uint64_t key, uint64_t* value);
+// put and remove take the bucket's spinlock; they are not lock-free
+bool lf_map_put(LockFreeMap* map, EpochThread* thread, uint64_t key, uint64_t value);
+bool lf_map_remove(LockFreeMap* map, EpochThread* thread, uint64_t key);
+
+#endif /* LOCKFREE_H */
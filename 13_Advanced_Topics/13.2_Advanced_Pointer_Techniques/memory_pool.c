@@ -0,0 +1,260 @@
+#include "memory_pool.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct PoolChunk {
+    PoolChunk* next;
+    size_t capacity;
+};
+
+// Chunk data starts after the header, rounded up to a cache line
+#define CHUNK_HEADER_SIZE ((sizeof(PoolChunk) + 63) & ~(size_t)63)
+
+static char* chunk_data(PoolChunk* chunk) {
+    return (char*)chunk + CHUNK_HEADER_SIZE;
+}
+
+static size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static unsigned floor_log2(size_t value) {
+#if defined(__GNUC__)
+    return (unsigned)(sizeof(unsigned long long) * 8 - 1) - (unsigned)__builtin_clzll(value);
+#else
+    unsigned bits = 0;
+    while (value >>= 1) {
+        bits++;
+    }
+    return bits;
+#endif
+}
+
+// Class index for 1 <= size <= POOL_MAX_CLASS
+static unsigned class_index(size_t size) {
+    if (size <= 128) {
+        return (unsigned)((size + 15) >> 4) - 1;
+    }
+    unsigned bits = floor_log2(size - 1);
+    return 8 + (bits - 7) * 4 + (unsigned)(((size - 1) >> (bits - 2)) & 3);
+}
+
+static size_t class_size(unsigned index) {
+    if (index < 8) {
+        return (size_t)(index + 1) << 4;
+    }
+    unsigned k = index - 8;
+    return (size_t)(5 + k % 4) << (5 + k / 4);
+}
+
+size_t pool_size_class(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    return size <= POOL_MAX_CLASS ? class_size(class_index(size)) : align_up(size, POOL_ALIGNMENT);
+}
+
+int pool_class_index(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    return size <= POOL_MAX_CLASS ? (int)class_index(size) : -1;
+}
+
+size_t pool_class_size(int index) {
+    return class_size((unsigned)index);
+}
+
+void init_pool(MemoryPool* pool) {
+    memset(pool, 0, sizeof(*pool));
+    pool->next_chunk_size = POOL_MIN_CHUNK;
+}
+
+void pool_destroy(MemoryPool* pool) {
+    PoolChunk* chunk = pool->first;
+    while (chunk != NULL) {
+        PoolChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    init_pool(pool);
+}
+
+// Makes current a chunk with at least min_size free bytes: reuse the next
+// spare chunk when it is big enough, otherwise link a new one after current
+static bool advance_chunk(MemoryPool* pool, size_t min_size) {
+    PoolChunk* spare = pool->current ? pool->current->next : pool->first;
+    if (spare != NULL && spare->capacity >= min_size) {
+        pool->current = spare;
+        pool->offset = 0;
+        return true;
+    }
+
+    size_t capacity = pool->next_chunk_size > min_size ? pool->next_chunk_size : min_size;
+    PoolChunk* chunk = malloc(CHUNK_HEADER_SIZE + capacity);
+    if (chunk == NULL) {
+        return false;
+    }
+    chunk->capacity = capacity;
+    chunk->next = spare;
+
+    if (pool->current) {
+        pool->current->next = chunk;
+    } else {
+        pool->first = chunk;
+    }
+    pool->current = chunk;
+    pool->offset = 0;
+
+    if (pool->next_chunk_size < POOL_MAX_CHUNK) {
+        pool->next_chunk_size *= 2;
+    }
+    pool->stats.chunk_count++;
+    pool->stats.reserved_bytes += capacity;
+    return true;
+}
+
+static void* bump(MemoryPool* pool, size_t size, size_t alignment) {
+    for (;;) {
+        if (pool->current) {
+            char* base = chunk_data(pool->current);
+            uintptr_t address = (uintptr_t)(base + pool->offset);
+            size_t padding = (alignment - (address & (alignment - 1))) & (alignment - 1);
+
+            if (pool->offset + padding + size <= pool->current->capacity) {
+                void* ptr = base + pool->offset + padding;
+                pool->offset += padding + size;
+                pool->stats.carved_bytes += padding + size;
+                return ptr;
+            }
+        }
+        if (!advance_chunk(pool, size + alignment)) {
+            return NULL;
+        }
+    }
+}
+
+static void record_alloc(MemoryPool* pool, size_t rounded, size_t requested) {
+    PoolStats* stats = &pool->stats;
+    stats->allocations++;
+    stats->bytes_in_use += rounded;
+    stats->bytes_requested += requested;
+    if (stats->bytes_in_use > stats->high_water_bytes) {
+        stats->high_water_bytes = stats->bytes_in_use;
+    }
+}
+
+void* pool_alloc(MemoryPool* pool, size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+
+    void* ptr;
+    size_t rounded;
+    if (size <= POOL_MAX_CLASS) {
+        unsigned index = class_index(size);
+        rounded = class_size(index);
+
+        FreeBlock* block = pool->free_lists[index];
+        if (block != NULL) {
+            pool->free_lists[index] = block->next;
+            pool->stats.free_list_bytes -= rounded;
+            record_alloc(pool, rounded, size);
+            return block;
+        }
+    } else {
+        rounded = align_up(size, POOL_ALIGNMENT);
+    }
+
+    ptr = bump(pool, rounded, POOL_ALIGNMENT);
+    if (ptr != NULL) {
+        record_alloc(pool, rounded, size);
+    }
+    return ptr;
+}
+
+void* pool_alloc_aligned(MemoryPool* pool, size_t size, size_t alignment) {
+    if (alignment <= POOL_ALIGNMENT) {
+        return pool_alloc(pool, size);
+    }
+    if (alignment & (alignment - 1)) {
+        return NULL;    // not a power of two
+    }
+
+    // Always bumped: a recycled block only carries the default alignment.
+    // Rounded to its class so pool_free can still recycle it.
+    size_t rounded = pool_size_class(size);
+    void* ptr = bump(pool, rounded, alignment);
+    if (ptr != NULL) {
+        record_alloc(pool, rounded, size == 0 ? 1 : size);
+    }
+    return ptr;
+}
+
+void pool_free(MemoryPool* pool, void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return;
+    }
+    if (size == 0) {
+        size = 1;
+    }
+
+    size_t rounded = pool_size_class(size);
+    pool->stats.frees++;
+    pool->stats.bytes_in_use -= rounded;
+    pool->stats.bytes_requested -= size;
+
+    if (size <= POOL_MAX_CLASS) {
+        FreeBlock* block = ptr;
+        unsigned index = class_index(size);
+        block->next = pool->free_lists[index];
+        pool->free_lists[index] = block;
+        pool->stats.free_list_bytes += rounded;
+    }
+}
+
+PoolMark pool_mark(const MemoryPool* pool) {
+    PoolMark mark;
+    mark.chunk = pool->current;
+    mark.offset = pool->offset;
+    mark.carved_bytes = pool->stats.carved_bytes;
+    mark.bytes_in_use = pool->stats.bytes_in_use;
+    mark.bytes_requested = pool->stats.bytes_requested;
+    return mark;
+}
+
+void pool_rewind(MemoryPool* pool, PoolMark mark) {
+    // Chunks after the marked one stay linked as spares for reuse
+    pool->current = mark.chunk;
+    pool->offset = mark.offset;
+    memset(pool->free_lists, 0, sizeof(pool->free_lists));
+
+    pool->stats.carved_bytes = mark.carved_bytes;
+    pool->stats.bytes_in_use = mark.bytes_in_use;
+    pool->stats.bytes_requested = mark.bytes_requested;
+    pool->stats.free_list_bytes = 0;
+}
+
+void pool_reset(MemoryPool* pool) {
+    PoolMark start = {NULL, 0, 0, 0, 0};
+    pool_rewind(pool, start);
+}
+
+PoolStats pool_get_stats(const MemoryPool* pool) {
+    PoolStats stats = pool->stats;
+    stats.fragmentation = stats.carved_bytes
+        ? 1.0 - (double)stats.bytes_requested / (double)stats.carved_bytes : 0.0;
+    return stats;
+}
+
+bool pool_owns(const MemoryPool* pool, const void* ptr) {
+    const char* address = ptr;
+    for (PoolChunk* chunk = pool->first; chunk != NULL; chunk = chunk->next) {
+        const char* base = chunk_data(chunk);
+        if (address >= base && address < base + chunk->capacity) {
+            return true;
+        }
+    }
+    return false;
+}
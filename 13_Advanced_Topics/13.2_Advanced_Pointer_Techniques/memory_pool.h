@@ -0,0 +1,81 @@
+#ifndef MEMORY_POOL_H
+#define MEMORY_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Every block is aligned to POOL_ALIGNMENT; pool_alloc_aligned goes higher
+#define POOL_ALIGNMENT 16
+
+// Chunks start at POOL_MIN_CHUNK bytes and double up to POOL_MAX_CHUNK;
+// a request that does not fit gets a chunk of its own size
+#define POOL_MIN_CHUNK (64 * 1024)
+#define POOL_MAX_CHUNK (1024 * 1024)
+
+// Size classes: 16-byte steps up to 128, then four per power of two up to
+// POOL_MAX_CLASS. Freed blocks of a class are reused by the next request
+// of that class; larger blocks are only reclaimed by rewind/reset.
+#define POOL_SIZE_CLASSES 28
+#define POOL_MAX_CLASS 4096
+
+typedef struct PoolChunk PoolChunk;
+
+typedef struct FreeBlock {
+    struct FreeBlock* next;
+} FreeBlock;
+
+typedef struct {
+    size_t chunk_count;
+    size_t reserved_bytes;      // capacity of all chunks
+    size_t carved_bytes;        // bump-allocated so far, including padding
+    size_t bytes_in_use;        // live blocks, rounded to their size class
+    size_t bytes_requested;     // live blocks, as requested
+    size_t free_list_bytes;     // freed blocks waiting for reuse
+    size_t high_water_bytes;    // peak bytes_in_use
+    size_t allocations;
+    size_t frees;
+    double fragmentation;       // 1 - bytes_requested / carved_bytes
+} PoolStats;
+
+typedef struct {
+    PoolChunk* first;
+    PoolChunk* current;
+    size_t offset;              // bump position inside current
+    size_t next_chunk_size;
+    FreeBlock* free_lists[POOL_SIZE_CLASSES];
+    PoolStats stats;
+} MemoryPool;
+
+// Rewind point captured by pool_mark
+typedef struct {
+    PoolChunk* chunk;
+    size_t offset;
+    size_t carved_bytes;
+    size_t bytes_in_use;
+    size_t bytes_requested;
+} PoolMark;
+
+// Lifetime: init is free (chunks are allocated on demand)
+void init_pool(MemoryPool* pool);
+void pool_destroy(MemoryPool* pool);
+
+// Allocation. pool_free must be given the size passed to pool_alloc.
+void* pool_alloc(MemoryPool* pool, size_t size);
+void* pool_alloc_aligned(MemoryPool* pool, size_t size, size_t alignment);
+void pool_free(MemoryPool* pool, void* ptr, size_t size);
+
+// Scopes: rewind releases everything allocated since the mark. Free lists
+// are emptied, so blocks freed before a rewind are only reclaimed by reset.
+PoolMark pool_mark(const MemoryPool* pool);
+void pool_rewind(MemoryPool* pool, PoolMark mark);
+
+// Release every block but keep the chunks for reuse
+void pool_reset(MemoryPool* pool);
+
+PoolStats pool_get_stats(const MemoryPool* pool);
+size_t pool_size_class(size_t size);
+int pool_class_index(size_t size);     // -1 above POOL_MAX_CLASS
+size_t pool_class_size(int index);     // block size of a class
+bool pool_owns(const MemoryPool* pool, const void* ptr);
+
+#endif /* MEMORY_POOL_H */
@@ -0,0 +1,139 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "memory_pool.h"
+
+// Small-object churn: a working set of LIVE_OBJECTS slots where each step
+// frees a random slot and refills it with a new 8..256 byte object
+#define LIVE_OBJECTS 10000
+#define MIN_OBJECT 8
+#define MAX_OBJECT 256
+#define SCOPE_OBJECTS 1000
+
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint32_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (uint32_t)(rng_state >> 32);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char* name, long ops, double seconds) {
+    printf("  %-32s %8.2f M ops/s  (%.3f s)\n", name, ops / seconds / 1e6, seconds);
+}
+
+static uint32_t* make_plan(long steps, uint32_t** sizes) {
+    uint32_t* slots = malloc((size_t)steps * sizeof(uint32_t));
+    *sizes = malloc((size_t)steps * sizeof(uint32_t));
+    if (slots == NULL || *sizes == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (long i = 0; i < steps; i++) {
+        slots[i] = next_random() % LIVE_OBJECTS;
+        (*sizes)[i] = MIN_OBJECT + next_random() % (MAX_OBJECT - MIN_OBJECT + 1);
+    }
+    return slots;
+}
+
+int main(int argc, char* argv[]) {
+    long steps = argc > 1 ? atol(argv[1]) : 20000000;
+    if (steps < 1) {
+        fprintf(stderr, "Usage: %s [steps >= 1]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== Memory Pool Benchmark ===\n");
+    printf("%d live objects of %d..%d bytes, %ld free+alloc steps\n\n",
+           LIVE_OBJECTS, MIN_OBJECT, MAX_OBJECT, steps);
+
+    uint32_t* sizes;
+    uint32_t* slots = make_plan(steps, &sizes);
+    static void* live[LIVE_OBJECTS];
+    static uint32_t live_size[LIVE_OBJECTS];
+
+    printf("Churn:\n");
+    for (int i = 0; i < LIVE_OBJECTS; i++) {
+        live_size[i] = MAX_OBJECT;
+        live[i] = malloc(MAX_OBJECT);
+    }
+    double start = now_seconds();
+    for (long i = 0; i < steps; i++) {
+        uint32_t slot = slots[i];
+        free(live[slot]);
+        live[slot] = malloc(sizes[i]);
+        *(volatile char*)live[slot] = 1;
+    }
+    report("malloc/free", steps, now_seconds() - start);
+    for (int i = 0; i < LIVE_OBJECTS; i++) {
+        free(live[i]);
+    }
+
+    MemoryPool pool;
+    init_pool(&pool);
+    for (int i = 0; i < LIVE_OBJECTS; i++) {
+        live_size[i] = MAX_OBJECT;
+        live[i] = pool_alloc(&pool, MAX_OBJECT);
+    }
+    start = now_seconds();
+    for (long i = 0; i < steps; i++) {
+        uint32_t slot = slots[i];
+        pool_free(&pool, live[slot], live_size[slot]);
+        live[slot] = pool_alloc(&pool, sizes[i]);
+        live_size[slot] = sizes[i];
+        *(volatile char*)live[slot] = 1;
+    }
+    report("pool_alloc/pool_free", steps, now_seconds() - start);
+
+    PoolStats stats = pool_get_stats(&pool);
+    printf("  pool: %zu chunks, %zu KB reserved, high-water %zu KB, fragmentation %.1f%%\n",
+           stats.chunk_count, stats.reserved_bytes / 1024, stats.high_water_bytes / 1024,
+           stats.fragmentation * 100.0);
+    pool_reset(&pool);
+
+    // Scoped: allocate a batch of temporaries, then drop them all at once
+    long rounds = steps / SCOPE_OBJECTS;
+    if (rounds < 1) {
+        rounds = 1;
+    }
+    printf("\nScoped batches of %d objects (%ld rounds):\n", SCOPE_OBJECTS, rounds);
+    static void* batch[SCOPE_OBJECTS];
+
+    start = now_seconds();
+    for (long r = 0; r < rounds; r++) {
+        for (int i = 0; i < SCOPE_OBJECTS; i++) {
+            batch[i] = malloc(sizes[(r * SCOPE_OBJECTS + i) % steps]);
+            *(volatile char*)batch[i] = 1;
+        }
+        for (int i = 0; i < SCOPE_OBJECTS; i++) {
+            free(batch[i]);
+        }
+    }
+    report("malloc + free each", rounds * SCOPE_OBJECTS, now_seconds() - start);
+
+    start = now_seconds();
+    for (long r = 0; r < rounds; r++) {
+        PoolMark mark = pool_mark(&pool);
+        for (int i = 0; i < SCOPE_OBJECTS; i++) {
+            batch[i] = pool_alloc(&pool, sizes[(r * SCOPE_OBJECTS + i) % steps]);
+            *(volatile char*)batch[i] = 1;
+        }
+        pool_rewind(&pool, mark);
+    }
+    report("pool_alloc + pool_rewind", rounds * SCOPE_OBJECTS, now_seconds() - start);
+
+    pool_destroy(&pool);
+    free(slots);
+    free(sizes);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "ref_count.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// C99 has no <stdatomic.h>; the GCC/Clang __atomic builtins take the same
+// memory orders as the C11 atomic_* functions
+RefCountedData* create_ref_data_deferred(void* data, void (*destructor)(void*),
+                                         ReleaseQueue* queue) {
+    RefCountedData* ref_data = malloc(sizeof(RefCountedData));
+    if (ref_data == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    ref_data->ref_count = 1;
+    ref_data->weak_count = 1;
+    ref_data->data = data;
+    ref_data->destructor = destructor;
+    ref_data->queue = queue;
+    ref_data->next_pending = NULL;
+    return ref_data;
+}
+
+RefCountedData* create_ref_data(void* data, void (*destructor)(void*)) {
+    return create_ref_data_deferred(data, destructor, NULL);
+}
+
+void retain(RefCountedData* ref_data) {
+    if (ref_data) {
+        __atomic_fetch_add(&ref_data->ref_count, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void destroy_data(RefCountedData* ref_data) {
+    if (ref_data->destructor && ref_data->data) {
+        ref_data->destructor(ref_data->data);
+    }
+    ref_data->data = NULL;
+    weak_release(ref_data);     // the weak reference held by the strong ones
+}
+
+void release(RefCountedData* ref_data) {
+    if (ref_data == NULL) {
+        return;
+    }
+    if (__atomic_sub_fetch(&ref_data->ref_count, 1, __ATOMIC_ACQ_REL) != 0) {
+        return;
+    }
+
+    ReleaseQueue* queue = ref_data->queue;
+    if (queue == NULL) {
+        destroy_data(ref_data);
+        return;
+    }
+
+    // Treiber push; the drainer takes the whole list at once, so there is
+    // no ABA on the pop side
+    RefCountedData* head = __atomic_load_n(&queue->pending, __ATOMIC_RELAXED);
+    do {
+        ref_data->next_pending = head;
+    } while (!__atomic_compare_exchange_n(&queue->pending, &head, ref_data, true,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+}
+
+int ref_count_get(const RefCountedData* ref_data) {
+    return __atomic_load_n(&ref_data->ref_count, __ATOMIC_RELAXED);
+}
+
+void weak_retain(RefCountedData* ref_data) {
+    if (ref_data) {
+        __atomic_fetch_add(&ref_data->weak_count, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void weak_release(RefCountedData* ref_data) {
+    if (ref_data && __atomic_sub_fetch(&ref_data->weak_count, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(ref_data);
+    }
+}
+
+RefCountedData* weak_lock(RefCountedData* ref_data) {
+    if (ref_data == NULL) {
+        return NULL;
+    }
+
+    // Increment only from a nonzero count: once it reaches zero the data
+    // is gone for good
+    int count = __atomic_load_n(&ref_data->ref_count, __ATOMIC_RELAXED);
+    while (count != 0) {
+        if (__atomic_compare_exchange_n(&ref_data->ref_count, &count, count + 1, true,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return ref_data;
+        }
+    }
+    return NULL;
+}
+
+void release_queue_init(ReleaseQueue* queue) {
+    queue->pending = NULL;
+    queue->destroyed = 0;
+}
+
+size_t release_queue_drain(ReleaseQueue* queue) {
+    RefCountedData* ref_data = __atomic_exchange_n(&queue->pending, NULL, __ATOMIC_ACQUIRE);
+    size_t count = 0;
+
+    while (ref_data != NULL) {
+        RefCountedData* next = ref_data->next_pending;
+        destroy_data(ref_data);
+        ref_data = next;
+        count++;
+    }
+    __atomic_fetch_add(&queue->destroyed, count, __ATOMIC_RELAXED);
+    return count;
+}
+
+bool release_queue_empty(const ReleaseQueue* queue) {
+    return __atomic_load_n(&queue->pending, __ATOMIC_ACQUIRE) == NULL;
+}
@@ -0,0 +1,54 @@
+#ifndef REF_COUNT_H
+#define REF_COUNT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Thread-safe reference counting with weak references.
+//
+// ref_count counts strong references; the data lives while it is > 0.
+// weak_count counts weak references plus one shared by all strong ones;
+// the RefCountedData block itself lives while it is > 0, so a weak
+// reference can always ask whether the data is still alive.
+//
+// Memory orders: retain is relaxed (a new reference can only be made from
+// an existing one, so nothing needs ordering). release is acq_rel: every
+// thread's writes through its reference happen-before the destructor.
+typedef struct ReleaseQueue ReleaseQueue;
+
+typedef struct RefCountedData {
+    int ref_count;
+    int weak_count;
+    void* data;
+    void (*destructor)(void*);
+    ReleaseQueue* queue;                // NULL: destroy on the releasing thread
+    struct RefCountedData* next_pending;
+} RefCountedData;
+
+// Deferred destruction: the last release only pushes the block (lock-free)
+// and release_queue_drain runs the destructors on whichever thread calls it
+struct ReleaseQueue {
+    RefCountedData* pending;
+    size_t destroyed;
+};
+
+RefCountedData* create_ref_data(void* data, void (*destructor)(void*));
+RefCountedData* create_ref_data_deferred(void* data, void (*destructor)(void*),
+                                         ReleaseQueue* queue);
+
+// Strong references
+void retain(RefCountedData* ref_data);
+void release(RefCountedData* ref_data);
+int ref_count_get(const RefCountedData* ref_data);   // racy snapshot
+
+// Weak references: weak_lock returns ref_data with a new strong reference,
+// or NULL once the data has been released
+void weak_retain(RefCountedData* ref_data);
+void weak_release(RefCountedData* ref_data);
+RefCountedData* weak_lock(RefCountedData* ref_data);
+
+void release_queue_init(ReleaseQueue* queue);
+size_t release_queue_drain(ReleaseQueue* queue);    // returns blocks destroyed
+bool release_queue_empty(const ReleaseQueue* queue);
+
+#endif /* REF_COUNT_H */
@@ -0,0 +1,263 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "ref_count.h"
+
+// Part 1 is a stress test: threads race strong and weak references on a
+// sequence of shared objects while the owner drops its reference, and the
+// run fails if a destructor runs twice, never, or while a reader holds a
+// reference. Part 2 measures retain/release throughput under contention.
+#define MAX_THREADS 8
+#define STRESS_OBJECTS 2000
+#define STRESS_ITERATIONS 200
+
+typedef struct {
+    int alive;              // cleared by the destructor
+    int destroy_count;
+} Payload;
+
+typedef struct {
+    int index;
+    int threads;
+    long iterations;
+    bool use_weak;
+    RefCountedData* volatile* slot;     // current object (stress test)
+    pthread_barrier_t* barrier;
+    RefCountedData* target;             // object to hammer (benchmark)
+    long violations;
+} Worker;
+
+static int destructor_calls;
+
+static void payload_destructor(void* data) {
+    Payload* payload = data;
+    __atomic_store_n(&payload->alive, 0, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&payload->destroy_count, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&destructor_calls, 1, __ATOMIC_RELAXED);
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* stress_worker(void* arg) {
+    Worker* worker = arg;
+
+    for (int object = 0; object < STRESS_OBJECTS; object++) {
+        // Round start: the main thread has published a new object and
+        // given each worker one strong (or weak) reference to it
+        pthread_barrier_wait(worker->barrier);
+        RefCountedData* ref_data = *worker->slot;
+
+        for (int i = 0; i < STRESS_ITERATIONS; i++) {
+            RefCountedData* strong = worker->use_weak ? weak_lock(ref_data) : ref_data;
+            if (strong == NULL) {
+                break;      // owner and everyone else let go
+            }
+            if (!worker->use_weak) {
+                retain(strong);
+            }
+            Payload* payload = strong->data;
+            if (__atomic_load_n(&payload->alive, __ATOMIC_RELAXED) == 0) {
+                worker->violations++;
+            }
+            release(strong);
+        }
+
+        if (worker->use_weak) {
+            weak_release(ref_data);
+        } else {
+            release(ref_data);
+        }
+        pthread_barrier_wait(worker->barrier);
+    }
+    return NULL;
+}
+
+// Returns the number of failures detected
+static long run_stress(int threads, ReleaseQueue* queue) {
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+    Payload* payloads = calloc(STRESS_OBJECTS, sizeof(Payload));
+    RefCountedData* volatile slot = NULL;
+    Worker workers[MAX_THREADS];
+    pthread_t ids[MAX_THREADS];
+    if (payloads == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
+    __atomic_store_n(&destructor_calls, 0, __ATOMIC_RELAXED);
+    for (int t = 0; t < threads; t++) {
+        workers[t].index = t;
+        workers[t].use_weak = t % 2 == 1;
+        workers[t].slot = &slot;
+        workers[t].barrier = &barrier;
+        workers[t].violations = 0;
+        pthread_create(&ids[t], NULL, stress_worker, &workers[t]);
+    }
+
+    long failures = 0;
+    for (int object = 0; object < STRESS_OBJECTS; object++) {
+        payloads[object].alive = 1;
+        RefCountedData* ref_data = create_ref_data_deferred(&payloads[object],
+                                                            payload_destructor, queue);
+        if (ref_data == NULL) {
+            exit(1);
+        }
+        for (int t = 0; t < threads; t++) {
+            if (workers[t].use_weak) {
+                weak_retain(ref_data);
+            } else {
+                retain(ref_data);
+            }
+        }
+        slot = ref_data;
+
+        pthread_barrier_wait(&barrier);
+        release(ref_data);          // the owner drops out mid-round
+        if (queue != NULL) {
+            release_queue_drain(queue);
+        }
+        pthread_barrier_wait(&barrier);
+        if (queue != NULL) {
+            release_queue_drain(queue);
+        }
+        if (payloads[object].destroy_count != 1) {
+            failures++;
+        }
+    }
+
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        failures += workers[t].violations;
+    }
+    if (__atomic_load_n(&destructor_calls, __ATOMIC_RELAXED) != STRESS_OBJECTS) {
+        failures++;
+    }
+    pthread_barrier_destroy(&barrier);
+    free(payloads);
+    return failures;
+}
+
+static void* pairs_worker(void* arg) {
+    Worker* worker = arg;
+    RefCountedData* ref_data = worker->target;
+
+    pthread_barrier_wait(worker->barrier);
+    for (long i = 0; i < worker->iterations; i++) {
+        retain(ref_data);
+        release(ref_data);
+    }
+    pthread_barrier_wait(worker->barrier);
+    return NULL;
+}
+
+static void* weak_lock_worker(void* arg) {
+    Worker* worker = arg;
+    RefCountedData* ref_data = worker->target;
+
+    pthread_barrier_wait(worker->barrier);
+    for (long i = 0; i < worker->iterations; i++) {
+        release(weak_lock(ref_data));
+    }
+    pthread_barrier_wait(worker->barrier);
+    return NULL;
+}
+
+// shared: every thread hammers one object; otherwise one object per thread
+static double run_pairs(int threads, long iterations, bool shared, void* (*body)(void*)) {
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+    RefCountedData* objects[MAX_THREADS];
+    Worker workers[MAX_THREADS];
+    pthread_t ids[MAX_THREADS];
+
+    for (int t = 0; t < threads; t++) {
+        objects[t] = (shared && t > 0) ? objects[0] : create_ref_data(NULL, NULL);
+        workers[t].iterations = iterations;
+        workers[t].target = objects[t];
+        workers[t].barrier = &barrier;
+        pthread_create(&ids[t], NULL, body, &workers[t]);
+    }
+
+    pthread_barrier_wait(&barrier);
+    double start = now_seconds();
+    pthread_barrier_wait(&barrier);
+    double seconds = now_seconds() - start;
+
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        if (!shared || t == 0) {
+            release(objects[t]);
+        }
+    }
+    pthread_barrier_destroy(&barrier);
+    return threads * iterations / seconds / 1e6;
+}
+
+int main(int argc, char* argv[]) {
+    long iterations = argc > 1 ? atol(argv[1]) : 10000000;
+    if (iterations < 1) {
+        fprintf(stderr, "Usage: %s [pairs per thread >= 1]\n", argv[0]);
+        return 1;
+    }
+    static const int thread_counts[] = {1, 2, 4, MAX_THREADS};
+
+    printf("=== Reference Counting Benchmark ===\n\n");
+
+    printf("Stress test (%d objects, strong and weak readers racing the owner):\n",
+           STRESS_OBJECTS);
+    long failures = 0;
+    for (int i = 1; i < 4; i++) {
+        ReleaseQueue queue;
+        release_queue_init(&queue);
+        long immediate = run_stress(thread_counts[i], NULL);
+        long deferred = run_stress(thread_counts[i], &queue);
+        printf("  %d threads: immediate %s, deferred %s (%zu queued destructions)\n",
+               thread_counts[i], immediate ? "FAILED" : "ok", deferred ? "FAILED" : "ok",
+               queue.destroyed);
+        failures += immediate + deferred;
+    }
+    if (failures != 0) {
+        printf("Stress test FAILED: %ld errors\n", failures);
+        return 1;
+    }
+
+    printf("\nThroughput, %ld pairs per thread (aggregate M pairs/s):\n", iterations);
+    printf("  %-28s", "threads");
+    for (int i = 0; i < 4; i++) {
+        printf("  %8d", thread_counts[i]);
+    }
+    printf("\n");
+
+    // Non-atomic baseline: what the original int ref_count cost
+    volatile int plain_count = 1;
+    double start = now_seconds();
+    for (long i = 0; i < iterations; i++) {
+        plain_count++;
+        plain_count--;
+    }
+    printf("  %-28s  %8.2f\n", "plain int (1 thread only)",
+           iterations / (now_seconds() - start) / 1e6);
+
+    const char* names[] = {"retain/release, own object", "retain/release, shared",
+                           "weak_lock/release, shared"};
+    for (int row = 0; row < 3; row++) {
+        printf("  %-28s", names[row]);
+        for (int i = 0; i < 4; i++) {
+            double rate = run_pairs(thread_counts[i], iterations, row > 0,
+                                    row == 2 ? weak_lock_worker : pairs_worker);
+            printf("  %8.2f", rate);
+            fflush(stdout);
+        }
+        printf("\n");
+    }
+    return 0;
+}
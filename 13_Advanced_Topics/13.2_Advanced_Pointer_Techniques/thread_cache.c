@@ -0,0 +1,275 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "thread_cache.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Magazine bookkeeping allocator; only tests replace it
+static void* (*magazine_alloc)(size_t) = malloc;
+
+void thread_cache_set_magazine_alloc(void* (*alloc)(size_t)) {
+    magazine_alloc = alloc != NULL ? alloc : malloc;
+}
+
+bool shared_pool_init(SharedPool* shared) {
+    memset(shared, 0, sizeof(*shared));
+    if (pthread_mutex_init(&shared->lock, NULL) != 0) {
+        return false;
+    }
+    init_pool(&shared->pool);
+    for (int c = 0; c < POOL_SIZE_CLASSES; c++) {
+        pthread_mutex_init(&shared->depot[c].lock, NULL);
+    }
+    return true;
+}
+
+static void free_magazine_list(Magazine* magazine) {
+    while (magazine != NULL) {
+        Magazine* next = magazine->next;
+        free(magazine);
+        magazine = next;
+    }
+}
+
+void shared_pool_destroy(SharedPool* shared) {
+    for (int c = 0; c < POOL_SIZE_CLASSES; c++) {
+        free_magazine_list(shared->depot[c].full);
+        free_magazine_list(shared->depot[c].empty);
+        pthread_mutex_destroy(&shared->depot[c].lock);
+    }
+    pool_destroy(&shared->pool);
+    pthread_mutex_destroy(&shared->lock);
+}
+
+void* shared_pool_alloc(SharedPool* shared, size_t size) {
+    pthread_mutex_lock(&shared->lock);
+    void* ptr = pool_alloc(&shared->pool, size);
+    pthread_mutex_unlock(&shared->lock);
+    return ptr;
+}
+
+void shared_pool_free(SharedPool* shared, void* ptr, size_t size) {
+    pthread_mutex_lock(&shared->lock);
+    pool_free(&shared->pool, ptr, size);
+    pthread_mutex_unlock(&shared->lock);
+}
+
+static Magazine* magazine_create(void) {
+    Magazine* magazine = magazine_alloc(sizeof(Magazine));
+    if (magazine != NULL) {
+        magazine->next = NULL;
+        magazine->count = 0;
+    }
+    return magazine;
+}
+
+// Batch transfers: one lock acquisition per magazine, not per block
+static void refill_from_pool(SharedPool* shared, Magazine* magazine, size_t block_size) {
+    pthread_mutex_lock(&shared->lock);
+    while (magazine->count < MAGAZINE_SIZE) {
+        void* block = pool_alloc(&shared->pool, block_size);
+        if (block == NULL) {
+            break;
+        }
+        magazine->blocks[magazine->count++] = block;
+    }
+    pthread_mutex_unlock(&shared->lock);
+}
+
+static void drain_to_pool(SharedPool* shared, Magazine* magazine, size_t block_size) {
+    pthread_mutex_lock(&shared->lock);
+    while (magazine->count > 0) {
+        pool_free(&shared->pool, magazine->blocks[--magazine->count], block_size);
+    }
+    pthread_mutex_unlock(&shared->lock);
+}
+
+ThreadCache* thread_cache_create(SharedPool* shared) {
+    ThreadCache* cache = calloc(1, sizeof(ThreadCache));
+    if (cache == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    cache->shared = shared;
+    return cache;
+}
+
+void thread_cache_destroy(ThreadCache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    // Full magazines go to the depot as they are; partial ones hand their
+    // blocks back to the pool and park empty
+    for (int c = 0; c < POOL_SIZE_CLASSES; c++) {
+        DepotClass* depot = &cache->shared->depot[c];
+        Magazine* magazines[2] = {cache->loaded[c], cache->previous[c]};
+
+        for (int i = 0; i < 2; i++) {
+            Magazine* magazine = magazines[i];
+            if (magazine == NULL) {
+                continue;
+            }
+            if (magazine->count < MAGAZINE_SIZE) {
+                drain_to_pool(cache->shared, magazine, pool_class_size(c));
+            }
+
+            pthread_mutex_lock(&depot->lock);
+            if (magazine->count == MAGAZINE_SIZE) {
+                magazine->next = depot->full;
+                depot->full = magazine;
+                depot->full_count++;
+            } else {
+                magazine->next = depot->empty;
+                depot->empty = magazine;
+            }
+            pthread_mutex_unlock(&depot->lock);
+        }
+    }
+    free(cache);
+}
+
+// Both magazines of a class are created on first use
+static bool ensure_magazines(ThreadCache* cache, int c) {
+    if (cache->loaded[c] == NULL) {
+        cache->loaded[c] = magazine_create();
+        cache->previous[c] = magazine_create();
+        if (cache->loaded[c] == NULL || cache->previous[c] == NULL) {
+            free(cache->loaded[c]);
+            free(cache->previous[c]);
+            cache->loaded[c] = cache->previous[c] = NULL;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void swap_magazines(ThreadCache* cache, int c) {
+    Magazine* temp = cache->loaded[c];
+    cache->loaded[c] = cache->previous[c];
+    cache->previous[c] = temp;
+}
+
+void* cache_alloc(ThreadCache* cache, size_t size) {
+    int c = pool_class_index(size);
+    if (c < 0) {
+        return shared_pool_alloc(cache->shared, size);
+    }
+
+    Magazine* loaded = cache->loaded[c];
+    if (loaded != NULL && loaded->count > 0) {
+        cache->stats.hits++;
+        return loaded->blocks[--loaded->count];
+    }
+    if (!ensure_magazines(cache, c)) {
+        return shared_pool_alloc(cache->shared, size);
+    }
+
+    if (cache->previous[c]->count > 0) {
+        swap_magazines(cache, c);
+        cache->stats.hits++;
+    } else {
+        // Both empty: trade the spare empty magazine for a full one
+        DepotClass* depot = &cache->shared->depot[c];
+        Magazine* full = NULL;
+
+        pthread_mutex_lock(&depot->lock);
+        if (depot->full != NULL) {
+            full = depot->full;
+            depot->full = full->next;
+            depot->full_count--;
+            cache->previous[c]->next = depot->empty;
+            depot->empty = cache->previous[c];
+        }
+        pthread_mutex_unlock(&depot->lock);
+
+        if (full != NULL) {
+            cache->previous[c] = cache->loaded[c];
+            cache->loaded[c] = full;
+            cache->stats.depot_swaps++;
+        } else {
+            refill_from_pool(cache->shared, cache->loaded[c], pool_class_size(c));
+            cache->stats.pool_refills++;
+            if (cache->loaded[c]->count == 0) {
+                return NULL;
+            }
+        }
+    }
+
+    loaded = cache->loaded[c];
+    return loaded->blocks[--loaded->count];
+}
+
+void cache_free(ThreadCache* cache, void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return;
+    }
+
+    int c = pool_class_index(size);
+    if (c < 0) {
+        shared_pool_free(cache->shared, ptr, size);
+        return;
+    }
+
+    Magazine* loaded = cache->loaded[c];
+    if (loaded != NULL && loaded->count < MAGAZINE_SIZE) {
+        loaded->blocks[loaded->count++] = ptr;
+        return;
+    }
+    if (!ensure_magazines(cache, c)) {
+        shared_pool_free(cache->shared, ptr, size);
+        return;
+    }
+
+    if (cache->previous[c]->count == 0) {
+        swap_magazines(cache, c);
+    } else {
+        // Both full: park the spare full magazine in the depot and take an
+        // empty one, or drain it to the pool once the depot holds enough
+        DepotClass* depot = &cache->shared->depot[c];
+        Magazine* full = cache->previous[c];
+        Magazine* empty = NULL;
+        bool room;
+
+        pthread_mutex_lock(&depot->lock);
+        room = depot->full_count < DEPOT_MAX_FULL;
+        if (room && depot->empty != NULL) {
+            empty = depot->empty;
+            depot->empty = empty->next;
+            full->next = depot->full;
+            depot->full = full;
+            depot->full_count++;
+        }
+        pthread_mutex_unlock(&depot->lock);
+
+        if (room && empty == NULL) {
+            // No spare in the depot: allocate one before parking, so both
+            // magazines stay in place if that fails
+            empty = magazine_create();
+            if (empty == NULL) {
+                shared_pool_free(cache->shared, ptr, size);
+                return;
+            }
+            pthread_mutex_lock(&depot->lock);
+            full->next = depot->full;
+            depot->full = full;
+            depot->full_count++;
+            pthread_mutex_unlock(&depot->lock);
+        }
+
+        if (room) {
+            cache->stats.depot_swaps++;
+        } else {
+            drain_to_pool(cache->shared, full, pool_class_size(c));
+            cache->stats.pool_drains++;
+            empty = full;
+        }
+
+        cache->previous[c] = cache->loaded[c];
+        cache->loaded[c] = empty;
+    }
+
+    loaded = cache->loaded[c];
+    loaded->blocks[loaded->count++] = ptr;
+}
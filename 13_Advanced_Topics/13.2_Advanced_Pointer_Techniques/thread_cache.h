@@ -0,0 +1,73 @@
+#ifndef THREAD_CACHE_H
+#define THREAD_CACHE_H
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "memory_pool.h"
+
+// Magazine allocator (Bonwick & Adams) in front of one MemoryPool:
+//
+//   thread -> ThreadCache (2 magazines per class, no locking)
+//          -> Depot (full/empty magazines per class, one lock per class)
+//          -> SharedPool (MemoryPool behind a mutex, touched in batches)
+//
+// Blocks are interchangeable within a size class, so any thread may free
+// a block another thread allocated: it simply lands in the freeing
+// thread's magazine.
+#define MAGAZINE_SIZE 64
+#define DEPOT_MAX_FULL 32   // full magazines kept per class before draining
+
+typedef struct Magazine {
+    struct Magazine* next;
+    int count;
+    void* blocks[MAGAZINE_SIZE];
+} Magazine;
+
+typedef struct {
+    pthread_mutex_t lock;
+    Magazine* full;
+    Magazine* empty;
+    int full_count;
+} DepotClass;
+
+typedef struct {
+    pthread_mutex_t lock;
+    MemoryPool pool;
+    DepotClass depot[POOL_SIZE_CLASSES];
+} SharedPool;
+
+typedef struct {
+    size_t hits;            // served from a loaded/previous magazine
+    size_t depot_swaps;     // magazine exchanged with the depot
+    size_t pool_refills;    // batch allocated from the shared pool
+    size_t pool_drains;     // batch returned to the shared pool
+} ThreadCacheStats;
+
+typedef struct {
+    SharedPool* shared;
+    Magazine* loaded[POOL_SIZE_CLASSES];
+    Magazine* previous[POOL_SIZE_CLASSES];
+    ThreadCacheStats stats;
+} ThreadCache;
+
+// Shared pool; the locked calls are the single-lock baseline
+bool shared_pool_init(SharedPool* shared);
+void shared_pool_destroy(SharedPool* shared);
+void* shared_pool_alloc(SharedPool* shared, size_t size);
+void shared_pool_free(SharedPool* shared, void* ptr, size_t size);
+
+// One cache per thread; destroy flushes its magazines to the depot
+ThreadCache* thread_cache_create(SharedPool* shared);
+void thread_cache_destroy(ThreadCache* cache);
+
+// Same contract as pool_alloc/pool_free (sized free)
+void* cache_alloc(ThreadCache* cache, size_t size);
+void cache_free(ThreadCache* cache, void* ptr, size_t size);
+
+// Test hook: allocator for magazine bookkeeping, so a test can make it run
+// out. NULL restores malloc. Affects every pool; set it while no cache is
+// in use.
+void thread_cache_set_magazine_alloc(void* (*alloc)(size_t));
+
+#endif /* THREAD_CACHE_H */
@@ -0,0 +1,275 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "thread_cache.h"
+
+// Each thread churns its own working set of LIVE_OBJECTS slots: free a
+// random slot, refill it with an 8..256 byte object. The handoff phase
+// frees every object on a different thread than the one that allocated it.
+#define LIVE_OBJECTS 4096
+#define MIN_OBJECT 8
+#define MAX_OBJECT 256
+#define MAX_THREADS 8
+#define HANDOFF_BATCH 1024
+
+typedef enum { ALLOC_MALLOC, ALLOC_LOCKED_POOL, ALLOC_THREAD_CACHE } AllocKind;
+
+typedef struct {
+    AllocKind kind;
+    SharedPool* shared;
+    ThreadCache* cache;
+    long steps;
+    uint64_t seed;
+    pthread_barrier_t* barrier;
+    void** outbox;          // handoff: objects this thread allocated
+    void** inbox;           // handoff: objects this thread frees
+    uint32_t* inbox_sizes;
+    uint32_t* outbox_sizes;
+} Worker;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint32_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return (uint32_t)(*state >> 32);
+}
+
+static void* worker_alloc(Worker* worker, size_t size) {
+    switch (worker->kind) {
+    case ALLOC_MALLOC:
+        return malloc(size);
+    case ALLOC_LOCKED_POOL:
+        return shared_pool_alloc(worker->shared, size);
+    default:
+        return cache_alloc(worker->cache, size);
+    }
+}
+
+static void worker_free(Worker* worker, void* ptr, size_t size) {
+    switch (worker->kind) {
+    case ALLOC_MALLOC:
+        free(ptr);
+        break;
+    case ALLOC_LOCKED_POOL:
+        shared_pool_free(worker->shared, ptr, size);
+        break;
+    default:
+        cache_free(worker->cache, ptr, size);
+        break;
+    }
+}
+
+static void* churn_worker(void* arg) {
+    Worker* worker = arg;
+    void** live = malloc(LIVE_OBJECTS * sizeof(void*));
+    uint32_t* live_size = malloc(LIVE_OBJECTS * sizeof(uint32_t));
+    if (live == NULL || live_size == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
+    uint64_t state = worker->seed;
+    for (int i = 0; i < LIVE_OBJECTS; i++) {
+        live_size[i] = MAX_OBJECT;
+        live[i] = worker_alloc(worker, MAX_OBJECT);
+    }
+
+    pthread_barrier_wait(worker->barrier);
+    for (long i = 0; i < worker->steps; i++) {
+        uint32_t slot = next_random(&state) % LIVE_OBJECTS;
+        uint32_t size = MIN_OBJECT + next_random(&state) % (MAX_OBJECT - MIN_OBJECT + 1);
+        worker_free(worker, live[slot], live_size[slot]);
+        live[slot] = worker_alloc(worker, size);
+        live_size[slot] = size;
+        *(volatile char*)live[slot] = 1;
+    }
+    pthread_barrier_wait(worker->barrier);
+
+    for (int i = 0; i < LIVE_OBJECTS; i++) {
+        worker_free(worker, live[i], live_size[i]);
+    }
+    free(live);
+    free(live_size);
+    return NULL;
+}
+
+// Rounds of: fill the outbox, swap with the neighbour, free its objects
+static void* handoff_worker(void* arg) {
+    Worker* worker = arg;
+    uint64_t state = worker->seed;
+    long rounds = worker->steps / HANDOFF_BATCH;
+
+    pthread_barrier_wait(worker->barrier);
+    for (long r = 0; r < rounds; r++) {
+        for (int i = 0; i < HANDOFF_BATCH; i++) {
+            uint32_t size = MIN_OBJECT + next_random(&state) % (MAX_OBJECT - MIN_OBJECT + 1);
+            worker->outbox[i] = worker_alloc(worker, size);
+            worker->outbox_sizes[i] = size;
+            *(volatile char*)worker->outbox[i] = 1;
+        }
+        pthread_barrier_wait(worker->barrier);
+        for (int i = 0; i < HANDOFF_BATCH; i++) {
+            worker_free(worker, worker->inbox[i], worker->inbox_sizes[i]);
+        }
+        pthread_barrier_wait(worker->barrier);
+    }
+    pthread_barrier_wait(worker->barrier);
+    return NULL;
+}
+
+// Returns elapsed seconds between the first and last barrier of the run
+static double run(AllocKind kind, int threads, long steps, bool handoff, ThreadCacheStats* totals) {
+    SharedPool shared;
+    if (!shared_pool_init(&shared)) {
+        fprintf(stderr, "Failed to initialize shared pool\n");
+        exit(1);
+    }
+
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned)threads + 1);
+    Worker workers[MAX_THREADS];
+    pthread_t ids[MAX_THREADS];
+    static void* boxes[MAX_THREADS][HANDOFF_BATCH];
+    static uint32_t box_sizes[MAX_THREADS][HANDOFF_BATCH];
+
+    for (int t = 0; t < threads; t++) {
+        Worker* worker = &workers[t];
+        int neighbour = (t + 1) % threads;
+        worker->kind = kind;
+        worker->shared = &shared;
+        worker->cache = kind == ALLOC_THREAD_CACHE ? thread_cache_create(&shared) : NULL;
+        worker->steps = steps;
+        worker->seed = 0x853C49E6748FEA9Bull + (uint64_t)t * 0x9E3779B97F4A7C15ull;
+        worker->barrier = &barrier;
+        worker->outbox = boxes[t];
+        worker->outbox_sizes = box_sizes[t];
+        worker->inbox = boxes[neighbour];
+        worker->inbox_sizes = box_sizes[neighbour];
+        pthread_create(&ids[t], NULL, handoff ? handoff_worker : churn_worker, worker);
+    }
+
+    pthread_barrier_wait(&barrier);
+    double start = now_seconds();
+    if (handoff) {
+        for (long r = 0; r < steps / HANDOFF_BATCH; r++) {
+            pthread_barrier_wait(&barrier);
+            pthread_barrier_wait(&barrier);
+        }
+    }
+    pthread_barrier_wait(&barrier);
+    double seconds = now_seconds() - start;
+
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        if (workers[t].cache != NULL) {
+            totals->hits += workers[t].cache->stats.hits;
+            totals->depot_swaps += workers[t].cache->stats.depot_swaps;
+            totals->pool_refills += workers[t].cache->stats.pool_refills;
+            totals->pool_drains += workers[t].cache->stats.pool_drains;
+            thread_cache_destroy(workers[t].cache);
+        }
+    }
+    pthread_barrier_destroy(&barrier);
+    shared_pool_destroy(&shared);
+    return seconds;
+}
+
+// Magazine bookkeeping that runs out after a set number of allocations
+static int magazines_left = 0;
+
+static void* limited_magazine_alloc(size_t size) {
+    return magazines_left-- > 0 ? malloc(size) : NULL;
+}
+
+// Frees past two full magazines need a third; when it cannot be created
+// the block goes back to the pool and the cache must stay usable
+static bool check_magazine_failure(void) {
+    enum { BLOCKS = 3 * MAGAZINE_SIZE };
+    SharedPool shared;
+    if (!shared_pool_init(&shared)) {
+        return false;
+    }
+    thread_cache_set_magazine_alloc(limited_magazine_alloc);
+    magazines_left = 2;
+    ThreadCache* cache = thread_cache_create(&shared);
+    void* blocks[BLOCKS];
+    bool ok = cache != NULL;
+
+    for (int round = 0; ok && round < 2; round++) {
+        for (int i = 0; i < BLOCKS; i++) {
+            blocks[i] = cache_alloc(cache, 64);
+            ok &= blocks[i] != NULL;
+        }
+        for (int i = 0; ok && i < BLOCKS; i++) {
+            cache_free(cache, blocks[i], 64);
+        }
+    }
+    int c = pool_class_index(64);
+    ok &= magazines_left < 0 && cache->loaded[c] != NULL && cache->previous[c] != NULL;
+
+    thread_cache_destroy(cache);
+    shared_pool_destroy(&shared);
+    thread_cache_set_magazine_alloc(NULL);
+    return ok;
+}
+
+static void run_table(const char* title, long steps, bool handoff) {
+    static const char* names[] = {"malloc/free", "locked shared pool", "thread cache"};
+    static const int thread_counts[] = {1, 2, 4, MAX_THREADS};
+
+    printf("%s:\n", title);
+    printf("  %-20s", "threads");
+    for (int i = 0; i < 4; i++) {
+        printf("  %10d", thread_counts[i]);
+    }
+    printf("   (aggregate M ops/s)\n");
+
+    for (int kind = ALLOC_MALLOC; kind <= ALLOC_THREAD_CACHE; kind++) {
+        ThreadCacheStats totals = {0, 0, 0, 0};
+        printf("  %-20s", names[kind]);
+        for (int i = 0; i < 4; i++) {
+            int threads = thread_counts[i];
+            double seconds = run((AllocKind)kind, threads, steps, handoff, &totals);
+            // A churn step is one free + one alloc; count both
+            printf("  %10.2f", 2.0 * steps * threads / seconds / 1e6);
+            fflush(stdout);
+        }
+        printf("\n");
+        if (kind == ALLOC_THREAD_CACHE) {
+            printf("  %-20s  hits %zu, depot swaps %zu, pool refills %zu, pool drains %zu\n",
+                   "", totals.hits, totals.depot_swaps, totals.pool_refills, totals.pool_drains);
+        }
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    long steps = argc > 1 ? atol(argv[1]) : 5000000;
+    if (steps < HANDOFF_BATCH) {
+        fprintf(stderr, "Usage: %s [steps per thread >= %d]\n", argv[0], HANDOFF_BATCH);
+        return 1;
+    }
+
+    printf("=== Thread Cache Benchmark ===\n");
+    printf("%ld steps per thread, objects of %d..%d bytes\n\n", steps, MIN_OBJECT, MAX_OBJECT);
+
+    run_table("Private churn", steps, false);
+    run_table("Cross-thread handoff (freed by the next thread)", steps, true);
+
+    if (!check_magazine_failure()) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
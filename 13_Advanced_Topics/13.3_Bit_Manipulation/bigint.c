@@ -0,0 +1,549 @@
+#include "bigint.h"
+#include "modarith.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ---------------------------------------------------------------------
+// Storage
+
+static bool reserve(BigInt* x, size_t limbs) {
+    if (limbs <= x->capacity) return true;
+    size_t capacity = x->capacity > 0 ? x->capacity : 4;
+    while (capacity < limbs) {
+        capacity *= 2;
+    }
+    uint64_t* grown = realloc(x->limbs, capacity * sizeof(uint64_t));
+    if (grown == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    x->limbs = grown;
+    x->capacity = capacity;
+    return true;
+}
+
+static void normalize(BigInt* x) {
+    while (x->size > 0 && x->limbs[x->size - 1] == 0) {
+        x->size--;
+    }
+}
+
+// Moves a finished temporary into r, so r may alias the operands
+static void publish(BigInt* r, BigInt* result) {
+    BigInt old = *r;
+    *r = *result;
+    *result = old;
+    bigint_destroy(result);
+}
+
+void bigint_init(BigInt* x) {
+    x->limbs = NULL;
+    x->size = 0;
+    x->capacity = 0;
+}
+
+void bigint_destroy(BigInt* x) {
+    free(x->limbs);
+    bigint_init(x);
+}
+
+bool bigint_set_u64(BigInt* x, uint64_t value) {
+    if (!reserve(x, 1)) return false;
+    x->limbs[0] = value;
+    x->size = value != 0;
+    return true;
+}
+
+bool bigint_copy(BigInt* dst, const BigInt* src) {
+    if (dst == src) return true;
+    if (!reserve(dst, src->size)) return false;
+    if (src->size > 0) memcpy(dst->limbs, src->limbs, src->size * sizeof(uint64_t));
+    dst->size = src->size;
+    return true;
+}
+
+bool bigint_from_hex(BigInt* x, const char* hex) {
+    if (hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex += 2;
+    size_t digits = strlen(hex);
+    if (!reserve(x, digits / 16 + 1)) return false;
+    memset(x->limbs, 0, (digits / 16 + 1) * sizeof(uint64_t));
+    for (size_t i = 0; i < digits; i++) {
+        char c = hex[digits - 1 - i];
+        uint64_t value;
+        if (c >= '0' && c <= '9') value = (uint64_t)(c - '0');
+        else if (c >= 'a' && c <= 'f') value = (uint64_t)(c - 'a' + 10);
+        else if (c >= 'A' && c <= 'F') value = (uint64_t)(c - 'A' + 10);
+        else return false;
+        x->limbs[i / 16] |= value << (4 * (i % 16));
+    }
+    x->size = digits / 16 + 1;
+    normalize(x);
+    return true;
+}
+
+// Repeated division by 10^9, in 32-bit halves so the running remainder
+// and the next half always fit in 64 bits
+char* bigint_to_decimal(const BigInt* x) {
+    size_t chunk_capacity = x->size * 64 / 29 + 2;
+    uint64_t* work = malloc((x->size + 1) * sizeof(uint64_t));
+    uint32_t* chunks = malloc(chunk_capacity * sizeof(uint32_t));
+    char* text = malloc(chunk_capacity * 9 + 2);
+    if (work == NULL || chunks == NULL || text == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(work);
+        free(chunks);
+        free(text);
+        return NULL;
+    }
+    if (x->size > 0) memcpy(work, x->limbs, x->size * sizeof(uint64_t));
+
+    size_t size = x->size, count = 0;
+    while (size > 0) {
+        uint64_t remainder = 0;
+        for (size_t i = size; i-- > 0;) {
+            uint64_t high = (remainder << 32) | (work[i] >> 32);
+            uint64_t q_high = high / 1000000000u;
+            remainder = high % 1000000000u;
+            uint64_t low = (remainder << 32) | (work[i] & 0xFFFFFFFFu);
+            uint64_t q_low = low / 1000000000u;
+            remainder = low % 1000000000u;
+            work[i] = q_high << 32 | q_low;
+        }
+        chunks[count++] = (uint32_t)remainder;
+        while (size > 0 && work[size - 1] == 0) {
+            size--;
+        }
+    }
+
+    char* p = text;
+    if (count == 0) {
+        *p++ = '0';
+    } else {
+        p += sprintf(p, "%u", (unsigned)chunks[count - 1]);
+        for (size_t i = count - 1; i-- > 0;) {
+            p += sprintf(p, "%09u", (unsigned)chunks[i]);
+        }
+    }
+    *p = '\0';
+    free(work);
+    free(chunks);
+    return text;
+}
+
+size_t bigint_bits(const BigInt* x) {
+    if (x->size == 0) return 0;
+    uint64_t top = x->limbs[x->size - 1];
+    size_t bits = (x->size - 1) * 64;
+    while (top != 0) {
+        bits++;
+        top >>= 1;
+    }
+    return bits;
+}
+
+bool bigint_test_bit(const BigInt* x, size_t bit) {
+    if (bit / 64 >= x->size) return false;
+    return (x->limbs[bit / 64] >> (bit % 64)) & 1;
+}
+
+static int compare_limbs(const uint64_t* a, const uint64_t* b, size_t n) {
+    for (size_t i = n; i-- > 0;) {
+        if (a[i] != b[i]) return a[i] < b[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+int bigint_compare(const BigInt* a, const BigInt* b) {
+    if (a->size != b->size) return a->size < b->size ? -1 : 1;
+    return compare_limbs(a->limbs, b->limbs, a->size);
+}
+
+// ---------------------------------------------------------------------
+// Limb arithmetic
+
+// r = a + b for an >= bn, r holding an limbs; returns the carry out
+static uint64_t add_limbs(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    uint64_t carry = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        uint64_t s = a[i] + carry;
+        carry = s < carry;
+        uint64_t t = s + b[i];
+        carry += t < s;
+        r[i] = t;
+    }
+    for (; i < an; i++) {
+        uint64_t s = a[i] + carry;
+        carry = s < carry;
+        r[i] = s;
+    }
+    return carry;
+}
+
+// r = a - b for an >= bn; returns the borrow out
+static uint64_t sub_limbs(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    uint64_t borrow = 0;
+    size_t i = 0;
+    for (; i < bn; i++) {
+        uint64_t d = a[i] - b[i];
+        uint64_t next = a[i] < b[i];
+        uint64_t e = d - borrow;
+        next |= d < borrow;
+        r[i] = e;
+        borrow = next;
+    }
+    for (; i < an; i++) {
+        uint64_t e = a[i] - borrow;
+        borrow = a[i] < borrow;
+        r[i] = e;
+    }
+    return borrow;
+}
+
+static size_t trimmed(const uint64_t* a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) {
+        n--;
+    }
+    return n;
+}
+
+// a * b + c + d, which always fits in 128 bits; returns the low word
+static inline uint64_t mul_add2(uint64_t a, uint64_t b, uint64_t c, uint64_t d, uint64_t* hi_out) {
+    uint64_t hi, lo;
+    mul_wide(a, b, &hi, &lo);
+    lo += c;
+    hi += lo < c;
+    lo += d;
+    hi += lo < d;
+    *hi_out = hi;
+    return lo;
+}
+
+// r (an + bn limbs, distinct from a and b) = a * b
+static void mul_schoolbook_limbs(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn) {
+    memset(r, 0, (an + bn) * sizeof(uint64_t));
+    for (size_t i = 0; i < bn; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < an; j++) {
+            r[i + j] = mul_add2(a[j], b[i], r[i + j], carry, &carry);
+        }
+        r[i + an] = carry;
+    }
+}
+
+static void mul_limbs(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn, uint64_t* scratch);
+
+// a = a1 B^h + a0, b = b1 B^h + b0 with an >= bn > h:
+// a b = z2 B^2h + (z1 - z2 - z0) B^h + z0, z1 = (a0 + a1)(b0 + b1).
+// z0 and z2 go straight into r; the middle term is added on top.
+static void mul_karatsuba(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn, uint64_t* scratch) {
+    size_t h = an / 2;
+    size_t high = an - h;
+    size_t b_high = bn - h;
+    size_t total = an + bn;
+
+    mul_limbs(r, a, h, b, h, scratch);
+    mul_limbs(r + 2 * h, a + h, high, b + h, b_high, scratch);
+
+    uint64_t* sa = scratch;
+    uint64_t* sb = sa + high + 1;
+    uint64_t* z1 = sb + high + 1;
+    uint64_t* rest = z1 + 2 * high + 2;
+    sa[high] = add_limbs(sa, a + h, high, a, h);
+    size_t sb_limbs;
+    if (b_high >= h) {
+        sb[b_high] = add_limbs(sb, b + h, b_high, b, h);
+        sb_limbs = b_high + 1;
+    } else {
+        sb[h] = add_limbs(sb, b, h, b + h, b_high);
+        sb_limbs = h + 1;
+    }
+    size_t sa_n = trimmed(sa, high + 1);
+    size_t sb_n = trimmed(sb, sb_limbs);
+    size_t z1_n = sa_n + sb_n;
+    mul_limbs(z1, sa, sa_n, sb, sb_n, rest);
+
+    sub_limbs(z1, z1, z1_n, r, trimmed(r, 2 * h));
+    sub_limbs(z1, z1, z1_n, r + 2 * h, trimmed(r + 2 * h, total - 2 * h));
+    add_limbs(r + h, r + h, total - h, z1, trimmed(z1, z1_n));
+}
+
+// r (an + bn limbs, distinct from a, b and scratch) = a * b
+static void mul_limbs(uint64_t* r, const uint64_t* a, size_t an, const uint64_t* b, size_t bn, uint64_t* scratch) {
+    if (an < bn) {
+        const uint64_t* t = a;
+        a = b;
+        b = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn == 0) {
+        memset(r, 0, an * sizeof(uint64_t));
+        return;
+    }
+    if (bn < BIGINT_KARATSUBA_THRESHOLD) {
+        mul_schoolbook_limbs(r, a, an, b, bn);
+        return;
+    }
+    if (an >= 2 * bn) {
+        // Lopsided: multiply bn-limb slices of a and accumulate
+        uint64_t* piece = scratch;
+        memset(r, 0, (an + bn) * sizeof(uint64_t));
+        for (size_t offset = 0; offset < an; offset += bn) {
+            size_t len = an - offset < bn ? an - offset : bn;
+            mul_limbs(piece, a + offset, len, b, bn, scratch + 2 * bn);
+            add_limbs(r + offset, r + offset, an + bn - offset, piece, len + bn);
+        }
+        return;
+    }
+    mul_karatsuba(r, a, an, b, bn, scratch);
+}
+
+// Each Karatsuba level takes about 2n + 8 limbs of scratch and halves n
+static size_t scratch_limbs(size_t n) {
+    return 6 * n + 1024;
+}
+
+static bool multiply(BigInt* r, const BigInt* a, const BigInt* b, bool karatsuba) {
+    if (a->size == 0 || b->size == 0) {
+        r->size = 0;
+        return true;
+    }
+    BigInt result;
+    bigint_init(&result);
+    if (!reserve(&result, a->size + b->size)) return false;
+
+    size_t longest = a->size > b->size ? a->size : b->size;
+    size_t shortest = a->size < b->size ? a->size : b->size;
+    if (!karatsuba || shortest < BIGINT_KARATSUBA_THRESHOLD) {
+        mul_schoolbook_limbs(result.limbs, a->limbs, a->size, b->limbs, b->size);
+    } else {
+        uint64_t* scratch = malloc(scratch_limbs(longest) * sizeof(uint64_t));
+        if (scratch == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            bigint_destroy(&result);
+            return false;
+        }
+        mul_limbs(result.limbs, a->limbs, a->size, b->limbs, b->size, scratch);
+        free(scratch);
+    }
+    result.size = a->size + b->size;
+    normalize(&result);
+    publish(r, &result);
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// Arithmetic
+
+bool bigint_add(BigInt* r, const BigInt* a, const BigInt* b) {
+    if (a->size < b->size) {
+        const BigInt* t = a;
+        a = b;
+        b = t;
+    }
+    size_t an = a->size, bn = b->size;
+    if (!reserve(r, an + 1)) return false;      // a or b may be r
+    r->limbs[an] = add_limbs(r->limbs, a->limbs, an, b->limbs, bn);
+    r->size = an + 1;
+    normalize(r);
+    return true;
+}
+
+bool bigint_sub(BigInt* r, const BigInt* a, const BigInt* b) {
+    if (bigint_compare(a, b) < 0) return false;
+    size_t an = a->size, bn = b->size;
+    if (!reserve(r, an)) return false;
+    sub_limbs(r->limbs, a->limbs, an, b->limbs, bn);
+    r->size = an;
+    normalize(r);
+    return true;
+}
+
+bool bigint_mul(BigInt* r, const BigInt* a, const BigInt* b) {
+    return multiply(r, a, b, true);
+}
+
+bool bigint_mul_schoolbook(BigInt* r, const BigInt* a, const BigInt* b) {
+    return multiply(r, a, b, false);
+}
+
+// Binary long division keeping only the remainder: one shift, compare and
+// conditional subtract of m per bit of a
+bool bigint_mod(BigInt* r, const BigInt* a, const BigInt* m) {
+    if (m->size == 0) return false;
+    if (bigint_compare(a, m) < 0) return bigint_copy(r, a);
+
+    size_t k = m->size;
+    BigInt rem;
+    bigint_init(&rem);
+    if (!reserve(&rem, k + 1)) return false;
+    uint64_t* x = rem.limbs;
+    memset(x, 0, (k + 1) * sizeof(uint64_t));
+    for (size_t bit = bigint_bits(a); bit-- > 0;) {
+        uint64_t carry = (a->limbs[bit / 64] >> (bit % 64)) & 1;
+        for (size_t i = 0; i <= k; i++) {
+            uint64_t next = x[i] >> 63;
+            x[i] = x[i] << 1 | carry;
+            carry = next;
+        }
+        if (x[k] != 0 || compare_limbs(x, m->limbs, k) >= 0) {
+            x[k] -= sub_limbs(x, x, k, m->limbs, k);
+        }
+    }
+    rem.size = k;
+    normalize(&rem);
+    publish(r, &rem);
+    return true;
+}
+
+bool bigint_pow(BigInt* r, const BigInt* base, uint64_t exp) {
+    BigInt b, result;
+    bigint_init(&b);
+    bigint_init(&result);
+    bool ok = bigint_copy(&b, base) && bigint_set_u64(&result, 1);
+    int top = 63;
+    while (top >= 0 && !((exp >> top) & 1)) {
+        top--;
+    }
+    for (int bit = top; bit >= 0 && ok; bit--) {
+        ok = bigint_mul(&result, &result, &result);
+        if (ok && ((exp >> bit) & 1)) ok = bigint_mul(&result, &result, &b);
+    }
+    bigint_destroy(&b);
+    if (ok) publish(r, &result);
+    else bigint_destroy(&result);
+    return ok;
+}
+
+// ---------------------------------------------------------------------
+// Montgomery exponentiation
+
+// out = a * b / R mod n on k-limb operands (CIOS: multiply and reduce one
+// limb of b at a time); t has k + 2 limbs, out may alias a or b
+static void mont_mul(uint64_t* out, const uint64_t* a, const uint64_t* b, const uint64_t* n, size_t k,
+                     uint64_t n_neg_inv, uint64_t* t) {
+    memset(t, 0, (k + 2) * sizeof(uint64_t));
+    for (size_t i = 0; i < k; i++) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < k; j++) {
+            t[j] = mul_add2(a[j], b[i], t[j], carry, &carry);
+        }
+        uint64_t s = t[k] + carry;
+        t[k + 1] = s < carry;
+        t[k] = s;
+
+        uint64_t m = t[0] * n_neg_inv;
+        mul_add2(m, n[0], t[0], 0, &carry);
+        for (size_t j = 1; j < k; j++) {
+            t[j - 1] = mul_add2(m, n[j], t[j], carry, &carry);
+        }
+        s = t[k] + carry;
+        t[k - 1] = s;
+        t[k] = t[k + 1] + (s < carry);
+    }
+    if (t[k] != 0 || compare_limbs(t, n, k) >= 0) {
+        sub_limbs(out, t, k, n, k);
+    } else {
+        memcpy(out, t, k * sizeof(uint64_t));
+    }
+}
+
+static bool modpow_plain(BigInt* r, const BigInt* base, const BigInt* exp, const BigInt* m) {
+    BigInt b, result;
+    bigint_init(&b);
+    bigint_init(&result);
+    bool ok = bigint_mod(&b, base, m) && bigint_set_u64(&result, 1);
+    for (size_t bit = bigint_bits(exp); bit-- > 0 && ok;) {
+        ok = bigint_mul(&result, &result, &result) && bigint_mod(&result, &result, m);
+        if (ok && bigint_test_bit(exp, bit)) {
+            ok = bigint_mul(&result, &result, &b) && bigint_mod(&result, &result, m);
+        }
+    }
+    bigint_destroy(&b);
+    if (ok) publish(r, &result);
+    else bigint_destroy(&result);
+    return ok;
+}
+
+bool bigint_modpow(BigInt* r, const BigInt* base, const BigInt* exp, const BigInt* m) {
+    if (m->size == 0) return false;
+    if (m->size == 1 && m->limbs[0] == 1) {
+        r->size = 0;
+        return true;
+    }
+    if ((m->limbs[0] & 1) == 0) return modpow_plain(r, base, exp, m);
+
+    size_t k = m->size;
+    uint64_t inv = m->limbs[0];
+    for (int i = 0; i < 5; i++) {
+        inv *= 2 - m->limbs[0] * inv;
+    }
+    uint64_t n_neg_inv = 0 - inv;
+
+    // R^2 mod m with R = 2^(64k), and the base reduced below m
+    BigInt r2, b;
+    bigint_init(&r2);
+    bigint_init(&b);
+    uint64_t* work = malloc((21 * k + 2) * sizeof(uint64_t));
+    bool ok = work != NULL && reserve(&r2, 2 * k + 1);
+    if (ok) {
+        memset(r2.limbs, 0, (2 * k + 1) * sizeof(uint64_t));
+        r2.limbs[2 * k] = 1;
+        r2.size = 2 * k + 1;
+        ok = bigint_mod(&r2, &r2, m) && bigint_mod(&b, base, m);
+    }
+    if (!ok) {
+        if (work == NULL) fprintf(stderr, "Memory allocation failed\n");
+        free(work);
+        bigint_destroy(&r2);
+        bigint_destroy(&b);
+        return false;
+    }
+
+    uint64_t* table = work;             // base^0 .. base^15, Montgomery form
+    uint64_t* acc = table + 16 * k;
+    uint64_t* r2_limbs = acc + k;
+    uint64_t* plain = r2_limbs + k;
+    uint64_t* t = plain + k;
+    memset(r2_limbs, 0, k * sizeof(uint64_t));
+    memcpy(r2_limbs, r2.limbs, r2.size * sizeof(uint64_t));
+    memset(plain, 0, k * sizeof(uint64_t));
+    plain[0] = 1;
+    mont_mul(table, plain, r2_limbs, m->limbs, k, n_neg_inv, t);
+    memset(plain, 0, k * sizeof(uint64_t));
+    if (b.size > 0) memcpy(plain, b.limbs, b.size * sizeof(uint64_t));
+    mont_mul(table + k, plain, r2_limbs, m->limbs, k, n_neg_inv, t);
+    for (int i = 2; i < 16; i++) {
+        mont_mul(table + i * k, table + (i - 1) * k, table + k, m->limbs, k, n_neg_inv, t);
+    }
+
+    // Fixed 4-bit windows from the top; windows never straddle a limb
+    memcpy(acc, table, k * sizeof(uint64_t));
+    size_t windows = (bigint_bits(exp) + 3) / 4;
+    for (size_t w = windows; w-- > 0;) {
+        if (w + 1 < windows) {
+            for (int s = 0; s < 4; s++) {
+                mont_mul(acc, acc, acc, m->limbs, k, n_neg_inv, t);
+            }
+        }
+        unsigned digit = (unsigned)((exp->limbs[w / 16] >> (4 * (w % 16))) & 0xF);
+        if (digit != 0) mont_mul(acc, acc, table + digit * k, m->limbs, k, n_neg_inv, t);
+    }
+
+    memset(plain, 0, k * sizeof(uint64_t));
+    plain[0] = 1;
+    mont_mul(acc, acc, plain, m->limbs, k, n_neg_inv, t);
+    ok = reserve(r, k);
+    if (ok) {
+        memcpy(r->limbs, acc, k * sizeof(uint64_t));
+        r->size = k;
+        normalize(r);
+    }
+    free(work);
+    bigint_destroy(&r2);
+    bigint_destroy(&b);
+    return ok;
+}
@@ -0,0 +1,42 @@
+#ifndef BIGINT_H
+#define BIGINT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Non-negative arbitrary-precision integers on 64-bit limbs, least
+// significant first, with no high zero limbs (zero has size 0). Products
+// switch from schoolbook to Karatsuba at BIGINT_KARATSUBA_THRESHOLD limbs;
+// modular powers with an odd modulus run in Montgomery form with a 4-bit
+// window. Results may alias the operands. Functions returning bool fail
+// only when allocation fails or an argument is out of range.
+#define BIGINT_KARATSUBA_THRESHOLD 32
+
+typedef struct {
+    uint64_t* limbs;
+    size_t size;
+    size_t capacity;
+} BigInt;
+
+void bigint_init(BigInt* x);              // zero, no allocation
+void bigint_destroy(BigInt* x);
+bool bigint_set_u64(BigInt* x, uint64_t value);
+bool bigint_copy(BigInt* dst, const BigInt* src);
+bool bigint_from_hex(BigInt* x, const char* hex);
+char* bigint_to_decimal(const BigInt* x);  // malloc'd, caller frees
+
+size_t bigint_bits(const BigInt* x);
+bool bigint_test_bit(const BigInt* x, size_t bit);
+int bigint_compare(const BigInt* a, const BigInt* b);     // -1, 0, 1
+
+bool bigint_add(BigInt* r, const BigInt* a, const BigInt* b);
+bool bigint_sub(BigInt* r, const BigInt* a, const BigInt* b);   // needs a >= b
+bool bigint_mul(BigInt* r, const BigInt* a, const BigInt* b);
+bool bigint_mul_schoolbook(BigInt* r, const BigInt* a, const BigInt* b);
+bool bigint_mod(BigInt* r, const BigInt* a, const BigInt* m);   // shift-and-subtract, m > 0
+
+bool bigint_pow(BigInt* r, const BigInt* base, uint64_t exp);
+bool bigint_modpow(BigInt* r, const BigInt* base, const BigInt* exp, const BigInt* m);
+
+#endif /* BIGINT_H */
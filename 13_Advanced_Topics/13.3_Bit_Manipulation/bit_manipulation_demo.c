@@ -2,6 +2,13 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include "bitops.h"
+#include "bitset.h"
+#include "roaring.h"
+#include "checksum.h"
+#include "enumerate.h"
+#include "modarith.h"
+#include "bigint.h"
 
 // Function prototypes
 void demonstrate_basic_operations(void);
@@ -12,6 +19,7 @@ void demonstrate_advanced_algorithms(void);
 void demonstrate_embedded_operations(void);
 void demonstrate_performance_hacks(void);
 void demonstrate_debugging_tools(void);
+void demonstrate_bitsets(void);
 
 // Bit manipulation macros
 #define SET_BIT(x, pos)     ((x) |= (1U << (pos)))
@@ -61,42 +69,22 @@ unsigned int next_power_of_2(unsigned int n) {
 }
 
 int count_trailing_zeros(unsigned int n) {
-    if (n == 0) return 32;
-    int count = 0;
-    while (!(n & 1)) {
-        n >>= 1;
-        count++;
-    }
-    return count;
+    return bitops_ctz32(n);     // 32 for 0
 }
 
-// Bit counting functions
+// Bit counting functions: the portable SWAR count, and whichever kernel
+// bitops_init picked (POPCNT where the CPU has it)
 int popcount(unsigned int n) {
-    int count = 0;
-    while (n) {
-        count += n & 1;
-        n >>= 1;
-    }
-    return count;
+    return bitops_portable_kernels()->popcount32(n);
 }
 
 int popcount_fast(unsigned int n) {
-    int count = 0;
-    while (n) {
-        n &= n - 1;
-        count++;
-    }
-    return count;
+    return bitops_popcount32(n);
 }
 
 // Bit reversal
 unsigned int reverse_bits(unsigned int n) {
-    unsigned int result = 0;
-    for (int i = 0; i < 32; i++) {
-        result = (result << 1) | (n & 1);
-        n >>= 1;
-    }
-    return result;
+    return bitops_reverse32(n);
 }
 
 // Flag management
@@ -140,15 +128,11 @@ int abs_no_branch(int n) {
 
 // Bit extraction and manipulation
 unsigned int extract_bits(unsigned int num, int pos, int len) {
-    unsigned int mask = (1U << len) - 1;
-    return (num >> pos) & mask;
+    return bitops_extract_bits(num, pos, len);
 }
 
 unsigned int set_bits(unsigned int num, int pos, int len, unsigned int value) {
-    unsigned int mask = (1U << len) - 1;
-    num &= ~(mask << pos);
-    num |= (value & mask) << pos;
-    return num;
+    return bitops_set_bits(num, pos, len, value);
 }
 
 unsigned int rotate_left(unsigned int num, int shift) {
@@ -161,30 +145,29 @@ unsigned int rotate_right(unsigned int num, int shift) {
     return (num >> shift) | (num << (32 - shift));
 }
 
-// Fast exponentiation
-long long fast_power(long long base, long long exp) {
-    long long result = 1;
-    while (exp > 0) {
-        if (exp & 1) {
-            result *= base;
-        }
-        base *= base;
-        exp >>= 1;
+// Fast exponentiation; false on overflow or a negative exponent
+bool fast_power(long long base, long long exp, long long* result) {
+    int64_t power;
+    if (exp < 0 || !checked_pow_i64(base, (uint64_t)exp, &power)) {
+        return false;
     }
-    return result;
+    *result = power;
+    return true;
 }
 
 // Gray code generation
 void generate_gray_code(int n, int max_display) {
-    int total = 1 << n;
-    int display_count = (total > max_display) ? max_display : total;
-    
-    printf("First %d Gray codes for n=%d:\n", display_count, n);
-    for (int i = 0; i < display_count; i++) {
-        int gray = i ^ (i >> 1);
-        
+    uint64_t total = 1ull << n;
+    uint64_t display_count = (total > (uint64_t)max_display) ? (uint64_t)max_display : total;
+    GrayIterator it;
+    uint64_t gray;
+    int flipped;
+    
+    printf("First %d Gray codes for n=%d:\n", (int)display_count, n);
+    gray_iter_init(&it, 0, display_count);
+    for (int i = 0; gray_iter_next(&it, &gray, &flipped); i++) {
         for (int j = n - 1; j >= 0; j--) {
-            printf("%d", (gray >> j) & 1);
+            printf("%d", (int)((gray >> j) & 1));
         }
         printf(" ");
         if ((i + 1) % 8 == 0) printf("\n");
@@ -194,14 +177,17 @@ void generate_gray_code(int n, int max_display) {
 
 // Subset generation
 void generate_subsets(int arr[], int n, int max_display) {
-    int total_subsets = 1 << n;
-    int display_count = (total_subsets > max_display) ? max_display : total_subsets;
-    
-    printf("First %d subsets:\n", display_count);
-    for (int i = 0; i < display_count; i++) {
+    uint64_t total_subsets = 1ull << n;
+    uint64_t display_count = (total_subsets > (uint64_t)max_display) ? (uint64_t)max_display : total_subsets;
+    SubsetIterator it;
+    uint64_t mask;
+    
+    printf("First %d subsets:\n", (int)display_count);
+    subset_iter_init(&it, 0, display_count);
+    while (subset_iter_next(&it, &mask)) {
         printf("{ ");
         for (int j = 0; j < n; j++) {
-            if (i & (1 << j)) {
+            if (mask & (1ull << j)) {
                 printf("%d ", arr[j]);
             }
         }
@@ -211,20 +197,11 @@ void generate_subsets(int arr[], int n, int max_display) {
 
 // Checksum and parity
 unsigned char calculate_checksum(unsigned char data[], int length) {
-    unsigned char checksum = 0;
-    for (int i = 0; i < length; i++) {
-        checksum ^= data[i];
-    }
-    return checksum;
+    return checksum_xor8(0, data, (size_t)length);
 }
 
 int calculate_parity(unsigned int data) {
-    int parity = 0;
-    while (data) {
-        parity ^= (data & 1);
-        data >>= 1;
-    }
-    return parity;
+    return bitops_parity32(data);
 }
 
 // Performance optimizations
@@ -279,6 +256,7 @@ void analyze_bits(unsigned int n) {
 
 int main(void) {
     printf("=== Bit Manipulation Demo ===\n\n");
+    bitops_init();
     
     demonstrate_basic_operations();
     demonstrate_bit_tricks();
@@ -288,6 +266,7 @@ int main(void) {
     demonstrate_embedded_operations();
     demonstrate_performance_hacks();
     demonstrate_debugging_tools();
+    demonstrate_bitsets();
     
     printf("=== Demo Complete ===\n");
     return 0;
@@ -390,9 +369,9 @@ void demonstrate_bit_counting(void) {
     
     printf("Population count (number of set bits):\n");
     for (int i = 0; i < count; i++) {
-        printf("0x%04X: %d bits (slow: %d, fast: %d)\n", 
-               test_values[i], 
-               popcount(test_values[i]),
+        printf("0x%04X: %d bits (portable: %d, dispatched: %d)\n",
+               test_values[i],
+               popcount_fast(test_values[i]),
                popcount(test_values[i]),
                popcount_fast(test_values[i]));
     }
@@ -407,6 +386,30 @@ void demonstrate_bit_counting(void) {
         printf("0x%08X -> 0x%08X\n", original, reversed);
     }
     
+    printf("\nHardware kernels (selected at runtime):\n");
+    const BitopsCpu* cpu = bitops_cpu();
+    const BitopsKernels* kernels = bitops_kernels();
+    printf("CPU: popcnt=%d bmi1=%d lzcnt=%d bmi2=%d avx2=%d\n",
+           cpu->popcnt, cpu->bmi1, cpu->lzcnt, cpu->bmi2, cpu->avx2);
+    printf("popcount: %s, ctz: %s, clz: %s, pext/pdep: %s, buffers: %s\n",
+           kernels->popcount_name, kernels->ctz_name, kernels->clz_name,
+           kernels->pext_name, kernels->buffer_name);
+    for (int i = 0; i < reverse_count; i++) {
+        unsigned int value = test_reverse[i];
+        printf("0x%08X: popcount %d, ctz %d, clz %d, parity %d, reversed 0x%08X\n",
+               value, bitops_popcount32(value), bitops_ctz32(value), bitops_clz32(value),
+               bitops_parity32(value), bitops_reverse32(value));
+    }
+    printf("pext(0x12345678, 0x0F0F0F0F) = 0x%04X\n", bitops_pext32(0x12345678, 0x0F0F0F0F));
+    printf("pdep(0x00001234, 0x0F0F0F0F) = 0x%08X\n", bitops_pdep32(0x1234, 0x0F0F0F0F));
+    
+    unsigned char buffer[1000];
+    for (int i = 0; i < 1000; i++) {
+        buffer[i] = (unsigned char)(i * 37);
+    }
+    printf("Set bits in a 1000-byte buffer: %llu\n",
+           (unsigned long long)bitops_popcount_buffer(buffer, sizeof(buffer)));
+    
     printf("\n");
 }
 
@@ -523,9 +526,24 @@ void demonstrate_advanced_algorithms(void) {
     
     // Fast exponentiation
     printf("\nFast exponentiation:\n");
-    printf("2^10 = %lld\n", fast_power(2, 10));
-    printf("3^5 = %lld\n", fast_power(3, 5));
-    printf("5^0 = %lld\n", fast_power(5, 0));
+    long long power;
+    if (fast_power(2, 10, &power)) printf("2^10 = %lld\n", power);
+    if (fast_power(3, 5, &power)) printf("3^5 = %lld\n", power);
+    if (fast_power(5, 0, &power)) printf("5^0 = %lld\n", power);
+    if (fast_power(3, 39, &power)) printf("3^39 = %lld\n", power);
+    printf("3^40 fits in long long: %s\n", fast_power(3, 40, &power) ? "yes" : "no, overflow");
+    printf("3^40 mod (2^61 - 1) = %llu\n", (unsigned long long)mod_pow(3, 40, (1ull << 61) - 1));
+    BigInt big_base, big_power;
+    bigint_init(&big_base);
+    bigint_init(&big_power);
+    char* digits = NULL;
+    if (bigint_set_u64(&big_base, 3) && bigint_pow(&big_power, &big_base, 100)) {
+        digits = bigint_to_decimal(&big_power);
+    }
+    if (digits != NULL) printf("3^100 = %s\n", digits);
+    free(digits);
+    bigint_destroy(&big_base);
+    bigint_destroy(&big_power);
     
     // Gray code
     printf("\nGray code generation:\n");
@@ -536,6 +554,26 @@ void demonstrate_advanced_algorithms(void) {
     int subset_arr[] = {1, 2, 3};
     generate_subsets(subset_arr, 3, 8);
     
+    // Splitting the enumeration across workers
+    printf("\nSplitting 2^40 Gray codes over 4 workers:\n");
+    for (int part = 0; part < 4; part++) {
+        EnumRange range = enum_split(1ull << 40, 4, part);
+        printf("Worker %d: positions %llu..%llu, first code 0x%010llX\n", part,
+               (unsigned long long)range.begin, (unsigned long long)(range.end - 1),
+               (unsigned long long)gray_code(range.begin));
+    }
+    printf("3-element subsets of 5 elements:");
+    CombinationIterator combos;
+    uint64_t combo;
+    combination_iter_init(&combos, 5, 3, 0, enum_binomial(5, 3));
+    while (combination_iter_next(&combos, &combo)) {
+        printf(" ");
+        for (int j = 4; j >= 0; j--) {
+            printf("%d", (int)((combo >> j) & 1));
+        }
+    }
+    printf("\n");
+    
     printf("\n");
 }
 
@@ -557,6 +595,15 @@ void demonstrate_embedded_operations(void) {
     unsigned char checksum = calculate_checksum(data, data_len);
     printf("XOR Checksum: 0x%02X\n", checksum);
     
+    checksum_init();
+    const ChecksumKernels* kernels = checksum_kernels();
+    Fletcher32 fletcher;
+    fletcher32_init(&fletcher);
+    fletcher32_update(&fletcher, data, data_len);
+    printf("CRC32C:       0x%08X (%s)\n", checksum_crc32c(0, data, data_len), kernels->crc32c_name);
+    printf("Adler-32:     0x%08X (%s)\n", checksum_adler32(1, data, data_len), kernels->adler32_name);
+    printf("Fletcher-32:  0x%08X (%s)\n", fletcher32_final(&fletcher), kernels->fletcher32_name);
+    
     // Parity calculation
     printf("\nParity calculation:\n");
     unsigned int parity_values[] = {0b1010, 0b1111, 0b0001, 0b1100};
@@ -633,3 +680,66 @@ void demonstrate_debugging_tools(void) {
     
     printf("\n");
 }
+
+void demonstrate_bitsets(void) {
+    printf("9. BITSETS AND COMPRESSED BITMAPS\n");
+    printf("----------------------------------------\n");
+    
+    // Two filters over 1000 rows; zeroed so cleanup can destroy all three
+    // whichever init fails
+    Bitset even = {0}, in_range = {0}, matches = {0};
+    if (!bitset_init(&even, 1000) || !bitset_init(&in_range, 1000) || !bitset_init(&matches, 1000)) {
+        goto cleanup;
+    }
+    for (size_t row = 0; row < 1000; row += 2) {
+        bitset_set(&even, row);
+    }
+    bitset_set_range(&in_range, 100, 120);
+    
+    bitset_and(&matches, &even, &in_range);
+    printf("Bitset filter (even rows AND rows 100-119): %zu matches\n", bitset_count(&matches));
+    printf("Matching rows:");
+    for (size_t row = bitset_next(&matches, 0); row != BITSET_NONE; row = bitset_next(&matches, row + 1)) {
+        printf(" %zu", row);
+    }
+    printf("\n");
+    
+    bitset_build_rank(&even);
+    printf("Even rows before row 501: %zu\n", bitset_rank(&even, 501));
+    printf("100th even row (k=99): %zu\n", bitset_select(&even, 99));
+    
+    // Roaring: a sparse set, a dense range and their union
+    Roaring sparse, range, both;
+    roaring_init(&sparse);
+    roaring_init(&range);
+    roaring_init(&both);
+    for (uint32_t i = 0; i < 1000; i++) {
+        roaring_add(&sparse, i * 100003u);
+    }
+    roaring_add_range(&range, 5000000, 5200000);
+    roaring_or(&both, &sparse, &range);
+    roaring_run_optimize(&both);
+    
+    size_t counts[3];
+    roaring_container_counts(&both, counts);
+    uint32_t largest = 999 * 100003u;
+    printf("\nRoaring bitmap: %llu values in %zu bytes (a bitset up to %u needs %u bytes)\n",
+           (unsigned long long)roaring_cardinality(&both), roaring_size_bytes(&both),
+           largest, largest / 8 + 1);
+    printf("Containers: %zu array, %zu bitmap, %zu run\n",
+           counts[ROARING_ARRAY], counts[ROARING_BITMAP], counts[ROARING_RUN]);
+    printf("Contains 300009: %s, contains 5100000: %s, contains 5300000: %s\n",
+           roaring_contains(&both, 300009) ? "Yes" : "No",
+           roaring_contains(&both, 5100000) ? "Yes" : "No",
+           roaring_contains(&both, 5300000) ? "Yes" : "No");
+    
+    roaring_destroy(&sparse);
+    roaring_destroy(&range);
+    roaring_destroy(&both);
+
+cleanup:
+    bitset_destroy(&even);
+    bitset_destroy(&in_range);
+    bitset_destroy(&matches);
+    printf("\n");
+}
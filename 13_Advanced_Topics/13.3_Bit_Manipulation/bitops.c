@@ -0,0 +1,350 @@
+#include "bitops.h"
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BITOPS_X86 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define BITOPS_X86 0
+#endif
+
+// ---------------------------------------------------------------------
+// Portable kernels
+
+static int popcount32_portable(uint32_t x) {
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return (int)((x * 0x01010101u) >> 24);
+}
+
+static int popcount64_portable(uint64_t x) {
+    x = x - ((x >> 1) & 0x5555555555555555ull);
+    x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+    return (int)((x * 0x0101010101010101ull) >> 56);
+}
+
+static int ctz32_portable(uint32_t x) {
+    // Isolate the lowest set bit; a de Bruijn multiply maps it to its index
+    static const int positions[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    if (x == 0) return 32;
+    return positions[((x & (0u - x)) * 0x077CB531u) >> 27];
+}
+
+static int clz32_portable(uint32_t x) {
+    // Smear the top bit down, then count what is not set
+    x |= x >> 1;
+    x |= x >> 2;
+    x |= x >> 4;
+    x |= x >> 8;
+    x |= x >> 16;
+    return 32 - popcount32_portable(x);
+}
+
+static uint32_t pext32_portable(uint32_t x, uint32_t mask) {
+    uint32_t result = 0;
+    for (uint32_t bit = 1; mask != 0; bit <<= 1) {
+        uint32_t lowest = mask & (0u - mask);
+        if (x & lowest) {
+            result |= bit;
+        }
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+static uint32_t pdep32_portable(uint32_t x, uint32_t mask) {
+    uint32_t result = 0;
+    for (uint32_t bit = 1; mask != 0; bit <<= 1) {
+        uint32_t lowest = mask & (0u - mask);
+        if (x & bit) {
+            result |= lowest;
+        }
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+static uint64_t popcount_buffer_portable(const void* data, size_t bytes) {
+    const unsigned char* p = data;
+    uint64_t total = 0;
+    size_t i = 0;
+    for (; i + 8 <= bytes; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, 8);
+        total += (uint64_t)popcount64_portable(word);
+    }
+    for (; i < bytes; i++) {
+        total += (uint64_t)popcount32_portable(p[i]);
+    }
+    return total;
+}
+
+static const BitopsKernels portable_kernels = {
+    popcount32_portable, popcount64_portable, ctz32_portable, clz32_portable,
+    pext32_portable, pdep32_portable, popcount_buffer_portable,
+    "swar", "de bruijn", "smear+swar", "mask loop", "swar64"
+};
+
+// ---------------------------------------------------------------------
+// x86 kernels, each compiled for the instruction set it needs
+
+#if BITOPS_X86
+__attribute__((target("popcnt")))
+static int popcount32_popcnt(uint32_t x) {
+    return _mm_popcnt_u32(x);
+}
+
+__attribute__((target("popcnt")))
+static int popcount64_popcnt(uint64_t x) {
+    return (int)_mm_popcnt_u64(x);
+}
+
+__attribute__((target("bmi")))
+static int ctz32_tzcnt(uint32_t x) {
+    return (int)_tzcnt_u32(x);
+}
+
+__attribute__((target("lzcnt")))
+static int clz32_lzcnt(uint32_t x) {
+    return (int)_lzcnt_u32(x);
+}
+
+__attribute__((target("bmi2")))
+static uint32_t pext32_bmi2(uint32_t x, uint32_t mask) {
+    return _pext_u32(x, mask);
+}
+
+__attribute__((target("bmi2")))
+static uint32_t pdep32_bmi2(uint32_t x, uint32_t mask) {
+    return _pdep_u32(x, mask);
+}
+
+// Four independent accumulators keep several POPCNTs in flight
+__attribute__((target("popcnt")))
+static uint64_t popcount_buffer_popcnt(const void* data, size_t bytes) {
+    const unsigned char* p = data;
+    uint64_t a = 0, b = 0, c = 0, d = 0;
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        uint64_t w[4];
+        memcpy(w, p + i, 32);
+        a += (uint64_t)_mm_popcnt_u64(w[0]);
+        b += (uint64_t)_mm_popcnt_u64(w[1]);
+        c += (uint64_t)_mm_popcnt_u64(w[2]);
+        d += (uint64_t)_mm_popcnt_u64(w[3]);
+    }
+    for (; i < bytes; i++) {
+        a += (uint64_t)_mm_popcnt_u32(p[i]);
+    }
+    return a + b + c + d;
+}
+
+// Per-byte counts by nibble lookup, summed into four 64-bit lanes
+__attribute__((target("avx2")))
+static __m256i popcount256(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0F);
+    __m256i low = _mm256_and_si256(v, low_mask);
+    __m256i high = _mm256_and_si256(_mm256_srli_epi32(v, 4), low_mask);
+    __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low),
+                                     _mm256_shuffle_epi8(lookup, high));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+// Carry-save adder: (high, low) = a + b + c, bitwise
+#define CSA(high, low, a, b, c)                                                    \
+    do {                                                                           \
+        __m256i u_ = _mm256_xor_si256((a), (b));                                   \
+        (high) = _mm256_or_si256(_mm256_and_si256((a), (b)), _mm256_and_si256(u_, (c))); \
+        (low) = _mm256_xor_si256(u_, (c));                                         \
+    } while (0)
+
+// Harley-Seal (Mula, Kurz & Lemire): a tree of carry-save adders folds 16
+// vectors into ones/twos/fours/eights/sixteens, so the expensive popcount
+// runs once per 16 vectors instead of once per vector
+__attribute__((target("avx2")))
+static uint64_t popcount_buffer_avx2(const void* data, size_t bytes) {
+    const unsigned char* p = data;
+    size_t vectors = bytes / 32;
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = _mm256_setzero_si256();
+    __m256i twos = _mm256_setzero_si256();
+    __m256i fours = _mm256_setzero_si256();
+    __m256i eights = _mm256_setzero_si256();
+    __m256i sixteens, twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+    size_t i = 0;
+
+#define LOAD(k) _mm256_loadu_si256((const __m256i*)(p + (i + (k)) * 32))
+    for (; i + 16 <= vectors; i += 16) {
+        CSA(twos_a, ones, ones, LOAD(0), LOAD(1));
+        CSA(twos_b, ones, ones, LOAD(2), LOAD(3));
+        CSA(fours_a, twos, twos, twos_a, twos_b);
+        CSA(twos_a, ones, ones, LOAD(4), LOAD(5));
+        CSA(twos_b, ones, ones, LOAD(6), LOAD(7));
+        CSA(fours_b, twos, twos, twos_a, twos_b);
+        CSA(eights_a, fours, fours, fours_a, fours_b);
+        CSA(twos_a, ones, ones, LOAD(8), LOAD(9));
+        CSA(twos_b, ones, ones, LOAD(10), LOAD(11));
+        CSA(fours_a, twos, twos, twos_a, twos_b);
+        CSA(twos_a, ones, ones, LOAD(12), LOAD(13));
+        CSA(twos_b, ones, ones, LOAD(14), LOAD(15));
+        CSA(fours_b, twos, twos, twos_a, twos_b);
+        CSA(eights_b, fours, fours, fours_a, fours_b);
+        CSA(sixteens, eights, eights, eights_a, eights_b);
+        total = _mm256_add_epi64(total, popcount256(sixteens));
+    }
+
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(twos), 1));
+    total = _mm256_add_epi64(total, popcount256(ones));
+    for (; i < vectors; i++) {
+        total = _mm256_add_epi64(total, popcount256(LOAD(0)));
+    }
+#undef LOAD
+
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, total);
+    uint64_t count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (size_t b = vectors * 32; b < bytes; b++) {
+        count += (uint64_t)popcount32_portable(p[b]);
+    }
+    return count;
+}
+
+static void read_cpuid(BitopsCpu* cpu) {
+    unsigned int eax, ebx, ecx, edx;
+    bool os_avx = false;
+
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        cpu->popcnt = (ecx & bit_POPCNT) != 0;
+        cpu->sse42 = (ecx & bit_SSE4_2) != 0;
+        cpu->pclmul = (ecx & bit_PCLMUL) != 0;
+        // AVX registers are only usable if the OS saves them (OSXSAVE + XCR0)
+        if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+            unsigned int xcr0_low, xcr0_high;
+            __asm__ volatile("xgetbv" : "=a"(xcr0_low), "=d"(xcr0_high) : "c"(0));
+            os_avx = (xcr0_low & 0x6) == 0x6;
+        }
+    }
+    if (__get_cpuid_max(0, NULL) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        cpu->bmi1 = (ebx & bit_BMI) != 0;
+        cpu->bmi2 = (ebx & bit_BMI2) != 0;
+        cpu->avx2 = os_avx && (ebx & bit_AVX2) != 0;
+    }
+    if (__get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx)) {
+        cpu->lzcnt = (ecx & bit_LZCNT) != 0;
+    }
+}
+#endif /* BITOPS_X86 */
+
+// ---------------------------------------------------------------------
+// Dispatch
+
+static BitopsCpu detected_cpu;
+static BitopsKernels native_kernels;
+static const BitopsKernels* active_kernels = &portable_kernels;
+
+void bitops_init(void) {
+    BitopsKernels kernels = portable_kernels;
+
+#if BITOPS_X86
+    read_cpuid(&detected_cpu);
+    if (detected_cpu.popcnt) {
+        kernels.popcount32 = popcount32_popcnt;
+        kernels.popcount64 = popcount64_popcnt;
+        kernels.popcount_buffer = popcount_buffer_popcnt;
+        kernels.popcount_name = "popcnt";
+        kernels.buffer_name = "popcnt x4";
+    }
+    if (detected_cpu.bmi1) {
+        kernels.ctz32 = ctz32_tzcnt;
+        kernels.ctz_name = "tzcnt";
+    }
+    if (detected_cpu.lzcnt) {
+        kernels.clz32 = clz32_lzcnt;
+        kernels.clz_name = "lzcnt";
+    }
+    if (detected_cpu.bmi2) {
+        kernels.pext32 = pext32_bmi2;
+        kernels.pdep32 = pdep32_bmi2;
+        kernels.pext_name = "bmi2";
+    }
+    if (detected_cpu.avx2) {
+        kernels.popcount_buffer = popcount_buffer_avx2;
+        kernels.buffer_name = "avx2 harley-seal";
+    }
+#endif
+
+    native_kernels = kernels;
+    active_kernels = &native_kernels;
+}
+
+const BitopsCpu* bitops_cpu(void) {
+    return &detected_cpu;
+}
+
+const BitopsKernels* bitops_kernels(void) {
+    return active_kernels;
+}
+
+const BitopsKernels* bitops_portable_kernels(void) {
+    return &portable_kernels;
+}
+
+int bitops_popcount32(uint32_t x) {
+    return active_kernels->popcount32(x);
+}
+
+int bitops_popcount64(uint64_t x) {
+    return active_kernels->popcount64(x);
+}
+
+int bitops_ctz32(uint32_t x) {
+    return active_kernels->ctz32(x);
+}
+
+int bitops_clz32(uint32_t x) {
+    return active_kernels->clz32(x);
+}
+
+uint32_t bitops_pext32(uint32_t x, uint32_t mask) {
+    return active_kernels->pext32(x, mask);
+}
+
+uint32_t bitops_pdep32(uint32_t x, uint32_t mask) {
+    return active_kernels->pdep32(x, mask);
+}
+
+uint64_t bitops_popcount_buffer(const void* data, size_t bytes) {
+    return active_kernels->popcount_buffer(data, bytes);
+}
+
+int bitops_parity32(uint32_t x) {
+    // Fold to 4 bits, then look the parity up in a 16-bit constant
+    x ^= x >> 16;
+    x ^= x >> 8;
+    x ^= x >> 4;
+    return (0x6996 >> (x & 0xF)) & 1;
+}
+
+uint32_t bitops_reverse32(uint32_t x) {
+    // Swap halves at every scale: bits, pairs, nibbles, then bytes
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+#if defined(__GNUC__)
+    return __builtin_bswap32(x);
+#else
+    return (x >> 24) | ((x >> 8) & 0xFF00u) | ((x << 8) & 0xFF0000u) | (x << 24);
+#endif
+}
@@ -0,0 +1,76 @@
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Bit kernels with runtime dispatch. Every operation has a portable
+// version (SWAR, de Bruijn, mask loops) and, on x86-64, versions compiled for
+// POPCNT, BMI1 (TZCNT), LZCNT, BMI2 (PEXT/PDEP) and AVX2 through function
+// target attributes, so the program itself is built for the baseline CPU.
+// bitops_init reads CPUID once and points the dispatch table at the best
+// kernel for each operation; until then the portable table is used.
+
+typedef struct {
+    bool popcnt;
+    bool bmi1;
+    bool lzcnt;
+    bool bmi2;
+    bool avx2;      // CPU support and YMM state enabled by the OS
+    bool sse42;     // CRC32 instruction
+    bool pclmul;    // carry-less multiply
+} BitopsCpu;
+
+typedef struct {
+    int (*popcount32)(uint32_t x);
+    int (*popcount64)(uint64_t x);
+    int (*ctz32)(uint32_t x);                       // 32 for 0
+    int (*clz32)(uint32_t x);                       // 32 for 0
+    uint32_t (*pext32)(uint32_t x, uint32_t mask);  // gather mask bits to the bottom
+    uint32_t (*pdep32)(uint32_t x, uint32_t mask);  // scatter low bits into mask
+    uint64_t (*popcount_buffer)(const void* data, size_t bytes);
+
+    // Which implementation each entry uses, for reports
+    const char* popcount_name;
+    const char* ctz_name;
+    const char* clz_name;
+    const char* pext_name;
+    const char* buffer_name;
+} BitopsKernels;
+
+void bitops_init(void);
+const BitopsCpu* bitops_cpu(void);
+const BitopsKernels* bitops_kernels(void);          // active table
+const BitopsKernels* bitops_portable_kernels(void);
+
+// Convenience calls through the active table
+int bitops_popcount32(uint32_t x);
+int bitops_popcount64(uint64_t x);
+int bitops_ctz32(uint32_t x);
+int bitops_clz32(uint32_t x);
+uint32_t bitops_pext32(uint32_t x, uint32_t mask);
+uint32_t bitops_pdep32(uint32_t x, uint32_t mask);
+uint64_t bitops_popcount_buffer(const void* data, size_t bytes);
+
+// No x86 instruction helps these; branch-free portable versions
+int bitops_parity32(uint32_t x);
+uint32_t bitops_reverse32(uint32_t x);
+
+// Contiguous bit fields; len may be 0..32. A shift and a mask beat an
+// indirect PEXT/PDEP call here, so those are kept for scattered masks.
+static inline uint32_t bitops_field_mask(int pos, int len) {
+    uint32_t low = len >= 32 ? 0xFFFFFFFFu : (1u << len) - 1;
+    return low << pos;
+}
+
+static inline uint32_t bitops_extract_bits(uint32_t num, int pos, int len) {
+    return (num & bitops_field_mask(pos, len)) >> pos;
+}
+
+static inline uint32_t bitops_set_bits(uint32_t num, int pos, int len, uint32_t value) {
+    uint32_t mask = bitops_field_mask(pos, len);
+    return (num & ~mask) | ((value << pos) & mask);
+}
+
+#endif /* BITOPS_H */
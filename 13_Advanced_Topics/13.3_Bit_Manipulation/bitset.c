@@ -0,0 +1,370 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "bitset.h"
+#include "bitops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define BITSET_X86 1
+#include <immintrin.h>
+#else
+#define BITSET_X86 0
+#endif
+
+// On CPUs with BMI1 GCC emits this as TZCNT (rep bsf)
+#if defined(__GNUC__)
+#define CTZ64(x) __builtin_ctzll(x)
+#else
+static int ctz64_loop(uint64_t x) {
+    int count = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        count++;
+    }
+    return count;
+}
+#define CTZ64(x) ctz64_loop(x)
+#endif
+
+// ---------------------------------------------------------------------
+// Word kernels
+
+#define OP_AND(x, y) ((x) & (y))
+#define OP_OR(x, y) ((x) | (y))
+#define OP_XOR(x, y) ((x) ^ (y))
+#define OP_ANDNOT(x, y) ((x) & ~(y))
+
+#define DEFINE_PORTABLE_KERNEL(name, op)                                              \
+    static void name##_words_portable(uint64_t* dst, const uint64_t* a,              \
+                                      const uint64_t* b, size_t count) {             \
+        for (size_t i = 0; i < count; i++) {                                          \
+            dst[i] = op(a[i], b[i]);                                                  \
+        }                                                                             \
+    }
+
+DEFINE_PORTABLE_KERNEL(and, OP_AND)
+DEFINE_PORTABLE_KERNEL(or, OP_OR)
+DEFINE_PORTABLE_KERNEL(xor, OP_XOR)
+DEFINE_PORTABLE_KERNEL(andnot, OP_ANDNOT)
+
+static const BitsetKernels portable_kernels = {
+    and_words_portable, or_words_portable, xor_words_portable, andnot_words_portable,
+    "scalar"
+};
+
+#if BITSET_X86
+#define AVX_AND(x, y) _mm256_and_si256((x), (y))
+#define AVX_OR(x, y) _mm256_or_si256((x), (y))
+#define AVX_XOR(x, y) _mm256_xor_si256((x), (y))
+#define AVX_ANDNOT(x, y) _mm256_andnot_si256((y), (x))
+
+// Two vectors (8 words) per iteration, scalar tail
+#define DEFINE_AVX2_KERNEL(name, avx_op, op)                                          \
+    __attribute__((target("avx2")))                                                   \
+    static void name##_words_avx2(uint64_t* dst, const uint64_t* a,                  \
+                                  const uint64_t* b, size_t count) {                 \
+        size_t i = 0;                                                                 \
+        for (; i + 8 <= count; i += 8) {                                              \
+            __m256i a0 = _mm256_loadu_si256((const __m256i*)(a + i));                 \
+            __m256i a1 = _mm256_loadu_si256((const __m256i*)(a + i + 4));             \
+            __m256i b0 = _mm256_loadu_si256((const __m256i*)(b + i));                 \
+            __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + i + 4));             \
+            _mm256_storeu_si256((__m256i*)(dst + i), avx_op(a0, b0));                 \
+            _mm256_storeu_si256((__m256i*)(dst + i + 4), avx_op(a1, b1));             \
+        }                                                                             \
+        for (; i < count; i++) {                                                      \
+            dst[i] = op(a[i], b[i]);                                                  \
+        }                                                                             \
+    }
+
+DEFINE_AVX2_KERNEL(and, AVX_AND, OP_AND)
+DEFINE_AVX2_KERNEL(or, AVX_OR, OP_OR)
+DEFINE_AVX2_KERNEL(xor, AVX_XOR, OP_XOR)
+DEFINE_AVX2_KERNEL(andnot, AVX_ANDNOT, OP_ANDNOT)
+
+static const BitsetKernels avx2_kernels = {
+    and_words_avx2, or_words_avx2, xor_words_avx2, andnot_words_avx2,
+    "avx2"
+};
+#endif /* BITSET_X86 */
+
+const BitsetKernels* bitset_kernels(void) {
+#if BITSET_X86
+    if (bitops_cpu()->avx2) {
+        return &avx2_kernels;
+    }
+#endif
+    return &portable_kernels;
+}
+
+const BitsetKernels* bitset_portable_kernels(void) {
+    return &portable_kernels;
+}
+
+// ---------------------------------------------------------------------
+// Bitset
+
+static uint64_t* alloc_words(size_t count) {
+    size_t bytes = (count > 0 ? count : 1) * sizeof(uint64_t);
+    void* words = NULL;
+    if (posix_memalign(&words, BITSET_ALIGNMENT, bytes) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    memset(words, 0, bytes);
+    return words;
+}
+
+bool bitset_init(Bitset* bs, size_t bits) {
+    bs->size = bits;
+    bs->word_count = (bits + 63) / 64;
+    bs->word_capacity = bs->word_count;
+    bs->rank_index = NULL;
+    bs->rank_blocks = 0;
+    bs->words = alloc_words(bs->word_count);
+    return bs->words != NULL;
+}
+
+void bitset_destroy(Bitset* bs) {
+    free(bs->words);
+    free(bs->rank_index);
+    bs->words = NULL;
+    bs->rank_index = NULL;
+    bs->size = 0;
+    bs->word_count = 0;
+    bs->word_capacity = 0;
+    bs->rank_blocks = 0;
+}
+
+bool bitset_resize(Bitset* bs, size_t bits) {
+    size_t word_count = (bits + 63) / 64;
+    if (word_count > bs->word_capacity) {
+        size_t capacity = bs->word_capacity * 2 > word_count ? bs->word_capacity * 2 : word_count;
+        uint64_t* words = alloc_words(capacity);
+        if (words == NULL) return false;
+        memcpy(words, bs->words, bs->word_count * sizeof(uint64_t));
+        free(bs->words);
+        bs->words = words;
+        bs->word_capacity = capacity;
+    } else if (bits < bs->size) {
+        // Dropped bits must read as clear if the bitset grows again
+        memset(bs->words + word_count, 0, (bs->word_count - word_count) * sizeof(uint64_t));
+        if (bits & 63) {
+            bs->words[word_count - 1] &= (1ull << (bits & 63)) - 1;
+        }
+    }
+    bs->size = bits;
+    bs->word_count = word_count;
+    free(bs->rank_index);
+    bs->rank_index = NULL;
+    bs->rank_blocks = 0;
+    return true;
+}
+
+void bitset_clear_all(Bitset* bs) {
+    memset(bs->words, 0, bs->word_count * sizeof(uint64_t));
+}
+
+void bitset_set_range(Bitset* bs, size_t start, size_t end) {
+    if (end > bs->size) end = bs->size;
+    if (start >= end) return;
+
+    size_t first = start >> 6;
+    size_t last = (end - 1) >> 6;
+    uint64_t first_mask = ~0ull << (start & 63);
+    uint64_t last_mask = ~0ull >> (63 - ((end - 1) & 63));
+    if (first == last) {
+        bs->words[first] |= first_mask & last_mask;
+        return;
+    }
+    bs->words[first] |= first_mask;
+    for (size_t w = first + 1; w < last; w++) {
+        bs->words[w] = ~0ull;
+    }
+    bs->words[last] |= last_mask;
+}
+
+static bool same_size(const Bitset* dst, const Bitset* a, const Bitset* b) {
+    if (dst->size != a->size || a->size != b->size) {
+        fprintf(stderr, "Bitset sizes differ\n");
+        return false;
+    }
+    return true;
+}
+
+bool bitset_and(Bitset* dst, const Bitset* a, const Bitset* b) {
+    if (!same_size(dst, a, b)) return false;
+    bitset_kernels()->and_words(dst->words, a->words, b->words, dst->word_count);
+    return true;
+}
+
+bool bitset_or(Bitset* dst, const Bitset* a, const Bitset* b) {
+    if (!same_size(dst, a, b)) return false;
+    bitset_kernels()->or_words(dst->words, a->words, b->words, dst->word_count);
+    return true;
+}
+
+bool bitset_xor(Bitset* dst, const Bitset* a, const Bitset* b) {
+    if (!same_size(dst, a, b)) return false;
+    bitset_kernels()->xor_words(dst->words, a->words, b->words, dst->word_count);
+    return true;
+}
+
+bool bitset_andnot(Bitset* dst, const Bitset* a, const Bitset* b) {
+    if (!same_size(dst, a, b)) return false;
+    bitset_kernels()->andnot_words(dst->words, a->words, b->words, dst->word_count);
+    return true;
+}
+
+size_t bitset_count(const Bitset* bs) {
+    return (size_t)bitops_popcount_buffer(bs->words, bs->word_count * sizeof(uint64_t));
+}
+
+// ---------------------------------------------------------------------
+// Rank and select
+
+bool bitset_build_rank(Bitset* bs) {
+    size_t blocks = (bs->word_count + BITSET_RANK_WORDS - 1) / BITSET_RANK_WORDS;
+    uint64_t* index = realloc(bs->rank_index, (blocks > 0 ? blocks : 1) * sizeof(uint64_t));
+    if (index == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+
+    uint64_t total = 0;
+    for (size_t block = 0; block < blocks; block++) {
+        index[block] = total;
+        size_t start = block * BITSET_RANK_WORDS;
+        size_t end = start + BITSET_RANK_WORDS;
+        if (end > bs->word_count) end = bs->word_count;
+        for (size_t w = start; w < end; w++) {
+            total += (uint64_t)bitops_popcount64(bs->words[w]);
+        }
+    }
+    bs->rank_index = index;
+    bs->rank_blocks = blocks;
+    return true;
+}
+
+size_t bitset_rank(const Bitset* bs, size_t pos) {
+    if (pos > bs->size) pos = bs->size;
+    size_t word = pos >> 6;
+    size_t rank;
+    size_t w;
+
+    if (bs->rank_index != NULL && bs->rank_blocks > 0) {
+        size_t block = word / BITSET_RANK_WORDS;
+        if (block >= bs->rank_blocks) block = bs->rank_blocks - 1;
+        rank = (size_t)bs->rank_index[block];
+        w = block * BITSET_RANK_WORDS;
+        for (; w < word; w++) {
+            rank += (size_t)bitops_popcount64(bs->words[w]);
+        }
+    } else {
+        rank = (size_t)bitops_popcount_buffer(bs->words, word * sizeof(uint64_t));
+    }
+    if (pos & 63) {
+        rank += (size_t)bitops_popcount64(bs->words[word] & ((1ull << (pos & 63)) - 1));
+    }
+    return rank;
+}
+
+// Position of the k-th set bit of a word: PDEP deposits a single 1 at
+// that bit, and a trailing-zero count reads its position
+static int select_in_word(uint64_t word, size_t k) {
+    uint32_t low = (uint32_t)word;
+    int low_count = bitops_popcount32(low);
+    if ((int)k < low_count) {
+        return bitops_ctz32(bitops_pdep32(1u << k, low));
+    }
+    uint32_t high = (uint32_t)(word >> 32);
+    return 32 + bitops_ctz32(bitops_pdep32(1u << (k - (size_t)low_count), high));
+}
+
+size_t bitset_select(const Bitset* bs, size_t k) {
+    size_t w = 0;
+
+    if (bs->rank_index != NULL && bs->rank_blocks > 0) {
+        // Last block whose starting rank is still <= k
+        size_t low = 0, high = bs->rank_blocks;
+        while (high - low > 1) {
+            size_t mid = low + (high - low) / 2;
+            if (bs->rank_index[mid] <= k) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        k -= (size_t)bs->rank_index[low];
+        w = low * BITSET_RANK_WORDS;
+    }
+
+    for (; w < bs->word_count; w++) {
+        size_t count = (size_t)bitops_popcount64(bs->words[w]);
+        if (k < count) {
+            return w * 64 + (size_t)select_in_word(bs->words[w], k);
+        }
+        k -= count;
+    }
+    return BITSET_NONE;
+}
+
+// ---------------------------------------------------------------------
+// Iteration
+
+size_t bitset_next(const Bitset* bs, size_t from) {
+    if (from >= bs->size) return BITSET_NONE;
+    size_t w = from >> 6;
+    uint64_t word = bs->words[w] & (~0ull << (from & 63));
+    while (word == 0) {
+        if (++w >= bs->word_count) return BITSET_NONE;
+        word = bs->words[w];
+    }
+    return w * 64 + (size_t)CTZ64(word);
+}
+
+size_t bitset_to_array(const Bitset* bs, uint32_t* out, size_t capacity) {
+    size_t count = 0;
+    size_t w = 0;
+
+    // Decode four bits per step for popcount(word) bits: the loop trip
+    // count is known up front instead of ending on an unpredictable
+    // branch. Overshoot writes stay inside out while 64 slots remain.
+    for (; w < bs->word_count && count + 64 <= capacity; w++) {
+        uint64_t word = bs->words[w];
+        if (word == 0) continue;
+        uint32_t base = (uint32_t)(w * 64);
+        size_t bits = (size_t)bitops_popcount64(word);
+        for (size_t i = 0; i < bits; i += 4) {
+            out[count + i] = base + (uint32_t)CTZ64(word);
+            word &= word - 1;
+            out[count + i + 1] = base + (uint32_t)CTZ64(word | (1ull << 63));
+            word &= word - 1;
+            out[count + i + 2] = base + (uint32_t)CTZ64(word | (1ull << 63));
+            word &= word - 1;
+            out[count + i + 3] = base + (uint32_t)CTZ64(word | (1ull << 63));
+            word &= word - 1;
+        }
+        count += bits;
+    }
+    for (; w < bs->word_count; w++) {
+        uint64_t word = bs->words[w];
+        while (word != 0 && count < capacity) {
+            out[count++] = (uint32_t)(w * 64) + (uint32_t)CTZ64(word);
+            word &= word - 1;
+        }
+    }
+    return count;
+}
+
+void bitset_for_each(const Bitset* bs, void (*visit)(size_t pos, void* context), void* context) {
+    for (size_t w = 0; w < bs->word_count; w++) {
+        uint64_t word = bs->words[w];
+        while (word != 0) {
+            visit(w * 64 + (size_t)CTZ64(word), context);
+            word &= word - 1;
+        }
+    }
+}
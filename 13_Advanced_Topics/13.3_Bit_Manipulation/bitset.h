@@ -0,0 +1,79 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Resizable multi-word bitset. Words are BITSET_ALIGNMENT-aligned and the
+// bits past size are kept clear, so whole-word kernels never need a tail
+// mask. The and/or/xor/andnot kernels use AVX2 when bitops_init has
+// detected it; counting, rank and select go through the bitops kernels.
+#define BITSET_ALIGNMENT 32
+#define BITSET_NONE ((size_t)-1)
+#define BITSET_RANK_WORDS 8         // one rank entry per 512 bits
+
+typedef struct {
+    uint64_t* words;
+    size_t size;                // bits
+    size_t word_count;
+    size_t word_capacity;       // allocated words, all clear past word_count
+    uint64_t* rank_index;       // set bits before each rank block
+    size_t rank_blocks;
+} Bitset;
+
+// Word-array kernels shared with the roaring bitmap containers
+typedef struct {
+    void (*and_words)(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t count);
+    void (*or_words)(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t count);
+    void (*xor_words)(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t count);
+    void (*andnot_words)(uint64_t* dst, const uint64_t* a, const uint64_t* b, size_t count);
+    const char* name;
+} BitsetKernels;
+
+const BitsetKernels* bitset_kernels(void);           // AVX2 if detected
+const BitsetKernels* bitset_portable_kernels(void);
+
+bool bitset_init(Bitset* bs, size_t bits);            // all clear
+void bitset_destroy(Bitset* bs);
+// Grows (new bits clear) or shrinks to bits; the storage grows
+// geometrically and the rank index is dropped
+bool bitset_resize(Bitset* bs, size_t bits);
+void bitset_clear_all(Bitset* bs);
+void bitset_set_range(Bitset* bs, size_t start, size_t end);     // [start, end)
+
+static inline void bitset_set(Bitset* bs, size_t pos) {
+    bs->words[pos >> 6] |= 1ull << (pos & 63);
+}
+
+static inline void bitset_clear(Bitset* bs, size_t pos) {
+    bs->words[pos >> 6] &= ~(1ull << (pos & 63));
+}
+
+static inline bool bitset_test(const Bitset* bs, size_t pos) {
+    return (bs->words[pos >> 6] >> (pos & 63)) & 1;
+}
+
+// dst = a OP b; all three the same size, dst may alias either input
+bool bitset_and(Bitset* dst, const Bitset* a, const Bitset* b);
+bool bitset_or(Bitset* dst, const Bitset* a, const Bitset* b);
+bool bitset_xor(Bitset* dst, const Bitset* a, const Bitset* b);
+bool bitset_andnot(Bitset* dst, const Bitset* a, const Bitset* b);     // a & ~b
+
+size_t bitset_count(const Bitset* bs);
+
+// rank: set bits in [0, pos). select: position of the k-th set bit
+// (k from 0), BITSET_NONE if there are not that many. Both scan the words
+// unless bitset_build_rank has run; the index is a snapshot and has to be
+// rebuilt after the bits change.
+bool bitset_build_rank(Bitset* bs);
+size_t bitset_rank(const Bitset* bs, size_t pos);
+size_t bitset_select(const Bitset* bs, size_t k);
+
+// Iteration over set bits: each word is consumed with count-trailing-zeros
+// and clear-lowest-bit, so the cost follows the set bits, not the size
+size_t bitset_next(const Bitset* bs, size_t from);    // BITSET_NONE at the end
+size_t bitset_to_array(const Bitset* bs, uint32_t* out, size_t capacity);  // positions below 2^32
+void bitset_for_each(const Bitset* bs, void (*visit)(size_t pos, void* context), void* context);
+
+#endif /* BITSET_H */
@@ -0,0 +1,213 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "bitops.h"
+#include "bitset.h"
+
+// Filter-style workload over a large row-ID space: word-wise set
+// operations (scalar vs AVX2), counting, extracting the set rows, and
+// rank/select. The baselines are the per-bit loops one would write with
+// the CHECK_BIT macro from the demo.
+#define CHECK_BIT(x, pos) (((x) >> (pos)) & 1ull)
+
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill_random(Bitset* bs) {
+    for (size_t w = 0; w < bs->word_count; w++) {
+        bs->words[w] = next_random();
+    }
+    if (bs->size & 63) {
+        bs->words[bs->word_count - 1] &= (1ull << (bs->size & 63)) - 1;
+    }
+}
+
+static size_t count_bits_loop(const Bitset* bs) {
+    size_t count = 0;
+    for (size_t pos = 0; pos < bs->size; pos++) {
+        count += CHECK_BIT(bs->words[pos >> 6], pos & 63);
+    }
+    return count;
+}
+
+static size_t to_array_loop(const Bitset* bs, uint32_t* out) {
+    size_t count = 0;
+    for (size_t pos = 0; pos < bs->size; pos++) {
+        if (CHECK_BIT(bs->words[pos >> 6], pos & 63)) {
+            out[count++] = (uint32_t)pos;
+        }
+    }
+    return count;
+}
+
+static int failed = 0;
+
+static void bench_word_op(const char* name, size_t op_index, Bitset* dst, const Bitset* a, const Bitset* b) {
+    const BitsetKernels* tables[2] = {bitset_portable_kernels(), bitset_kernels()};
+    double bytes = 3.0 * a->word_count * sizeof(uint64_t);
+    uint64_t checks[2] = {0, 0};
+    for (int t = 0; t < 2; t++) {
+        void (*kernel)(uint64_t*, const uint64_t*, const uint64_t*, size_t);
+        switch (op_index) {
+            case 0: kernel = tables[t]->and_words; break;
+            case 1: kernel = tables[t]->or_words; break;
+            case 2: kernel = tables[t]->xor_words; break;
+            default: kernel = tables[t]->andnot_words; break;
+        }
+        int rounds = 5;
+        double start = now_seconds();
+        for (int r = 0; r < rounds; r++) {
+            kernel(dst->words, a->words, b->words, dst->word_count);
+        }
+        double seconds = (now_seconds() - start) / rounds;
+        checks[t] = bitset_count(dst);
+        printf("  %-8s %-8s %8.2f ms  %6.2f GB/s\n", name, tables[t]->name, seconds * 1e3,
+               bytes / seconds / 1e9);
+    }
+    if (checks[0] != checks[1]) {
+        printf("  %s: scalar and vector results differ\n", name);
+        failed = 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long bits_arg = argc > 1 ? atol(argv[1]) : 100000000;
+    if (bits_arg < 64 || bits_arg > 4000000000L) {
+        fprintf(stderr, "Usage: %s [bits, 64 .. 4e9]\n", argv[0]);
+        return 1;
+    }
+    size_t bits = (size_t)bits_arg;
+    bitops_init();
+
+    printf("=== Bitset Benchmark ===\n");
+    printf("%zu bits (%.1f MB per set), vector kernels: %s\n\n", bits,
+           bits / 8.0 / (1 << 20), bitset_kernels()->name);
+
+    Bitset a, b, dst, sparse;
+    if (!bitset_init(&a, bits) || !bitset_init(&b, bits) || !bitset_init(&dst, bits) ||
+        !bitset_init(&sparse, bits)) {
+        return 1;
+    }
+    fill_random(&a);
+    fill_random(&b);
+
+    printf("Set operations (two random sets):\n");
+    bench_word_op("and", 0, &dst, &a, &b);
+    bench_word_op("or", 1, &dst, &a, &b);
+    bench_word_op("xor", 2, &dst, &a, &b);
+    bench_word_op("andnot", 3, &dst, &a, &b);
+    printf("\n");
+
+    printf("Counting set bits:\n");
+    double start = now_seconds();
+    size_t expected = count_bits_loop(&a);
+    double baseline = now_seconds() - start;
+    start = now_seconds();
+    size_t counted = bitset_count(&a);
+    double seconds = now_seconds() - start;
+    printf("  %-30s %8.2f ms\n", "per-bit CHECK_BIT loop", baseline * 1e3);
+    printf("  %-30s %8.2f ms  %6.1fx\n", "bitset_count", seconds * 1e3, baseline / seconds);
+    failed |= expected != counted;
+    printf("\n");
+
+    // A 1% filter: about one set bit per 100 rows, at least one
+    for (size_t i = 0; i <= bits / 100; i++) {
+        bitset_set(&sparse, next_random() % bits);
+    }
+    size_t sparse_count = bitset_count(&sparse);
+    uint32_t* rows = malloc(sparse_count * sizeof(uint32_t));
+    uint32_t* expected_rows = malloc(sparse_count * sizeof(uint32_t));
+    if (rows == NULL || expected_rows == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+    printf("Extracting %zu set rows (1%% density):\n", sparse_count);
+    start = now_seconds();
+    size_t loop_rows = to_array_loop(&sparse, expected_rows);
+    baseline = now_seconds() - start;
+    start = now_seconds();
+    size_t tz_rows = bitset_to_array(&sparse, rows, sparse_count);
+    seconds = now_seconds() - start;
+    printf("  %-30s %8.2f ms  %6.2f ns/row\n", "per-bit CHECK_BIT loop", baseline * 1e3,
+           baseline * 1e9 / sparse_count);
+    printf("  %-30s %8.2f ms  %6.2f ns/row  %6.1fx\n", "bitset_to_array (tzcnt)", seconds * 1e3,
+           seconds * 1e9 / sparse_count, baseline / seconds);
+    failed |= loop_rows != tz_rows;
+    for (size_t i = 0; i < tz_rows && !failed; i++) {
+        failed |= rows[i] != expected_rows[i];
+    }
+
+    start = now_seconds();
+    size_t walked = 0;
+    for (size_t pos = bitset_next(&sparse, 0); pos != BITSET_NONE; pos = bitset_next(&sparse, pos + 1)) {
+        failed |= pos != rows[walked];
+        walked++;
+    }
+    seconds = now_seconds() - start;
+    printf("  %-30s %8.2f ms  %6.2f ns/row\n", "bitset_next walk", seconds * 1e3, seconds * 1e9 / sparse_count);
+    failed |= walked != sparse_count;
+    printf("\n");
+
+    printf("Rank and select (1%% density):\n");
+    size_t scan_queries = 200, indexed_queries = 1000000;
+    start = now_seconds();
+    for (size_t q = 0; q < scan_queries; q++) {
+        size_t k = next_random() % sparse_count;
+        failed |= bitset_select(&sparse, k) != rows[k];
+        failed |= bitset_rank(&sparse, rows[k]) != k;
+    }
+    baseline = (now_seconds() - start) / scan_queries;
+    start = now_seconds();
+    if (!bitset_build_rank(&sparse)) return 1;
+    double build = now_seconds() - start;
+    start = now_seconds();
+    for (size_t q = 0; q < indexed_queries; q++) {
+        size_t k = next_random() % sparse_count;
+        failed |= bitset_select(&sparse, k) != rows[k];
+        failed |= bitset_rank(&sparse, rows[k]) != k;
+    }
+    seconds = (now_seconds() - start) / indexed_queries;
+    printf("  %-30s %10.1f ns/query pair\n", "word scan", baseline * 1e9);
+    printf("  %-30s %10.1f ns/query pair  (index built in %.1f ms, %zu KB)\n", "rank index", seconds * 1e9,
+           build * 1e3, sparse.rank_blocks * sizeof(uint64_t) / 1024);
+    printf("\n");
+
+    // Shrinking drops the upper rows for good; growing back and past the
+    // allocation brings only clear bits
+    size_t half = bits / 2 + 1;
+    size_t below_half = bitset_rank(&sparse, half);
+    failed |= !bitset_resize(&sparse, half) || bitset_count(&sparse) != below_half;
+    failed |= !bitset_resize(&sparse, bits * 2) || bitset_count(&sparse) != below_half;
+    failed |= bitset_next(&sparse, half) != BITSET_NONE || sparse.rank_index != NULL;
+    bitset_set(&sparse, bits * 2 - 1);
+    failed |= bitset_count(&sparse) != below_half + 1;
+
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+    bitset_destroy(&dst);
+    bitset_destroy(&sparse);
+    free(rows);
+    free(expected_rows);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
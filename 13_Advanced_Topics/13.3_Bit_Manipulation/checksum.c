@@ -0,0 +1,393 @@
+#include "checksum.h"
+#include "bitops.h"
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define CHECKSUM_X86 1
+#include <immintrin.h>
+#else
+#define CHECKSUM_X86 0
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define CHECKSUM_LITTLE_ENDIAN 1
+#else
+#define CHECKSUM_LITTLE_ENDIAN 0
+#endif
+
+#define CRC32C_POLY 0x82F63B78u     // Castagnoli polynomial, bit-reflected
+#define ADLER_BASE 65521u
+#define ADLER_NMAX 5552             // bytes before s2 could overflow 32 bits
+#define FLETCHER_MOD 65535u
+#define FLETCHER_BLOCK 359          // words, same bound for Fletcher-32
+
+// ---------------------------------------------------------------------
+// Portable kernels
+
+static uint32_t crc_tables[8][256];
+static bool crc_tables_ready = false;
+
+// Table t advances a byte through t further zero bytes, so eight lookups
+// consume eight bytes at once
+static void build_crc_tables(void) {
+    for (uint32_t n = 0; n < 256; n++) {
+        uint32_t crc = n;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (CRC32C_POLY & (0u - (crc & 1)));
+        }
+        crc_tables[0][n] = crc;
+    }
+    for (uint32_t n = 0; n < 256; n++) {
+        for (int t = 1; t < 8; t++) {
+            uint32_t previous = crc_tables[t - 1][n];
+            crc_tables[t][n] = (previous >> 8) ^ crc_tables[0][previous & 0xFF];
+        }
+    }
+    crc_tables_ready = true;
+}
+
+static uint32_t crc32c_slicing8(uint32_t crc, const unsigned char* p, size_t length) {
+    if (!crc_tables_ready) build_crc_tables();
+#if CHECKSUM_LITTLE_ENDIAN
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        word ^= crc;
+        crc = crc_tables[7][word & 0xFF] ^ crc_tables[6][(word >> 8) & 0xFF] ^
+              crc_tables[5][(word >> 16) & 0xFF] ^ crc_tables[4][(word >> 24) & 0xFF] ^
+              crc_tables[3][(word >> 32) & 0xFF] ^ crc_tables[2][(word >> 40) & 0xFF] ^
+              crc_tables[1][(word >> 48) & 0xFF] ^ crc_tables[0][word >> 56];
+        p += 8;
+        length -= 8;
+    }
+#endif
+    while (length--) {
+        crc = (crc >> 8) ^ crc_tables[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+static uint32_t adler32_scalar(uint32_t adler, const unsigned char* p, size_t length) {
+    uint32_t s1 = adler & 0xFFFF;
+    uint32_t s2 = adler >> 16;
+    while (length > 0) {
+        size_t n = length < ADLER_NMAX ? length : ADLER_NMAX;
+        length -= n;
+        while (n--) {
+            s1 += *p++;
+            s2 += s1;
+        }
+        s1 %= ADLER_BASE;
+        s2 %= ADLER_BASE;
+    }
+    return (s2 << 16) | s1;
+}
+
+static void fletcher32_scalar(uint32_t sums[2], const unsigned char* p, size_t words) {
+    uint32_t s1 = sums[0];
+    uint32_t s2 = sums[1];
+    while (words > 0) {
+        size_t n = words < FLETCHER_BLOCK ? words : FLETCHER_BLOCK;
+        words -= n;
+        for (; n > 0; n--, p += 2) {
+            s1 += p[0] | (uint32_t)p[1] << 8;
+            s2 += s1;
+        }
+        s1 %= FLETCHER_MOD;
+        s2 %= FLETCHER_MOD;
+    }
+    sums[0] = s1;
+    sums[1] = s2;
+}
+
+static uint8_t xor8_words(uint8_t value, const unsigned char* p, size_t length) {
+    uint64_t acc = 0;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        acc ^= word;
+        p += 8;
+        length -= 8;
+    }
+    acc ^= acc >> 32;
+    acc ^= acc >> 16;
+    acc ^= acc >> 8;
+    value ^= (uint8_t)acc;
+    while (length--) {
+        value ^= *p++;
+    }
+    return value;
+}
+
+static const ChecksumKernels portable_kernels = {
+    crc32c_slicing8, adler32_scalar, fletcher32_scalar, xor8_words,
+    "slicing-by-8", "scalar", "scalar", "64-bit words"
+};
+
+// ---------------------------------------------------------------------
+// x86 kernels
+
+#if CHECKSUM_X86
+#define CRC_LONG_BLOCK 2048         // bytes per stream in the 3-way loop
+#define CRC_SHORT_BLOCK 256
+
+// Multipliers that advance a CRC over 1 and 2 blocks of zero bytes
+static uint32_t crc_long_shift[2];
+static uint32_t crc_short_shift[2];
+
+// x^exponent mod P, bit-reflected
+static uint32_t crc_xpow(size_t exponent) {
+    uint32_t r = 0x80000000u;
+    while (exponent--) {
+        r = (r >> 1) ^ (CRC32C_POLY & (0u - (r & 1)));
+    }
+    return r;
+}
+
+// The carry-less product of two reflected 32-bit values, read as 64 bits
+// of data, is crc * k * x; CRC32 of that appends x^32 and reduces. So with
+// k = x^(8n - 33) the result is crc advanced over n zero bytes.
+static uint32_t crc_shift_constant(size_t bytes) {
+    return crc_xpow(8 * bytes - 33);
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_sse42(uint32_t crc, const unsigned char* p, size_t length) {
+    uint64_t crc64 = crc;
+    while (length >= 8) {
+        uint64_t word;
+        memcpy(&word, p, 8);
+        crc64 = _mm_crc32_u64(crc64, word);
+        p += 8;
+        length -= 8;
+    }
+    crc = (uint32_t)crc64;
+    while (length--) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc_shift(uint32_t crc, uint32_t k) {
+    __m128i product = _mm_clmulepi64_si128(_mm_cvtsi32_si128((int)crc), _mm_cvtsi32_si128((int)k), 0x00);
+    return (uint32_t)_mm_crc32_u64(0, (uint64_t)_mm_cvtsi128_si64(product));
+}
+
+// CRC32 has a latency of 3 cycles but a throughput of 1 per cycle, so one
+// dependency chain uses a third of the unit. Three adjacent blocks get
+// independent CRCs (the first seeded with the running CRC, the others with
+// 0); then crc(A B C) = shift(crc A, 2 blocks) ^ shift(crc B, 1 block) ^ crc C.
+__attribute__((target("sse4.2,pclmul")))
+static uint32_t crc32c_3way(uint32_t crc, const unsigned char* p, size_t length) {
+    for (int pass = 0; pass < 2; pass++) {
+        size_t block = pass == 0 ? CRC_LONG_BLOCK : CRC_SHORT_BLOCK;
+        const uint32_t* shift = pass == 0 ? crc_long_shift : crc_short_shift;
+        while (length >= 3 * block) {
+            uint64_t a = crc, b = 0, c = 0;
+            for (size_t i = 0; i < block; i += 8) {
+                uint64_t wa, wb, wc;
+                memcpy(&wa, p + i, 8);
+                memcpy(&wb, p + block + i, 8);
+                memcpy(&wc, p + 2 * block + i, 8);
+                a = _mm_crc32_u64(a, wa);
+                b = _mm_crc32_u64(b, wb);
+                c = _mm_crc32_u64(c, wc);
+            }
+            crc = crc_shift((uint32_t)a, shift[1]) ^ crc_shift((uint32_t)b, shift[0]) ^ (uint32_t)c;
+            p += 3 * block;
+            length -= 3 * block;
+        }
+    }
+    return crc32c_sse42(crc, p, length);
+}
+
+__attribute__((target("avx2")))
+static uint64_t sum_lanes(__m256i v) {
+    uint32_t lanes[8];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    uint64_t total = 0;
+    for (int i = 0; i < 8; i++) {
+        total += lanes[i];
+    }
+    return total;
+}
+
+// Per 32-byte block starting from s1 = S: s1 gains the byte sum and s2
+// gains 32 * S plus the bytes weighted 32..1. The lanes keep the byte
+// sums (SAD), the weighted sums (MADDUBS + MADD) and the running sum of
+// earlier s1 values, and are folded and reduced once per NMAX bytes.
+__attribute__((target("avx2")))
+static uint32_t adler32_avx2(uint32_t adler, const unsigned char* p, size_t length) {
+    const __m256i weights = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+                                             16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m256i ones = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    uint64_t s1 = adler & 0xFFFF;
+    uint64_t s2 = adler >> 16;
+
+    while (length >= 32) {
+        size_t blocks = length / 32;
+        if (blocks > ADLER_NMAX / 32) blocks = ADLER_NMAX / 32;
+        length -= blocks * 32;
+
+        __m256i byte_sums = zero, weighted = zero, prefix = zero;
+        for (size_t b = 0; b < blocks; b++) {
+            __m256i data = _mm256_loadu_si256((const __m256i*)p);
+            prefix = _mm256_add_epi32(prefix, byte_sums);
+            byte_sums = _mm256_add_epi32(byte_sums, _mm256_sad_epu8(data, zero));
+            weighted = _mm256_add_epi32(weighted, _mm256_madd_epi16(_mm256_maddubs_epi16(data, weights), ones));
+            p += 32;
+        }
+        s2 += blocks * 32 * s1 + 32 * sum_lanes(prefix) + sum_lanes(weighted);
+        s1 += sum_lanes(byte_sums);
+        s1 %= ADLER_BASE;
+        s2 %= ADLER_BASE;
+    }
+    return adler32_scalar((uint32_t)(s2 << 16 | s1), p, length);
+}
+
+// Same scheme on 16 words per step, widened to 32-bit lanes. 256 steps
+// keep the prefix lanes below 2^32.
+__attribute__((target("avx2")))
+static void fletcher32_avx2(uint32_t sums[2], const unsigned char* p, size_t words) {
+    const __m256i weights_low = _mm256_setr_epi32(16, 15, 14, 13, 12, 11, 10, 9);
+    const __m256i weights_high = _mm256_setr_epi32(8, 7, 6, 5, 4, 3, 2, 1);
+    uint64_t s1 = sums[0];
+    uint64_t s2 = sums[1];
+
+    while (words >= 16) {
+        size_t blocks = words / 16;
+        if (blocks > 256) blocks = 256;
+        words -= blocks * 16;
+
+        __m256i word_sums = _mm256_setzero_si256();
+        __m256i weighted = _mm256_setzero_si256();
+        __m256i prefix = _mm256_setzero_si256();
+        for (size_t b = 0; b < blocks; b++) {
+            __m256i low = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)p));
+            __m256i high = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(p + 16)));
+            prefix = _mm256_add_epi32(prefix, word_sums);
+            word_sums = _mm256_add_epi32(word_sums, _mm256_add_epi32(low, high));
+            weighted = _mm256_add_epi32(weighted, _mm256_add_epi32(_mm256_mullo_epi32(low, weights_low),
+                                                                   _mm256_mullo_epi32(high, weights_high)));
+            p += 32;
+        }
+        s2 += blocks * 16 * s1 + 16 * sum_lanes(prefix) + sum_lanes(weighted);
+        s1 += sum_lanes(word_sums);
+        s1 %= FLETCHER_MOD;
+        s2 %= FLETCHER_MOD;
+    }
+    sums[0] = (uint32_t)s1;
+    sums[1] = (uint32_t)s2;
+    fletcher32_scalar(sums, p, words);
+}
+
+__attribute__((target("avx2")))
+static uint8_t xor8_avx2(uint8_t value, const unsigned char* p, size_t length) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    while (length >= 64) {
+        acc0 = _mm256_xor_si256(acc0, _mm256_loadu_si256((const __m256i*)p));
+        acc1 = _mm256_xor_si256(acc1, _mm256_loadu_si256((const __m256i*)(p + 32)));
+        p += 64;
+        length -= 64;
+    }
+    unsigned char lanes[32];
+    _mm256_storeu_si256((__m256i*)lanes, _mm256_xor_si256(acc0, acc1));
+    value = xor8_words(value, lanes, sizeof(lanes));
+    return xor8_words(value, p, length);
+}
+#endif /* CHECKSUM_X86 */
+
+// ---------------------------------------------------------------------
+// Dispatch
+
+static ChecksumKernels native_kernels;
+static const ChecksumKernels* active_kernels = &portable_kernels;
+
+void checksum_init(void) {
+    ChecksumKernels kernels = portable_kernels;
+    bitops_init();
+    build_crc_tables();
+
+#if CHECKSUM_X86
+    const BitopsCpu* cpu = bitops_cpu();
+    if (cpu->sse42) {
+        kernels.crc32c = crc32c_sse42;
+        kernels.crc32c_name = "sse4.2 crc32";
+    }
+    if (cpu->sse42 && cpu->pclmul) {
+        crc_long_shift[0] = crc_shift_constant(CRC_LONG_BLOCK);
+        crc_long_shift[1] = crc_shift_constant(2 * CRC_LONG_BLOCK);
+        crc_short_shift[0] = crc_shift_constant(CRC_SHORT_BLOCK);
+        crc_short_shift[1] = crc_shift_constant(2 * CRC_SHORT_BLOCK);
+        kernels.crc32c = crc32c_3way;
+        kernels.crc32c_name = "crc32 x3 + pclmul";
+    }
+    if (cpu->avx2) {
+        kernels.adler32 = adler32_avx2;
+        kernels.fletcher32 = fletcher32_avx2;
+        kernels.xor8 = xor8_avx2;
+        kernels.adler32_name = "avx2";
+        kernels.fletcher32_name = "avx2";
+        kernels.xor8_name = "avx2";
+    }
+#endif
+
+    native_kernels = kernels;
+    active_kernels = &native_kernels;
+}
+
+const ChecksumKernels* checksum_kernels(void) {
+    return active_kernels;
+}
+
+const ChecksumKernels* checksum_portable_kernels(void) {
+    return &portable_kernels;
+}
+
+uint32_t checksum_crc32c(uint32_t crc, const void* data, size_t length) {
+    return ~active_kernels->crc32c(~crc, data, length);
+}
+
+uint32_t checksum_adler32(uint32_t adler, const void* data, size_t length) {
+    return active_kernels->adler32(adler, data, length);
+}
+
+uint8_t checksum_xor8(uint8_t value, const void* data, size_t length) {
+    return active_kernels->xor8(value, data, length);
+}
+
+void fletcher32_init(Fletcher32* state) {
+    state->sums[0] = 0;
+    state->sums[1] = 0;
+    state->has_pending = false;
+    state->pending = 0;
+}
+
+void fletcher32_update(Fletcher32* state, const void* data, size_t length) {
+    const unsigned char* p = data;
+    if (length == 0) return;
+    if (state->has_pending) {
+        unsigned char word[2] = {state->pending, p[0]};
+        fletcher32_scalar(state->sums, word, 1);
+        state->has_pending = false;
+        p++;
+        length--;
+    }
+    active_kernels->fletcher32(state->sums, p, length / 2);
+    if (length & 1) {
+        state->pending = p[length - 1];
+        state->has_pending = true;
+    }
+}
+
+uint32_t fletcher32_final(const Fletcher32* state) {
+    uint32_t sums[2] = {state->sums[0], state->sums[1]};
+    if (state->has_pending) {
+        unsigned char word[2] = {state->pending, 0};
+        fletcher32_scalar(sums, word, 1);
+    }
+    return sums[1] << 16 | sums[0];
+}
@@ -0,0 +1,56 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Checksums for persisted records, each with a portable kernel and an x86
+// kernel selected at runtime (same scheme as bitops.h):
+//   CRC32C    slicing-by-8 tables / SSE4.2 CRC32 on three interleaved
+//             streams, merged with PCLMULQDQ
+//   Adler-32  zlib's checksum, deferred modulo / AVX2
+//   Fletcher  Fletcher-32 over little-endian 16-bit words / AVX2
+//   XOR       one-byte XOR of all bytes (calculate_checksum) / AVX2
+// All of them are streaming: feed a buffer in pieces and the result equals
+// one call over the whole buffer.
+
+typedef struct {
+    uint32_t (*crc32c)(uint32_t crc, const unsigned char* data, size_t length);     // raw register
+    uint32_t (*adler32)(uint32_t adler, const unsigned char* data, size_t length);
+    void (*fletcher32)(uint32_t sums[2], const unsigned char* data, size_t words);  // reduced sums
+    uint8_t (*xor8)(uint8_t value, const unsigned char* data, size_t length);
+
+    const char* crc32c_name;
+    const char* adler32_name;
+    const char* fletcher32_name;
+    const char* xor8_name;
+} ChecksumKernels;
+
+// Calls bitops_init, builds the CRC tables and picks kernels
+void checksum_init(void);
+const ChecksumKernels* checksum_kernels(void);           // active table
+const ChecksumKernels* checksum_portable_kernels(void);
+
+// Start with crc = 0; pass the previous result to continue
+uint32_t checksum_crc32c(uint32_t crc, const void* data, size_t length);
+
+// Start with adler = 1
+uint32_t checksum_adler32(uint32_t adler, const void* data, size_t length);
+
+// Start with value = 0
+uint8_t checksum_xor8(uint8_t value, const void* data, size_t length);
+
+// Fletcher-32 works on 16-bit words, so a piece may end halfway through
+// one; the state carries the odd byte into the next update
+typedef struct {
+    uint32_t sums[2];
+    bool has_pending;
+    unsigned char pending;
+} Fletcher32;
+
+void fletcher32_init(Fletcher32* state);
+void fletcher32_update(Fletcher32* state, const void* data, size_t length);
+uint32_t fletcher32_final(const Fletcher32* state);     // a trailing odd byte counts as a word
+
+#endif /* CHECKSUM_H */
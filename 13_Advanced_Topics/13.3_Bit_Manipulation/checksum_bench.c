@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "checksum.h"
+
+// Throughput of each checksum over a buffer that fits in cache and one
+// that streams from memory, portable kernel vs the runtime-selected one.
+// The baseline is the byte loop calculate_checksum from the demo, and a
+// bitwise CRC32C is the reference every CRC result is checked against.
+// Streaming in random-sized pieces has to give the one-shot result.
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Legacy implementation from bit_manipulation_demo.c
+static unsigned char calculate_checksum(unsigned char data[], int length) {
+    unsigned char checksum = 0;
+    for (int i = 0; i < length; i++) {
+        checksum ^= data[i];
+    }
+    return checksum;
+}
+
+static uint32_t crc32c_bitwise(const unsigned char* data, size_t length) {
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int k = 0; k < 8; k++) {
+            crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static int failed = 0;
+
+static void report(const char* name, const char* kernel, double seconds, size_t bytes, double baseline) {
+    char label[64];
+    snprintf(label, sizeof(label), "%s (%s)", name, kernel);
+    printf("  %-34s %9.3f ms  %7.2f GB/s", label, seconds * 1e3, bytes / seconds / 1e9);
+    if (baseline > 0) printf("  %6.1fx", baseline / seconds);
+    printf("\n");
+}
+
+static void bench_size(const unsigned char* data, size_t bytes, int rounds) {
+    const ChecksumKernels* tables[2] = {checksum_portable_kernels(), checksum_kernels()};
+
+    double start = now_seconds();
+    volatile unsigned char legacy = 0;
+    for (int r = 0; r < rounds; r++) {
+        legacy ^= calculate_checksum((unsigned char*)data, (int)bytes);
+    }
+    double baseline = (now_seconds() - start) / rounds;
+    report("calculate_checksum", "byte loop", baseline, bytes, 0);
+
+    uint32_t results[4][2];
+    for (int t = 0; t < 2; t++) {
+        const ChecksumKernels* k = tables[t];
+        uint8_t x = 0;
+        start = now_seconds();
+        for (int r = 0; r < rounds; r++) x = k->xor8(0, data, bytes);
+        report("xor8", k->xor8_name, (now_seconds() - start) / rounds, bytes, baseline);
+        results[0][t] = x;
+        failed |= x != calculate_checksum((unsigned char*)data, (int)bytes);
+
+        uint32_t crc = 0;
+        start = now_seconds();
+        for (int r = 0; r < rounds; r++) crc = ~k->crc32c(0xFFFFFFFFu, data, bytes);
+        report("crc32c", k->crc32c_name, (now_seconds() - start) / rounds, bytes, 0);
+        results[1][t] = crc;
+
+        uint32_t adler = 0;
+        start = now_seconds();
+        for (int r = 0; r < rounds; r++) adler = k->adler32(1, data, bytes);
+        report("adler32", k->adler32_name, (now_seconds() - start) / rounds, bytes, 0);
+        results[2][t] = adler;
+
+        uint32_t sums[2] = {0, 0};
+        start = now_seconds();
+        for (int r = 0; r < rounds; r++) {
+            sums[0] = sums[1] = 0;
+            k->fletcher32(sums, data, bytes / 2);
+        }
+        report("fletcher32", k->fletcher32_name, (now_seconds() - start) / rounds, bytes, 0);
+        results[3][t] = sums[1] << 16 | sums[0];
+    }
+    for (int c = 0; c < 4; c++) {
+        failed |= results[c][0] != results[c][1];
+    }
+    (void)legacy;
+}
+
+// Every kernel against the reference on short and odd lengths and
+// misaligned starts, then the streaming APIs over random pieces
+static void check_kernels(const unsigned char* data, size_t bytes) {
+    const ChecksumKernels* tables[2] = {checksum_portable_kernels(), checksum_kernels()};
+    static const unsigned char vector[] = "123456789";
+    if (checksum_crc32c(0, vector, 9) != 0xE3069283u || checksum_adler32(1, vector, 9) != 0x091E01DEu) {
+        printf("  check vectors differ\n");
+        failed = 1;
+    }
+
+    for (int trial = 0; trial < 2000; trial++) {
+        size_t offset = next_random() % 64;
+        size_t length = trial < 1000 ? (size_t)trial : next_random() % 40000;
+        const unsigned char* p = data + offset;
+        uint32_t expected = crc32c_bitwise(p, length);
+        for (int t = 0; t < 2; t++) {
+            if (~tables[t]->crc32c(0xFFFFFFFFu, p, length) != expected) {
+                printf("  crc32c (%s) differs at length %zu\n", tables[t]->crc32c_name, length);
+                failed = 1;
+            }
+        }
+        uint32_t sums[2][2] = {{0, 0}, {0, 0}};
+        for (int t = 0; t < 2; t++) tables[t]->fletcher32(sums[t], p, length / 2);
+        failed |= tables[0]->adler32(1, p, length) != tables[1]->adler32(1, p, length);
+        failed |= sums[0][0] != sums[1][0] || sums[0][1] != sums[1][1];
+        failed |= tables[0]->xor8(0, p, length) != tables[1]->xor8(0, p, length);
+    }
+
+    uint32_t crc = 0, adler = 1;
+    uint8_t x = 0;
+    Fletcher32 fletcher, whole;
+    fletcher32_init(&fletcher);
+    fletcher32_init(&whole);
+    fletcher32_update(&whole, data, bytes);
+    for (size_t pos = 0; pos < bytes;) {
+        size_t piece = next_random() % 100000;
+        if (piece > bytes - pos) piece = bytes - pos;
+        crc = checksum_crc32c(crc, data + pos, piece);
+        adler = checksum_adler32(adler, data + pos, piece);
+        x = checksum_xor8(x, data + pos, piece);
+        fletcher32_update(&fletcher, data + pos, piece);
+        pos += piece;
+    }
+    if (crc != checksum_crc32c(0, data, bytes) || adler != checksum_adler32(1, data, bytes) ||
+        x != checksum_xor8(0, data, bytes) || fletcher32_final(&fletcher) != fletcher32_final(&whole)) {
+        printf("  streaming result differs from one-shot\n");
+        failed = 1;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    long mb_arg = argc > 1 ? atol(argv[1]) : 256;
+    if (mb_arg < 1 || mb_arg > 4096) {
+        fprintf(stderr, "Usage: %s [megabytes, 1 .. 4096]\n", argv[0]);
+        return 1;
+    }
+    size_t bytes = (size_t)mb_arg << 20;
+    checksum_init();
+
+    unsigned char* data = malloc(bytes + 64);
+    if (data == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+    for (size_t i = 0; i < bytes + 64; i += 8) {
+        uint64_t word = next_random();
+        for (int b = 0; b < 8; b++) data[i + b] = (unsigned char)(word >> (8 * b));
+    }
+
+    printf("=== Checksum Benchmark ===\n");
+    printf("Kernels: crc32c %s, adler32 %s, fletcher32 %s, xor8 %s\n\n", checksum_kernels()->crc32c_name,
+           checksum_kernels()->adler32_name, checksum_kernels()->fletcher32_name, checksum_kernels()->xor8_name);
+
+    printf("In cache (64 KB + 7, 2000 rounds):\n");
+    bench_size(data + 1, 65536 + 7, 2000);
+    printf("\n");
+
+    printf("Streaming (%ld MB):\n", mb_arg);
+    bench_size(data, bytes, 1);
+    printf("\n");
+
+    check_kernels(data, bytes < (16u << 20) ? bytes : (16u << 20));
+    free(data);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
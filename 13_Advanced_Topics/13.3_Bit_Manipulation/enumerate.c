@@ -0,0 +1,76 @@
+#include "enumerate.h"
+
+EnumRange enum_split(uint64_t total, int parts, int part) {
+    uint64_t base = total / (uint64_t)parts;
+    uint64_t extra = total % (uint64_t)parts;
+    uint64_t index = (uint64_t)part;
+    EnumRange range;
+    range.begin = index * base + (index < extra ? index : extra);
+    range.end = range.begin + base + (index < extra ? 1 : 0);
+    return range;
+}
+
+static uint64_t gcd(uint64_t a, uint64_t b) {
+    while (b != 0) {
+        uint64_t t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+// C(n, i + 1) = C(n, i) * (n - i) / (i + 1). Dividing out the common
+// factor first keeps the product within 64 bits up to C(63, 31).
+uint64_t enum_binomial(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    if (k > n - k) k = n - k;
+    uint64_t result = 1;
+    for (int i = 0; i < k; i++) {
+        uint64_t numerator = (uint64_t)(n - i);
+        uint64_t denominator = (uint64_t)(i + 1);
+        uint64_t g = gcd(result, denominator);
+        result = (result / g) * (numerator / (denominator / g));
+    }
+    return result;
+}
+
+// Each bit of the rank is the XOR of all higher bits of the code
+uint64_t gray_rank(uint64_t code) {
+    for (int shift = 1; shift < 64; shift <<= 1) {
+        code ^= code >> shift;
+    }
+    return code;
+}
+
+void gray_iter_init(GrayIterator* it, uint64_t begin, uint64_t end) {
+    it->index = begin;
+    it->end = end < begin ? begin : end;
+    it->code = gray_code(begin);
+    it->flipped = -1;
+}
+
+void subset_iter_init(SubsetIterator* it, uint64_t begin, uint64_t end) {
+    it->mask = begin;
+    it->end = end < begin ? begin : end;
+}
+
+// The mask at position r is the one whose bits c_k > ... > c_1 satisfy
+// r = C(c_k, k) + ... + C(c_1, 1) (combinatorial number system)
+bool combination_iter_init(CombinationIterator* it, int n, int k, uint64_t begin, uint64_t end) {
+    if (n < 0 || n > ENUMERATE_MAX_BITS || k < 0 || k > n) return false;
+    uint64_t total = enum_binomial(n, k);
+    if (begin > end || end > total) return false;
+
+    uint64_t rank = begin;
+    uint64_t mask = 0;
+    int c = n;
+    for (int i = k; i >= 1 && begin < total; i--) {
+        c--;
+        while (enum_binomial(c, i) > rank) c--;
+        mask |= 1ull << c;
+        rank -= enum_binomial(c, i);
+    }
+    it->mask = mask;
+    it->remaining = end - begin;
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef ENUMERATE_H
+#define ENUMERATE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming enumeration of n-bit masks (n up to ENUMERATE_MAX_BITS): Gray
+// codes, all subsets, and k-element subsets. Each iterator yields the next
+// mask in O(1) with no I/O, and can start at any position, so the space can
+// be cut into disjoint ranges with enum_split and handed to worker threads.
+#define ENUMERATE_MAX_BITS 63
+
+#if defined(__GNUC__)
+#define ENUM_CTZ64(x) __builtin_ctzll(x)
+#else
+static inline int enum_ctz64_loop(uint64_t x) {
+    int count = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        count++;
+    }
+    return count;
+}
+#define ENUM_CTZ64(x) enum_ctz64_loop(x)
+#endif
+
+typedef struct {
+    uint64_t begin;
+    uint64_t end;       // one past the last position
+} EnumRange;
+
+// Part `part` (from 0) of `parts` near-equal disjoint ranges over [0, total)
+EnumRange enum_split(uint64_t total, int parts, int part);
+
+// C(n, k), 0 when k > n; exact for n <= ENUMERATE_MAX_BITS
+uint64_t enum_binomial(int n, int k);
+
+// ---------------------------------------------------------------------
+// Gray codes: position i holds i ^ (i >> 1). Moving from position i - 1
+// to i flips bit ctz(i), so a consumer can update its state from the one
+// element that entered or left instead of rescanning the mask.
+
+typedef struct {
+    uint64_t index;     // position of the next code
+    uint64_t end;
+    uint64_t code;      // gray_code(index)
+    int flipped;        // bit that changed to reach code, -1 at the start
+} GrayIterator;
+
+static inline uint64_t gray_code(uint64_t index) {
+    return index ^ (index >> 1);
+}
+
+uint64_t gray_rank(uint64_t code);     // inverse of gray_code
+
+// Positions [begin, end), both at most 2^ENUMERATE_MAX_BITS
+void gray_iter_init(GrayIterator* it, uint64_t begin, uint64_t end);
+
+// flipped is the bit that differs from the previous code, or -1 for the
+// first code of the range
+static inline bool gray_iter_next(GrayIterator* it, uint64_t* code, int* flipped) {
+    if (it->index == it->end) return false;
+    *code = it->code;
+    *flipped = it->flipped;
+    it->index++;
+    it->flipped = ENUM_CTZ64(it->index);
+    it->code ^= 1ull << it->flipped;
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// All subsets in counting order: mask i is bit j set <=> element j present
+
+typedef struct {
+    uint64_t mask;
+    uint64_t end;
+} SubsetIterator;
+
+void subset_iter_init(SubsetIterator* it, uint64_t begin, uint64_t end);
+
+static inline bool subset_iter_next(SubsetIterator* it, uint64_t* mask) {
+    if (it->mask == it->end) return false;
+    *mask = it->mask++;
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// k-element subsets of n in increasing numeric order (Gosper's hack).
+// Positions run over [0, enum_binomial(n, k)); starting mid-way unranks the
+// position in O(n), after which each step is O(1).
+
+typedef struct {
+    uint64_t mask;
+    uint64_t remaining;
+} CombinationIterator;
+
+bool combination_iter_init(CombinationIterator* it, int n, int k, uint64_t begin, uint64_t end);
+
+static inline bool combination_iter_next(CombinationIterator* it, uint64_t* mask) {
+    if (it->remaining == 0) return false;
+    *mask = it->mask;
+    if (--it->remaining > 0) {
+        uint64_t low = it->mask & (0 - it->mask);
+        uint64_t ripple = it->mask + low;
+        it->mask = ripple | (((ripple ^ it->mask) >> 2) >> ENUM_CTZ64(it->mask));
+    }
+    return true;
+}
+
+#endif /* ENUMERATE_H */
@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "bitops.h"
+#include "enumerate.h"
+
+// Masks per second per core for the enumeration iterators, single-threaded
+// and split over worker threads with enum_split. Workloads:
+//   gray codes     sum of all n-bit Gray codes (a permutation of 0..2^n-1,
+//                  so the sum is known)
+//   subset sum     count the subsets of n weights hitting a target, against
+//                  the generate_subsets loop that rescans every mask
+//   combinations   all n/2-element subsets of n (Gosper's hack)
+// Every threaded result has to match the single-threaded one.
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef enum { GRAY_SUM, SUBSET_SUM, COMBINATIONS } Workload;
+
+static int64_t weights[ENUMERATE_MAX_BITS];
+static int64_t target;
+
+typedef struct {
+    Workload workload;
+    int n;
+    EnumRange range;
+    uint64_t result;
+} Job;
+
+// Legacy shape from generate_subsets: test every bit of every mask
+static uint64_t subset_sum_loop(int n, uint64_t begin, uint64_t end) {
+    uint64_t hits = 0;
+    for (uint64_t i = begin; i < end; i++) {
+        int64_t sum = 0;
+        for (int j = 0; j < n; j++) {
+            if (i & (1ull << j)) {
+                sum += weights[j];
+            }
+        }
+        hits += sum == target;
+    }
+    return hits;
+}
+
+static uint64_t gray_sum(EnumRange range) {
+    GrayIterator it;
+    uint64_t code, sum = 0;
+    int flipped;
+    gray_iter_init(&it, range.begin, range.end);
+    while (gray_iter_next(&it, &code, &flipped)) {
+        sum += code;
+    }
+    return sum;
+}
+
+// One weight enters or leaves per step
+static uint64_t subset_sum_gray(int n, EnumRange range) {
+    GrayIterator it;
+    uint64_t code, hits = 0;
+    int flipped;
+    int64_t sum = 0;
+    gray_iter_init(&it, range.begin, range.end);
+    while (gray_iter_next(&it, &code, &flipped)) {
+        if (flipped < 0) {
+            for (int j = 0; j < n; j++) {
+                if (code & (1ull << j)) sum += weights[j];
+            }
+        } else if (code & (1ull << flipped)) {
+            sum += weights[flipped];
+        } else {
+            sum -= weights[flipped];
+        }
+        hits += sum == target;
+    }
+    return hits;
+}
+
+static uint64_t combination_sum(int n, EnumRange range) {
+    CombinationIterator it;
+    uint64_t mask, sum = 0;
+    if (!combination_iter_init(&it, n, n / 2, range.begin, range.end)) return 0;
+    while (combination_iter_next(&it, &mask)) {
+        sum += mask;
+    }
+    return sum;
+}
+
+static void* run_job(void* arg) {
+    Job* job = arg;
+    switch (job->workload) {
+        case GRAY_SUM: job->result = gray_sum(job->range); break;
+        case SUBSET_SUM: job->result = subset_sum_gray(job->n, job->range); break;
+        case COMBINATIONS: job->result = combination_sum(job->n, job->range); break;
+    }
+    return NULL;
+}
+
+static int failed = 0;
+static int cores = 1;
+
+static void report(const char* name, int threads, uint64_t masks, double seconds, double baseline) {
+    int used = threads < cores ? threads : cores;
+    printf("  %-30s %2d thr %9.3f s  %8.1f M masks/s  %8.1f M/s/core", name, threads, seconds,
+           masks / seconds / 1e6, masks / seconds / 1e6 / used);
+    if (baseline > 0) printf("  %6.1fx", baseline / seconds);
+    printf("\n");
+}
+
+// Splits [0, total) into one range per thread and sums the partial results
+static uint64_t run_split(Workload workload, int n, uint64_t total, int threads, double* seconds) {
+    Job jobs[64];
+    pthread_t ids[64];
+    double start = now_seconds();
+    for (int t = 0; t < threads; t++) {
+        jobs[t].workload = workload;
+        jobs[t].n = n;
+        jobs[t].range = enum_split(total, threads, t);
+        if (pthread_create(&ids[t], NULL, run_job, &jobs[t]) != 0) {
+            fprintf(stderr, "pthread_create failed\n");
+            exit(1);
+        }
+    }
+    uint64_t result = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        result += jobs[t].result;
+    }
+    *seconds = now_seconds() - start;
+    return result;
+}
+
+// Returns the single-threaded result; checks it against expected if given
+static uint64_t bench_workload(const char* name, Workload workload, int n, uint64_t total, int threads,
+                               const uint64_t* expected) {
+    double single, parallel;
+    uint64_t one = run_split(workload, n, total, 1, &single);
+    report(name, 1, total, single, 0);
+    if (threads > 1) {
+        uint64_t many = run_split(workload, n, total, threads, &parallel);
+        report(name, threads, total, parallel, single);
+        failed |= one != many;
+    }
+    if (expected != NULL) failed |= one != *expected;
+    return one;
+}
+
+int main(int argc, char* argv[]) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    int n = argc > 1 ? atoi(argv[1]) : 30;
+    int threads = argc > 2 ? atoi(argv[2]) : (online > 1 ? (int)online : 4);
+    if (n < 8 || n > 40 || threads < 1 || threads > 64) {
+        fprintf(stderr, "Usage: %s [bits, 8 .. 40] [threads, 1 .. 64]\n", argv[0]);
+        return 1;
+    }
+    cores = online > 0 ? (int)online : 1;
+    bitops_init();
+    uint64_t total = 1ull << n;
+
+    for (int j = 0; j < n; j++) {
+        weights[j] = 1 + (int64_t)(next_random() % 1000);
+    }
+
+    printf("=== Enumeration Benchmark ===\n");
+    printf("n = %d (%llu masks), %d threads on %d cores\n\n", n, (unsigned long long)total, threads, cores);
+
+    // Sanity checks on the iterators themselves
+    GrayIterator gray;
+    uint64_t code, previous = 0;
+    int flipped;
+    gray_iter_init(&gray, 0, 1u << 16);
+    for (uint64_t i = 0; gray_iter_next(&gray, &code, &flipped); i++) {
+        failed |= code != (i ^ (i >> 1)) || gray_rank(code) != i;
+        failed |= i > 0 && (code ^ previous) != 1ull << flipped;
+        previous = code;
+    }
+    CombinationIterator combos;
+    uint64_t mask, combo_count = 0;
+    combination_iter_init(&combos, 20, 7, 0, enum_binomial(20, 7));
+    for (uint64_t m = 0; m < 1u << 20; m++) {
+        if (bitops_popcount64(m) != 7) continue;
+        failed |= !combination_iter_next(&combos, &mask) || mask != m;
+        combo_count++;
+    }
+    failed |= combination_iter_next(&combos, &mask) || combo_count != enum_binomial(20, 7);
+
+    printf("Gray codes:\n");
+    double start = now_seconds();
+    uint64_t legacy_sum = 0;
+    for (uint64_t i = 0; i < total; i++) {
+        legacy_sum += i ^ (i >> 1);
+    }
+    double baseline = now_seconds() - start;
+    report("closed form i ^ (i >> 1)", 1, total, baseline, 0);
+    uint64_t expected = (total / 2) * (total - 1);
+    failed |= legacy_sum != expected;
+    bench_workload("GrayIterator", GRAY_SUM, n, total, threads, &expected);
+    printf("\n");
+
+    int small = n < 24 ? n : 24;
+    uint64_t small_total = 1ull << small;
+    target = 0;
+    for (int j = 0; j < small; j++) target += weights[j];
+    target /= 2;
+    printf("Subset sum (count subsets of %d weights with sum %lld):\n", small, (long long)target);
+    start = now_seconds();
+    uint64_t hits = subset_sum_loop(small, 0, small_total);
+    baseline = now_seconds() - start;
+    report("per-mask bit loop", 1, small_total, baseline, 0);
+    double seconds;
+    uint64_t gray_hits = run_split(SUBSET_SUM, small, small_total, 1, &seconds);
+    report("Gray order, incremental", 1, small_total, seconds, baseline);
+    failed |= gray_hits != hits;
+
+    target = 0;
+    for (int j = 0; j < n; j++) target += weights[j];
+    target /= 2;
+    printf("Subset sum over all %d weights (sum %lld):\n", n, (long long)target);
+    uint64_t full_hits = bench_workload("Gray order, incremental", SUBSET_SUM, n, total, threads, NULL);
+    printf("  %llu subsets hit the target\n\n", (unsigned long long)full_hits);
+
+    uint64_t combo_total = enum_binomial(n, n / 2);
+    printf("Combinations (%d choose %d = %llu):\n", n, n / 2, (unsigned long long)combo_total);
+    bench_workload("CombinationIterator", COMBINATIONS, n, combo_total, threads, NULL);
+    printf("\n");
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "modarith.h"
+
+bool checked_mul_i64(int64_t a, int64_t b, int64_t* result) {
+#if defined(__GNUC__)
+    return !__builtin_mul_overflow(a, b, result);
+#else
+    if (a > 0) {
+        if (b > 0 ? a > INT64_MAX / b : b < INT64_MIN / a) return false;
+    } else if (a < 0) {
+        if (b > 0 ? a < INT64_MIN / b : b < INT64_MAX / a) return false;
+    }
+    *result = a * b;
+    return true;
+#endif
+}
+
+// Squares the base only while bits of the exponent remain, so the last
+// square (which is never used) cannot report a false overflow
+bool checked_pow_i64(int64_t base, uint64_t exp, int64_t* result) {
+    int64_t acc = 1;
+    while (exp > 0) {
+        if ((exp & 1) && !checked_mul_i64(acc, base, &acc)) return false;
+        exp >>= 1;
+        if (exp > 0 && !checked_mul_i64(base, base, &base)) return false;
+    }
+    *result = acc;
+    return true;
+}
+
+uint64_t mod_add(uint64_t a, uint64_t b, uint64_t m) {
+    a %= m;
+    b %= m;
+    return a >= m - b ? a - (m - b) : a + b;
+}
+
+uint64_t mod_mul(uint64_t a, uint64_t b, uint64_t m) {
+#if MODARITH_INT128
+    return (uint64_t)((modarith_u128)a * b % m);
+#else
+    // Long division of the 128-bit product, one bit of the low half at a time
+    uint64_t hi, lo;
+    mul_wide(a, b, &hi, &lo);
+    uint64_t r = hi % m;
+    for (int bit = 63; bit >= 0; bit--) {
+        uint64_t doubled = r << 1 | ((lo >> bit) & 1);
+        r = (r >= m - r || doubled >= m) ? doubled - m : doubled;
+    }
+    return r;
+#endif
+}
+
+uint64_t mod_pow(uint64_t base, uint64_t exp, uint64_t m) {
+    Montgomery64 ctx;
+    if (m == 1) return 0;
+    if (montgomery64_init(&ctx, m)) return montgomery64_pow(&ctx, base, exp);
+
+    uint64_t result = 1;
+    base %= m;
+    while (exp > 0) {
+        if (exp & 1) result = mod_mul(result, base, m);
+        base = mod_mul(base, base, m);
+        exp >>= 1;
+    }
+    return result;
+}
+
+// Newton's iteration x = x * (2 - n * x) doubles the number of correct low
+// bits; n * n == 1 mod 8 for odd n, so x = n starts with 3 of them
+bool montgomery64_init(Montgomery64* ctx, uint64_t n) {
+    if ((n & 1) == 0 || n == 1) return false;
+    uint64_t inv = n;
+    for (int i = 0; i < 5; i++) {
+        inv *= 2 - n * inv;
+    }
+    ctx->n = n;
+    ctx->n_inv = inv;
+    ctx->r_mod = (0 - n) % n;
+    ctx->r2_mod = mod_mul(ctx->r_mod, ctx->r_mod, n);
+    return true;
+}
+
+// REDC in its subtractive form: with m = lo * n^-1 the low words of T and
+// m * n are equal, so (T - m * n) / 2^64 = hi - high(m * n), which lies in
+// (-n, n). One compare and no carry out of 64 bits for any odd n.
+static inline uint64_t montgomery64_reduce(const Montgomery64* ctx, uint64_t hi, uint64_t lo) {
+    uint64_t m = lo * ctx->n_inv;
+    uint64_t mn_hi, mn_lo;
+    mul_wide(m, ctx->n, &mn_hi, &mn_lo);
+    uint64_t result = hi - mn_hi;
+    return hi < mn_hi ? result + ctx->n : result;
+}
+
+uint64_t montgomery64_mul(const Montgomery64* ctx, uint64_t a, uint64_t b) {
+    uint64_t hi, lo;
+    mul_wide(a, b, &hi, &lo);
+    return montgomery64_reduce(ctx, hi, lo);
+}
+
+uint64_t montgomery64_to(const Montgomery64* ctx, uint64_t x) {
+    return montgomery64_mul(ctx, x % ctx->n, ctx->r2_mod);
+}
+
+uint64_t montgomery64_from(const Montgomery64* ctx, uint64_t x) {
+    return montgomery64_reduce(ctx, 0, x);
+}
+
+uint64_t montgomery64_pow(const Montgomery64* ctx, uint64_t base, uint64_t exp) {
+    uint64_t x = montgomery64_to(ctx, base);
+    uint64_t result = ctx->r_mod;
+    // Random exponent bits mispredict; multiplying every step and
+    // selecting the result is cheaper than the branch
+    while (exp > 0) {
+        uint64_t product = montgomery64_mul(ctx, result, x);
+        result = (exp & 1) ? product : result;
+        x = montgomery64_mul(ctx, x, x);
+        exp >>= 1;
+    }
+    return montgomery64_from(ctx, result);
+}
@@ -0,0 +1,62 @@
+#ifndef MODARITH_H
+#define MODARITH_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Overflow-safe 64-bit modular arithmetic for hashing and sharding math.
+// Products go through a 128-bit intermediate: unsigned __int128 where the
+// compiler has it, otherwise a 32x32 split. Odd moduli can use Montgomery
+// multiplication, which replaces the 128/64 division by two multiplies.
+
+#if defined(__SIZEOF_INT128__)
+#define MODARITH_INT128 1
+__extension__ typedef unsigned __int128 modarith_u128;
+#else
+#define MODARITH_INT128 0
+#endif
+
+// Full 64x64 -> 128-bit product
+static inline void mul_wide(uint64_t a, uint64_t b, uint64_t* hi, uint64_t* lo) {
+#if MODARITH_INT128
+    modarith_u128 product = (modarith_u128)a * b;
+    *hi = (uint64_t)(product >> 64);
+    *lo = (uint64_t)product;
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    uint64_t ll = a_lo * b_lo, lh = a_lo * b_hi, hl = a_hi * b_lo, hh = a_hi * b_hi;
+    uint64_t middle = (ll >> 32) + (lh & 0xFFFFFFFFu) + (hl & 0xFFFFFFFFu);
+    *lo = (middle << 32) | (ll & 0xFFFFFFFFu);
+    *hi = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+#endif
+}
+
+// a * b overflows int64_t? Otherwise stores the product.
+bool checked_mul_i64(int64_t a, int64_t b, int64_t* result);
+
+// base^exp, false if the result does not fit in int64_t
+bool checked_pow_i64(int64_t base, uint64_t exp, int64_t* result);
+
+// (a * b) mod m and (a + b) mod m for any m >= 1, operands of any size
+uint64_t mod_mul(uint64_t a, uint64_t b, uint64_t m);
+uint64_t mod_add(uint64_t a, uint64_t b, uint64_t m);
+
+// base^exp mod m; Montgomery for odd m, mod_mul otherwise
+uint64_t mod_pow(uint64_t base, uint64_t exp, uint64_t m);
+
+// Montgomery form for an odd modulus n > 1: x is kept as x * 2^64 mod n
+typedef struct {
+    uint64_t n;
+    uint64_t n_inv;         // n^-1 mod 2^64
+    uint64_t r_mod;         // 2^64 mod n, i.e. 1 in Montgomery form
+    uint64_t r2_mod;        // 2^128 mod n, converts into Montgomery form
+} Montgomery64;
+
+bool montgomery64_init(Montgomery64* ctx, uint64_t n);     // false for even n or n == 1
+uint64_t montgomery64_to(const Montgomery64* ctx, uint64_t x);
+uint64_t montgomery64_from(const Montgomery64* ctx, uint64_t x);
+uint64_t montgomery64_mul(const Montgomery64* ctx, uint64_t a, uint64_t b);  // both in Montgomery form
+uint64_t montgomery64_pow(const Montgomery64* ctx, uint64_t base, uint64_t exp);  // plain in, plain out
+
+#endif /* MODARITH_H */
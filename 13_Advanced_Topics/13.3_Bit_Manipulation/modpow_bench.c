@@ -0,0 +1,285 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "modarith.h"
+#include "bigint.h"
+
+// Modular exponentiation throughput at 64, 128 and 1024 bits, plus big
+// multiplication (schoolbook vs Karatsuba). Baselines:
+//   64-bit    square-and-multiply with a double-and-add mulmod (no 128-bit
+//             products) and with an __int128 % per step
+//   128/1024  bigint square-and-multiply with a full product and a
+//             shift-and-subtract reduction per step
+// Results are cross-checked, and Fermat's little theorem is checked on
+// known primes (2^61 - 1, 2^64 - 59, 2^127 - 1).
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int failed = 0;
+
+// Overflow-safe without wide products: add a, doubled, for each bit of b
+static uint64_t mulmod_double_add(uint64_t a, uint64_t b, uint64_t m) {
+    uint64_t result = 0;
+    a %= m;
+    while (b > 0) {
+        if (b & 1) result = mod_add(result, a, m);
+        a = mod_add(a, a, m);
+        b >>= 1;
+    }
+    return result;
+}
+
+static uint64_t modpow_double_add(uint64_t base, uint64_t exp, uint64_t m) {
+    uint64_t result = 1 % m;
+    base %= m;
+    while (exp > 0) {
+        if (exp & 1) result = mulmod_double_add(result, base, m);
+        base = mulmod_double_add(base, base, m);
+        exp >>= 1;
+    }
+    return result;
+}
+
+static uint64_t modpow_mod_mul(uint64_t base, uint64_t exp, uint64_t m) {
+    uint64_t result = 1 % m;
+    base %= m;
+    while (exp > 0) {
+        if (exp & 1) result = mod_mul(result, base, m);
+        base = mod_mul(base, base, m);
+        exp >>= 1;
+    }
+    return result;
+}
+
+static void report(const char* name, size_t ops, double seconds, double baseline) {
+    printf("  %-34s %12.0f ops/s  %10.2f us/op", name, ops / seconds, seconds * 1e6 / ops);
+    if (baseline > 0) printf("  %7.1fx", baseline / seconds);
+    printf("\n");
+}
+
+static void bench_64(uint64_t m, const char* label, size_t ops) {
+    uint64_t* bases = malloc(ops * sizeof(uint64_t));
+    uint64_t* exps = malloc(ops * sizeof(uint64_t));
+    uint64_t* results = malloc(ops * sizeof(uint64_t));
+    if (bases == NULL || exps == NULL || results == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < ops; i++) {
+        bases[i] = next_random();
+        exps[i] = next_random();
+    }
+    printf("64-bit modulus %s:\n", label);
+
+    size_t slow_ops = ops / 50;
+    double start = now_seconds();
+    for (size_t i = 0; i < slow_ops; i++) {
+        results[i] = modpow_double_add(bases[i], exps[i], m);
+    }
+    double slow_seconds = now_seconds() - start;
+    report("double-and-add mulmod", slow_ops, slow_seconds, 0);
+    double baseline = slow_seconds / slow_ops * ops;      // scaled to ops
+
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t r = modpow_mod_mul(bases[i], exps[i], m);
+        failed |= i < slow_ops && r != results[i];
+        results[i] = r;
+    }
+    double seconds = now_seconds() - start;
+    report(MODARITH_INT128 ? "__int128 % mulmod" : "split-product mulmod", ops, seconds, baseline);
+
+    Montgomery64 ctx;
+    montgomery64_init(&ctx, m);
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        failed |= montgomery64_pow(&ctx, bases[i], exps[i]) != results[i];
+    }
+    seconds = now_seconds() - start;
+    report("Montgomery", ops, seconds, baseline);
+
+    for (size_t i = 0; i < 1000; i++) {
+        failed |= mod_pow(bases[i] % (m - 1) + 1, m - 1, m) != 1;
+    }
+    printf("\n");
+    free(bases);
+    free(exps);
+    free(results);
+}
+
+static void random_bigint(BigInt* x, size_t bits) {
+    size_t digits = (bits + 3) / 4;
+    char* hex = malloc(digits + 1);
+    if (hex == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < digits; i++) {
+        hex[i] = "0123456789abcdef"[next_random() & 15];
+    }
+    hex[digits] = '\0';
+    bigint_from_hex(x, hex);
+    free(hex);
+}
+
+static bool modpow_baseline(BigInt* r, const BigInt* base, const BigInt* exp, const BigInt* m) {
+    BigInt b, result;
+    bigint_init(&b);
+    bigint_init(&result);
+    bool ok = bigint_mod(&b, base, m) && bigint_set_u64(&result, 1);
+    for (size_t bit = bigint_bits(exp); bit-- > 0 && ok;) {
+        ok = bigint_mul_schoolbook(&result, &result, &result) && bigint_mod(&result, &result, m);
+        if (ok && bigint_test_bit(exp, bit)) {
+            ok = bigint_mul_schoolbook(&result, &result, &b) && bigint_mod(&result, &result, m);
+        }
+    }
+    ok = ok && bigint_copy(r, &result);
+    bigint_destroy(&b);
+    bigint_destroy(&result);
+    return ok;
+}
+
+static void bench_big(const char* label, const BigInt* m, size_t ops, size_t baseline_ops) {
+    BigInt base, exp, expected, actual;
+    bigint_init(&base);
+    bigint_init(&exp);
+    bigint_init(&expected);
+    bigint_init(&actual);
+    size_t bits = bigint_bits(m);
+    printf("%zu-bit modulus %s:\n", bits, label);
+
+    double baseline = 0, seconds = 0;
+    uint64_t saved = rng_state;
+    for (size_t i = 0; i < baseline_ops; i++) {
+        random_bigint(&base, bits);
+        random_bigint(&exp, bits);
+        double start = now_seconds();
+        modpow_baseline(&expected, &base, &exp, m);
+        baseline += now_seconds() - start;
+        start = now_seconds();
+        bigint_modpow(&actual, &base, &exp, m);
+        seconds += now_seconds() - start;
+        failed |= bigint_compare(&expected, &actual) != 0;
+    }
+    report("schoolbook + shift-subtract mod", baseline_ops, baseline, 0);
+    baseline /= baseline_ops;
+
+    rng_state = saved;
+    seconds = 0;
+    for (size_t i = 0; i < ops; i++) {
+        random_bigint(&base, bits);
+        random_bigint(&exp, bits);
+        double start = now_seconds();
+        bigint_modpow(&actual, &base, &exp, m);
+        seconds += now_seconds() - start;
+    }
+    report("Montgomery, 4-bit window", ops, seconds, baseline * ops);
+    printf("\n");
+    bigint_destroy(&base);
+    bigint_destroy(&exp);
+    bigint_destroy(&expected);
+    bigint_destroy(&actual);
+}
+
+static void bench_mul(size_t bits, int rounds) {
+    BigInt a, b, fast, slow;
+    bigint_init(&a);
+    bigint_init(&b);
+    bigint_init(&fast);
+    bigint_init(&slow);
+    random_bigint(&a, bits);
+    random_bigint(&b, bits);
+
+    double start = now_seconds();
+    for (int r = 0; r < rounds; r++) bigint_mul_schoolbook(&slow, &a, &b);
+    double baseline = (now_seconds() - start) / rounds;
+    start = now_seconds();
+    for (int r = 0; r < rounds; r++) bigint_mul(&fast, &a, &b);
+    double seconds = (now_seconds() - start) / rounds;
+    printf("  %7zu bits  schoolbook %10.3f ms  Karatsuba %10.3f ms  %6.1fx\n", bits, baseline * 1e3,
+           seconds * 1e3, baseline / seconds);
+    failed |= bigint_compare(&fast, &slow) != 0;
+    bigint_destroy(&a);
+    bigint_destroy(&b);
+    bigint_destroy(&fast);
+    bigint_destroy(&slow);
+}
+
+int main(int argc, char* argv[]) {
+    long ops_arg = argc > 1 ? atol(argv[1]) : 200000;
+    if (ops_arg < 1000 || ops_arg > 100000000) {
+        fprintf(stderr, "Usage: %s [64-bit operations, 1000 .. 1e8]\n", argv[0]);
+        return 1;
+    }
+    size_t ops = (size_t)ops_arg;
+
+    printf("=== Modular Exponentiation Benchmark ===\n");
+    printf("Random 64-bit exponents at 64 bits, full-width exponents above\n\n");
+    bench_64((1ull << 61) - 1, "2^61 - 1", ops);
+    bench_64(0xFFFFFFFFFFFFFFC5ull, "2^64 - 59", ops);
+
+    BigInt m, one, p_minus_1, result, three;
+    bigint_init(&m);
+    bigint_init(&one);
+    bigint_init(&p_minus_1);
+    bigint_init(&result);
+    bigint_init(&three);
+    bigint_from_hex(&m, "7fffffffffffffffffffffffffffffff");
+    bench_big("2^127 - 1", &m, ops / 20, ops / 2000);
+    bigint_set_u64(&one, 1);
+    bigint_set_u64(&three, 3);
+    bigint_sub(&p_minus_1, &m, &one);
+    bigint_modpow(&result, &three, &p_minus_1, &m);
+    failed |= bigint_compare(&result, &one) != 0;
+
+    random_bigint(&m, 1024);
+    m.limbs[0] |= 1;
+    m.limbs[m.size - 1] |= 1ull << 63;
+    bench_big("(random odd)", &m, ops / 1000 + 10, 3);
+
+    printf("Multiplication (equal-size operands):\n");
+    bench_mul(1024, 20000);
+    bench_mul(8192, 500);
+    bench_mul(65536, 10);
+    bench_mul(524288, 1);
+    printf("\n");
+
+    double start = now_seconds();
+    bigint_set_u64(&three, 3);
+    bigint_pow(&result, &three, 1000000);
+    double seconds = now_seconds() - start;
+    char* digits = bigint_to_decimal(&result);
+    printf("3^1000000: %zu digits, %.1f ms (decimal conversion not timed)\n\n",
+           digits != NULL ? strlen(digits) : 0, seconds * 1e3);
+    failed |= digits == NULL || strlen(digits) != 477122;
+    free(digits);
+
+    bigint_destroy(&m);
+    bigint_destroy(&one);
+    bigint_destroy(&p_minus_1);
+    bigint_destroy(&result);
+    bigint_destroy(&three);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
@@ -0,0 +1,875 @@
+#include "roaring.h"
+#include "bitops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__)
+#define CTZ64(x) __builtin_ctzll(x)
+#else
+static int ctz64_loop(uint64_t x) {
+    int count = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        count++;
+    }
+    return count;
+}
+#define CTZ64(x) ctz64_loop(x)
+#endif
+
+#define BITMAP_BYTES (ROARING_BITMAP_WORDS * sizeof(uint64_t))
+#define CHUNK_VALUES 65536u
+
+// ---------------------------------------------------------------------
+// Bitmap words
+
+static uint64_t* alloc_words(void) {
+    uint64_t* words = malloc(BITMAP_BYTES);
+    if (words == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+    }
+    return words;
+}
+
+// Sets bits first..last inclusive
+static void words_set_range(uint64_t* words, uint32_t first, uint32_t last) {
+    uint32_t first_word = first >> 6;
+    uint32_t last_word = last >> 6;
+    uint64_t first_mask = ~0ull << (first & 63);
+    uint64_t last_mask = ~0ull >> (63 - (last & 63));
+    if (first_word == last_word) {
+        words[first_word] |= first_mask & last_mask;
+        return;
+    }
+    words[first_word] |= first_mask;
+    for (uint32_t w = first_word + 1; w < last_word; w++) {
+        words[w] = ~0ull;
+    }
+    words[last_word] |= last_mask;
+}
+
+static uint32_t words_cardinality(const uint64_t* words) {
+    return (uint32_t)bitops_popcount_buffer(words, BITMAP_BYTES);
+}
+
+// A run starts at every set bit whose lower neighbour is clear
+static uint32_t words_count_runs(const uint64_t* words) {
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (uint32_t w = 0; w < ROARING_BITMAP_WORDS; w++) {
+        uint64_t word = words[w];
+        runs += (uint32_t)bitops_popcount64(word & ~((word << 1) | carry));
+        carry = word >> 63;
+    }
+    return runs;
+}
+
+// Next set (or, with invert, clear) bit at or after pos; CHUNK_VALUES if none
+static uint32_t words_next(const uint64_t* words, uint32_t pos, bool invert) {
+    if (pos >= CHUNK_VALUES) return CHUNK_VALUES;
+    uint64_t flip = invert ? ~0ull : 0;
+    uint32_t w = pos >> 6;
+    uint64_t word = (words[w] ^ flip) & (~0ull << (pos & 63));
+    while (word == 0) {
+        if (++w >= ROARING_BITMAP_WORDS) return CHUNK_VALUES;
+        word = words[w] ^ flip;
+    }
+    return w * 64 + (uint32_t)CTZ64(word);
+}
+
+// ---------------------------------------------------------------------
+// Containers
+
+static void container_free(RoaringContainer* c) {
+    free(c->values);
+    free(c->words);
+    free(c->runs);
+    memset(c, 0, sizeof(*c));
+}
+
+static bool container_init_array(RoaringContainer* c, uint32_t capacity) {
+    memset(c, 0, sizeof(*c));
+    c->type = ROARING_ARRAY;
+    if (capacity < 4) capacity = 4;
+    c->values = malloc(capacity * sizeof(uint16_t));
+    if (c->values == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    c->capacity = capacity;
+    return true;
+}
+
+static bool container_clone(RoaringContainer* dst, const RoaringContainer* src) {
+    *dst = *src;
+    dst->values = NULL;
+    dst->words = NULL;
+    dst->runs = NULL;
+    if (src->type == ROARING_BITMAP) {
+        dst->words = alloc_words();
+        if (dst->words == NULL) return false;
+        memcpy(dst->words, src->words, BITMAP_BYTES);
+        return true;
+    }
+    if (src->type == ROARING_ARRAY) {
+        dst->values = malloc(src->capacity * sizeof(uint16_t));
+        if (dst->values != NULL) {
+            memcpy(dst->values, src->values, src->count * sizeof(uint16_t));
+            return true;
+        }
+    } else {
+        dst->runs = malloc(src->capacity * sizeof(RoaringRun));
+        if (dst->runs != NULL) {
+            memcpy(dst->runs, src->runs, src->count * sizeof(RoaringRun));
+            return true;
+        }
+    }
+    fprintf(stderr, "Memory allocation failed\n");
+    return false;
+}
+
+// First index whose value is >= low
+static uint32_t array_lower_bound(const uint16_t* values, uint32_t begin, uint32_t count, uint16_t low) {
+    uint32_t end = count;
+    while (begin < end) {
+        uint32_t mid = begin + (end - begin) / 2;
+        if (values[mid] < low) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    return begin;
+}
+
+static bool container_contains(const RoaringContainer* c, uint16_t low) {
+    switch (c->type) {
+        case ROARING_ARRAY: {
+            uint32_t pos = array_lower_bound(c->values, 0, c->count, low);
+            return pos < c->count && c->values[pos] == low;
+        }
+        case ROARING_BITMAP:
+            return (c->words[low >> 6] >> (low & 63)) & 1;
+        case ROARING_RUN: {
+            // Last run starting at or before low
+            uint32_t begin = 0, end = c->count;
+            while (begin < end) {
+                uint32_t mid = begin + (end - begin) / 2;
+                if (c->runs[mid].start <= low) {
+                    begin = mid + 1;
+                } else {
+                    end = mid;
+                }
+            }
+            return begin > 0 && (uint32_t)(low - c->runs[begin - 1].start) <= c->runs[begin - 1].length;
+        }
+    }
+    return false;
+}
+
+static void container_fill_words(const RoaringContainer* c, uint64_t* words) {
+    if (c->type == ROARING_BITMAP) {
+        memcpy(words, c->words, BITMAP_BYTES);
+        return;
+    }
+    memset(words, 0, BITMAP_BYTES);
+    if (c->type == ROARING_ARRAY) {
+        for (uint32_t i = 0; i < c->count; i++) {
+            words[c->values[i] >> 6] |= 1ull << (c->values[i] & 63);
+        }
+    } else {
+        for (uint32_t i = 0; i < c->count; i++) {
+            words_set_range(words, c->runs[i].start, (uint32_t)c->runs[i].start + c->runs[i].length);
+        }
+    }
+}
+
+// Unpacks words into an array container (cardinality <= ROARING_ARRAY_MAX).
+// Bits are decoded four at a time for popcount(word) bits, so the loop
+// exit no longer depends on each bit; the array gets 3 slots of slack for
+// the overshoot.
+static bool container_array_from_words(RoaringContainer* c, const uint64_t* words, uint32_t cardinality) {
+    if (!container_init_array(c, cardinality + 3)) return false;
+    uint32_t count = 0;
+    for (uint32_t w = 0; w < ROARING_BITMAP_WORDS; w++) {
+        uint64_t word = words[w];
+        if (word == 0) continue;
+        uint16_t base = (uint16_t)(w * 64);
+        uint32_t bits = (uint32_t)bitops_popcount64(word);
+        for (uint32_t i = 0; i < bits; i += 4) {
+            c->values[count + i] = (uint16_t)(base + CTZ64(word));
+            word &= word - 1;
+            c->values[count + i + 1] = (uint16_t)(base + CTZ64(word | (1ull << 63)));
+            word &= word - 1;
+            c->values[count + i + 2] = (uint16_t)(base + CTZ64(word | (1ull << 63)));
+            word &= word - 1;
+            c->values[count + i + 3] = (uint16_t)(base + CTZ64(word | (1ull << 63)));
+            word &= word - 1;
+        }
+        count += bits;
+    }
+    c->count = count;
+    c->cardinality = count;
+    return true;
+}
+
+// Takes ownership of words: they stay as a bitmap above ROARING_ARRAY_MAX
+// values and are unpacked into an array otherwise
+static bool container_from_words(RoaringContainer* c, uint64_t* words, uint32_t cardinality) {
+    memset(c, 0, sizeof(*c));
+    if (cardinality > ROARING_ARRAY_MAX) {
+        c->type = ROARING_BITMAP;
+        c->words = words;
+        c->cardinality = cardinality;
+        return true;
+    }
+    bool ok = container_array_from_words(c, words, cardinality);
+    free(words);
+    return ok;
+}
+
+// Same for a scratch buffer the caller keeps: copied only if it stays a bitmap
+static bool container_from_scratch(RoaringContainer* c, const uint64_t* scratch) {
+    uint32_t cardinality = words_cardinality(scratch);
+    memset(c, 0, sizeof(*c));
+    if (cardinality <= ROARING_ARRAY_MAX) {
+        return container_array_from_words(c, scratch, cardinality);
+    }
+    uint64_t* words = alloc_words();
+    if (words == NULL) return false;
+    memcpy(words, scratch, BITMAP_BYTES);
+    return container_from_words(c, words, cardinality);
+}
+
+static bool container_runs_from_words(RoaringContainer* c, const uint64_t* words, uint32_t run_count,
+                                      uint32_t cardinality) {
+    RoaringRun* runs = malloc((run_count > 0 ? run_count : 1) * sizeof(RoaringRun));
+    if (runs == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    uint32_t count = 0;
+    uint32_t start = words_next(words, 0, false);
+    while (start < CHUNK_VALUES) {
+        uint32_t end = words_next(words, start, true);
+        runs[count].start = (uint16_t)start;
+        runs[count].length = (uint16_t)(end - 1 - start);
+        count++;
+        start = words_next(words, end, false);
+    }
+    memset(c, 0, sizeof(*c));
+    c->type = ROARING_RUN;
+    c->runs = runs;
+    c->count = count;
+    c->capacity = run_count > 0 ? run_count : 1;
+    c->cardinality = cardinality;
+    return true;
+}
+
+// Re-encodes a run container as an array or bitmap
+static bool container_unpack_runs(RoaringContainer* c) {
+    uint64_t* words = alloc_words();
+    if (words == NULL) return false;
+    container_fill_words(c, words);
+    uint32_t cardinality = c->cardinality;
+    container_free(c);
+    return container_from_words(c, words, cardinality);
+}
+
+static bool container_add(RoaringContainer* c, uint16_t low) {
+    if (c->type == ROARING_RUN) {
+        if (container_contains(c, low)) return true;
+        if (!container_unpack_runs(c)) return false;
+    }
+
+    if (c->type == ROARING_BITMAP) {
+        uint64_t bit = 1ull << (low & 63);
+        if (!(c->words[low >> 6] & bit)) {
+            c->words[low >> 6] |= bit;
+            c->cardinality++;
+        }
+        return true;
+    }
+
+    uint32_t pos = array_lower_bound(c->values, 0, c->count, low);
+    if (pos < c->count && c->values[pos] == low) return true;
+
+    if (c->count == ROARING_ARRAY_MAX) {
+        uint64_t* words = alloc_words();
+        if (words == NULL) return false;
+        container_fill_words(c, words);
+        container_free(c);
+        c->type = ROARING_BITMAP;
+        c->words = words;
+        c->cardinality = ROARING_ARRAY_MAX + 1;
+        words[low >> 6] |= 1ull << (low & 63);
+        return true;
+    }
+    if (c->count == c->capacity) {
+        uint32_t capacity = c->capacity * 2;
+        if (capacity > ROARING_ARRAY_MAX) capacity = ROARING_ARRAY_MAX;
+        uint16_t* values = realloc(c->values, capacity * sizeof(uint16_t));
+        if (values == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return false;
+        }
+        c->values = values;
+        c->capacity = capacity;
+    }
+    memmove(c->values + pos + 1, c->values + pos, (c->count - pos) * sizeof(uint16_t));
+    c->values[pos] = low;
+    c->count++;
+    c->cardinality++;
+    return true;
+}
+
+static uint32_t container_count_runs(const RoaringContainer* c) {
+    switch (c->type) {
+        case ROARING_ARRAY: {
+            uint32_t runs = c->count > 0 ? 1 : 0;
+            for (uint32_t i = 1; i < c->count; i++) {
+                runs += c->values[i] != c->values[i - 1] + 1;
+            }
+            return runs;
+        }
+        case ROARING_BITMAP:
+            return words_count_runs(c->words);
+        case ROARING_RUN:
+            return c->count;
+    }
+    return 0;
+}
+
+// Array result of keeping the values of a that are (or are not) in other
+static bool array_filter(const RoaringContainer* a, const RoaringContainer* other, bool keep_present,
+                         RoaringContainer* out) {
+    if (!container_init_array(out, a->count)) return false;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < a->count; i++) {
+        if (container_contains(other, a->values[i]) == keep_present) {
+            out->values[count++] = a->values[i];
+        }
+    }
+    out->count = count;
+    out->cardinality = count;
+    return true;
+}
+
+// Merge when the arrays are of similar size; when one is much smaller,
+// binary-search its values in the larger one with a moving lower bound
+static bool array_intersect(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out) {
+    if (a->count > b->count) {
+        const RoaringContainer* temp = a;
+        a = b;
+        b = temp;
+    }
+    if (!container_init_array(out, a->count)) return false;
+    uint32_t count = 0;
+
+    if ((uint64_t)a->count * 32 < b->count) {
+        uint32_t lower = 0;
+        for (uint32_t i = 0; i < a->count && lower < b->count; i++) {
+            lower = array_lower_bound(b->values, lower, b->count, a->values[i]);
+            if (lower < b->count && b->values[lower] == a->values[i]) {
+                out->values[count++] = a->values[i];
+            }
+        }
+    } else {
+        uint32_t i = 0, j = 0;
+        while (i < a->count && j < b->count) {
+            uint16_t x = a->values[i], y = b->values[j];
+            if (x == y) out->values[count++] = x;
+            i += x <= y;
+            j += y <= x;
+        }
+    }
+    out->count = count;
+    out->cardinality = count;
+    return true;
+}
+
+static bool array_union(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out) {
+    if (!container_init_array(out, a->count + b->count)) return false;
+    uint32_t i = 0, j = 0, count = 0;
+    while (i < a->count && j < b->count) {
+        uint16_t x = a->values[i], y = b->values[j];
+        out->values[count++] = x <= y ? x : y;
+        i += x <= y;
+        j += y <= x;
+    }
+    while (i < a->count) out->values[count++] = a->values[i++];
+    while (j < b->count) out->values[count++] = b->values[j++];
+    out->count = count;
+    out->cardinality = count;
+    return true;
+}
+
+static bool container_and(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out) {
+    if (a->type == ROARING_ARRAY && b->type == ROARING_ARRAY) return array_intersect(a, b, out);
+    if (a->type == ROARING_ARRAY) return array_filter(a, b, true, out);
+    if (b->type == ROARING_ARRAY) return array_filter(b, a, true, out);
+
+    // Both dense: combine in scratch space, allocate only for the result
+    uint64_t scratch[ROARING_BITMAP_WORDS];
+    uint64_t other[ROARING_BITMAP_WORDS];
+    const uint64_t* a_words = a->words;
+    const uint64_t* b_words = b->words;
+    if (a->type != ROARING_BITMAP) {
+        container_fill_words(a, scratch);
+        a_words = scratch;
+    }
+    if (b->type != ROARING_BITMAP) {
+        container_fill_words(b, other);
+        b_words = other;
+    }
+    bitset_kernels()->and_words(scratch, a_words, b_words, ROARING_BITMAP_WORDS);
+    return container_from_scratch(out, scratch);
+}
+
+static bool container_or(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out) {
+    if (a->type == ROARING_ARRAY && b->type == ROARING_ARRAY &&
+        a->cardinality + b->cardinality <= ROARING_ARRAY_MAX) {
+        return array_union(a, b, out);
+    }
+
+    uint64_t* words = alloc_words();
+    if (words == NULL) return false;
+    container_fill_words(a, words);
+    switch (b->type) {
+        case ROARING_ARRAY:
+            for (uint32_t i = 0; i < b->count; i++) {
+                words[b->values[i] >> 6] |= 1ull << (b->values[i] & 63);
+            }
+            break;
+        case ROARING_BITMAP:
+            bitset_kernels()->or_words(words, words, b->words, ROARING_BITMAP_WORDS);
+            break;
+        case ROARING_RUN:
+            for (uint32_t i = 0; i < b->count; i++) {
+                words_set_range(words, b->runs[i].start, (uint32_t)b->runs[i].start + b->runs[i].length);
+            }
+            break;
+    }
+    return container_from_words(out, words, words_cardinality(words));
+}
+
+static bool array_difference(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out) {
+    if (!container_init_array(out, a->count)) return false;
+    uint32_t i = 0, j = 0, count = 0;
+    while (i < a->count && j < b->count) {
+        uint16_t x = a->values[i], y = b->values[j];
+        if (x < y) out->values[count++] = x;
+        i += x <= y;
+        j += y <= x;
+    }
+    while (i < a->count) out->values[count++] = a->values[i++];
+    out->count = count;
+    out->cardinality = count;
+    return true;
+}
+
+static bool container_andnot(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out) {
+    if (a->type == ROARING_ARRAY && b->type == ROARING_ARRAY) return array_difference(a, b, out);
+    if (a->type == ROARING_ARRAY) return array_filter(a, b, false, out);
+
+    uint64_t scratch[ROARING_BITMAP_WORDS];
+    container_fill_words(a, scratch);
+    if (b->type == ROARING_ARRAY) {
+        for (uint32_t i = 0; i < b->count; i++) {
+            scratch[b->values[i] >> 6] &= ~(1ull << (b->values[i] & 63));
+        }
+    } else if (b->type == ROARING_BITMAP) {
+        bitset_kernels()->andnot_words(scratch, scratch, b->words, ROARING_BITMAP_WORDS);
+    } else {
+        uint64_t other[ROARING_BITMAP_WORDS];
+        container_fill_words(b, other);
+        bitset_kernels()->andnot_words(scratch, scratch, other, ROARING_BITMAP_WORDS);
+    }
+    return container_from_scratch(out, scratch);
+}
+
+// Values in exactly one of the two arrays
+static bool array_symmetric_difference(const RoaringContainer* a, const RoaringContainer* b,
+                                       RoaringContainer* out) {
+    if (!container_init_array(out, a->count + b->count)) return false;
+    uint32_t i = 0, j = 0, count = 0;
+    while (i < a->count && j < b->count) {
+        uint16_t x = a->values[i], y = b->values[j];
+        if (x != y) out->values[count++] = x < y ? x : y;
+        i += x <= y;
+        j += y <= x;
+    }
+    while (i < a->count) out->values[count++] = a->values[i++];
+    while (j < b->count) out->values[count++] = b->values[j++];
+    out->count = count;
+    out->cardinality = count;
+    return true;
+}
+
+static bool container_xor(const RoaringContainer* a, const RoaringContainer* b, RoaringContainer* out) {
+    if (a->type == ROARING_ARRAY && b->type == ROARING_ARRAY &&
+        a->cardinality + b->cardinality <= ROARING_ARRAY_MAX) {
+        return array_symmetric_difference(a, b, out);
+    }
+
+    uint64_t scratch[ROARING_BITMAP_WORDS];
+    container_fill_words(a, scratch);
+    if (b->type == ROARING_ARRAY) {
+        for (uint32_t i = 0; i < b->count; i++) {
+            scratch[b->values[i] >> 6] ^= 1ull << (b->values[i] & 63);
+        }
+    } else if (b->type == ROARING_BITMAP) {
+        bitset_kernels()->xor_words(scratch, scratch, b->words, ROARING_BITMAP_WORDS);
+    } else {
+        uint64_t other[ROARING_BITMAP_WORDS];
+        container_fill_words(b, other);
+        bitset_kernels()->xor_words(scratch, scratch, other, ROARING_BITMAP_WORDS);
+    }
+    return container_from_scratch(out, scratch);
+}
+
+// ---------------------------------------------------------------------
+// Key index
+
+// Index of the first key >= key; appends in increasing order hit the
+// fast path
+static size_t find_key(const Roaring* r, uint16_t key, bool* found) {
+    size_t begin = 0, end = r->size;
+    if (end > 0 && r->keys[end - 1] < key) {
+        begin = end;
+    }
+    while (begin < end) {
+        size_t mid = begin + (end - begin) / 2;
+        if (r->keys[mid] < key) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
+    }
+    *found = begin < r->size && r->keys[begin] == key;
+    return begin;
+}
+
+// Moves c into the bitmap at index; on failure c is freed
+static bool insert_container(Roaring* r, size_t index, uint16_t key, RoaringContainer* c) {
+    if (r->size == r->capacity) {
+        size_t capacity = r->capacity > 0 ? r->capacity * 2 : 16;
+        uint16_t* keys = realloc(r->keys, capacity * sizeof(uint16_t));
+        if (keys != NULL) r->keys = keys;
+        RoaringContainer* containers = realloc(r->containers, capacity * sizeof(RoaringContainer));
+        if (containers != NULL) r->containers = containers;
+        if (keys == NULL || containers == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            container_free(c);
+            return false;
+        }
+        r->capacity = capacity;
+    }
+    memmove(r->keys + index + 1, r->keys + index, (r->size - index) * sizeof(uint16_t));
+    memmove(r->containers + index + 1, r->containers + index,
+            (r->size - index) * sizeof(RoaringContainer));
+    r->keys[index] = key;
+    r->containers[index] = *c;
+    r->size++;
+    return true;
+}
+
+// Appends a result container, dropping it if empty
+static bool append_result(Roaring* r, uint16_t key, RoaringContainer* c) {
+    if (c->cardinality == 0) {
+        container_free(c);
+        return true;
+    }
+    return insert_container(r, r->size, key, c);
+}
+
+// ---------------------------------------------------------------------
+// Roaring
+
+void roaring_init(Roaring* r) {
+    r->keys = NULL;
+    r->containers = NULL;
+    r->size = 0;
+    r->capacity = 0;
+}
+
+void roaring_clear(Roaring* r) {
+    for (size_t i = 0; i < r->size; i++) {
+        container_free(&r->containers[i]);
+    }
+    r->size = 0;
+}
+
+void roaring_destroy(Roaring* r) {
+    roaring_clear(r);
+    free(r->keys);
+    free(r->containers);
+    roaring_init(r);
+}
+
+bool roaring_add(Roaring* r, uint32_t value) {
+    uint16_t key = (uint16_t)(value >> 16);
+    bool found;
+    size_t index = find_key(r, key, &found);
+    if (!found) {
+        RoaringContainer c;
+        if (!container_init_array(&c, 4) || !insert_container(r, index, key, &c)) {
+            return false;
+        }
+    }
+    return container_add(&r->containers[index], (uint16_t)value);
+}
+
+bool roaring_add_range(Roaring* r, uint64_t start, uint64_t end) {
+    if (end > (1ull << 32)) end = 1ull << 32;
+    if (start >= end) return true;
+
+    uint64_t first_chunk = start >> 16;
+    uint64_t last_chunk = (end - 1) >> 16;
+    for (uint64_t chunk = first_chunk; chunk <= last_chunk; chunk++) {
+        uint32_t first = chunk == first_chunk ? (uint32_t)(start & 0xFFFF) : 0;
+        uint32_t last = chunk == last_chunk ? (uint32_t)((end - 1) & 0xFFFF) : 0xFFFF;
+        uint16_t key = (uint16_t)chunk;
+        bool found;
+        size_t index = find_key(r, key, &found);
+
+        if (!found) {
+            // A new group is a single run
+            RoaringContainer c;
+            memset(&c, 0, sizeof(c));
+            c.type = ROARING_RUN;
+            c.runs = malloc(sizeof(RoaringRun));
+            if (c.runs == NULL) {
+                fprintf(stderr, "Memory allocation failed\n");
+                return false;
+            }
+            c.runs[0].start = (uint16_t)first;
+            c.runs[0].length = (uint16_t)(last - first);
+            c.count = 1;
+            c.capacity = 1;
+            c.cardinality = last - first + 1;
+            if (!insert_container(r, index, key, &c)) return false;
+            continue;
+        }
+
+        RoaringContainer* c = &r->containers[index];
+        uint64_t* words = alloc_words();
+        if (words == NULL) return false;
+        container_fill_words(c, words);
+        words_set_range(words, first, last);
+        container_free(c);
+        if (!container_from_words(c, words, words_cardinality(words))) return false;
+    }
+    return true;
+}
+
+bool roaring_contains(const Roaring* r, uint32_t value) {
+    bool found;
+    size_t index = find_key(r, (uint16_t)(value >> 16), &found);
+    return found && container_contains(&r->containers[index], (uint16_t)value);
+}
+
+uint64_t roaring_cardinality(const Roaring* r) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < r->size; i++) {
+        total += r->containers[i].cardinality;
+    }
+    return total;
+}
+
+bool roaring_and(Roaring* dst, const Roaring* a, const Roaring* b) {
+    roaring_clear(dst);
+    size_t i = 0, j = 0;
+    while (i < a->size && j < b->size) {
+        if (a->keys[i] < b->keys[j]) {
+            i++;
+        } else if (b->keys[j] < a->keys[i]) {
+            j++;
+        } else {
+            RoaringContainer c;
+            if (!container_and(&a->containers[i], &b->containers[j], &c) ||
+                !append_result(dst, a->keys[i], &c)) {
+                return false;
+            }
+            i++;
+            j++;
+        }
+    }
+    return true;
+}
+
+bool roaring_or(Roaring* dst, const Roaring* a, const Roaring* b) {
+    roaring_clear(dst);
+    size_t i = 0, j = 0;
+    while (i < a->size || j < b->size) {
+        RoaringContainer c;
+        uint16_t key;
+        bool ok;
+        if (j >= b->size || (i < a->size && a->keys[i] < b->keys[j])) {
+            key = a->keys[i];
+            ok = container_clone(&c, &a->containers[i++]);
+        } else if (i >= a->size || b->keys[j] < a->keys[i]) {
+            key = b->keys[j];
+            ok = container_clone(&c, &b->containers[j++]);
+        } else {
+            key = a->keys[i];
+            ok = container_or(&a->containers[i++], &b->containers[j++], &c);
+        }
+        if (!ok || !append_result(dst, key, &c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Same walk as or; groups present on both sides may cancel out entirely
+bool roaring_xor(Roaring* dst, const Roaring* a, const Roaring* b) {
+    roaring_clear(dst);
+    size_t i = 0, j = 0;
+    while (i < a->size || j < b->size) {
+        RoaringContainer c;
+        uint16_t key;
+        bool ok;
+        if (j >= b->size || (i < a->size && a->keys[i] < b->keys[j])) {
+            key = a->keys[i];
+            ok = container_clone(&c, &a->containers[i++]);
+        } else if (i >= a->size || b->keys[j] < a->keys[i]) {
+            key = b->keys[j];
+            ok = container_clone(&c, &b->containers[j++]);
+        } else {
+            key = a->keys[i];
+            ok = container_xor(&a->containers[i++], &b->containers[j++], &c);
+        }
+        if (!ok || !append_result(dst, key, &c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool roaring_andnot(Roaring* dst, const Roaring* a, const Roaring* b) {
+    roaring_clear(dst);
+    size_t j = 0;
+    for (size_t i = 0; i < a->size; i++) {
+        while (j < b->size && b->keys[j] < a->keys[i]) {
+            j++;
+        }
+        RoaringContainer c;
+        bool ok;
+        if (j < b->size && b->keys[j] == a->keys[i]) {
+            ok = container_andnot(&a->containers[i], &b->containers[j], &c);
+        } else {
+            ok = container_clone(&c, &a->containers[i]);
+        }
+        if (!ok || !append_result(dst, a->keys[i], &c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool roaring_run_optimize(Roaring* r) {
+    for (size_t i = 0; i < r->size; i++) {
+        RoaringContainer* c = &r->containers[i];
+        uint32_t run_count = container_count_runs(c);
+        size_t run_bytes = (size_t)run_count * sizeof(RoaringRun);
+        size_t other_bytes = c->cardinality <= ROARING_ARRAY_MAX
+                                 ? c->cardinality * sizeof(uint16_t) : BITMAP_BYTES;
+
+        if (run_bytes < other_bytes && c->type != ROARING_RUN) {
+            uint64_t* words = alloc_words();
+            if (words == NULL) return false;
+            container_fill_words(c, words);
+            RoaringContainer runs;
+            bool ok = container_runs_from_words(&runs, words, run_count, c->cardinality);
+            free(words);
+            if (!ok) return false;
+            container_free(c);
+            *c = runs;
+        } else if (run_bytes >= other_bytes && c->type == ROARING_RUN) {
+            if (!container_unpack_runs(c)) return false;
+        }
+    }
+    return true;
+}
+
+size_t roaring_to_array(const Roaring* r, uint32_t* out) {
+    size_t count = 0;
+    for (size_t i = 0; i < r->size; i++) {
+        const RoaringContainer* c = &r->containers[i];
+        uint32_t high = (uint32_t)r->keys[i] << 16;
+        switch (c->type) {
+            case ROARING_ARRAY:
+                for (uint32_t k = 0; k < c->count; k++) {
+                    out[count++] = high | c->values[k];
+                }
+                break;
+            case ROARING_BITMAP:
+                for (uint32_t w = 0; w < ROARING_BITMAP_WORDS; w++) {
+                    uint64_t word = c->words[w];
+                    while (word != 0) {
+                        out[count++] = high | (w * 64 + (uint32_t)CTZ64(word));
+                        word &= word - 1;
+                    }
+                }
+                break;
+            case ROARING_RUN:
+                for (uint32_t k = 0; k < c->count; k++) {
+                    uint32_t value = high | c->runs[k].start;
+                    for (uint32_t n = 0; n <= c->runs[k].length; n++) {
+                        out[count++] = value + n;
+                    }
+                }
+                break;
+        }
+    }
+    return count;
+}
+
+bool roaring_from_bitset(Roaring* r, const Bitset* bs) {
+    roaring_clear(r);
+    size_t chunks = (bs->word_count + ROARING_BITMAP_WORDS - 1) / ROARING_BITMAP_WORDS;
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        size_t first = chunk * ROARING_BITMAP_WORDS;
+        size_t words_in_chunk = bs->word_count - first;
+        if (words_in_chunk > ROARING_BITMAP_WORDS) words_in_chunk = ROARING_BITMAP_WORDS;
+
+        uint32_t cardinality = (uint32_t)bitops_popcount_buffer(bs->words + first,
+                                                                words_in_chunk * sizeof(uint64_t));
+        if (cardinality == 0) continue;
+        uint64_t* words = alloc_words();
+        if (words == NULL) return false;
+        memcpy(words, bs->words + first, words_in_chunk * sizeof(uint64_t));
+        memset(words + words_in_chunk, 0, (ROARING_BITMAP_WORDS - words_in_chunk) * sizeof(uint64_t));
+
+        RoaringContainer c;
+        if (!container_from_words(&c, words, cardinality) ||
+            !insert_container(r, r->size, (uint16_t)chunk, &c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t roaring_size_bytes(const Roaring* r) {
+    size_t bytes = r->capacity * (sizeof(uint16_t) + sizeof(RoaringContainer));
+    for (size_t i = 0; i < r->size; i++) {
+        const RoaringContainer* c = &r->containers[i];
+        switch (c->type) {
+            case ROARING_ARRAY: bytes += c->capacity * sizeof(uint16_t); break;
+            case ROARING_BITMAP: bytes += BITMAP_BYTES; break;
+            case ROARING_RUN: bytes += c->capacity * sizeof(RoaringRun); break;
+        }
+    }
+    return bytes;
+}
+
+void roaring_container_counts(const Roaring* r, size_t counts[3]) {
+    counts[ROARING_ARRAY] = 0;
+    counts[ROARING_BITMAP] = 0;
+    counts[ROARING_RUN] = 0;
+    for (size_t i = 0; i < r->size; i++) {
+        counts[r->containers[i].type]++;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef ROARING_H
+#define ROARING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "bitset.h"
+
+// Compressed bitmap for sets of 32-bit values, after Roaring (Chambi,
+// Lemire et al.). Values are grouped by their high 16 bits; each group of
+// up to 65536 low halves is stored in whichever container is smallest:
+//   array   sorted uint16_t values, up to ROARING_ARRAY_MAX of them
+//   bitmap  1024 words (8 KB), for dense groups
+//   run     (start, length) pairs, for long stretches of consecutive values
+// Sparse sets cost about 2 bytes per value instead of one bit per possible
+// value, and set operations skip groups that are absent on either side.
+#define ROARING_ARRAY_MAX 4096
+#define ROARING_BITMAP_WORDS 1024
+
+typedef enum {
+    ROARING_ARRAY,
+    ROARING_BITMAP,
+    ROARING_RUN
+} RoaringContainerType;
+
+typedef struct {
+    uint16_t start;
+    uint16_t length;        // run covers start .. start + length
+} RoaringRun;
+
+typedef struct {
+    RoaringContainerType type;
+    uint32_t cardinality;
+    uint32_t count;         // array values or runs in use
+    uint32_t capacity;      // array values or runs allocated
+    uint16_t* values;       // ROARING_ARRAY
+    uint64_t* words;        // ROARING_BITMAP
+    RoaringRun* runs;       // ROARING_RUN
+} RoaringContainer;
+
+typedef struct {
+    uint16_t* keys;         // sorted high halves
+    RoaringContainer* containers;
+    size_t size;
+    size_t capacity;
+} Roaring;
+
+void roaring_init(Roaring* r);
+void roaring_destroy(Roaring* r);
+void roaring_clear(Roaring* r);
+
+bool roaring_add(Roaring* r, uint32_t value);
+bool roaring_add_range(Roaring* r, uint64_t start, uint64_t end);    // [start, end)
+bool roaring_contains(const Roaring* r, uint32_t value);
+uint64_t roaring_cardinality(const Roaring* r);
+
+// dst = a OP b. dst must be initialized and distinct from a and b; its
+// previous contents are discarded.
+bool roaring_and(Roaring* dst, const Roaring* a, const Roaring* b);
+bool roaring_or(Roaring* dst, const Roaring* a, const Roaring* b);
+bool roaring_xor(Roaring* dst, const Roaring* a, const Roaring* b);
+bool roaring_andnot(Roaring* dst, const Roaring* a, const Roaring* b);
+
+// Converts each container to run form where that is smaller, and run
+// containers back where it is not. Adds never create runs on their own.
+bool roaring_run_optimize(Roaring* r);
+
+// Conversions; out must have room for roaring_cardinality values
+size_t roaring_to_array(const Roaring* r, uint32_t* out);
+bool roaring_from_bitset(Roaring* r, const Bitset* bs);    // bs size up to 2^32
+
+// Memory held by the bitmap: keys, container headers and payloads
+size_t roaring_size_bytes(const Roaring* r);
+void roaring_container_counts(const Roaring* r, size_t counts[3]);   // by type
+
+#endif /* ROARING_H */
@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "bitops.h"
+#include "bitset.h"
+#include "roaring.h"
+
+// Two filters over the same row-ID space, evaluated as a plain bitset and
+// as a roaring bitmap, for three shapes of data: sparse random rows, dense
+// random rows, and clustered ranges (what a date or ID-range predicate
+// produces). Every roaring result is checked row by row against the bitset.
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef enum { SPARSE, DENSE, CLUSTERED } Shape;
+
+static void fill(Bitset* bs, Shape shape) {
+    bitset_clear_all(bs);
+    switch (shape) {
+        case SPARSE:
+            for (size_t i = 0; i < bs->size / 1000; i++) {
+                bitset_set(bs, next_random() % bs->size);
+            }
+            break;
+        case DENSE:
+            // About 25%: the AND of two random words
+            for (size_t w = 0; w < bs->word_count; w++) {
+                bs->words[w] = next_random() & next_random();
+            }
+            if (bs->size & 63) {
+                bs->words[bs->word_count - 1] &= (1ull << (bs->size & 63)) - 1;
+            }
+            break;
+        case CLUSTERED:
+            for (int i = 0; i < 2000; i++) {
+                size_t start = next_random() % bs->size;
+                bitset_set_range(bs, start, start + next_random() % 20000);
+            }
+            break;
+    }
+}
+
+static int failed = 0;
+
+static void verify(const char* name, const Bitset* expected, const Roaring* actual,
+                   uint32_t* expected_rows, uint32_t* actual_rows) {
+    size_t count = bitset_to_array(expected, expected_rows, expected->size);
+    if (roaring_cardinality(actual) != count) {
+        printf("  %s: cardinality %llu, expected %zu\n", name,
+               (unsigned long long)roaring_cardinality(actual), count);
+        failed = 1;
+        return;
+    }
+    roaring_to_array(actual, actual_rows);
+    for (size_t i = 0; i < count; i++) {
+        if (expected_rows[i] != actual_rows[i]) {
+            printf("  %s: row %zu differs\n", name, i);
+            failed = 1;
+            return;
+        }
+    }
+}
+
+static void run_shape(const char* label, Shape shape, Bitset* a, Bitset* b, Bitset* result,
+                      uint32_t* expected_rows, uint32_t* actual_rows) {
+    fill(a, shape);
+    fill(b, shape);
+
+    Roaring ra, rb, rresult;
+    roaring_init(&ra);
+    roaring_init(&rb);
+    roaring_init(&rresult);
+    double start = now_seconds();
+    if (!roaring_from_bitset(&ra, a) || !roaring_from_bitset(&rb, b) ||
+        !roaring_run_optimize(&ra) || !roaring_run_optimize(&rb)) {
+        exit(1);
+    }
+    double convert = now_seconds() - start;
+
+    size_t counts[3];
+    roaring_container_counts(&ra, counts);
+    printf("%s: %zu rows per filter\n", label, bitset_count(a));
+    printf("  %-22s %10.2f MB\n", "bitset size", a->word_count * sizeof(uint64_t) / 1048576.0);
+    printf("  %-22s %10.2f MB  (%zu array, %zu bitmap, %zu run containers; built in %.1f ms)\n",
+           "roaring size", roaring_size_bytes(&ra) / 1048576.0,
+           counts[ROARING_ARRAY], counts[ROARING_BITMAP], counts[ROARING_RUN], convert * 1e3 / 2);
+
+    const char* names[4] = {"and", "or", "xor", "andnot"};
+    for (int op = 0; op < 4; op++) {
+        start = now_seconds();
+        switch (op) {
+            case 0: bitset_and(result, a, b); break;
+            case 1: bitset_or(result, a, b); break;
+            case 2: bitset_xor(result, a, b); break;
+            default: bitset_andnot(result, a, b); break;
+        }
+        size_t bitset_rows = bitset_count(result);
+        double bitset_seconds = now_seconds() - start;
+
+        start = now_seconds();
+        bool ok;
+        switch (op) {
+            case 0: ok = roaring_and(&rresult, &ra, &rb); break;
+            case 1: ok = roaring_or(&rresult, &ra, &rb); break;
+            case 2: ok = roaring_xor(&rresult, &ra, &rb); break;
+            default: ok = roaring_andnot(&rresult, &ra, &rb); break;
+        }
+        uint64_t roaring_rows = roaring_cardinality(&rresult);
+        double roaring_seconds = now_seconds() - start;
+        if (!ok) exit(1);
+
+        printf("  %-8s bitset %8.3f ms   roaring %8.3f ms  %7.1fx   (%zu rows)\n", names[op],
+               bitset_seconds * 1e3, roaring_seconds * 1e3, bitset_seconds / roaring_seconds, bitset_rows);
+        failed |= bitset_rows != roaring_rows;
+        verify(names[op], result, &rresult, expected_rows, actual_rows);
+    }
+
+    // Point lookups
+    size_t probes = 1000000, hits_bitset = 0, hits_roaring = 0;
+    uint64_t saved = rng_state;
+    start = now_seconds();
+    for (size_t i = 0; i < probes; i++) {
+        hits_bitset += bitset_test(a, next_random() % a->size);
+    }
+    double bitset_seconds = now_seconds() - start;
+    rng_state = saved;
+    start = now_seconds();
+    for (size_t i = 0; i < probes; i++) {
+        hits_roaring += roaring_contains(&ra, (uint32_t)(next_random() % a->size));
+    }
+    double roaring_seconds = now_seconds() - start;
+    printf("  %-8s bitset %8.1f ns   roaring %8.1f ns\n", "contains",
+           bitset_seconds * 1e9 / probes, roaring_seconds * 1e9 / probes);
+    failed |= hits_bitset != hits_roaring;
+    printf("\n");
+
+    roaring_destroy(&ra);
+    roaring_destroy(&rb);
+    roaring_destroy(&rresult);
+}
+
+int main(int argc, char* argv[]) {
+    long bits_arg = argc > 1 ? atol(argv[1]) : 100000000;
+    if (bits_arg < 64 || bits_arg > 4000000000L) {
+        fprintf(stderr, "Usage: %s [rows, 64 .. 4e9]\n", argv[0]);
+        return 1;
+    }
+    size_t bits = (size_t)bits_arg;
+    bitops_init();
+
+    printf("=== Roaring Bitmap Benchmark ===\n");
+    printf("%zu rows, bitset kernels: %s\n\n", bits, bitset_kernels()->name);
+
+    Bitset a, b, result;
+    if (!bitset_init(&a, bits) || !bitset_init(&b, bits) || !bitset_init(&result, bits)) {
+        return 1;
+    }
+    // Up to every row: clustered filters are over half full, and their OR more so
+    uint32_t* expected_rows = malloc(bits * sizeof(uint32_t));
+    uint32_t* actual_rows = malloc(bits * sizeof(uint32_t));
+    if (expected_rows == NULL || actual_rows == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return 1;
+    }
+
+    run_shape("Sparse (0.1% random rows)", SPARSE, &a, &b, &result, expected_rows, actual_rows);
+    run_shape("Dense (25% random rows)", DENSE, &a, &b, &result, expected_rows, actual_rows);
+    run_shape("Clustered (2000 ranges)", CLUSTERED, &a, &b, &result, expected_rows, actual_rows);
+
+    bitset_destroy(&a);
+    bitset_destroy(&b);
+    bitset_destroy(&result);
+    free(expected_rows);
+    free(actual_rows);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
@@ -0,0 +1,349 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "cmdreg.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CMD_MAX_DISPLACEMENT (1 << 20)     // tries per bucket before giving up
+#define CMD_SCRIPT_BLOCK (1 << 16)          // script bytes read at a time
+
+struct CommandRegistry {
+    size_t count;
+    int32_t* displacement;          // per bucket: >0 seed for the second hash, <0 -(slot + 1)
+    const Command** slots;          // command stored in each slot
+    size_t* name_lengths;
+    CommandStats* stats;
+};
+
+// FNV-1a over the name, computed once per lookup
+static uint64_t hash_name(const char* name, size_t length) {
+    uint64_t h = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < length; i++) {
+        h ^= (unsigned char)name[i];
+        h *= 0x100000001B3ull;
+    }
+    return h;
+}
+
+// splitmix64 finalizer of the name hash and a displacement
+static uint64_t mix(uint64_t h, uint64_t seed) {
+    h ^= seed * 0x9E3779B97F4A7C15ull;
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ull;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBull;
+    h ^= h >> 31;
+    return h;
+}
+
+// Maps the top 32 bits onto [0, n) with a multiply instead of a division
+static size_t reduce_range(uint64_t h, size_t n) {
+    return (size_t)(((h >> 32) * (uint64_t)n) >> 32);
+}
+
+static size_t bucket_of(uint64_t h, size_t n) {
+    return reduce_range(h, n);
+}
+
+static size_t slot_of(uint64_t h, int32_t displacement, size_t n) {
+    return reduce_range(mix(h, (uint64_t)displacement), n);
+}
+
+static void* allocate(size_t count, size_t size) {
+    void* block = calloc(count > 0 ? count : 1, size);
+    if (block == NULL) fprintf(stderr, "Memory allocation failed\n");
+    return block;
+}
+
+// Places the keys of one bucket: finds a displacement under which they all
+// land in distinct free slots. members are indices into commands.
+static bool place_bucket(CommandRegistry* registry, const Command* commands, const uint64_t* hashes,
+                         const size_t* members, size_t size, size_t bucket, size_t* chosen) {
+    size_t n = registry->count;
+    for (int32_t d = 1; d < CMD_MAX_DISPLACEMENT; d++) {
+        bool ok = true;
+        for (size_t k = 0; k < size && ok; k++) {
+            chosen[k] = slot_of(hashes[members[k]], d, n);
+            ok = registry->slots[chosen[k]] == NULL;
+            for (size_t j = 0; j < k && ok; j++) {
+                ok = chosen[j] != chosen[k];
+            }
+        }
+        if (!ok) continue;
+        for (size_t k = 0; k < size; k++) {
+            registry->slots[chosen[k]] = &commands[members[k]];
+            registry->name_lengths[chosen[k]] = strlen(commands[members[k]].name);
+        }
+        registry->displacement[bucket] = d;
+        return true;
+    }
+    fprintf(stderr, "No perfect hash found for %zu commands\n", n);
+    return false;
+}
+
+static bool build(CommandRegistry* registry, const Command* commands) {
+    size_t n = registry->count;
+    uint64_t* hashes = allocate(n, sizeof(uint64_t));
+    size_t* bucket_start = allocate(n + 1, sizeof(size_t));
+    size_t* members = allocate(n, sizeof(size_t));
+    size_t* by_size = allocate(n, sizeof(size_t));
+    size_t* size_start = allocate(n + 2, sizeof(size_t));
+    size_t* chosen = allocate(n, sizeof(size_t));
+    bool ok = hashes && bucket_start && members && by_size && size_start && chosen;
+
+    if (ok) {
+        // Group keys by bucket (counting sort)
+        for (size_t i = 0; i < n; i++) {
+            hashes[i] = hash_name(commands[i].name, strlen(commands[i].name));
+            bucket_start[bucket_of(hashes[i], n) + 1]++;
+        }
+        for (size_t b = 0; b < n; b++) {
+            bucket_start[b + 1] += bucket_start[b];
+        }
+        for (size_t i = 0; i < n; i++) {
+            size_t b = bucket_of(hashes[i], n);
+            members[bucket_start[b] + (size_t)by_size[b]++] = i;
+        }
+
+        // Order buckets largest first: big buckets are hardest to place
+        memset(by_size, 0, n * sizeof(size_t));
+        for (size_t b = 0; b < n; b++) {
+            size_start[n - (bucket_start[b + 1] - bucket_start[b]) + 1]++;
+        }
+        for (size_t s = 0; s <= n; s++) {
+            size_start[s + 1] += size_start[s];
+        }
+        for (size_t b = 0; b < n; b++) {
+            by_size[size_start[n - (bucket_start[b + 1] - bucket_start[b])]++] = b;
+        }
+    }
+
+    size_t next_free = 0;
+    for (size_t r = 0; ok && r < n; r++) {
+        size_t b = by_size[r];
+        const size_t* keys = members + bucket_start[b];
+        size_t size = bucket_start[b + 1] - bucket_start[b];
+        if (size == 0) break;
+
+        for (size_t k = 0; k < size && ok; k++) {
+            for (size_t j = 0; j < k && ok; j++) {
+                if (hashes[keys[j]] == hashes[keys[k]] &&
+                    strcmp(commands[keys[j]].name, commands[keys[k]].name) == 0) {
+                    fprintf(stderr, "Duplicate command: %s\n", commands[keys[k]].name);
+                    ok = false;
+                }
+            }
+        }
+        if (!ok) break;
+
+        if (size > 1) {
+            ok = place_bucket(registry, commands, hashes, keys, size, b, chosen);
+        } else {
+            // Single keys go straight into the remaining slots
+            while (registry->slots[next_free] != NULL) next_free++;
+            registry->slots[next_free] = &commands[keys[0]];
+            registry->name_lengths[next_free] = strlen(commands[keys[0]].name);
+            registry->displacement[b] = -(int32_t)next_free - 1;
+        }
+    }
+
+    free(hashes);
+    free(bucket_start);
+    free(members);
+    free(by_size);
+    free(size_start);
+    free(chosen);
+    return ok;
+}
+
+CommandRegistry* cmd_registry_create(const Command* commands, size_t count) {
+    if (count > INT32_MAX) return NULL;
+    CommandRegistry* registry = allocate(1, sizeof(CommandRegistry));
+    if (registry == NULL) return NULL;
+    registry->count = count;
+    registry->displacement = allocate(count, sizeof(int32_t));
+    registry->slots = allocate(count, sizeof(const Command*));
+    registry->name_lengths = allocate(count, sizeof(size_t));
+    registry->stats = allocate(count, sizeof(CommandStats));
+    if (registry->displacement == NULL || registry->slots == NULL ||
+        registry->name_lengths == NULL || registry->stats == NULL || !build(registry, commands)) {
+        cmd_registry_destroy(registry);
+        return NULL;
+    }
+    return registry;
+}
+
+void cmd_registry_destroy(CommandRegistry* registry) {
+    if (registry == NULL) return;
+    free(registry->displacement);
+    free(registry->slots);
+    free(registry->name_lengths);
+    free(registry->stats);
+    free(registry);
+}
+
+size_t cmd_registry_count(const CommandRegistry* registry) {
+    return registry->count;
+}
+
+int cmd_registry_lookup(const CommandRegistry* registry, const char* name, size_t length) {
+    size_t n = registry->count;
+    if (n == 0) return -1;
+    uint64_t h = hash_name(name, length);
+    int32_t d = registry->displacement[bucket_of(h, n)];
+    size_t slot = d < 0 ? (size_t)(-(int64_t)d - 1) : slot_of(h, d, n);
+    if (registry->name_lengths[slot] != length ||
+        memcmp(registry->slots[slot]->name, name, length) != 0) {
+        return -1;
+    }
+    return (int)slot;
+}
+
+const Command* cmd_registry_command(const CommandRegistry* registry, int slot) {
+    return registry->slots[slot];
+}
+
+const CommandStats* cmd_registry_stats(const CommandRegistry* registry, int slot) {
+    return &registry->stats[slot];
+}
+
+// ---------------------------------------------------------------------
+// Invocation and statistics
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static int latency_bucket(uint64_t ns) {
+    int bucket = 0;
+    while (ns > 1 && bucket < CMD_LATENCY_BUCKETS - 1) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void cmd_registry_invoke(CommandRegistry* registry, int slot, const char* text) {
+    uint64_t start = now_ns();
+    registry->slots[slot]->func("%s", text);
+    uint64_t elapsed = now_ns() - start;
+
+    CommandStats* stats = &registry->stats[slot];
+    stats->calls++;
+    stats->total_ns += elapsed;
+    if (elapsed > stats->max_ns) stats->max_ns = elapsed;
+    stats->latency[latency_bucket(elapsed)]++;
+}
+
+uint64_t cmd_stats_percentile(const CommandStats* stats, double q) {
+    if (stats->calls == 0) return 0;
+    uint64_t target = (uint64_t)(q * (double)stats->calls + 0.5);
+    if (target < 1) target = 1;
+    uint64_t seen = 0;
+    for (int b = 0; b < CMD_LATENCY_BUCKETS; b++) {
+        seen += stats->latency[b];
+        if (seen >= target) {
+            uint64_t bound = 2ull << b;
+            return bound < stats->max_ns ? bound : stats->max_ns;
+        }
+    }
+    return stats->max_ns;
+}
+
+void cmd_registry_print_stats(const CommandRegistry* registry, FILE* out) {
+    fprintf(out, "  %-12s %10s %10s %10s %10s %10s\n", "command", "calls", "mean ns", "p50 ns",
+            "p99 ns", "max ns");
+    for (size_t slot = 0; slot < registry->count; slot++) {
+        const CommandStats* stats = &registry->stats[slot];
+        if (stats->calls == 0) continue;
+        fprintf(out, "  %-12s %10llu %10.0f %10llu %10llu %10llu\n", registry->slots[slot]->name,
+                (unsigned long long)stats->calls, (double)stats->total_ns / (double)stats->calls,
+                (unsigned long long)cmd_stats_percentile(stats, 0.50),
+                (unsigned long long)cmd_stats_percentile(stats, 0.99),
+                (unsigned long long)stats->max_ns);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Batch mode
+
+// One line without its newline; the line is modified in place
+static void run_line(CommandRegistry* registry, char* line, size_t length, CommandScriptResult* counts) {
+    counts->lines++;
+    if (length > 0 && line[length - 1] == '\r') length--;
+    line[length] = '\0';
+
+    char* p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '\0' || *p == '#') return;
+
+    const char* name = p;
+    while (*p != '\0' && *p != ' ' && *p != '\t') p++;
+    size_t name_length = (size_t)(p - name);
+    while (*p == ' ' || *p == '\t') p++;
+
+    int slot = cmd_registry_lookup(registry, name, name_length);
+    if (slot < 0) {
+        fprintf(stderr, "Unknown command: %.*s (line %zu)\n", (int)name_length, name, counts->lines);
+        counts->unknown++;
+        return;
+    }
+    cmd_registry_invoke(registry, slot, p);
+    counts->executed++;
+}
+
+// The script is read in large blocks and split with memchr rather than
+// line by line through stdio
+bool cmd_registry_run_script(CommandRegistry* registry, FILE* script, CommandScriptResult* result) {
+    CommandScriptResult counts = {0, 0, 0};
+    size_t capacity = CMD_SCRIPT_BLOCK;
+    char* buffer = malloc(capacity);
+    if (buffer == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    size_t start = 0, used = 0;
+    bool ok = true, at_end = false;
+
+    while (ok) {
+        char* newline = memchr(buffer + start, '\n', used - start);
+        if (newline != NULL) {
+            run_line(registry, buffer + start, (size_t)(newline - (buffer + start)), &counts);
+            start = (size_t)(newline - buffer) + 1;
+            continue;
+        }
+        if (at_end) {
+            if (start < used) run_line(registry, buffer + start, used - start, &counts);
+            break;
+        }
+
+        // Keep the partial line, then refill; one byte stays free for a
+        // final line's terminator
+        memmove(buffer, buffer + start, used - start);
+        used -= start;
+        start = 0;
+        if (used == capacity - 1) {
+            char* grown = realloc(buffer, capacity * 2);
+            if (grown == NULL) {
+                fprintf(stderr, "Memory allocation failed\n");
+                ok = false;
+                break;
+            }
+            buffer = grown;
+            capacity *= 2;
+        }
+        size_t n = fread(buffer + used, 1, capacity - 1 - used, script);
+        used += n;
+        if (n == 0) {
+            at_end = true;
+            ok = !ferror(script);
+        }
+    }
+
+    free(buffer);
+    if (result != NULL) *result = counts;
+    return ok;
+}
@@ -0,0 +1,71 @@
+#ifndef CMDREG_H
+#define CMDREG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Command registry behind execute_command. At creation a minimal perfect
+// hash is built over the command names (hash and displace): every name
+// hashes to its own slot in a table exactly as large as the command set,
+// so a lookup is one hash of the name, one displacement read and one
+// string compare to reject unknown names.
+//
+// Each command keeps an invocation count and a latency histogram with
+// power-of-two nanosecond buckets. Scripts of commands, one per line,
+// run through the same table in batch mode.
+
+// Command function pointer type
+typedef void (*CommandFunc)(const char* format, ...);
+
+// Command structure
+typedef struct {
+    const char* name;
+    CommandFunc func;
+} Command;
+
+// Bucket b counts calls that took [2^b, 2^(b+1)) ns; bucket 0 includes 0
+#define CMD_LATENCY_BUCKETS 40
+
+typedef struct {
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+    uint64_t latency[CMD_LATENCY_BUCKETS];
+} CommandStats;
+
+typedef struct CommandRegistry CommandRegistry;
+
+// The table and its names must outlive the registry. NULL on failure or
+// when two commands share a name.
+CommandRegistry* cmd_registry_create(const Command* commands, size_t count);
+void cmd_registry_destroy(CommandRegistry* registry);
+
+size_t cmd_registry_count(const CommandRegistry* registry);
+
+// Slot of a name of length bytes (need not be terminated), -1 if unknown
+int cmd_registry_lookup(const CommandRegistry* registry, const char* name, size_t length);
+const Command* cmd_registry_command(const CommandRegistry* registry, int slot);
+const CommandStats* cmd_registry_stats(const CommandRegistry* registry, int slot);
+
+// Calls the command with ("%s", text), timed into its statistics
+void cmd_registry_invoke(CommandRegistry* registry, int slot, const char* text);
+
+// Upper bound in ns of the latency below which a fraction q of calls fall
+uint64_t cmd_stats_percentile(const CommandStats* stats, double q);
+
+// One row per command that has been called
+void cmd_registry_print_stats(const CommandRegistry* registry, FILE* out);
+
+typedef struct {
+    size_t lines;
+    size_t executed;
+    size_t unknown;         // reported on stderr with their line numbers
+} CommandScriptResult;
+
+// Runs "name text..." lines; blank lines and lines starting with '#' are
+// skipped. Returns false on a read or allocation error.
+bool cmd_registry_run_script(CommandRegistry* registry, FILE* script, CommandScriptResult* result);
+
+#endif /* CMDREG_H */
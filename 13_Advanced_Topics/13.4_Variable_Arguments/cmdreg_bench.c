@@ -0,0 +1,262 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <time.h>
+#include "cmdreg.h"
+
+// Command dispatch for tables of 2 to 256 commands:
+//   lookup   the original strcmp scan over the table vs the perfect
+//            hash, on a mix of known names and 10% unknown ones
+//   build    time to hash 10^5 commands, every one checked for its slot
+//   script   a batch of the argument's number of lines (default 10^6)
+//            through fgets and the strcmp scan vs cmd_registry_run_script,
+//            which also records per-command latency
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int failed = 0;
+
+static void report(const char* name, double ops, double seconds, double baseline) {
+    printf("  %-28s %12.0f ops/s  %8.1f ns/op", name, ops / seconds, seconds * 1e9 / ops);
+    if (baseline > 0) printf("  %6.2fx", baseline / seconds);
+    printf("\n");
+}
+
+// Commands that only count their calls and the bytes they were given
+static uint64_t calls_made = 0;
+static uint64_t bytes_seen = 0;
+
+static void cmd_count(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const char* text = va_arg(args, const char*);
+    va_end(args);
+    calls_made++;
+    bytes_seen += strlen(text);
+}
+
+// Admin-style names of varied length: "print", "error", then "set_cache_17"...
+static const char* stems[] = {"set", "get", "reload", "flush", "stat", "drop", "sync", "dump"};
+static const char* nouns[] = {"cache", "user", "index", "queue", "log", "session", "shard", "quota"};
+
+static Command* make_commands(size_t count, char*** names_out) {
+    Command* commands = malloc(count * sizeof(Command));
+    char** names = malloc(count * sizeof(char*));
+    if (commands == NULL || names == NULL) exit(1);
+    for (size_t i = 0; i < count; i++) {
+        names[i] = malloc(48);
+        if (names[i] == NULL) exit(1);
+        if (i == 0) snprintf(names[i], 48, "print");
+        else if (i == 1) snprintf(names[i], 48, "error");
+        else snprintf(names[i], 48, "%s_%s_%zu", stems[i % 8], nouns[(i / 8) % 8], i);
+        commands[i].name = names[i];
+        commands[i].func = cmd_count;
+    }
+    *names_out = names;
+    return commands;
+}
+
+static void free_commands(Command* commands, char** names, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(names[i]);
+    }
+    free(names);
+    free(commands);
+}
+
+// The original dispatch loop
+static int scan_lookup(const Command* commands, size_t count, const char* name) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(commands[i].name, name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+#define LOOKUPS 4000000
+#define QUERY_MASK 4095
+
+static void bench_lookup(void) {
+    static const size_t sizes[] = {2, 16, 64, 256};
+    printf("Lookup:\n");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t count = sizes[s];
+        char** names;
+        Command* commands = make_commands(count, &names);
+        CommandRegistry* registry = cmd_registry_create(commands, count);
+        if (registry == NULL) exit(1);
+
+        // Query mix; about one in ten is not a command
+        static char queries[QUERY_MASK + 1][48];
+        for (int q = 0; q <= QUERY_MASK; q++) {
+            size_t i = (size_t)(next_random() % count);
+            if (next_random() % 10 == 0) {
+                snprintf(queries[q], sizeof(queries[q]), "%sx", names[i]);
+            } else {
+                snprintf(queries[q], sizeof(queries[q]), "%s", names[i]);
+            }
+        }
+
+        long scan_found = 0, hash_found = 0;
+        double start = now_seconds();
+        for (int r = 0; r < LOOKUPS; r++) {
+            scan_found += scan_lookup(commands, count, queries[r & QUERY_MASK]) >= 0;
+        }
+        double baseline = now_seconds() - start;
+
+        start = now_seconds();
+        for (int r = 0; r < LOOKUPS; r++) {
+            const char* name = queries[r & QUERY_MASK];
+            hash_found += cmd_registry_lookup(registry, name, strlen(name)) >= 0;
+        }
+        double seconds = now_seconds() - start;
+
+        char label[64];
+        snprintf(label, sizeof(label), "strcmp scan, %zu commands", count);
+        report(label, LOOKUPS, baseline, 0);
+        snprintf(label, sizeof(label), "perfect hash, %zu commands", count);
+        report(label, LOOKUPS, seconds, baseline);
+        failed |= scan_found != hash_found;
+        for (int q = 0; q <= QUERY_MASK; q++) {
+            int expected = scan_lookup(commands, count, queries[q]);
+            int slot = cmd_registry_lookup(registry, queries[q], strlen(queries[q]));
+            failed |= (expected < 0) != (slot < 0);
+            failed |= slot >= 0 && cmd_registry_command(registry, slot) != &commands[expected];
+        }
+
+        cmd_registry_destroy(registry);
+        free_commands(commands, names, count);
+    }
+    printf("\n");
+}
+
+static void bench_build(void) {
+    size_t count = 100000;
+    char** names;
+    Command* commands = make_commands(count, &names);
+    double start = now_seconds();
+    CommandRegistry* registry = cmd_registry_create(commands, count);
+    double seconds = now_seconds() - start;
+    if (registry == NULL) exit(1);
+    printf("Build:\n");
+    report("perfect hash, 100000 commands", count, seconds, 0);
+    printf("\n");
+
+    // Every command owns exactly one slot
+    for (size_t i = 0; i < count; i++) {
+        int slot = cmd_registry_lookup(registry, names[i], strlen(names[i]));
+        failed |= slot < 0 || cmd_registry_command(registry, slot) != &commands[i];
+    }
+    failed |= cmd_registry_lookup(registry, "", 0) >= 0;
+    cmd_registry_destroy(registry);
+
+    // Duplicates are refused
+    Command twice[] = {{"print", cmd_count}, {"error", cmd_count}, {"print", cmd_count}};
+    fflush(stdout);
+    fprintf(stderr, "(expected) ");
+    registry = cmd_registry_create(twice, 3);
+    failed |= registry != NULL;
+    cmd_registry_destroy(registry);
+    free_commands(commands, names, count);
+}
+
+static void bench_script(size_t lines) {
+    size_t count = 64;
+    char** names;
+    Command* commands = make_commands(count, &names);
+    CommandRegistry* registry = cmd_registry_create(commands, count);
+    FILE* script = tmpfile();
+    if (registry == NULL || script == NULL) exit(1);
+
+    for (size_t i = 0; i < lines; i++) {
+        if (i % 100 == 0) {
+            fprintf(script, "# step %zu\n", i);
+        } else {
+            fprintf(script, "%s item=%llu value=%llu\n", names[next_random() % count],
+                    (unsigned long long)(next_random() % 100000),
+                    (unsigned long long)(next_random() % 1000));
+        }
+    }
+
+    // Baseline: fgets, split at the first space, strcmp scan
+    rewind(script);
+    calls_made = bytes_seen = 0;
+    double start = now_seconds();
+    char line[1024];
+    while (fgets(line, sizeof(line), script) != NULL) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0' || line[0] == '#') continue;
+        char* text = strchr(line, ' ');
+        if (text != NULL) *text++ = '\0';
+        else text = line + strlen(line);
+        int i = scan_lookup(commands, count, line);
+        if (i >= 0) commands[i].func("%s", text);
+    }
+    double baseline = now_seconds() - start;
+    uint64_t expected_calls = calls_made, expected_bytes = bytes_seen;
+
+    rewind(script);
+    calls_made = bytes_seen = 0;
+    CommandScriptResult result;
+    start = now_seconds();
+    failed |= !cmd_registry_run_script(registry, script, &result);
+    double seconds = now_seconds() - start;
+
+    printf("Script, %zu lines, 64 commands:\n", lines);
+    report("fgets + strcmp scan", (double)lines, baseline, 0);
+    report("cmd_registry_run_script", (double)lines, seconds, baseline);
+    printf("\nLatency of the counting commands (first four):\n");
+    for (int slot = 0; slot < 4; slot++) {
+        const CommandStats* stats = cmd_registry_stats(registry, slot);
+        printf("  %-20s %8llu calls, p50 %llu ns, p99 %llu ns\n", cmd_registry_command(registry, slot)->name,
+               (unsigned long long)stats->calls, (unsigned long long)cmd_stats_percentile(stats, 0.50),
+               (unsigned long long)cmd_stats_percentile(stats, 0.99));
+    }
+    printf("\n");
+
+    uint64_t recorded = 0;
+    for (size_t slot = 0; slot < count; slot++) {
+        recorded += cmd_registry_stats(registry, (int)slot)->calls;
+    }
+    failed |= result.lines != lines || result.executed != expected_calls || result.unknown != 0;
+    failed |= calls_made != expected_calls || bytes_seen != expected_bytes || recorded != expected_calls;
+
+    fclose(script);
+    cmd_registry_destroy(registry);
+    free_commands(commands, names, count);
+}
+
+int main(int argc, char* argv[]) {
+    long lines_arg = argc > 1 ? atol(argv[1]) : 1000000;
+    if (lines_arg < 1 || lines_arg > 100000000) {
+        fprintf(stderr, "Usage: %s [script lines, 1 .. 100000000]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== Command Registry Benchmark ===\n\n");
+    bench_lookup();
+    bench_build();
+    bench_script((size_t)lines_arg);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
@@ -0,0 +1,949 @@
+#include "fmt.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#if defined(__SIZEOF_INT128__)
+#define FMT_INT128 1
+__extension__ typedef unsigned __int128 fmt_u128;
+#else
+#define FMT_INT128 0
+#endif
+
+// ---------------------------------------------------------------------
+// Bounded output
+
+typedef struct {
+    char* buffer;
+    size_t size;
+    size_t length;          // full length, may run past size
+} Sink;
+
+static void sink_write(Sink* sink, const char* data, size_t n) {
+    if (n > 0 && sink->length < sink->size) {
+        size_t room = sink->size - 1 - sink->length;
+        memcpy(sink->buffer + sink->length, data, n < room ? n : room);
+    }
+    sink->length += n;
+}
+
+static void sink_fill(Sink* sink, char c, size_t n) {
+    if (sink->length < sink->size) {
+        size_t room = sink->size - 1 - sink->length;
+        memset(sink->buffer + sink->length, c, n < room ? n : room);
+    }
+    sink->length += n;
+}
+
+static int sink_finish(Sink* sink) {
+    if (sink->size > 0) {
+        sink->buffer[sink->length < sink->size ? sink->length : sink->size - 1] = '\0';
+    }
+    return sink->length > INT_MAX ? -1 : (int)sink->length;
+}
+
+// ---------------------------------------------------------------------
+// Integers
+
+static const char digit_pairs[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static const uint64_t powers_of_10[20] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull, 100000000ull,
+    1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull, 10000000000000ull,
+    100000000000000ull, 1000000000000000ull, 10000000000000000ull, 100000000000000000ull,
+    1000000000000000000ull, 10000000000000000000ull
+};
+
+static int bit_length(uint64_t value) {
+#if defined(__GNUC__)
+    return value == 0 ? 0 : 64 - __builtin_clzll(value);
+#else
+    int bits = 0;
+    while (value != 0) {
+        bits++;
+        value >>= 1;
+    }
+    return bits;
+#endif
+}
+
+// log10(2) ~ 1233 / 4096 gives the digit count of 2^(bits-1) or one less;
+// one compare settles it
+static size_t count_digits(uint64_t value) {
+    if (value < 10) return 1;
+    int guess = (bit_length(value) * 1233) >> 12;
+    return (size_t)guess + (value >= powers_of_10[guess]);
+}
+
+// Exactly `digits` characters, right-aligned, written two at a time
+static void write_digits(char* out, uint64_t value, size_t digits) {
+    char* p = out + digits;
+    while (value >= 100) {
+        unsigned pair = (unsigned)(value % 100);
+        value /= 100;
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * pair, 2);
+    }
+    if (value >= 10) {
+        p -= 2;
+        memcpy(p, digit_pairs + 2 * value, 2);
+    } else if (p > out) {
+        *--p = (char)('0' + value);
+    }
+    while (p > out) {
+        *--p = '0';
+    }
+}
+
+size_t fmt_u64(char* out, uint64_t value) {
+    size_t digits = count_digits(value);
+    write_digits(out, value, digits);
+    return digits;
+}
+
+size_t fmt_i64(char* out, int64_t value) {
+    if (value < 0) {
+        *out = '-';
+        return 1 + fmt_u64(out + 1, 0 - (uint64_t)value);
+    }
+    return fmt_u64(out, (uint64_t)value);
+}
+
+static size_t format_radix(char* out, uint64_t value, unsigned shift, bool upper) {
+    const char* alphabet = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    unsigned mask = (1u << shift) - 1;
+    char tmp[24];
+    size_t n = 0;
+    do {
+        tmp[sizeof(tmp) - 1 - n++] = alphabet[value & mask];
+        value >>= shift;
+    } while (value != 0);
+    memcpy(out, tmp + sizeof(tmp) - n, n);
+    return n;
+}
+
+// ---------------------------------------------------------------------
+// %f: value * 10^precision as an exact integer. With the double written
+// as m * 2^e, the fraction bits f (f / 2^s, s = -e) scaled by 10^p fit in
+// 128 bits (f < 2^53, 10^p < 2^57), so the quotient and the remainder
+// against one half are exact and rounding is half-to-even like glibc.
+
+#define FMT_FIXED_MAX_PRECISION 17
+
+static size_t format_fixed_magnitude(char* out, double value, int precision, bool* handled) {
+    *handled = false;
+#if FMT_INT128
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    int biased = (int)((bits >> 52) & 0x7FF);
+    uint64_t m = bits & ((1ull << 52) - 1);
+    int e;
+    if (biased == 0x7FF || precision > FMT_FIXED_MAX_PRECISION) return 0;
+    if (biased == 0) {
+        e = -1074;
+    } else {
+        m |= 1ull << 52;
+        e = biased - 1075;
+    }
+    if (e > 10) return 0;       // 2^63 and up
+
+    uint64_t integer, fraction = 0;
+    uint64_t scale = powers_of_10[precision];
+    if (e >= 0) {
+        integer = m << e;
+    } else {
+        int s = -e;
+        uint64_t f;
+        if (s < 64) {
+            integer = m >> s;
+            f = m & ((1ull << s) - 1);
+        } else {
+            integer = 0;
+            f = m;
+        }
+        // Below 2^-128 the scaled fraction is under one half: rounds to 0
+        if (s < 128) {
+            fmt_u128 scaled = (fmt_u128)f * scale;
+            fraction = (uint64_t)(scaled >> s);
+            fmt_u128 remainder = scaled & (((fmt_u128)1 << s) - 1);
+            fmt_u128 half = (fmt_u128)1 << (s - 1);
+            uint64_t last = precision > 0 ? fraction : integer;
+            if (remainder > half || (remainder == half && (last & 1))) {
+                fraction++;
+            }
+            if (fraction == scale) {
+                fraction = 0;
+                integer++;
+            }
+        }
+    }
+
+    size_t n = fmt_u64(out, integer);
+    if (precision > 0) {
+        out[n++] = '.';
+        write_digits(out + n, fraction, (size_t)precision);
+        n += (size_t)precision;
+    }
+    *handled = true;
+    return n;
+#else
+    (void)out;
+    (void)value;
+    (void)precision;
+    return 0;
+#endif
+}
+
+// ---------------------------------------------------------------------
+// Shortest round-trip doubles (Ryu, Ulf Adams 2018). The 125-bit tables of
+// 5^i and 2^k / 5^i are computed once from exact big integers.
+
+#if FMT_INT128
+#define RYU_POW5_BITCOUNT 125
+#define RYU_POW5_INV_BITCOUNT 125
+#define RYU_POW5_TABLE_SIZE 326
+#define RYU_POW5_INV_TABLE_SIZE 342
+#define RYU_BIG_LIMBS 32            // 32-bit limbs, enough for 5^341 and 2^916
+
+static uint64_t ryu_pow5[RYU_POW5_TABLE_SIZE][2];
+static uint64_t ryu_pow5_inv[RYU_POW5_INV_TABLE_SIZE][2];
+static bool ryu_tables_ready = false;
+
+typedef struct {
+    uint32_t limbs[RYU_BIG_LIMBS];
+} RyuBig;
+
+static int ryu_big_bits(const RyuBig* x) {
+    for (int i = RYU_BIG_LIMBS - 1; i >= 0; i--) {
+        if (x->limbs[i] != 0) return i * 32 + bit_length(x->limbs[i]);
+    }
+    return 0;
+}
+
+static bool ryu_big_bit(const RyuBig* x, int bit) {
+    return bit >= 0 && ((x->limbs[bit / 32] >> (bit % 32)) & 1);
+}
+
+static int ryu_big_compare(const RyuBig* a, const RyuBig* b) {
+    for (int i = RYU_BIG_LIMBS - 1; i >= 0; i--) {
+        if (a->limbs[i] != b->limbs[i]) return a->limbs[i] < b->limbs[i] ? -1 : 1;
+    }
+    return 0;
+}
+
+static void ryu_big_sub(RyuBig* a, const RyuBig* b) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < RYU_BIG_LIMBS; i++) {
+        uint64_t d = (uint64_t)a->limbs[i] - b->limbs[i] - borrow;
+        a->limbs[i] = (uint32_t)d;
+        borrow = (d >> 32) & 1;
+    }
+}
+
+static void ryu_big_shift_left_1(RyuBig* a) {
+    for (int i = RYU_BIG_LIMBS - 1; i > 0; i--) {
+        a->limbs[i] = a->limbs[i] << 1 | a->limbs[i - 1] >> 31;
+    }
+    a->limbs[0] <<= 1;
+}
+
+// Bits [low, low + 125) of x, shifting in zeros below bit 0
+static void ryu_big_window(const RyuBig* x, int low, uint64_t out[2]) {
+    out[0] = out[1] = 0;
+    for (int b = 0; b < 125; b++) {
+        if (ryu_big_bit(x, low + b)) out[b / 64] |= 1ull << (b % 64);
+    }
+}
+
+static void build_ryu_tables(void) {
+    RyuBig pow;
+    memset(&pow, 0, sizeof(pow));
+    pow.limbs[0] = 1;
+    for (int i = 0; i < RYU_POW5_INV_TABLE_SIZE; i++) {
+        int length = ryu_big_bits(&pow);
+        if (i < RYU_POW5_TABLE_SIZE) {
+            ryu_big_window(&pow, length - RYU_POW5_BITCOUNT, ryu_pow5[i]);
+        }
+
+        // floor(2^(length - 1 + 125) / 5^i) + 1 by long division. The
+        // leading 2^(length - 1) never exceeds 5^i, so the division starts
+        // there and only the 126 quotient bits below it are computed.
+        RyuBig remainder;
+        memset(&remainder, 0, sizeof(remainder));
+        remainder.limbs[(length - 1) / 32] = 1u << ((length - 1) % 32);
+        uint64_t quotient[2] = {0, 0};
+        for (int b = RYU_POW5_INV_BITCOUNT; b >= 0; b--) {
+            if (ryu_big_compare(&remainder, &pow) >= 0) {
+                ryu_big_sub(&remainder, &pow);
+                quotient[b / 64] |= 1ull << (b % 64);
+            }
+            if (b > 0) ryu_big_shift_left_1(&remainder);
+        }
+        fmt_u128 inv = ((fmt_u128)quotient[1] << 64 | quotient[0]) + 1;
+        ryu_pow5_inv[i][0] = (uint64_t)inv;
+        ryu_pow5_inv[i][1] = (uint64_t)(inv >> 64);
+
+        // pow *= 5
+        uint64_t carry = 0;
+        for (int l = 0; l < RYU_BIG_LIMBS; l++) {
+            uint64_t product = (uint64_t)pow.limbs[l] * 5 + carry;
+            pow.limbs[l] = (uint32_t)product;
+            carry = product >> 32;
+        }
+    }
+    ryu_tables_ready = true;
+}
+
+static int pow5_bits(int e) {               // ceil(log2(5^e)), 1 for e == 0
+    return (int)(((uint32_t)e * 1217359) >> 19) + 1;
+}
+
+static int log10_pow2(int e) {              // floor(log10(2^e))
+    return (int)(((uint32_t)e * 78913) >> 18);
+}
+
+static int log10_pow5(int e) {              // floor(log10(5^e))
+    return (int)(((uint32_t)e * 732923) >> 20);
+}
+
+static bool multiple_of_pow5(uint64_t value, int p) {
+    int count = 0;
+    while (value % 5 == 0 && value != 0) {
+        value /= 5;
+        count++;
+    }
+    return count >= p;
+}
+
+static uint64_t mul_shift(uint64_t m, const uint64_t mul[2], int j) {
+    fmt_u128 b0 = (fmt_u128)m * mul[0];
+    fmt_u128 b2 = (fmt_u128)m * mul[1];
+    return (uint64_t)(((b0 >> 64) + b2) >> (j - 64));
+}
+
+// Shortest digits and decimal exponent for a finite, nonzero double
+static uint64_t ryu_d2d(uint64_t ieee_mantissa, int ieee_exponent, int* exponent10) {
+    int e2;
+    uint64_t m2;
+    if (ieee_exponent == 0) {
+        e2 = 1 - 1023 - 52 - 2;
+        m2 = ieee_mantissa;
+    } else {
+        e2 = ieee_exponent - 1023 - 52 - 2;
+        m2 = (1ull << 52) | ieee_mantissa;
+    }
+    bool accept_bounds = (m2 & 1) == 0;
+
+    // The halfway points to the neighbours: mv +- 2, or -1 below a power
+    // of two where the lower neighbour is closer
+    uint64_t mv = 4 * m2;
+    uint64_t mm_shift = ieee_mantissa != 0 || ieee_exponent <= 1;
+    uint64_t vr, vp, vm;
+    int e10;
+    bool vm_trailing_zeros = false, vr_trailing_zeros = false;
+
+    if (e2 >= 0) {
+        int q = log10_pow2(e2) - (e2 > 3);
+        e10 = q;
+        int k = RYU_POW5_INV_BITCOUNT + pow5_bits(q) - 1;
+        int i = -e2 + q + k;
+        vr = mul_shift(4 * m2, ryu_pow5_inv[q], i);
+        vp = mul_shift(4 * m2 + 2, ryu_pow5_inv[q], i);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, ryu_pow5_inv[q], i);
+        if (q <= 21) {
+            if (mv % 5 == 0) {
+                vr_trailing_zeros = multiple_of_pow5(mv, q);
+            } else if (accept_bounds) {
+                vm_trailing_zeros = multiple_of_pow5(mv - 1 - mm_shift, q);
+            } else {
+                vp -= multiple_of_pow5(mv + 2, q);
+            }
+        }
+    } else {
+        int q = log10_pow5(-e2) - (-e2 > 1);
+        e10 = q + e2;
+        int i = -e2 - q;
+        int k = pow5_bits(i) - RYU_POW5_BITCOUNT;
+        int j = q - k;
+        vr = mul_shift(4 * m2, ryu_pow5[i], j);
+        vp = mul_shift(4 * m2 + 2, ryu_pow5[i], j);
+        vm = mul_shift(4 * m2 - 1 - mm_shift, ryu_pow5[i], j);
+        if (q <= 1) {
+            vr_trailing_zeros = true;
+            if (accept_bounds) {
+                vm_trailing_zeros = mm_shift == 1;
+            } else {
+                vp--;
+            }
+        } else if (q < 63) {
+            vr_trailing_zeros = (mv & ((1ull << q) - 1)) == 0;
+        }
+    }
+
+    // Drop digits while the interval (vm, vp) still holds a shorter number
+    int removed = 0;
+    unsigned last_removed = 0;
+    uint64_t output;
+    if (vm_trailing_zeros || vr_trailing_zeros) {
+        while (vp / 10 > vm / 10) {
+            vm_trailing_zeros &= vm % 10 == 0;
+            vr_trailing_zeros &= last_removed == 0;
+            last_removed = (unsigned)(vr % 10);
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        if (vm_trailing_zeros) {
+            while (vm % 10 == 0) {
+                vr_trailing_zeros &= last_removed == 0;
+                last_removed = (unsigned)(vr % 10);
+                vr /= 10;
+                vp /= 10;
+                vm /= 10;
+                removed++;
+            }
+        }
+        if (vr_trailing_zeros && last_removed == 5 && vr % 2 == 0) {
+            last_removed = 4;       // exactly halfway: round to even
+        }
+        output = vr + ((vr == vm && (!accept_bounds || !vm_trailing_zeros)) || last_removed >= 5);
+    } else {
+        bool round_up = false;
+        if (vp / 100 > vm / 100) {
+            round_up = vr % 100 >= 50;
+            vr /= 100;
+            vp /= 100;
+            vm /= 100;
+            removed += 2;
+        }
+        while (vp / 10 > vm / 10) {
+            round_up = vr % 10 >= 5;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            removed++;
+        }
+        output = vr + (vr == vm || round_up);
+    }
+    *exponent10 = e10 + removed;
+    return output;
+}
+#endif /* FMT_INT128 */
+
+size_t fmt_double_shortest(char* out, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bool negative = bits >> 63;
+    int ieee_exponent = (int)((bits >> 52) & 0x7FF);
+    uint64_t ieee_mantissa = bits & ((1ull << 52) - 1);
+    size_t n = 0;
+
+    if (ieee_exponent == 0x7FF) {
+        if (ieee_mantissa != 0) {
+            memcpy(out, "nan", 3);
+            return 3;
+        }
+        if (negative) out[n++] = '-';
+        memcpy(out + n, "inf", 3);
+        return n + 3;
+    }
+    if (negative) out[n++] = '-';
+    if (ieee_exponent == 0 && ieee_mantissa == 0) {
+        out[n++] = '0';
+        return n;
+    }
+
+#if FMT_INT128
+    if (!ryu_tables_ready) build_ryu_tables();
+    int exponent10;
+    uint64_t mantissa10 = ryu_d2d(ieee_mantissa, ieee_exponent, &exponent10);
+    char digits[20];
+    size_t count = fmt_u64(digits, mantissa10);
+    int x = exponent10 + (int)count - 1;            // scientific exponent
+
+    if (x >= -5 && x < 17) {
+        if (x >= (int)count - 1) {
+            memcpy(out + n, digits, count);
+            n += count;
+            memset(out + n, '0', (size_t)(x - (int)count + 1));
+            n += (size_t)(x - (int)count + 1);
+        } else if (x >= 0) {
+            memcpy(out + n, digits, (size_t)x + 1);
+            n += (size_t)x + 1;
+            out[n++] = '.';
+            memcpy(out + n, digits + x + 1, count - (size_t)x - 1);
+            n += count - (size_t)x - 1;
+        } else {
+            out[n++] = '0';
+            out[n++] = '.';
+            memset(out + n, '0', (size_t)(-x - 1));
+            n += (size_t)(-x - 1);
+            memcpy(out + n, digits, count);
+            n += count;
+        }
+        return n;
+    }
+    out[n++] = digits[0];
+    if (count > 1) {
+        out[n++] = '.';
+        memcpy(out + n, digits + 1, count - 1);
+        n += count - 1;
+    }
+    out[n++] = 'e';
+    out[n++] = x < 0 ? '-' : '+';
+    unsigned magnitude = (unsigned)(x < 0 ? -x : x);
+    size_t exp_digits = magnitude >= 100 ? 3 : 2;
+    write_digits(out + n, magnitude, exp_digits);
+    return n + exp_digits;
+#else
+    // No 128-bit products: 17 significant digits always round-trip
+    char tmp[32];
+    int written = snprintf(tmp, sizeof(tmp), "%.17g", negative ? -value : value);
+    memcpy(out + n, tmp, (size_t)written);
+    return n + (size_t)written;
+#endif
+}
+
+// ---------------------------------------------------------------------
+// Parsing
+
+// p points just past the '%'; returns the end of the spec, NULL if invalid
+static const char* parse_spec(const char* p, FmtSpec* spec) {
+    const char* start = p - 1;
+    spec->flags = 0;
+    spec->width = FMT_NONE;
+    spec->precision = FMT_NONE;
+    spec->length = FMT_LEN_DEFAULT;
+
+    for (;; p++) {
+        if (*p == '-') spec->flags |= FMT_FLAG_LEFT;
+        else if (*p == '+') spec->flags |= FMT_FLAG_PLUS;
+        else if (*p == ' ') spec->flags |= FMT_FLAG_SPACE;
+        else if (*p == '0') spec->flags |= FMT_FLAG_ZERO;
+        else if (*p == '#') spec->flags |= FMT_FLAG_ALT;
+        else break;
+    }
+
+    if (*p == '*') {
+        spec->width = FMT_STAR;
+        p++;
+    } else if (*p >= '1' && *p <= '9') {
+        spec->width = 0;
+        while (*p >= '0' && *p <= '9') {
+            if (spec->width > (INT_MAX - 9) / 10) return NULL;
+            spec->width = spec->width * 10 + (*p++ - '0');
+        }
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->precision = FMT_STAR;
+            p++;
+        } else {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9') {
+                if (spec->precision > (INT_MAX - 9) / 10) return NULL;
+                spec->precision = spec->precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+
+    switch (*p) {
+        case 'h':
+            if (p[1] == 'h') {
+                spec->length = FMT_LEN_HH;
+                p++;
+            } else {
+                spec->length = FMT_LEN_H;
+            }
+            p++;
+            break;
+        case 'l':
+            if (p[1] == 'l') {
+                spec->length = FMT_LEN_LL;
+                p++;
+            } else {
+                spec->length = FMT_LEN_L;
+            }
+            p++;
+            break;
+        case 'z': spec->length = FMT_LEN_Z; p++; break;
+        case 'j': spec->length = FMT_LEN_J; p++; break;
+        case 't': spec->length = FMT_LEN_T; p++; break;
+        case 'L': spec->length = FMT_LEN_LONG_DOUBLE; p++; break;
+        default: break;
+    }
+
+    spec->conversion = *p;
+    switch (*p) {
+        case 'd': case 'i':
+            spec->kind = FMT_SIGNED;
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            spec->kind = FMT_UNSIGNED;
+            break;
+        case 'c': case 's':
+            // Wide characters go through snprintf
+            spec->kind = spec->length == FMT_LEN_L ? FMT_DELEGATE : (*p == 'c' ? FMT_CHAR : FMT_STRING);
+            break;
+        case 'f': case 'F':
+            spec->kind = spec->length == FMT_LEN_LONG_DOUBLE ? FMT_DELEGATE : FMT_FIXED;
+            break;
+        case 'e': case 'E': case 'g': case 'G': case 'a': case 'A': case 'p':
+            spec->kind = FMT_DELEGATE;
+            break;
+        case '%':
+            spec->kind = FMT_PERCENT;
+            break;
+        default:
+            return NULL;        // includes %n and a trailing '%'
+    }
+    spec->text = start;
+    spec->text_length = (size_t)(p + 1 - start);
+    return p + 1;
+}
+
+// ---------------------------------------------------------------------
+// Conversions
+
+// Lays out [prefix][zeros][body] within width, honouring '-' and '0'
+static void emit_padded(Sink* sink, unsigned flags, int width, const char* prefix, size_t prefix_length,
+                        size_t zeros, const char* body, size_t body_length, bool zero_pad) {
+    size_t content = prefix_length + zeros + body_length;
+    size_t padding = width > 0 && (size_t)width > content ? (size_t)width - content : 0;
+    if (flags & FMT_FLAG_LEFT) {
+        sink_write(sink, prefix, prefix_length);
+        sink_fill(sink, '0', zeros);
+        sink_write(sink, body, body_length);
+        sink_fill(sink, ' ', padding);
+    } else if (zero_pad && (flags & FMT_FLAG_ZERO)) {
+        sink_write(sink, prefix, prefix_length);
+        sink_fill(sink, '0', zeros + padding);
+        sink_write(sink, body, body_length);
+    } else {
+        sink_fill(sink, ' ', padding);
+        sink_write(sink, prefix, prefix_length);
+        sink_fill(sink, '0', zeros);
+        sink_write(sink, body, body_length);
+    }
+}
+
+static int64_t fetch_signed(const FmtSpec* spec, va_list* args) {
+    switch (spec->length) {
+        case FMT_LEN_HH: return (signed char)va_arg(*args, int);
+        case FMT_LEN_H: return (short)va_arg(*args, int);
+        case FMT_LEN_L: return va_arg(*args, long);
+        case FMT_LEN_LL: return va_arg(*args, long long);
+        case FMT_LEN_Z: return (int64_t)va_arg(*args, ptrdiff_t);
+        case FMT_LEN_J: return va_arg(*args, intmax_t);
+        case FMT_LEN_T: return va_arg(*args, ptrdiff_t);
+        default: return va_arg(*args, int);
+    }
+}
+
+static uint64_t fetch_unsigned(const FmtSpec* spec, va_list* args) {
+    switch (spec->length) {
+        case FMT_LEN_HH: return (unsigned char)va_arg(*args, unsigned int);
+        case FMT_LEN_H: return (unsigned short)va_arg(*args, unsigned int);
+        case FMT_LEN_L: return va_arg(*args, unsigned long);
+        case FMT_LEN_LL: return va_arg(*args, unsigned long long);
+        case FMT_LEN_Z: return va_arg(*args, size_t);
+        case FMT_LEN_J: return va_arg(*args, uintmax_t);
+        case FMT_LEN_T: return (uint64_t)va_arg(*args, ptrdiff_t);
+        default: return va_arg(*args, unsigned int);
+    }
+}
+
+static void emit_integer(Sink* sink, const FmtSpec* spec, int width, int precision, va_list* args) {
+    char prefix[2];
+    size_t prefix_length = 0;
+    char body[24];
+    size_t body_length;
+    uint64_t magnitude;
+
+    if (spec->kind == FMT_SIGNED) {
+        int64_t value = fetch_signed(spec, args);
+        magnitude = value < 0 ? 0 - (uint64_t)value : (uint64_t)value;
+        if (value < 0) prefix[prefix_length++] = '-';
+        else if (spec->flags & FMT_FLAG_PLUS) prefix[prefix_length++] = '+';
+        else if (spec->flags & FMT_FLAG_SPACE) prefix[prefix_length++] = ' ';
+    } else {
+        magnitude = fetch_unsigned(spec, args);
+    }
+
+    switch (spec->conversion) {
+        case 'x': case 'X':
+            body_length = format_radix(body, magnitude, 4, spec->conversion == 'X');
+            if ((spec->flags & FMT_FLAG_ALT) && magnitude != 0) {
+                prefix[prefix_length++] = '0';
+                prefix[prefix_length++] = spec->conversion;
+            }
+            break;
+        case 'o':
+            body_length = format_radix(body, magnitude, 3, false);
+            break;
+        default:
+            body_length = fmt_u64(body, magnitude);
+            break;
+    }
+
+    // A precision of 0 prints nothing for 0 (but %#o still prints "0")
+    if (precision == 0 && magnitude == 0) body_length = 0;
+    size_t zeros = precision > 0 && (size_t)precision > body_length ? (size_t)precision - body_length : 0;
+    if (spec->conversion == 'o' && (spec->flags & FMT_FLAG_ALT) && zeros == 0 &&
+        (body_length == 0 || body[0] != '0')) {
+        zeros = 1;
+    }
+    emit_padded(sink, spec->flags, width, prefix, prefix_length, zeros, body, body_length,
+                precision == FMT_NONE);
+}
+
+typedef union {
+    double d;
+    long double ld;
+    void* p;
+    wint_t wc;
+    const wchar_t* ws;
+} DelegateValue;
+
+static int call_snprintf(char* buffer, size_t size, const char* format, char conversion, FmtLength length,
+                         const DelegateValue* value) {
+    if (conversion == 'p') return snprintf(buffer, size, format, value->p);
+    if (conversion == 'c') return snprintf(buffer, size, format, value->wc);
+    if (conversion == 's') return snprintf(buffer, size, format, value->ws);
+    if (length == FMT_LEN_LONG_DOUBLE) return snprintf(buffer, size, format, value->ld);
+    return snprintf(buffer, size, format, value->d);
+}
+
+// Rebuilds the single spec with '*' resolved and lets snprintf format it
+static bool emit_delegated(Sink* sink, const FmtSpec* spec, int width, int precision, const DelegateValue* value) {
+    char format[48];
+    size_t n = 0;
+    format[n++] = '%';
+    if (spec->flags & FMT_FLAG_LEFT) format[n++] = '-';
+    if (spec->flags & FMT_FLAG_PLUS) format[n++] = '+';
+    if (spec->flags & FMT_FLAG_SPACE) format[n++] = ' ';
+    if (spec->flags & FMT_FLAG_ZERO) format[n++] = '0';
+    if (spec->flags & FMT_FLAG_ALT) format[n++] = '#';
+    if (width > 0) n += fmt_u64(format + n, (uint64_t)width);
+    if (precision >= 0) {
+        format[n++] = '.';
+        n += fmt_u64(format + n, (uint64_t)precision);
+    }
+    if (spec->length == FMT_LEN_LONG_DOUBLE) format[n++] = 'L';
+    if (spec->length == FMT_LEN_L) format[n++] = 'l';
+    format[n++] = spec->conversion;
+    format[n] = '\0';
+
+    char local[128];
+    int written = call_snprintf(local, sizeof(local), format, spec->conversion, (FmtLength)spec->length, value);
+    if (written < 0) return false;
+    if ((size_t)written < sizeof(local)) {
+        sink_write(sink, local, (size_t)written);
+        return true;
+    }
+    char* heap = malloc((size_t)written + 1);
+    if (heap == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    call_snprintf(heap, (size_t)written + 1, format, spec->conversion, (FmtLength)spec->length, value);
+    sink_write(sink, heap, (size_t)written);
+    free(heap);
+    return true;
+}
+
+static bool emit_spec(Sink* sink, const FmtSpec* spec, va_list* args) {
+    int width = spec->width;
+    int precision = spec->precision;
+    unsigned flags = spec->flags;
+    if (width == FMT_STAR) {
+        width = va_arg(*args, int);
+        if (width < 0) {
+            flags |= FMT_FLAG_LEFT;
+            width = width == INT_MIN ? INT_MAX : -width;
+        }
+    }
+    if (precision == FMT_STAR) {
+        precision = va_arg(*args, int);
+        if (precision < 0) precision = FMT_NONE;
+    }
+    FmtSpec resolved = *spec;
+    resolved.flags = (uint8_t)flags;
+
+    switch (spec->kind) {
+        case FMT_SIGNED:
+        case FMT_UNSIGNED:
+            emit_integer(sink, &resolved, width, precision, args);
+            return true;
+        case FMT_CHAR: {
+            char c = (char)va_arg(*args, int);
+            emit_padded(sink, flags, width, NULL, 0, 0, &c, 1, false);
+            return true;
+        }
+        case FMT_STRING: {
+            const char* s = va_arg(*args, const char*);
+            if (s == NULL) s = precision == FMT_NONE || precision >= 6 ? "(null)" : "";
+            size_t length = 0;
+            if (precision >= 0) {
+                while (length < (size_t)precision && s[length] != '\0') length++;
+            } else {
+                length = strlen(s);
+            }
+            emit_padded(sink, flags, width, NULL, 0, 0, s, length, false);
+            return true;
+        }
+        case FMT_FIXED: {
+            DelegateValue value;
+            value.d = va_arg(*args, double);
+            if (!(flags & FMT_FLAG_ALT)) {
+                char body[64];
+                bool handled;
+                size_t length = format_fixed_magnitude(body, value.d, precision == FMT_NONE ? 6 : precision,
+                                                       &handled);
+                if (handled) {
+                    char sign[1];
+                    size_t sign_length = 0;
+                    if (signbit(value.d)) sign[sign_length++] = '-';
+                    else if (flags & FMT_FLAG_PLUS) sign[sign_length++] = '+';
+                    else if (flags & FMT_FLAG_SPACE) sign[sign_length++] = ' ';
+                    emit_padded(sink, flags, width, sign, sign_length, 0, body, length, true);
+                    return true;
+                }
+            }
+            return emit_delegated(sink, &resolved, width, precision, &value);
+        }
+        case FMT_DELEGATE: {
+            DelegateValue value;
+            if (spec->conversion == 'p') value.p = va_arg(*args, void*);
+            else if (spec->conversion == 'c') value.wc = va_arg(*args, wint_t);
+            else if (spec->conversion == 's') value.ws = va_arg(*args, const wchar_t*);
+            else if (spec->length == FMT_LEN_LONG_DOUBLE) value.ld = va_arg(*args, long double);
+            else value.d = va_arg(*args, double);
+            return emit_delegated(sink, &resolved, width, precision, &value);
+        }
+        case FMT_PERCENT:
+            sink_write(sink, "%", 1);
+            return true;
+        default:
+            sink_write(sink, spec->text, spec->text_length);
+            return true;
+    }
+}
+
+// ---------------------------------------------------------------------
+// Entry points
+
+bool fmt_compile(FmtProgram* program, const char* format) {
+    size_t length = strlen(format);
+    size_t capacity = 1;
+    for (const char* p = format; *p; p++) {
+        capacity += *p == '%';
+    }
+    capacity = 2 * capacity + 1;        // literal + spec per '%', plus a tail
+
+    program->text = malloc(length + 1);
+    program->specs = malloc(capacity * sizeof(FmtSpec));
+    program->count = 0;
+    if (program->text == NULL || program->specs == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        fmt_program_destroy(program);
+        return false;
+    }
+    memcpy(program->text, format, length + 1);
+
+    const char* p = program->text;
+    while (*p) {
+        const char* percent = strchr(p, '%');
+        const char* end = percent != NULL ? percent : p + strlen(p);
+        if (end > p) {
+            FmtSpec* literal = &program->specs[program->count++];
+            literal->kind = FMT_LITERAL;
+            literal->text = p;
+            literal->text_length = (size_t)(end - p);
+        }
+        if (percent == NULL) break;
+        FmtSpec* spec = &program->specs[program->count];
+        p = parse_spec(percent + 1, spec);
+        if (p == NULL) {
+            fmt_program_destroy(program);
+            return false;
+        }
+        program->count++;
+    }
+    return true;
+}
+
+void fmt_program_destroy(FmtProgram* program) {
+    free(program->specs);
+    free(program->text);
+    program->specs = NULL;
+    program->text = NULL;
+    program->count = 0;
+}
+
+int fmt_vformat(const FmtProgram* program, char* buffer, size_t size, va_list args) {
+    Sink sink = {buffer, size, 0};
+    va_list local;
+    va_copy(local, args);
+    for (size_t i = 0; i < program->count; i++) {
+        const FmtSpec* spec = &program->specs[i];
+        if (spec->kind == FMT_LITERAL) {
+            sink_write(&sink, spec->text, spec->text_length);
+        } else if (!emit_spec(&sink, spec, &local)) {
+            va_end(local);
+            sink_finish(&sink);
+            return -1;
+        }
+    }
+    va_end(local);
+    return sink_finish(&sink);
+}
+
+int fmt_format(const FmtProgram* program, char* buffer, size_t size, ...) {
+    va_list args;
+    va_start(args, size);
+    int result = fmt_vformat(program, buffer, size, args);
+    va_end(args);
+    return result;
+}
+
+int fmt_vsnprintf(char* buffer, size_t size, const char* format, va_list args) {
+    Sink sink = {buffer, size, 0};
+    va_list local;
+    va_copy(local, args);
+    const char* p = format;
+    while (*p) {
+        const char* start = p;
+        while (*p && *p != '%') {
+            p++;
+        }
+        if (p > start) sink_write(&sink, start, (size_t)(p - start));
+        if (*p == '\0') break;
+
+        FmtSpec spec;
+        p = parse_spec(p + 1, &spec);
+        if (p == NULL || !emit_spec(&sink, &spec, &local)) {
+            va_end(local);
+            sink_finish(&sink);
+            return -1;
+        }
+    }
+    va_end(local);
+    return sink_finish(&sink);
+}
+
+int fmt_snprintf(char* buffer, size_t size, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    int result = fmt_vsnprintf(buffer, size, format, args);
+    va_end(args);
+    return result;
+}
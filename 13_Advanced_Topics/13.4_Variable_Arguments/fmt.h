@@ -0,0 +1,89 @@
+#ifndef FMT_H
+#define FMT_H
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// printf-compatible formatting engine behind my_sprintf and my_snprintf.
+// Output always matches glibc snprintf; the speed comes from:
+//   - a format precompiler: fmt_compile parses once into a spec list that
+//     fmt_format replays without looking at the format string again
+//   - integer conversion two digits at a time from a 200-byte pair table,
+//     with the digit count from the bit length (no reverse/copy pass)
+//   - %f with precision <= 17 converted exactly in 128-bit integer
+//     arithmetic (round-half-even on the binary value, as glibc does)
+// Conversions without a fast path (%e %g %a %p, long double, huge %f) are
+// handed to snprintf one at a time. All output is bounded by size:
+// results are truncated and NUL-terminated, and the return value is the
+// full length, as with snprintf. %n is rejected (-1).
+
+#define FMT_FLAG_LEFT   0x01    // '-'
+#define FMT_FLAG_PLUS   0x02    // '+'
+#define FMT_FLAG_SPACE  0x04    // ' '
+#define FMT_FLAG_ZERO   0x08    // '0'
+#define FMT_FLAG_ALT    0x10    // '#'
+
+#define FMT_NONE (-1)           // no width / precision given
+#define FMT_STAR (-2)           // taken from the argument list
+
+typedef enum {
+    FMT_LITERAL,
+    FMT_SIGNED,         // d i
+    FMT_UNSIGNED,       // u o x X
+    FMT_CHAR,           // c
+    FMT_STRING,         // s
+    FMT_FIXED,          // f F
+    FMT_DELEGATE,       // e E g G a A p: formatted by snprintf
+    FMT_PERCENT         // %%
+} FmtKind;
+
+typedef enum {
+    FMT_LEN_DEFAULT,
+    FMT_LEN_HH,
+    FMT_LEN_H,
+    FMT_LEN_L,
+    FMT_LEN_LL,
+    FMT_LEN_Z,
+    FMT_LEN_J,
+    FMT_LEN_T,
+    FMT_LEN_LONG_DOUBLE
+} FmtLength;
+
+typedef struct {
+    uint8_t kind;           // FmtKind
+    uint8_t length;         // FmtLength
+    uint8_t flags;          // FMT_FLAG_*
+    char conversion;        // the conversion letter
+    int width;              // FMT_NONE, FMT_STAR or a value
+    int precision;
+    const char* text;       // literal text, or the spec itself for delegation
+    size_t text_length;
+} FmtSpec;
+
+typedef struct {
+    FmtSpec* specs;
+    size_t count;
+    char* text;             // owned copy of the format string
+} FmtProgram;
+
+bool fmt_compile(FmtProgram* program, const char* format);   // false if malformed or %n
+void fmt_program_destroy(FmtProgram* program);
+int fmt_format(const FmtProgram* program, char* buffer, size_t size, ...);
+int fmt_vformat(const FmtProgram* program, char* buffer, size_t size, va_list args);
+
+// One pass over the format, same conversions, no program kept
+int fmt_snprintf(char* buffer, size_t size, const char* format, ...);
+int fmt_vsnprintf(char* buffer, size_t size, const char* format, va_list args);
+
+// Building blocks; no terminator is written
+size_t fmt_u64(char* out, uint64_t value);          // out: 20 bytes
+size_t fmt_i64(char* out, int64_t value);           // out: 20 bytes
+
+// Shortest decimal that reads back as the same double (Ryu): plain
+// notation for exponents -5 .. 16, otherwise d.ddde+XX; "nan", "inf".
+// out: 25 bytes.
+size_t fmt_double_shortest(char* out, double value);
+
+#endif /* FMT_H */
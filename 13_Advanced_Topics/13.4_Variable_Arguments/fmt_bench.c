@@ -0,0 +1,320 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include "fmt.h"
+
+// Formatting throughput against glibc snprintf on the demo's
+// "Value: %d, Pi: %.2f" and on an integer-heavy log line, one pass
+// (fmt_snprintf) and precompiled (fmt_format). Shortest round-trip doubles
+// are timed against "%.17g". Every fmt result is compared byte for byte
+// with snprintf, first across a table of flags/widths/precisions with
+// truncating buffer sizes.
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int failed = 0;
+static size_t checks = 0;
+
+static char expected[1024];
+static char actual[1024];
+
+static void compare(const char* format, size_t size, int expected_length, int actual_length) {
+    checks++;
+    size_t shown = size == 0 ? 0 : strlen(expected) + 1;
+    if (expected_length != actual_length || memcmp(expected, actual, shown) != 0) {
+        if (failed < 10) {
+            printf("  mismatch for \"%s\" (size %zu): \"%s\" (%d) vs \"%s\" (%d)\n", format, size,
+                   expected, expected_length, actual, actual_length);
+        }
+        failed++;
+    }
+}
+
+// Runs both with identical arguments at full size and at truncating sizes;
+// the arguments are evaluated several times, so no side effects
+#define CHECK(format, ...)                                                              \
+    do {                                                                                \
+        static const size_t sizes[] = {sizeof(expected), 0, 1, 4, 9};                  \
+        for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {                 \
+            memset(expected, 'x', sizeof(expected));                                    \
+            memset(actual, 'x', sizeof(actual));                                        \
+            int e = snprintf(expected, sizes[s], format, __VA_ARGS__);                  \
+            int a = fmt_snprintf(actual, sizes[s], format, __VA_ARGS__);                \
+            compare(format, sizes[s], e, a);                                            \
+        }                                                                               \
+    } while (0)
+
+static double random_double(void) {
+    double value;
+    do {
+        uint64_t bits = next_random();
+        memcpy(&value, &bits, sizeof(value));
+    } while (isnan(value) || isinf(value));
+    return value;
+}
+
+// Values near the decimal scale of typical output, where rounding matters
+static double random_moderate(void) {
+    double value = (double)(next_random() % 2000000) / 1000.0 - 1000.0;
+    switch (next_random() % 4) {
+        case 0: return value;
+        case 1: return value / 1e6;
+        case 2: return value * 1e12;
+        default: return (double)(int64_t)(next_random() % 4001 - 2000) / 8.0;   // exact ties
+    }
+}
+
+static void differential_tests(void) {
+    static const char* int_formats[] = {
+        "%d", "%5d", "%-5d|", "%05d", "%+d", "% d", "%.3d", "%8.3d", "%-8.3d|", "%+08d", "%.0d",
+        "%x", "%#x", "%#08X", "%o", "%#o", "%#.0o", "%u", "%hhd", "%hu", "%i", "[%12d]", "%-+6d|"
+    };
+    static const char* double_formats[] = {
+        "%f", "%.0f", "%.1f", "%.2f", "%10.3f", "%-10.3f|", "%010.2f", "%+.2f", "% .2f", "%.17f",
+        "%.20f", "%#.0f", "%F", "%e", "%.3e", "%g", "%a", "%+012.4f", "%-+9.1f|"
+    };
+    static const char* string_formats[] = {"%s", "%10s", "%-10s|", "%.3s", "%10.3s", "<%-2.1s>"};
+    static const double special[] = {0.0, -0.0, 0.5, 1.5, 2.5, -2.5, 0.125, 0.005, 2.675, 1e-300,
+                                     4.9e-324, 1e300, 9.2e18, 1.8e19, 123456789.987654321, NAN,
+                                     INFINITY, -INFINITY};
+    static const int special_ints[] = {0, 1, -1, 7, 100, INT_MAX, INT_MIN, 255, -128};
+
+    for (int round = 0; round < 400; round++) {
+        int i = round < 9 ? special_ints[round] : (int)next_random() >> (next_random() % 31);
+        for (size_t f = 0; f < sizeof(int_formats) / sizeof(int_formats[0]); f++) {
+            CHECK(int_formats[f], i);
+        }
+        double d = round < 18 ? special[round] : (round % 2 ? random_moderate() : random_double());
+        for (size_t f = 0; f < sizeof(double_formats) / sizeof(double_formats[0]); f++) {
+            CHECK(double_formats[f], d);
+        }
+        long long ll = (long long)next_random();
+        CHECK("%lld", ll);
+        CHECK("%20lld", ll);
+        CHECK("%llx", (unsigned long long)ll);
+        CHECK("%#llo", (unsigned long long)ll);
+        CHECK("%zu", (size_t)ll);
+        int width = (int)(next_random() % 21) - 10;
+        int precision = (int)(next_random() % 22) - 2;
+        CHECK("%*d|", width, i);
+        CHECK("%.*f", precision, d);
+        CHECK("%-*.*d|", 12, precision, i);
+        CHECK("Value: %d, Pi: %.2f", i, d);
+        CHECK("%c%3c%-3c|", 'a' + round % 26, 'Z', '!');
+        CHECK("100%% %s", "done");
+    }
+    const char* strings[] = {"", "a", "hello", "variadic arguments", NULL};
+    for (size_t s = 0; s < sizeof(strings) / sizeof(strings[0]); s++) {
+        for (size_t f = 0; f < sizeof(string_formats) / sizeof(string_formats[0]); f++) {
+            if (strings[s] == NULL && f == 3) continue;     // "%.3s" of NULL differs by libc version
+            CHECK(string_formats[f], strings[s]);
+        }
+    }
+    CHECK("%p", (void*)&failed);
+    CHECK("%Lf", 1.25L);
+    CHECK("%.2f", 1e300);       // 300+ digits: snprintf through a heap buffer
+
+    FmtProgram program;
+    if (fmt_compile(&program, "%n") || !fmt_compile(&program, "a%db")) failed++;
+    fmt_program_destroy(&program);
+    printf("Differential checks against snprintf: %zu\n\n", checks);
+}
+
+static void report(const char* name, size_t ops, double seconds, double baseline) {
+    printf("  %-28s %12.0f ops/s  %8.1f ns/op", name, ops / seconds, seconds * 1e9 / ops);
+    if (baseline > 0) printf("  %6.2fx", baseline / seconds);
+    printf("\n");
+}
+
+static void bench_demo_format(size_t ops) {
+    int* ints = malloc(ops * sizeof(int));
+    double* doubles = malloc(ops * sizeof(double));
+    if (ints == NULL || doubles == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < ops; i++) {
+        ints[i] = (int)(next_random() % 2000001) - 1000000;
+        doubles[i] = random_moderate();
+    }
+    printf("\"Value: %%d, Pi: %%.2f\":\n");
+
+    char buffer[128], other[128];
+    size_t total = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        total += (size_t)snprintf(buffer, sizeof(buffer), "Value: %d, Pi: %.2f", ints[i], doubles[i]);
+    }
+    double baseline = now_seconds() - start;
+    report("snprintf", ops, baseline, 0);
+
+    size_t fast_total = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        fast_total += (size_t)fmt_snprintf(buffer, sizeof(buffer), "Value: %d, Pi: %.2f", ints[i], doubles[i]);
+    }
+    double seconds = now_seconds() - start;
+    report("fmt_snprintf", ops, seconds, baseline);
+    failed |= fast_total != total;
+
+    FmtProgram program;
+    if (!fmt_compile(&program, "Value: %d, Pi: %.2f")) exit(1);
+    fast_total = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        fast_total += (size_t)fmt_format(&program, buffer, sizeof(buffer), ints[i], doubles[i]);
+    }
+    seconds = now_seconds() - start;
+    report("fmt_format (precompiled)", ops, seconds, baseline);
+    failed |= fast_total != total;
+
+    for (size_t i = 0; i < ops; i += 97) {
+        snprintf(buffer, sizeof(buffer), "Value: %d, Pi: %.2f", ints[i], doubles[i]);
+        fmt_format(&program, other, sizeof(other), ints[i], doubles[i]);
+        failed |= strcmp(buffer, other) != 0;
+    }
+    fmt_program_destroy(&program);
+    printf("\n");
+    free(ints);
+    free(doubles);
+}
+
+static void bench_integer_format(size_t ops) {
+    static const char* format = "[%s] id=%u len=%zu offset=%lld crc=%08x";
+    printf("\"%s\":\n", format);
+    char buffer[128];
+    uint64_t saved = rng_state;
+    size_t total = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t r = next_random();
+        total += (size_t)snprintf(buffer, sizeof(buffer), format, "read", (unsigned)r, (size_t)(r >> 40),
+                                  (long long)r, (unsigned)(r >> 17));
+    }
+    double baseline = now_seconds() - start;
+    report("snprintf", ops, baseline, 0);
+
+    FmtProgram program;
+    if (!fmt_compile(&program, format)) exit(1);
+    rng_state = saved;
+    size_t fast_total = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        uint64_t r = next_random();
+        fast_total += (size_t)fmt_format(&program, buffer, sizeof(buffer), "read", (unsigned)r,
+                                         (size_t)(r >> 40), (long long)r, (unsigned)(r >> 17));
+    }
+    double seconds = now_seconds() - start;
+    report("fmt_format (precompiled)", ops, seconds, baseline);
+    failed |= fast_total != total;
+    fmt_program_destroy(&program);
+    printf("\n");
+}
+
+#if defined(__SIZEOF_INT128__)
+static size_t significant_digits(const char* text) {
+    size_t count = 0, pending_zeros = 0;
+    bool leading = true;
+    for (const char* p = text; *p && *p != 'e'; p++) {
+        if (*p < '0' || *p > '9') continue;
+        if (*p == '0') {
+            if (!leading) pending_zeros++;
+            continue;
+        }
+        leading = false;
+        count += pending_zeros + 1;
+        pending_zeros = 0;
+    }
+    return count;
+}
+#endif
+
+static void bench_shortest(size_t ops) {
+    double* values = malloc(ops * sizeof(double));
+    if (values == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < ops; i++) {
+        values[i] = i % 2 ? random_double() : random_moderate();
+    }
+    printf("Shortest round-trip double:\n");
+
+    char buffer[32];
+    size_t total = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        total += (size_t)snprintf(buffer, sizeof(buffer), "%.17g", values[i]);
+    }
+    double baseline = now_seconds() - start;
+    report("snprintf \"%.17g\"", ops, baseline, 0);
+
+    total = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        total += fmt_double_shortest(buffer, values[i]);
+    }
+    double seconds = now_seconds() - start;
+    report("fmt_double_shortest", ops, seconds, baseline);
+    printf("  average length %.1f characters\n", (double)total / ops);
+
+    // Reads back exactly, and the correctly rounded form with one digit
+    // fewer does not
+    for (size_t i = 0; i < ops; i += 7) {
+        size_t n = fmt_double_shortest(buffer, values[i]);
+        buffer[n] = '\0';
+        failed |= strtod(buffer, NULL) != values[i];
+        // Without 128-bit products the fallback prints 17 digits
+#if defined(__SIZEOF_INT128__)
+        size_t digits = significant_digits(buffer);
+        if (digits > 1) {
+            char shorter[40];
+            snprintf(shorter, sizeof(shorter), "%.*e", (int)digits - 2, values[i]);
+            failed |= strtod(shorter, NULL) == values[i];
+        }
+#endif
+    }
+    free(values);
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    long ops_arg = argc > 1 ? atol(argv[1]) : 2000000;
+    if (ops_arg < 1000 || ops_arg > 100000000) {
+        fprintf(stderr, "Usage: %s [operations, 1000 .. 1e8]\n", argv[0]);
+        return 1;
+    }
+    size_t ops = (size_t)ops_arg;
+
+    printf("=== Formatting Benchmark ===\n");
+    printf("%zu operations per run\n\n", ops);
+    differential_tests();
+    bench_demo_format(ops);
+    bench_integer_format(ops);
+    bench_shortest(ops);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
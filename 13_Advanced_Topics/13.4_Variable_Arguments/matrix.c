@@ -0,0 +1,442 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "matrix.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define MATRIX_X86 1
+#include <immintrin.h>
+#else
+#define MATRIX_X86 0
+#endif
+
+#define GEMM_MR 6
+#define GEMM_NR 8
+#define GEMM_KC 256                 // a kc x 8 B panel (16 KB) stays in L1
+#define GEMM_MC 96                  // an MC x KC A block (192 KB) stays in L2
+#define GEMM_NC 2048                // a KC x NC B block (4 MB) is shared in L3
+#define TRANSPOSE_BLOCK 32
+#define PARALLEL_FLOPS (1 << 22)    // below this, threads cost more than they save
+#define GEMV_CHUNK 64               // rows per parallel task
+
+static int min_int(int a, int b) {
+    return a < b ? a : b;
+}
+
+static double* aligned_doubles(size_t count) {
+    void* block = NULL;
+    if (posix_memalign(&block, MATRIX_ALIGNMENT, (count > 0 ? count : 1) * sizeof(double)) != 0) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    return block;
+}
+
+// ---------------------------------------------------------------------
+// Portable kernels
+
+static void gemm_tile_scalar(int kc, const double* a, const double* b, double* c, int ldc, int m, int n) {
+    double acc[GEMM_MR][GEMM_NR] = {{0}};
+    for (int k = 0; k < kc; k++) {
+        for (int r = 0; r < GEMM_MR; r++) {
+            double ar = a[r];
+            for (int j = 0; j < GEMM_NR; j++) {
+                acc[r][j] += ar * b[j];
+            }
+        }
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+    for (int r = 0; r < m; r++) {
+        for (int j = 0; j < n; j++) {
+            c[(size_t)r * ldc + j] += acc[r][j];
+        }
+    }
+}
+
+static void gemv_rows_scalar(int rows, int cols, const double* a, int lda, const double* x, double* out) {
+    for (int i = 0; i < rows; i++) {
+        const double* row = a + (size_t)i * lda;
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;     // independent chains
+        int j = 0;
+        for (; j + 4 <= cols; j += 4) {
+            s0 += row[j] * x[j];
+            s1 += row[j + 1] * x[j + 1];
+            s2 += row[j + 2] * x[j + 2];
+            s3 += row[j + 3] * x[j + 3];
+        }
+        for (; j < cols; j++) {
+            s0 += row[j] * x[j];
+        }
+        out[i] = (s0 + s1) + (s2 + s3);
+    }
+}
+
+static const MatrixKernels portable_kernels = {gemm_tile_scalar, gemv_rows_scalar, "scalar"};
+
+// ---------------------------------------------------------------------
+// AVX2 / FMA kernels
+
+#if MATRIX_X86
+// 12 accumulators hold the 6x8 tile; per k, two B loads and six
+// broadcasts feed 12 FMAs, enough to cover the FMA latency on two ports
+#define TILE_ROW(r, lo, hi)                             \
+    do {                                                \
+        __m256d ar = _mm256_broadcast_sd(a + (r));      \
+        lo = _mm256_fmadd_pd(ar, b0, lo);               \
+        hi = _mm256_fmadd_pd(ar, b1, hi);               \
+    } while (0)
+
+#define TILE_STORE(r, lo, hi)                                                           \
+    do {                                                                                \
+        double* row = c + (size_t)(r) * ldc;                                            \
+        _mm256_storeu_pd(row, _mm256_add_pd(_mm256_loadu_pd(row), lo));                 \
+        _mm256_storeu_pd(row + 4, _mm256_add_pd(_mm256_loadu_pd(row + 4), hi));         \
+    } while (0)
+
+__attribute__((target("avx2,fma")))
+static void gemm_tile_avx2(int kc, const double* a, const double* b, double* c, int ldc, int m, int n) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    __m256d c40 = _mm256_setzero_pd(), c41 = _mm256_setzero_pd();
+    __m256d c50 = _mm256_setzero_pd(), c51 = _mm256_setzero_pd();
+
+    for (int k = 0; k < kc; k++) {
+        __m256d b0 = _mm256_load_pd(b);
+        __m256d b1 = _mm256_load_pd(b + 4);
+        TILE_ROW(0, c00, c01);
+        TILE_ROW(1, c10, c11);
+        TILE_ROW(2, c20, c21);
+        TILE_ROW(3, c30, c31);
+        TILE_ROW(4, c40, c41);
+        TILE_ROW(5, c50, c51);
+        a += GEMM_MR;
+        b += GEMM_NR;
+    }
+
+    if (m == GEMM_MR && n == GEMM_NR) {
+        TILE_STORE(0, c00, c01);
+        TILE_STORE(1, c10, c11);
+        TILE_STORE(2, c20, c21);
+        TILE_STORE(3, c30, c31);
+        TILE_STORE(4, c40, c41);
+        TILE_STORE(5, c50, c51);
+        return;
+    }
+
+    // Edge tile: spill and add only the valid part
+    double tile[GEMM_MR][GEMM_NR];
+    _mm256_storeu_pd(tile[0], c00);
+    _mm256_storeu_pd(tile[0] + 4, c01);
+    _mm256_storeu_pd(tile[1], c10);
+    _mm256_storeu_pd(tile[1] + 4, c11);
+    _mm256_storeu_pd(tile[2], c20);
+    _mm256_storeu_pd(tile[2] + 4, c21);
+    _mm256_storeu_pd(tile[3], c30);
+    _mm256_storeu_pd(tile[3] + 4, c31);
+    _mm256_storeu_pd(tile[4], c40);
+    _mm256_storeu_pd(tile[4] + 4, c41);
+    _mm256_storeu_pd(tile[5], c50);
+    _mm256_storeu_pd(tile[5] + 4, c51);
+    for (int r = 0; r < m; r++) {
+        for (int j = 0; j < n; j++) {
+            c[(size_t)r * ldc + j] += tile[r][j];
+        }
+    }
+}
+
+__attribute__((target("avx2,fma")))
+static double horizontal_sum(__m256d v) {
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+// Four rows share each load of x
+__attribute__((target("avx2,fma")))
+static void gemv_rows_avx2(int rows, int cols, const double* a, int lda, const double* x, double* out) {
+    int i = 0;
+    for (; i + 4 <= rows; i += 4) {
+        const double* r0 = a + (size_t)i * lda;
+        const double* r1 = r0 + lda;
+        const double* r2 = r1 + lda;
+        const double* r3 = r2 + lda;
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        __m256d s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        int j = 0;
+        for (; j + 4 <= cols; j += 4) {
+            __m256d xv = _mm256_loadu_pd(x + j);
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(r0 + j), xv, s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(r1 + j), xv, s1);
+            s2 = _mm256_fmadd_pd(_mm256_loadu_pd(r2 + j), xv, s2);
+            s3 = _mm256_fmadd_pd(_mm256_loadu_pd(r3 + j), xv, s3);
+        }
+        double t0 = horizontal_sum(s0), t1 = horizontal_sum(s1);
+        double t2 = horizontal_sum(s2), t3 = horizontal_sum(s3);
+        for (; j < cols; j++) {
+            t0 += r0[j] * x[j];
+            t1 += r1[j] * x[j];
+            t2 += r2[j] * x[j];
+            t3 += r3[j] * x[j];
+        }
+        out[i] = t0;
+        out[i + 1] = t1;
+        out[i + 2] = t2;
+        out[i + 3] = t3;
+    }
+    for (; i < rows; i++) {
+        const double* row = a + (size_t)i * lda;
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        int j = 0;
+        for (; j + 8 <= cols; j += 8) {
+            s0 = _mm256_fmadd_pd(_mm256_loadu_pd(row + j), _mm256_loadu_pd(x + j), s0);
+            s1 = _mm256_fmadd_pd(_mm256_loadu_pd(row + j + 4), _mm256_loadu_pd(x + j + 4), s1);
+        }
+        double t = horizontal_sum(_mm256_add_pd(s0, s1));
+        for (; j < cols; j++) {
+            t += row[j] * x[j];
+        }
+        out[i] = t;
+    }
+}
+
+static const MatrixKernels avx2_kernels = {gemm_tile_avx2, gemv_rows_avx2, "avx2+fma"};
+#endif /* MATRIX_X86 */
+
+// ---------------------------------------------------------------------
+// Dispatch
+
+static const MatrixKernels* active_kernels = &portable_kernels;
+
+void matrix_init(void) {
+#if MATRIX_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        active_kernels = &avx2_kernels;
+    }
+#endif
+}
+
+const MatrixKernels* matrix_kernels(void) {
+    return active_kernels;
+}
+
+const MatrixKernels* matrix_portable_kernels(void) {
+    return &portable_kernels;
+}
+
+void matrix_select_kernels(const MatrixKernels* kernels) {
+    active_kernels = kernels;
+}
+
+// ---------------------------------------------------------------------
+// Storage
+
+Matrix* matrix_create(int rows, int cols) {
+    if (rows < 0 || cols < 0) return NULL;
+    Matrix* matrix = malloc(sizeof(Matrix));
+    if (matrix == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    int per_line = MATRIX_ALIGNMENT / (int)sizeof(double);
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->stride = (cols + per_line - 1) / per_line * per_line;
+    size_t count = (size_t)rows * (size_t)matrix->stride;
+    matrix->data = aligned_doubles(count);
+    if (matrix->data == NULL) {
+        free(matrix);
+        return NULL;
+    }
+    memset(matrix->data, 0, count * sizeof(double));
+    return matrix;
+}
+
+void matrix_destroy(Matrix* matrix) {
+    if (matrix) {
+        free(matrix->data);
+        free(matrix);
+    }
+}
+
+Matrix matrix_view(const Matrix* matrix, int row, int col, int rows, int cols) {
+    Matrix view;
+    view.data = matrix_row(matrix, row) + col;
+    view.rows = rows;
+    view.cols = cols;
+    view.stride = matrix->stride;
+    return view;
+}
+
+// ---------------------------------------------------------------------
+// GEMM
+
+static bool worth_threads(double flops) {
+#ifdef _OPENMP
+    return flops >= PARALLEL_FLOPS && omp_get_max_threads() > 1;
+#else
+    (void)flops;
+    return false;
+#endif
+}
+
+static void scale_matrix(Matrix* c, double beta) {
+    if (beta == 1.0) return;
+    for (int i = 0; i < c->rows; i++) {
+        double* row = matrix_row(c, i);
+        if (beta == 0.0) {
+            memset(row, 0, (size_t)c->cols * sizeof(double));     // drops NaNs too, as BLAS does
+        } else {
+            for (int j = 0; j < c->cols; j++) {
+                row[j] *= beta;
+            }
+        }
+    }
+}
+
+// MR-row panels, k-major, alpha folded in, short panels zero-padded
+static void pack_a(int mc, int kc, const double* a, int lda, double alpha, double* out) {
+    for (int ir = 0; ir < mc; ir += GEMM_MR) {
+        int rows = min_int(GEMM_MR, mc - ir);
+        for (int k = 0; k < kc; k++) {
+            for (int r = 0; r < rows; r++) {
+                out[r] = alpha * a[(size_t)(ir + r) * lda + k];
+            }
+            for (int r = rows; r < GEMM_MR; r++) {
+                out[r] = 0.0;
+            }
+            out += GEMM_MR;
+        }
+    }
+}
+
+// NR-column panels, k-major, short panels zero-padded
+static void pack_b(int kc, int nc, const double* b, int ldb, double* out) {
+    for (int jr = 0; jr < nc; jr += GEMM_NR) {
+        int cols = min_int(GEMM_NR, nc - jr);
+        for (int k = 0; k < kc; k++) {
+            const double* src = b + (size_t)k * ldb + jr;
+            for (int j = 0; j < cols; j++) {
+                out[j] = src[j];
+            }
+            for (int j = cols; j < GEMM_NR; j++) {
+                out[j] = 0.0;
+            }
+            out += GEMM_NR;
+        }
+    }
+}
+
+bool matrix_gemm(double alpha, const Matrix* a, const Matrix* b, double beta, Matrix* c) {
+    if (a->cols != b->rows || c->rows != a->rows || c->cols != b->cols) return false;
+    int m = a->rows, n = b->cols, k = a->cols;
+    scale_matrix(c, beta);
+    if (m == 0 || n == 0 || k == 0 || alpha == 0.0) return true;
+
+    const MatrixKernels* kernels = active_kernels;
+    bool parallel = worth_threads(2.0 * m * n * k);
+    (void)parallel;
+    int threads = 1;
+#ifdef _OPENMP
+    if (parallel) threads = omp_get_max_threads();
+#endif
+    int kc_max = min_int(k, GEMM_KC);
+    int nc_max = (min_int(n, GEMM_NC) + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+    int mc_max = (min_int(m, GEMM_MC) + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+    double* packed_b = aligned_doubles((size_t)kc_max * nc_max);
+    double* packed_a = aligned_doubles((size_t)threads * kc_max * mc_max);
+    if (packed_b == NULL || packed_a == NULL) {
+        free(packed_b);
+        free(packed_a);
+        return false;
+    }
+
+    for (int jc = 0; jc < n; jc += GEMM_NC) {
+        int nc = min_int(GEMM_NC, n - jc);
+        for (int pc = 0; pc < k; pc += GEMM_KC) {
+            int kc = min_int(GEMM_KC, k - pc);
+            pack_b(kc, nc, matrix_row(b, pc) + jc, b->stride, packed_b);
+
+            int blocks = (m + GEMM_MC - 1) / GEMM_MC;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(threads) if (parallel)
+#endif
+            for (int block = 0; block < blocks; block++) {
+                int thread = 0;
+#ifdef _OPENMP
+                thread = omp_get_thread_num();
+#endif
+                int ic = block * GEMM_MC;
+                int mc = min_int(GEMM_MC, m - ic);
+                double* panel_a = packed_a + (size_t)thread * kc_max * mc_max;
+                pack_a(mc, kc, matrix_row(a, ic) + pc, a->stride, alpha, panel_a);
+
+                // The B panel stays in L1 while every A panel streams past it
+                for (int jr = 0; jr < nc; jr += GEMM_NR) {
+                    for (int ir = 0; ir < mc; ir += GEMM_MR) {
+                        kernels->gemm_tile(kc, panel_a + (size_t)ir * kc, packed_b + (size_t)jr * kc,
+                                           matrix_row(c, ic + ir) + jc + jr, c->stride,
+                                           min_int(GEMM_MR, mc - ir), min_int(GEMM_NR, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+    free(packed_b);
+    free(packed_a);
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// GEMV and transpose
+
+void matrix_gemv(double alpha, const Matrix* a, const double* x, double beta, double* y) {
+    const MatrixKernels* kernels = active_kernels;
+    int chunks = (a->rows + GEMV_CHUNK - 1) / GEMV_CHUNK;
+    bool parallel = worth_threads(2.0 * a->rows * a->cols);
+    (void)parallel;
+#ifdef _OPENMP
+#pragma omp parallel for if (parallel)
+#endif
+    for (int chunk = 0; chunk < chunks; chunk++) {
+        int first = chunk * GEMV_CHUNK;
+        int rows = min_int(GEMV_CHUNK, a->rows - first);
+        double dots[GEMV_CHUNK];
+        kernels->gemv_rows(rows, a->cols, matrix_row(a, first), a->stride, x, dots);
+        for (int i = 0; i < rows; i++) {
+            y[first + i] = alpha * dots[i] + (beta == 0.0 ? 0.0 : beta * y[first + i]);
+        }
+    }
+}
+
+bool matrix_transpose(Matrix* dst, const Matrix* src) {
+    if (dst->rows != src->cols || dst->cols != src->rows) return false;
+    int blocks = (src->rows + TRANSPOSE_BLOCK - 1) / TRANSPOSE_BLOCK;
+    bool parallel = worth_threads(16.0 * src->rows * src->cols);
+    (void)parallel;
+#ifdef _OPENMP
+#pragma omp parallel for if (parallel)
+#endif
+    for (int block = 0; block < blocks; block++) {
+        int i0 = block * TRANSPOSE_BLOCK;
+        int i1 = min_int(i0 + TRANSPOSE_BLOCK, src->rows);
+        for (int j0 = 0; j0 < src->cols; j0 += TRANSPOSE_BLOCK) {
+            int j1 = min_int(j0 + TRANSPOSE_BLOCK, src->cols);
+            for (int i = i0; i < i1; i++) {
+                const double* row = matrix_row(src, i);
+                for (int j = j0; j < j1; j++) {
+                    matrix_row(dst, j)[i] = row[j];
+                }
+            }
+        }
+    }
+    return true;
+}
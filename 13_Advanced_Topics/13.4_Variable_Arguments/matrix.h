@@ -0,0 +1,62 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Dense row-major matrices of doubles for create_matrix_from_values.
+// Storage is one 64-byte-aligned block; row i starts at data + i * stride.
+// Owned matrices round the stride up to 8 doubles so every row starts on
+// a cache line; views share their parent's storage and stride.
+//
+// BLAS-like kernels, each with a scalar and an AVX2/FMA variant picked at
+// runtime (matrix_init):
+//   gemm       C = alpha * A * B + beta * C. B is packed into KC x NC
+//              blocks and A into MC x KC blocks, and a 6x8 register tile
+//              accumulates each block product (Goto's layout)
+//   gemv       y = alpha * A * x + beta * y, four rows per pass over x
+//   transpose  through 32x32 blocks that stay in L1
+// Built with -fopenmp, large problems are split across threads.
+
+#define MATRIX_ALIGNMENT 64
+
+typedef struct {
+    double* data;
+    int rows;
+    int cols;
+    int stride;             // elements between row starts, >= cols
+} Matrix;
+
+typedef struct {
+    // c[0..m)[0..n) += packed 6 x kc A panel times packed kc x 8 B panel
+    void (*gemm_tile)(int kc, const double* a, const double* b, double* c, int ldc, int m, int n);
+    // out[i] = dot(row i, x) for rows consecutive rows of lda elements
+    void (*gemv_rows)(int rows, int cols, const double* a, int lda, const double* x, double* out);
+    const char* name;
+} MatrixKernels;
+
+// Picks the AVX2/FMA kernels when the CPU has them
+void matrix_init(void);
+const MatrixKernels* matrix_kernels(void);                 // active table
+const MatrixKernels* matrix_portable_kernels(void);
+void matrix_select_kernels(const MatrixKernels* kernels);   // for comparisons
+
+Matrix* matrix_create(int rows, int cols);      // zero-filled, NULL on failure
+void matrix_destroy(Matrix* matrix);
+
+// rows x cols window at (row, col); never destroyed
+Matrix matrix_view(const Matrix* matrix, int row, int col, int rows, int cols);
+
+static inline double* matrix_row(const Matrix* matrix, int row) {
+    return matrix->data + (size_t)row * (size_t)matrix->stride;
+}
+
+// gemm and transpose return false on mismatched shapes or a failed
+// allocation. Outputs must not overlap the inputs.
+bool matrix_gemm(double alpha, const Matrix* a, const Matrix* b, double beta, Matrix* c);
+bool matrix_transpose(Matrix* dst, const Matrix* src);
+
+// x has a->cols elements, y has a->rows
+void matrix_gemv(double alpha, const Matrix* a, const double* x, double beta, double* y);
+
+#endif /* MATRIX_H */
@@ -0,0 +1,559 @@
+#include "reduce.h"
+
+#ifdef _OPENMP
+#define REDUCE_PARALLEL_FOR _Pragma("omp parallel for schedule(static)")
+#else
+#define REDUCE_PARALLEL_FOR
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define REDUCE_X86 1
+#include <immintrin.h>
+#else
+#define REDUCE_X86 0
+#endif
+
+#define REDUCE_MAX_CHUNKS 64
+#define REDUCE_CHUNK_MIN (1 << 16)
+
+// Accumulator per element type: integers wrap in unsigned arithmetic
+#define REDUCE_ACC_i32 uint64_t
+#define REDUCE_ACC_i64 uint64_t
+#define REDUCE_ACC_f32 double
+#define REDUCE_ACC_f64 double
+
+static double abs_double(double x) {
+    return x < 0 ? -x : x;
+}
+
+// Neumaier's variant of Kahan summation: the compensation also holds when
+// the new term is larger than the running sum
+static void neumaier_add(double* sum, double* compensation, double x) {
+    double t = *sum + x;
+    if (abs_double(*sum) >= abs_double(x)) {
+        *compensation += (*sum - t) + x;
+    } else {
+        *compensation += (x - t) + *sum;
+    }
+    *sum = t;
+}
+
+// ---------------------------------------------------------------------
+// Portable kernels, one set per element type
+
+#define DEFINE_SCALAR_KERNELS(suffix, T, S)                                             \
+    static S sum_##suffix##_scalar(const T* values, size_t count) {                     \
+        REDUCE_ACC_##suffix a0 = 0, a1 = 0, a2 = 0, a3 = 0;                             \
+        size_t i = 0;                                                                   \
+        for (; i + 4 <= count; i += 4) {                                                \
+            a0 += (REDUCE_ACC_##suffix)values[i];                                       \
+            a1 += (REDUCE_ACC_##suffix)values[i + 1];                                   \
+            a2 += (REDUCE_ACC_##suffix)values[i + 2];                                   \
+            a3 += (REDUCE_ACC_##suffix)values[i + 3];                                   \
+        }                                                                               \
+        for (; i < count; i++) {                                                        \
+            a0 += (REDUCE_ACC_##suffix)values[i];                                       \
+        }                                                                               \
+        return (S)((a0 + a1) + (a2 + a3));                                              \
+    }                                                                                   \
+                                                                                        \
+    static void minmax_##suffix##_scalar(const T* values, size_t count, T* min, T* max) { \
+        T lo = values[0], hi = values[0];                                               \
+        for (size_t i = 1; i < count; i++) {                                            \
+            if (values[i] < lo) lo = values[i];                                         \
+            if (values[i] > hi) hi = values[i];                                         \
+        }                                                                               \
+        *min = lo;                                                                      \
+        *max = hi;                                                                      \
+    }                                                                                   \
+                                                                                        \
+    static void sqdev_##suffix##_scalar(const T* values, size_t count, double mean,     \
+                                        double out[2]) {                                \
+        double sq = 0.0, dev = 0.0;                                                     \
+        for (size_t i = 0; i < count; i++) {                                            \
+            double d = (double)values[i] - mean;                                        \
+            sq += d * d;                                                                \
+            dev += d;                                                                   \
+        }                                                                               \
+        out[0] = sq;                                                                    \
+        out[1] = dev;                                                                   \
+    }
+
+REDUCE_TYPES(DEFINE_SCALAR_KERNELS)
+
+#define DEFINE_SCALAR_KAHAN(suffix, T)                                                  \
+    static void kahan_##suffix##_scalar(const T* values, size_t count, double out[2]) { \
+        double sum = 0.0, compensation = 0.0;                                           \
+        for (size_t i = 0; i < count; i++) {                                            \
+            neumaier_add(&sum, &compensation, (double)values[i]);                       \
+        }                                                                               \
+        out[0] = sum;                                                                   \
+        out[1] = compensation;                                                          \
+    }
+
+DEFINE_SCALAR_KAHAN(f32, float)
+DEFINE_SCALAR_KAHAN(f64, double)
+
+#define SCALAR_FIELDS(suffix, T, S)                     \
+    .sum_##suffix = sum_##suffix##_scalar,              \
+    .minmax_##suffix = minmax_##suffix##_scalar,        \
+    .sqdev_##suffix = sqdev_##suffix##_scalar,
+
+static const ReduceKernels portable_kernels = {
+    REDUCE_TYPES(SCALAR_FIELDS)
+    .kahan_f32 = kahan_f32_scalar,
+    .kahan_f64 = kahan_f64_scalar,
+    .name = "scalar"
+};
+
+// ---------------------------------------------------------------------
+// AVX2 kernels
+
+#if REDUCE_X86
+__attribute__((target("avx2")))
+static uint64_t horizontal_add_epi64(__m256i v) {
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i*)lanes, v);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3];
+}
+
+__attribute__((target("avx2")))
+static double horizontal_add_pd(__m256d v) {
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+// Each half of eight ints is sign-extended into four 64-bit lanes
+__attribute__((target("avx2")))
+static int64_t sum_i32_avx2(const int32_t* values, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(v)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(v, 1)));
+    }
+    uint64_t total = horizontal_add_epi64(_mm256_add_epi64(acc0, acc1));
+    for (; i < count; i++) {
+        total += (uint64_t)values[i];
+    }
+    return (int64_t)total;
+}
+
+__attribute__((target("avx2")))
+static int64_t sum_i64_avx2(const int64_t* values, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256(), acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_epi64(acc0, _mm256_loadu_si256((const __m256i*)(values + i)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_loadu_si256((const __m256i*)(values + i + 4)));
+    }
+    uint64_t total = horizontal_add_epi64(_mm256_add_epi64(acc0, acc1));
+    for (; i < count; i++) {
+        total += (uint64_t)values[i];
+    }
+    return (int64_t)total;
+}
+
+// Four accumulators cover the latency of the vector add
+__attribute__((target("avx2")))
+static double sum_f32_avx2(const float* values, size_t count) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256 lo = _mm256_loadu_ps(values + i);
+        __m256 hi = _mm256_loadu_ps(values + i + 8);
+        a0 = _mm256_add_pd(a0, _mm256_cvtps_pd(_mm256_castps256_ps128(lo)));
+        a1 = _mm256_add_pd(a1, _mm256_cvtps_pd(_mm256_extractf128_ps(lo, 1)));
+        a2 = _mm256_add_pd(a2, _mm256_cvtps_pd(_mm256_castps256_ps128(hi)));
+        a3 = _mm256_add_pd(a3, _mm256_cvtps_pd(_mm256_extractf128_ps(hi, 1)));
+    }
+    double total = horizontal_add_pd(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < count; i++) {
+        total += (double)values[i];
+    }
+    return total;
+}
+
+__attribute__((target("avx2")))
+static double sum_f64_avx2(const double* values, size_t count) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    __m256d a2 = _mm256_setzero_pd(), a3 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(values + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(values + i + 4));
+        a2 = _mm256_add_pd(a2, _mm256_loadu_pd(values + i + 8));
+        a3 = _mm256_add_pd(a3, _mm256_loadu_pd(values + i + 12));
+    }
+    double total = horizontal_add_pd(_mm256_add_pd(_mm256_add_pd(a0, a1), _mm256_add_pd(a2, a3)));
+    for (; i < count; i++) {
+        total += values[i];
+    }
+    return total;
+}
+
+__attribute__((target("avx2")))
+static void minmax_i32_avx2(const int32_t* values, size_t count, int32_t* min, int32_t* max) {
+    __m256i lo = _mm256_set1_epi32(values[0]), hi = lo;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(values + i));
+        lo = _mm256_min_epi32(lo, v);
+        hi = _mm256_max_epi32(hi, v);
+    }
+    int32_t lanes_lo[8], lanes_hi[8];
+    _mm256_storeu_si256((__m256i*)lanes_lo, lo);
+    _mm256_storeu_si256((__m256i*)lanes_hi, hi);
+    minmax_i32_scalar(lanes_lo, 8, min, &lanes_lo[0]);
+    minmax_i32_scalar(lanes_hi, 8, &lanes_hi[0], max);
+    for (; i < count; i++) {
+        if (values[i] < *min) *min = values[i];
+        if (values[i] > *max) *max = values[i];
+    }
+}
+
+// No 64-bit min/max in AVX2: compare and blend
+__attribute__((target("avx2")))
+static void minmax_i64_avx2(const int64_t* values, size_t count, int64_t* min, int64_t* max) {
+    __m256i lo0 = _mm256_set1_epi64x(values[0]), hi0 = lo0, lo1 = lo0, hi1 = lo0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v0 = _mm256_loadu_si256((const __m256i*)(values + i));
+        __m256i v1 = _mm256_loadu_si256((const __m256i*)(values + i + 4));
+        lo0 = _mm256_blendv_epi8(lo0, v0, _mm256_cmpgt_epi64(lo0, v0));
+        hi0 = _mm256_blendv_epi8(hi0, v0, _mm256_cmpgt_epi64(v0, hi0));
+        lo1 = _mm256_blendv_epi8(lo1, v1, _mm256_cmpgt_epi64(lo1, v1));
+        hi1 = _mm256_blendv_epi8(hi1, v1, _mm256_cmpgt_epi64(v1, hi1));
+    }
+    int64_t lanes_lo[8], lanes_hi[8];
+    _mm256_storeu_si256((__m256i*)lanes_lo, lo0);
+    _mm256_storeu_si256((__m256i*)(lanes_lo + 4), lo1);
+    _mm256_storeu_si256((__m256i*)lanes_hi, hi0);
+    _mm256_storeu_si256((__m256i*)(lanes_hi + 4), hi1);
+    minmax_i64_scalar(lanes_lo, 8, min, &lanes_lo[0]);
+    minmax_i64_scalar(lanes_hi, 8, &lanes_hi[0], max);
+    for (; i < count; i++) {
+        if (values[i] < *min) *min = values[i];
+        if (values[i] > *max) *max = values[i];
+    }
+}
+
+__attribute__((target("avx2")))
+static void minmax_f32_avx2(const float* values, size_t count, float* min, float* max) {
+    __m256 lo = _mm256_set1_ps(values[0]), hi = lo;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(values + i);
+        lo = _mm256_min_ps(lo, v);
+        hi = _mm256_max_ps(hi, v);
+    }
+    float lanes_lo[8], lanes_hi[8];
+    _mm256_storeu_ps(lanes_lo, lo);
+    _mm256_storeu_ps(lanes_hi, hi);
+    minmax_f32_scalar(lanes_lo, 8, min, &lanes_lo[0]);
+    minmax_f32_scalar(lanes_hi, 8, &lanes_hi[0], max);
+    for (; i < count; i++) {
+        if (values[i] < *min) *min = values[i];
+        if (values[i] > *max) *max = values[i];
+    }
+}
+
+__attribute__((target("avx2")))
+static void minmax_f64_avx2(const double* values, size_t count, double* min, double* max) {
+    __m256d lo0 = _mm256_set1_pd(values[0]), hi0 = lo0, lo1 = lo0, hi1 = lo0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d v0 = _mm256_loadu_pd(values + i);
+        __m256d v1 = _mm256_loadu_pd(values + i + 4);
+        lo0 = _mm256_min_pd(lo0, v0);
+        hi0 = _mm256_max_pd(hi0, v0);
+        lo1 = _mm256_min_pd(lo1, v1);
+        hi1 = _mm256_max_pd(hi1, v1);
+    }
+    double lanes_lo[4], lanes_hi[4];
+    _mm256_storeu_pd(lanes_lo, _mm256_min_pd(lo0, lo1));
+    _mm256_storeu_pd(lanes_hi, _mm256_max_pd(hi0, hi1));
+    minmax_f64_scalar(lanes_lo, 4, min, &lanes_lo[0]);
+    minmax_f64_scalar(lanes_hi, 4, &lanes_hi[0], max);
+    for (; i < count; i++) {
+        if (values[i] < *min) *min = values[i];
+        if (values[i] > *max) *max = values[i];
+    }
+}
+
+#define SQDEV_STEP(x)                               \
+    do {                                            \
+        __m256d d = _mm256_sub_pd((x), m);          \
+        sq = _mm256_fmadd_pd(d, d, sq);             \
+        dev = _mm256_add_pd(dev, d);                \
+    } while (0)
+
+#define SQDEV_TAIL(values, i, count)                \
+    double out_sq = horizontal_add_pd(sq);          \
+    double out_dev = horizontal_add_pd(dev);        \
+    for (; (i) < (count); (i)++) {                  \
+        double d = (double)(values)[i] - mean;      \
+        out_sq += d * d;                            \
+        out_dev += d;                               \
+    }                                               \
+    out[0] = out_sq;                                \
+    out[1] = out_dev
+
+__attribute__((target("avx2,fma")))
+static void sqdev_i32_avx2(const int32_t* values, size_t count, double mean, double out[2]) {
+    __m256d m = _mm256_set1_pd(mean), sq = _mm256_setzero_pd(), dev = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        SQDEV_STEP(_mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)(values + i))));
+    }
+    SQDEV_TAIL(values, i, count);
+}
+
+__attribute__((target("avx2,fma")))
+static void sqdev_f32_avx2(const float* values, size_t count, double mean, double out[2]) {
+    __m256d m = _mm256_set1_pd(mean), sq = _mm256_setzero_pd(), dev = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        SQDEV_STEP(_mm256_cvtps_pd(_mm_loadu_ps(values + i)));
+    }
+    SQDEV_TAIL(values, i, count);
+}
+
+__attribute__((target("avx2,fma")))
+static void sqdev_f64_avx2(const double* values, size_t count, double mean, double out[2]) {
+    __m256d m = _mm256_set1_pd(mean), sq = _mm256_setzero_pd(), dev = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        SQDEV_STEP(_mm256_loadu_pd(values + i));
+    }
+    SQDEV_TAIL(values, i, count);
+}
+
+// Neumaier per lane: the larger of sum and term is the one whose low bits
+// survive, so the lost part is (big - t) + small
+#define KAHAN_STEP(s, c, x)                                                             \
+    do {                                                                                \
+        __m256d t = _mm256_add_pd(s, x);                                                \
+        __m256d keep = _mm256_cmp_pd(_mm256_andnot_pd(sign, s), _mm256_andnot_pd(sign, x), _CMP_GE_OQ); \
+        __m256d big = _mm256_blendv_pd(x, s, keep);                                     \
+        __m256d small = _mm256_blendv_pd(s, x, keep);                                   \
+        c = _mm256_add_pd(c, _mm256_add_pd(_mm256_sub_pd(big, t), small));              \
+        s = t;                                                                          \
+    } while (0)
+
+__attribute__((target("avx2")))
+static void kahan_finish(__m256d s0, __m256d c0, __m256d s1, __m256d c1, double out[2]) {
+    double sums[8], comps[8];
+    _mm256_storeu_pd(sums, s0);
+    _mm256_storeu_pd(sums + 4, s1);
+    _mm256_storeu_pd(comps, c0);
+    _mm256_storeu_pd(comps + 4, c1);
+    out[0] = 0.0;
+    out[1] = 0.0;
+    for (int lane = 0; lane < 8; lane++) {
+        neumaier_add(&out[0], &out[1], sums[lane]);
+        out[1] += comps[lane];
+    }
+}
+
+__attribute__((target("avx2")))
+static void kahan_f64_avx2(const double* values, size_t count, double out[2]) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d s0 = _mm256_setzero_pd(), c0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d x0 = _mm256_loadu_pd(values + i);
+        __m256d x1 = _mm256_loadu_pd(values + i + 4);
+        KAHAN_STEP(s0, c0, x0);
+        KAHAN_STEP(s1, c1, x1);
+    }
+    kahan_finish(s0, c0, s1, c1, out);
+    for (; i < count; i++) {
+        neumaier_add(&out[0], &out[1], values[i]);
+    }
+}
+
+__attribute__((target("avx2")))
+static void kahan_f32_avx2(const float* values, size_t count, double out[2]) {
+    __m256d sign = _mm256_set1_pd(-0.0);
+    __m256d s0 = _mm256_setzero_pd(), c0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd(), c1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(values + i);
+        __m256d x0 = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+        __m256d x1 = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+        KAHAN_STEP(s0, c0, x0);
+        KAHAN_STEP(s1, c1, x1);
+    }
+    kahan_finish(s0, c0, s1, c1, out);
+    for (; i < count; i++) {
+        neumaier_add(&out[0], &out[1], (double)values[i]);
+    }
+}
+
+static const ReduceKernels avx2_kernels = {
+    .sum_i32 = sum_i32_avx2,
+    .minmax_i32 = minmax_i32_avx2,
+    .sqdev_i32 = sqdev_i32_avx2,
+    .sum_i64 = sum_i64_avx2,
+    .minmax_i64 = minmax_i64_avx2,
+    .sqdev_i64 = sqdev_i64_scalar,      // no 64-bit integer to double conversion in AVX2
+    .sum_f32 = sum_f32_avx2,
+    .minmax_f32 = minmax_f32_avx2,
+    .sqdev_f32 = sqdev_f32_avx2,
+    .sum_f64 = sum_f64_avx2,
+    .minmax_f64 = minmax_f64_avx2,
+    .sqdev_f64 = sqdev_f64_avx2,
+    .kahan_f32 = kahan_f32_avx2,
+    .kahan_f64 = kahan_f64_avx2,
+    .name = "avx2"
+};
+#endif /* REDUCE_X86 */
+
+// ---------------------------------------------------------------------
+// Dispatch
+
+static const ReduceKernels* active_kernels = &portable_kernels;
+
+void reduce_init(void) {
+#if REDUCE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        active_kernels = &avx2_kernels;
+    }
+#endif
+}
+
+const ReduceKernels* reduce_kernels(void) {
+    return active_kernels;
+}
+
+const ReduceKernels* reduce_portable_kernels(void) {
+    return &portable_kernels;
+}
+
+void reduce_select_kernels(const ReduceKernels* kernels) {
+    active_kernels = kernels;
+}
+
+// ---------------------------------------------------------------------
+// Chunked reductions
+
+// Small inputs are one chunk; large ones at most REDUCE_MAX_CHUNKS
+static size_t plan_chunks(size_t count, size_t* chunk_size) {
+    if (count < REDUCE_PARALLEL_MIN) {
+        *chunk_size = count;
+        return 1;
+    }
+    size_t size = (count + REDUCE_MAX_CHUNKS - 1) / REDUCE_MAX_CHUNKS;
+    if (size < REDUCE_CHUNK_MIN) size = REDUCE_CHUNK_MIN;
+    *chunk_size = size;
+    return (count + size - 1) / size;
+}
+
+static size_t chunk_length(size_t count, size_t first, size_t size) {
+    return count - first < size ? count - first : size;
+}
+
+#define DEFINE_REDUCE_API(suffix, T, S)                                                 \
+    S reduce_sum_##suffix(const T* values, size_t count) {                              \
+        const ReduceKernels* kernels = active_kernels;                                  \
+        size_t size, chunks = plan_chunks(count, &size);                                \
+        if (chunks <= 1) return kernels->sum_##suffix(values, count);                   \
+        S partial[REDUCE_MAX_CHUNKS];                                                   \
+        REDUCE_PARALLEL_FOR                                                             \
+        for (size_t c = 0; c < chunks; c++) {                                           \
+            size_t first = c * size;                                                    \
+            partial[c] = kernels->sum_##suffix(values + first, chunk_length(count, first, size)); \
+        }                                                                               \
+        REDUCE_ACC_##suffix total = 0;                                                  \
+        for (size_t c = 0; c < chunks; c++) {                                           \
+            total += (REDUCE_ACC_##suffix)partial[c];                                   \
+        }                                                                               \
+        return (S)total;                                                                \
+    }                                                                                   \
+                                                                                        \
+    double reduce_mean_##suffix(const T* values, size_t count) {                        \
+        return count == 0 ? 0.0 : (double)reduce_sum_##suffix(values, count) / (double)count; \
+    }                                                                                   \
+                                                                                        \
+    static void minmax_##suffix(const T* values, size_t count, T* min, T* max) {        \
+        const ReduceKernels* kernels = active_kernels;                                  \
+        size_t size, chunks = plan_chunks(count, &size);                                \
+        if (chunks <= 1) {                                                              \
+            kernels->minmax_##suffix(values, count, min, max);                          \
+            return;                                                                     \
+        }                                                                               \
+        T lows[REDUCE_MAX_CHUNKS], highs[REDUCE_MAX_CHUNKS];                            \
+        REDUCE_PARALLEL_FOR                                                             \
+        for (size_t c = 0; c < chunks; c++) {                                           \
+            size_t first = c * size;                                                    \
+            kernels->minmax_##suffix(values + first, chunk_length(count, first, size),  \
+                                     &lows[c], &highs[c]);                              \
+        }                                                                               \
+        T unused;                                                                       \
+        minmax_##suffix##_scalar(lows, chunks, min, &unused);                           \
+        minmax_##suffix##_scalar(highs, chunks, &unused, max);                          \
+    }                                                                                   \
+                                                                                        \
+    T reduce_min_##suffix(const T* values, size_t count) {                              \
+        T min = 0, max = 0;                                                             \
+        if (count > 0) minmax_##suffix(values, count, &min, &max);                      \
+        return min;                                                                     \
+    }                                                                                   \
+                                                                                        \
+    T reduce_max_##suffix(const T* values, size_t count) {                              \
+        T min = 0, max = 0;                                                             \
+        if (count > 0) minmax_##suffix(values, count, &min, &max);                      \
+        return max;                                                                     \
+    }                                                                                   \
+                                                                                        \
+    /* sum((x - mean)^2) minus the rounding error of the mean, (sum(x - mean))^2 / n */ \
+    double reduce_variance_##suffix(const T* values, size_t count) {                    \
+        if (count == 0) return 0.0;                                                     \
+        const ReduceKernels* kernels = active_kernels;                                  \
+        double mean = reduce_mean_##suffix(values, count);                              \
+        size_t size, chunks = plan_chunks(count, &size);                                \
+        double partial[REDUCE_MAX_CHUNKS][2];                                           \
+        REDUCE_PARALLEL_FOR                                                             \
+        for (size_t c = 0; c < chunks; c++) {                                           \
+            size_t first = c * size;                                                    \
+            kernels->sqdev_##suffix(values + first, chunk_length(count, first, size),   \
+                                    mean, partial[c]);                                  \
+        }                                                                               \
+        double sq = 0.0, dev = 0.0;                                                     \
+        for (size_t c = 0; c < chunks; c++) {                                           \
+            sq += partial[c][0];                                                        \
+            dev += partial[c][1];                                                       \
+        }                                                                               \
+        double variance = (sq - dev * dev / (double)count) / (double)count;             \
+        return variance > 0.0 ? variance : 0.0;                                         \
+    }
+
+REDUCE_TYPES(DEFINE_REDUCE_API)
+
+#define DEFINE_KAHAN_API(suffix, T)                                                     \
+    double reduce_sum_kahan_##suffix(const T* values, size_t count) {                   \
+        const ReduceKernels* kernels = active_kernels;                                  \
+        size_t size, chunks = plan_chunks(count, &size);                                \
+        double partial[REDUCE_MAX_CHUNKS][2];                                           \
+        REDUCE_PARALLEL_FOR                                                             \
+        for (size_t c = 0; c < chunks; c++) {                                           \
+            size_t first = c * size;                                                    \
+            kernels->kahan_##suffix(values + first, chunk_length(count, first, size),   \
+                                    partial[c]);                                        \
+        }                                                                               \
+        double sum = 0.0, compensation = 0.0;                                           \
+        for (size_t c = 0; c < chunks; c++) {                                           \
+            neumaier_add(&sum, &compensation, partial[c][0]);                           \
+            compensation += partial[c][1];                                              \
+        }                                                                               \
+        return sum + compensation;                                                      \
+    }
+
+DEFINE_KAHAN_API(f32, float)
+DEFINE_KAHAN_API(f64, double)
@@ -0,0 +1,62 @@
+#ifndef REDUCE_H
+#define REDUCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Reductions over contiguous arrays behind sum_integers, sum_large,
+// average and max_value. Every operation is generated per element type
+// from one macro list (REDUCE_TYPES):
+//   reduce_sum_<t>       sum, int64_t for integers (wrapping), double
+//                        for floating point (floats are widened)
+//   reduce_mean_<t>      sum / count
+//   reduce_min_<t>       smallest and largest element, 0 for empty input
+//   reduce_max_<t>
+//   reduce_variance_<t>  population variance, corrected two-pass
+// plus reduce_sum_kahan_f32/f64, Neumaier-compensated sums.
+//
+// Each kernel has a scalar and an AVX2 version (reduce_init). Inputs above
+// REDUCE_PARALLEL_MIN elements are cut into chunks that OpenMP threads
+// reduce; the chunks depend only on the count, so results do not change
+// with the number of threads. NaN inputs give an unspecified min/max.
+
+#define REDUCE_PARALLEL_MIN (1 << 18)
+
+//  suffix  element   sum
+#define REDUCE_TYPES(X)             \
+    X(i32, int32_t, int64_t)        \
+    X(i64, int64_t, int64_t)        \
+    X(f32, float, double)           \
+    X(f64, double, double)
+
+// Chunk kernels: sqdev gives sum((x - mean)^2) and sum(x - mean)
+#define REDUCE_KERNEL_FIELDS(suffix, T, S)                                          \
+    S (*sum_##suffix)(const T* values, size_t count);                               \
+    void (*minmax_##suffix)(const T* values, size_t count, T* min, T* max);         \
+    void (*sqdev_##suffix)(const T* values, size_t count, double mean, double out[2]);
+
+typedef struct {
+    REDUCE_TYPES(REDUCE_KERNEL_FIELDS)
+    void (*kahan_f32)(const float* values, size_t count, double out[2]);    // sum, compensation
+    void (*kahan_f64)(const double* values, size_t count, double out[2]);
+    const char* name;
+} ReduceKernels;
+
+void reduce_init(void);
+const ReduceKernels* reduce_kernels(void);                  // active table
+const ReduceKernels* reduce_portable_kernels(void);
+void reduce_select_kernels(const ReduceKernels* kernels);   // for comparisons
+
+#define REDUCE_DECLARE(suffix, T, S)                                    \
+    S reduce_sum_##suffix(const T* values, size_t count);               \
+    double reduce_mean_##suffix(const T* values, size_t count);         \
+    T reduce_min_##suffix(const T* values, size_t count);               \
+    T reduce_max_##suffix(const T* values, size_t count);               \
+    double reduce_variance_##suffix(const T* values, size_t count);
+
+REDUCE_TYPES(REDUCE_DECLARE)
+
+double reduce_sum_kahan_f32(const float* values, size_t count);
+double reduce_sum_kahan_f64(const double* values, size_t count);
+
+#endif /* REDUCE_H */
@@ -0,0 +1,356 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include <time.h>
+#include "reduce.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Reductions over arrays of the argument's length (default 10^7), in GB/s
+// of input read:
+//   loop     the plain one-accumulator loops the demo used (sum_array,
+//            average, max_value)
+//   scalar   the portable kernels, chunked
+//   avx2     the vector kernels, chunked
+// Every result is checked against a long double reference, and the
+// accuracy of plain and compensated float sums is compared on inputs
+// with heavy cancellation.
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int failed = 0;
+
+#define BYTES_PER_RUN 2e9           // repeat each measurement over about this much input
+
+static double random_unit(void) {
+    return (double)(next_random() >> 11) / (double)(1ull << 53);
+}
+
+// Baselines, written the way the original varargs loops were
+static int64_t loop_sum_i32(const int32_t* values, size_t count) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+static double loop_sum_f64(const double* values, size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+static double loop_max_f64(const double* values, size_t count) {
+    double max = values[0];
+    for (size_t i = 1; i < count; i++) {
+        if (values[i] > max) max = values[i];
+    }
+    return max;
+}
+
+static double loop_variance_f64(const double* values, size_t count) {
+    double sum = 0.0, sq = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        sum += values[i];
+        sq += values[i] * values[i];
+    }
+    double mean = sum / (double)count;
+    return sq / (double)count - mean * mean;
+}
+
+static long double reference_sum(const double* values, size_t count) {
+    long double sum = 0.0L, compensation = 0.0L;
+    for (size_t i = 0; i < count; i++) {
+        long double x = values[i], t = sum + x;
+        if (fabsl(sum) >= fabsl(x)) {
+            compensation += (sum - t) + x;
+        } else {
+            compensation += (x - t) + sum;
+        }
+        sum = t;
+    }
+    return sum + compensation;
+}
+
+static bool close_enough(double expected, double actual, double tolerance) {
+    return fabs(expected - actual) <= tolerance * (1.0 + fabs(expected));
+}
+
+// Times a reduction and prints its bandwidth; sink keeps the result live
+static volatile double sink;
+
+#define TIME_RUN(label, bytes, baseline, expr)                                  \
+    do {                                                                        \
+        int reps = (int)(BYTES_PER_RUN / (bytes)) + 1;                          \
+        double start = now_seconds();                                           \
+        for (int r = 0; r < reps; r++) {                                        \
+            sink = (double)(expr);                                              \
+        }                                                                       \
+        double seconds = (now_seconds() - start) / reps;                        \
+        printf("  %-30s %8.2f GB/s", label, (bytes) / seconds / 1e9);           \
+        if ((baseline) > 0) printf("  %6.2fx", (baseline) / seconds);           \
+        printf("\n");                                                           \
+        last_seconds = seconds;                                                 \
+    } while (0)
+
+static void bench_operations(size_t count) {
+    int32_t* ints = malloc(count * sizeof(int32_t));
+    int64_t* longs = malloc(count * sizeof(int64_t));
+    float* floats = malloc(count * sizeof(float));
+    double* doubles = malloc(count * sizeof(double));
+    if (ints == NULL || longs == NULL || floats == NULL || doubles == NULL) exit(1);
+    for (size_t i = 0; i < count; i++) {
+        ints[i] = (int32_t)(uint32_t)next_random();
+        longs[i] = (int64_t)(next_random() >> 8) - (1ll << 55);
+        doubles[i] = random_unit() * 200.0 - 100.0;
+        floats[i] = (float)doubles[i];
+    }
+
+    const ReduceKernels* native = reduce_kernels();
+    const ReduceKernels* tables[2] = {reduce_portable_kernels(), native};
+    int table_count = native == reduce_portable_kernels() ? 1 : 2;
+    double last_seconds = 0, baseline = 0;
+    char label[64];
+
+    printf("sum, int32 -> int64:\n");
+    TIME_RUN("loop", count * 4.0, 0.0, loop_sum_i32(ints, count));
+    baseline = last_seconds;
+    int64_t expected_i32 = loop_sum_i32(ints, count);
+    for (int t = 0; t < table_count; t++) {
+        reduce_select_kernels(tables[t]);
+        snprintf(label, sizeof(label), "reduce_sum_i32 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 4.0, baseline, reduce_sum_i32(ints, count));
+        failed |= reduce_sum_i32(ints, count) != expected_i32;
+    }
+
+    printf("\nsum, int64 (wrapping):\n");
+    uint64_t expected_i64 = 0;
+    for (size_t i = 0; i < count; i++) {
+        expected_i64 += (uint64_t)longs[i];
+    }
+    for (int t = 0; t < table_count; t++) {
+        reduce_select_kernels(tables[t]);
+        snprintf(label, sizeof(label), "reduce_sum_i64 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 8.0, 0.0, reduce_sum_i64(longs, count));
+        failed |= (uint64_t)reduce_sum_i64(longs, count) != expected_i64;
+    }
+
+    long double reference = reference_sum(doubles, count);
+    printf("\nsum, double:\n");
+    TIME_RUN("loop", count * 8.0, 0.0, loop_sum_f64(doubles, count));
+    baseline = last_seconds;
+    for (int t = 0; t < table_count; t++) {
+        reduce_select_kernels(tables[t]);
+        snprintf(label, sizeof(label), "reduce_sum_f64 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 8.0, baseline, reduce_sum_f64(doubles, count));
+        failed |= !close_enough((double)reference, reduce_sum_f64(doubles, count), 1e-9);
+        snprintf(label, sizeof(label), "reduce_sum_kahan_f64 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 8.0, baseline, reduce_sum_kahan_f64(doubles, count));
+        failed |= !close_enough((double)reference, reduce_sum_kahan_f64(doubles, count), 1e-15);
+    }
+
+    printf("\nsum, float -> double:\n");
+    for (int t = 0; t < table_count; t++) {
+        reduce_select_kernels(tables[t]);
+        snprintf(label, sizeof(label), "reduce_sum_f32 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 4.0, 0.0, reduce_sum_f32(floats, count));
+        double expected = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            expected += floats[i];
+        }
+        failed |= !close_enough(expected, reduce_sum_f32(floats, count), 1e-9);
+    }
+
+    printf("\nmax, double:\n");
+    TIME_RUN("loop", count * 8.0, 0.0, loop_max_f64(doubles, count));
+    baseline = last_seconds;
+    double expected_max = loop_max_f64(doubles, count);
+    for (int t = 0; t < table_count; t++) {
+        reduce_select_kernels(tables[t]);
+        snprintf(label, sizeof(label), "reduce_max_f64 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 8.0, baseline, reduce_max_f64(doubles, count));
+        failed |= reduce_max_f64(doubles, count) != expected_max;
+    }
+
+    printf("\nmin/max, int32 and int64:\n");
+    int32_t min32 = ints[0], max32 = ints[0];
+    int64_t min64 = longs[0], max64 = longs[0];
+    for (size_t i = 1; i < count; i++) {
+        if (ints[i] < min32) min32 = ints[i];
+        if (ints[i] > max32) max32 = ints[i];
+        if (longs[i] < min64) min64 = longs[i];
+        if (longs[i] > max64) max64 = longs[i];
+    }
+    for (int t = 0; t < table_count; t++) {
+        reduce_select_kernels(tables[t]);
+        snprintf(label, sizeof(label), "reduce_min_i32 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 4.0, 0.0, reduce_min_i32(ints, count));
+        snprintf(label, sizeof(label), "reduce_max_i64 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 8.0, 0.0, reduce_max_i64(longs, count));
+        failed |= reduce_min_i32(ints, count) != min32 || reduce_max_i32(ints, count) != max32;
+        failed |= reduce_min_i64(longs, count) != min64 || reduce_max_i64(longs, count) != max64;
+        failed |= reduce_min_f32(floats, count) != (float)reduce_min_f64(doubles, count);
+    }
+
+    // sum of squares minus the squared mean, the usual shortcut
+    printf("\nvariance, double (two passes for reduce):\n");
+    TIME_RUN("one-pass sum of squares", count * 8.0, 0.0, loop_variance_f64(doubles, count));
+    baseline = last_seconds;
+    long double mean = reference / count, sq = 0.0L;
+    for (size_t i = 0; i < count; i++) {
+        long double d = doubles[i] - mean;
+        sq += d * d;
+    }
+    double expected_variance = (double)(sq / count);
+    long double sum_i64 = 0.0L, sq_i64 = 0.0L;
+    for (size_t i = 0; i < count; i++) {
+        sum_i64 += longs[i];
+    }
+    for (size_t i = 0; i < count; i++) {
+        long double d = longs[i] - sum_i64 / count;
+        sq_i64 += d * d;
+    }
+    double expected_variance_i64 = (double)(sq_i64 / count);
+    for (int t = 0; t < table_count; t++) {
+        reduce_select_kernels(tables[t]);
+        snprintf(label, sizeof(label), "reduce_variance_f64 (%s)", tables[t]->name);
+        TIME_RUN(label, count * 8.0, baseline, reduce_variance_f64(doubles, count));
+        failed |= !close_enough(expected_variance, reduce_variance_f64(doubles, count), 1e-9);
+        failed |= !close_enough(expected_variance, reduce_variance_f32(floats, count), 1e-5);
+        failed |= !close_enough(expected_variance_i64, reduce_variance_i64(longs, count), 1e-9);
+    }
+    reduce_select_kernels(native);
+    printf("\n");
+
+    free(ints);
+    free(longs);
+    free(floats);
+    free(doubles);
+}
+
+// Large values that cancel around small ones: the plain sum loses the
+// small terms, the compensated one keeps them
+static void check_accuracy(size_t count) {
+    double* values = malloc(count * sizeof(double));
+    float* floats = malloc(count * sizeof(float));
+    if (values == NULL || floats == NULL) exit(1);
+    for (size_t i = 0; i < count; i++) {
+        double big = (i % 2 ? -1.0 : 1.0) * 1e12 * (1.0 + random_unit());
+        values[i] = i % 4 < 2 ? big : random_unit();
+        floats[i] = (float)(i % 4 < 2 ? big * 1e-6 : random_unit());
+    }
+    double reference = (double)reference_sum(values, count);
+    double plain = reduce_sum_f64(values, count);
+    double compensated = reduce_sum_kahan_f64(values, count);
+
+    long double float_reference = 0.0L;
+    for (size_t i = 0; i < count; i++) {
+        float_reference += floats[i];
+    }
+    float naive_float = 0.0f;
+    for (size_t i = 0; i < count; i++) {
+        naive_float += floats[i];
+    }
+
+    printf("Accuracy, cancelling terms (relative error):\n");
+    printf("  %-30s %12.3e\n", "double, plain", fabs(plain - reference) / fabs(reference));
+    printf("  %-30s %12.3e\n", "double, compensated", fabs(compensated - reference) / fabs(reference));
+    printf("  %-30s %12.3e\n", "float, float accumulator",
+           fabs(naive_float - (double)float_reference) / fabs((double)float_reference));
+    printf("  %-30s %12.3e\n", "float, compensated",
+           fabs(reduce_sum_kahan_f32(floats, count) - (double)float_reference) /
+           fabs((double)float_reference));
+    printf("\n");
+    failed |= !close_enough(reference, compensated, 1e-15);
+
+    free(values);
+    free(floats);
+}
+
+// Lengths around the vector widths and the chunking threshold, both tables
+static void check_edges(void) {
+    static const size_t lengths[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 33,
+                                     REDUCE_PARALLEL_MIN - 1, REDUCE_PARALLEL_MIN,
+                                     REDUCE_PARALLEL_MIN + 5, 3 * REDUCE_PARALLEL_MIN + 11};
+    size_t max_length = 3 * REDUCE_PARALLEL_MIN + 11;
+    int32_t* ints = malloc(max_length * sizeof(int32_t));
+    double* doubles = malloc(max_length * sizeof(double));
+    if (ints == NULL || doubles == NULL) exit(1);
+    for (size_t i = 0; i < max_length; i++) {
+        ints[i] = (int32_t)(next_random() % 2001) - 1000;
+        doubles[i] = (double)ints[i] * 0.5;
+    }
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        size_t n = lengths[l];
+        int64_t sum = 0;
+        int32_t lo = 0, hi = 0;
+        for (size_t i = 0; i < n; i++) {
+            sum += ints[i];
+            if (i == 0 || ints[i] < lo) lo = ints[i];
+            if (i == 0 || ints[i] > hi) hi = ints[i];
+        }
+        failed |= reduce_sum_i32(ints, n) != sum;
+        failed |= reduce_min_i32(ints, n) != lo || reduce_max_i32(ints, n) != hi;
+        failed |= reduce_sum_f64(doubles, n) != (double)sum * 0.5;      // exact in double
+        failed |= reduce_sum_kahan_f64(doubles, n) != (double)sum * 0.5;
+        failed |= reduce_max_f64(doubles, n) != hi * 0.5;
+        failed |= n == 0 && reduce_variance_i32(ints, n) != 0.0;
+    }
+    free(ints);
+    free(doubles);
+}
+
+int main(int argc, char* argv[]) {
+    long count_arg = argc > 1 ? atol(argv[1]) : 10000000;
+    if (count_arg < 1000 || count_arg > 200000000) {
+        fprintf(stderr, "Usage: %s [elements, 1000 .. 200000000]\n", argv[0]);
+        return 1;
+    }
+    size_t count = (size_t)count_arg;
+
+    reduce_init();
+    printf("=== Reduction Benchmark ===\n");
+#ifdef _OPENMP
+    printf("Kernels: %s, OpenMP threads: %d, %zu elements\n\n", reduce_kernels()->name,
+           omp_get_max_threads(), count);
+#else
+    printf("Kernels: %s, serial build, %zu elements\n\n", reduce_kernels()->name, count);
+#endif
+
+    const ReduceKernels* native = reduce_kernels();
+    reduce_select_kernels(reduce_portable_kernels());
+    check_edges();
+    reduce_select_kernels(native);
+    check_edges();
+
+    bench_operations(count);
+    check_accuracy(count);
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
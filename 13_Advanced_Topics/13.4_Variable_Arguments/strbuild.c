@@ -0,0 +1,167 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "strbuild.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define STR_LOCAL_SLICES 32         // va_list pieces measured on the stack
+#define STR_IOV_BATCH 1024          // Linux IOV_MAX; smaller limits come from sysconf
+
+void str_arena_init(StrArena* arena, char* buffer, size_t capacity) {
+    arena->base = buffer;
+    arena->capacity = capacity;
+    arena->used = 0;
+}
+
+char* str_arena_alloc(StrArena* arena, size_t size) {
+    if (size > arena->capacity - arena->used) return NULL;
+    char* block = arena->base + arena->used;
+    arena->used += size;
+    return block;
+}
+
+void str_arena_reset(StrArena* arena) {
+    arena->used = 0;
+}
+
+size_t str_join_length(const StrSlice* slices, size_t count, StrSlice separator) {
+    size_t total = count > 1 ? (count - 1) * separator.length : 0;
+    for (size_t i = 0; i < count; i++) {
+        total += slices[i].length;
+    }
+    return total;
+}
+
+char* str_join(const StrSlice* slices, size_t count, StrSlice separator, StrArena* arena, size_t* length) {
+    size_t total = str_join_length(slices, count, separator);
+    char* result = arena != NULL ? str_arena_alloc(arena, total + 1) : malloc(total + 1);
+    if (result == NULL) {
+        if (arena == NULL) fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+
+    char* out = result;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && separator.length > 0) {
+            memcpy(out, separator.data, separator.length);
+            out += separator.length;
+        }
+        if (slices[i].length > 0) {
+            memcpy(out, slices[i].data, slices[i].length);
+            out += slices[i].length;
+        }
+    }
+    *out = '\0';
+    if (length != NULL) *length = total;
+    return result;
+}
+
+char* str_vconcat(StrArena* arena, size_t* length, int count, va_list args) {
+    StrSlice none = {"", 0};
+    if (count < 0) return NULL;
+    if (count == 0) return str_join(&none, 0, none, arena, length);
+
+    StrSlice local[STR_LOCAL_SLICES];
+    StrSlice* slices = local;
+    if (count > STR_LOCAL_SLICES) {
+        slices = malloc((size_t)count * sizeof(StrSlice));
+        if (slices == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return NULL;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        slices[i] = str_slice(va_arg(args, const char*));
+    }
+
+    char* result = str_join(slices, (size_t)count, none, arena, length);
+    if (slices != local) free(slices);
+    return result;
+}
+
+char* str_concat(StrArena* arena, size_t* length, int count, ...) {
+    va_list args;
+    va_start(args, count);
+    char* result = str_vconcat(arena, length, count, args);
+    va_end(args);
+    return result;
+}
+
+size_t str_join_iovec(const StrSlice* slices, size_t count, StrSlice separator, struct iovec* iov,
+                      size_t capacity) {
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && separator.length > 0) {
+            if (n < capacity) {
+                iov[n].iov_base = (void*)separator.data;
+                iov[n].iov_len = separator.length;
+            }
+            n++;
+        }
+        if (slices[i].length > 0) {
+            if (n < capacity) {
+                iov[n].iov_base = (void*)slices[i].data;
+                iov[n].iov_len = slices[i].length;
+            }
+            n++;
+        }
+    }
+    return n;
+}
+
+// Drops the first `written` bytes from iov; returns the entries left
+static size_t advance_iovec(struct iovec* iov, size_t count, size_t written) {
+    size_t skip = 0;
+    while (skip < count && written >= iov[skip].iov_len) {
+        written -= iov[skip].iov_len;
+        skip++;
+    }
+    if (skip < count) {
+        iov[skip].iov_base = (char*)iov[skip].iov_base + written;
+        iov[skip].iov_len -= written;
+    }
+    memmove(iov, iov + skip, (count - skip) * sizeof(struct iovec));
+    return count - skip;
+}
+
+ssize_t str_writev(int fd, const StrSlice* slices, size_t count, StrSlice separator) {
+    struct iovec iov[STR_IOV_BATCH];
+    long limit = sysconf(_SC_IOV_MAX);
+    size_t batch = limit > 0 && limit < STR_IOV_BATCH ? (size_t)limit : STR_IOV_BATCH;
+    size_t total = 0;
+    size_t next = 0;            // first slice not yet placed in iov
+
+    while (next < count) {
+        // Take as many slices (with their leading separators) as fit
+        size_t taken = 0, used = 0;
+        while (next + taken < count) {
+            StrSlice sep = next + taken > 0 ? separator : (StrSlice){"", 0};
+            size_t need = (sep.length > 0) + (slices[next + taken].length > 0);
+            if (used + need > batch) break;
+            if (sep.length > 0) {
+                iov[used].iov_base = (void*)sep.data;
+                iov[used++].iov_len = sep.length;
+            }
+            if (slices[next + taken].length > 0) {
+                iov[used].iov_base = (void*)slices[next + taken].data;
+                iov[used++].iov_len = slices[next + taken].length;
+            }
+            taken++;
+        }
+        next += taken;
+
+        while (used > 0) {
+            ssize_t written = writev(fd, iov, (int)used);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return -1;
+            }
+            total += (size_t)written;
+            used = advance_iovec(iov, used, (size_t)written);
+        }
+    }
+    return (ssize_t)total;
+}
@@ -0,0 +1,60 @@
+#ifndef STRBUILD_H
+#define STRBUILD_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+// Single-pass string building for concat_strings and format_multiple.
+// Pieces are (pointer, length) slices: each length is measured once, the
+// total is summed, one block is allocated (from malloc or a caller's
+// arena) and every piece is placed with memcpy. Nothing rescans the
+// output the way strcat does. The iovec variants skip the copy entirely
+// and hand the slices to writev.
+
+typedef struct {
+    const char* data;
+    size_t length;
+} StrSlice;
+
+// NULL is an empty slice
+static inline StrSlice str_slice(const char* s) {
+    StrSlice slice = {s != NULL ? s : "", s != NULL ? strlen(s) : 0};
+    return slice;
+}
+
+// Bump allocator over a caller-owned buffer; reset frees everything
+typedef struct {
+    char* base;
+    size_t capacity;
+    size_t used;
+} StrArena;
+
+void str_arena_init(StrArena* arena, char* buffer, size_t capacity);
+char* str_arena_alloc(StrArena* arena, size_t size);    // NULL when full
+void str_arena_reset(StrArena* arena);
+
+// Joined length without the terminator
+size_t str_join_length(const StrSlice* slices, size_t count, StrSlice separator);
+
+// slices[0] sep slices[1] sep ... as one NUL-terminated block from the
+// arena, or from malloc when arena is NULL. length (optional) receives
+// the joined length. NULL if the allocation fails.
+char* str_join(const StrSlice* slices, size_t count, StrSlice separator, StrArena* arena, size_t* length);
+
+// count C strings from the argument list (NULLs are skipped), no separator
+char* str_vconcat(StrArena* arena, size_t* length, int count, va_list args);
+char* str_concat(StrArena* arena, size_t* length, int count, ...);
+
+// Fills iov with the pieces of the join (empty ones left out) and returns
+// how many entries the whole join needs; only the first capacity are set
+size_t str_join_iovec(const StrSlice* slices, size_t count, StrSlice separator, struct iovec* iov,
+                      size_t capacity);
+
+// Writes the join to fd with writev, in batches, retrying partial writes
+// and EINTR. Returns the bytes written or -1.
+ssize_t str_writev(int fd, const StrSlice* slices, size_t count, StrSlice separator);
+
+#endif /* STRBUILD_H */
@@ -0,0 +1,307 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "strbuild.h"
+
+// String building against the original concat_strings (measure with
+// strlen, then strcat every piece, rescanning the output each time):
+//   varargs   8 random pieces through concat_strings / str_concat, with
+//             malloc and with a reused arena
+//   arrays    16 and 256 pieces: strcat loop vs str_join
+//   output    256 small and 64 4 KB pieces to /dev/null: str_join + write
+//             vs str_writev
+// Every result is compared with the baseline, and str_writev output is
+// read back from a temporary file.
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int failed = 0;
+
+#define POOL_SIZE 64
+#define LARGE_POOL_SIZE 8
+#define LARGE_LENGTH 4096
+static char* pool[POOL_SIZE];
+static char* large_pool[LARGE_POOL_SIZE];
+
+// The original two-pass concat_strings
+static char* legacy_concat_strings(int count, ...) {
+    va_list args;
+    va_start(args, count);
+    size_t total_len = 0;
+    va_list args_copy;
+    va_copy(args_copy, args);
+    for (int i = 0; i < count; i++) {
+        const char* str = va_arg(args_copy, const char*);
+        if (str) total_len += strlen(str);
+    }
+    va_end(args_copy);
+    char* result = malloc(total_len + 1);
+    if (result == NULL) {
+        va_end(args);
+        return NULL;
+    }
+    result[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        const char* str = va_arg(args, const char*);
+        if (str) strcat(result, str);
+    }
+    va_end(args);
+    return result;
+}
+
+static char* legacy_concat_array(char** pieces, size_t count) {
+    size_t total_len = 0;
+    for (size_t i = 0; i < count; i++) {
+        total_len += strlen(pieces[i]);
+    }
+    char* result = malloc(total_len + 1);
+    if (result == NULL) return NULL;
+    result[0] = '\0';
+    for (size_t i = 0; i < count; i++) {
+        strcat(result, pieces[i]);
+    }
+    return result;
+}
+
+static void report(const char* name, size_t ops, double seconds, double baseline) {
+    printf("  %-30s %12.0f ops/s  %8.1f ns/op", name, ops / seconds, seconds * 1e9 / ops);
+    if (baseline > 0) printf("  %6.2fx", baseline / seconds);
+    printf("\n");
+}
+
+#define PIECES8(p) p[0], p[1], p[2], p[3], p[4], p[5], p[6], p[7]
+
+static void bench_varargs(size_t ops) {
+    printf("Varargs, 8 pieces of 1-32 characters:\n");
+    char** picks = malloc(ops * 8 * sizeof(char*));
+    if (picks == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < ops * 8; i++) {
+        picks[i] = pool[next_random() % POOL_SIZE];
+    }
+
+    size_t total = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        char* s = legacy_concat_strings(8, PIECES8((picks + 8 * i)));
+        total += s[0];
+        free(s);
+    }
+    double baseline = now_seconds() - start;
+    report("concat_strings (strcat)", ops, baseline, 0);
+
+    size_t fast_total = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        char* s = str_concat(NULL, NULL, 8, PIECES8((picks + 8 * i)));
+        fast_total += s[0];
+        free(s);
+    }
+    double seconds = now_seconds() - start;
+    report("str_concat (malloc)", ops, seconds, baseline);
+    failed |= fast_total != total;
+
+    char buffer[512];
+    StrArena arena;
+    str_arena_init(&arena, buffer, sizeof(buffer));
+    fast_total = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        str_arena_reset(&arena);
+        char* s = str_concat(&arena, NULL, 8, PIECES8((picks + 8 * i)));
+        fast_total += s[0];
+    }
+    seconds = now_seconds() - start;
+    report("str_concat (arena)", ops, seconds, baseline);
+    failed |= fast_total != total;
+
+    for (size_t i = 0; i < ops; i += 101) {
+        char* expected = legacy_concat_strings(8, PIECES8((picks + 8 * i)));
+        size_t length;
+        char* actual = str_concat(NULL, &length, 8, PIECES8((picks + 8 * i)));
+        failed |= strcmp(expected, actual) != 0 || length != strlen(expected);
+        free(expected);
+        free(actual);
+    }
+    free(picks);
+    printf("\n");
+}
+
+static void bench_array(size_t count, size_t ops) {
+    printf("Array of %zu pieces:\n", count);
+    char** pieces = malloc(count * sizeof(char*));
+    StrSlice* slices = malloc(count * sizeof(StrSlice));
+    if (pieces == NULL || slices == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        pieces[i] = pool[next_random() % POOL_SIZE];
+    }
+
+    size_t total = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        char* s = legacy_concat_array(pieces, count);
+        total += s[i % 8];
+        free(s);
+    }
+    double baseline = now_seconds() - start;
+    report("strlen + strcat loop", ops, baseline, 0);
+
+    // Slices are measured inside the loop, like the baseline's strlen
+    size_t fast_total = 0;
+    StrSlice none = {"", 0};
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        for (size_t p = 0; p < count; p++) {
+            slices[p] = str_slice(pieces[p]);
+        }
+        char* s = str_join(slices, count, none, NULL, NULL);
+        fast_total += s[i % 8];
+        free(s);
+    }
+    double seconds = now_seconds() - start;
+    report("str_slice + str_join", ops, seconds, baseline);
+    failed |= fast_total != total;
+
+    char* expected = legacy_concat_array(pieces, count);
+    char* actual = str_join(slices, count, none, NULL, NULL);
+    failed |= strcmp(expected, actual) != 0;
+    free(expected);
+    free(actual);
+    free(pieces);
+    free(slices);
+    printf("\n");
+}
+
+static void bench_output(const char* label, char** pieces, size_t pool_size, size_t count, size_t ops) {
+    printf("Output of %zu %s pieces with \", \" separators:\n", count, label);
+    StrSlice* slices = malloc(count * sizeof(StrSlice));
+    if (slices == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        slices[i] = str_slice(pieces[next_random() % pool_size]);
+    }
+    StrSlice separator = str_slice(", ");
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd < 0) {
+        perror("open");
+        exit(1);
+    }
+
+    double start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        size_t length;
+        char* s = str_join(slices, count, separator, NULL, &length);
+        failed |= write(null_fd, s, length) != (ssize_t)length;
+        free(s);
+    }
+    double baseline = now_seconds() - start;
+    report("str_join + write", ops, baseline, 0);
+
+    size_t expected_length = str_join_length(slices, count, separator);
+    start = now_seconds();
+    for (size_t i = 0; i < ops; i++) {
+        failed |= str_writev(null_fd, slices, count, separator) != (ssize_t)expected_length;
+    }
+    double seconds = now_seconds() - start;
+    report("str_writev (no copy)", ops, seconds, baseline);
+    close(null_fd);
+
+    // Read the gathered write back
+    FILE* file = tmpfile();
+    if (file == NULL) {
+        perror("tmpfile");
+        exit(1);
+    }
+    char* expected = str_join(slices, count, separator, NULL, NULL);
+    char* actual = malloc(expected_length + 1);
+    if (actual == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    failed |= str_writev(fileno(file), slices, count, separator) != (ssize_t)expected_length;
+    rewind(file);
+    failed |= fread(actual, 1, expected_length, file) != expected_length;
+    failed |= memcmp(expected, actual, expected_length) != 0;
+    fclose(file);
+    free(expected);
+    free(actual);
+    free(slices);
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    long ops_arg = argc > 1 ? atol(argv[1]) : 2000000;
+    if (ops_arg < 1000 || ops_arg > 100000000) {
+        fprintf(stderr, "Usage: %s [operations, 1000 .. 1e8]\n", argv[0]);
+        return 1;
+    }
+    size_t ops = (size_t)ops_arg;
+
+    for (int i = 0; i < POOL_SIZE; i++) {
+        size_t length = 1 + next_random() % 32;
+        pool[i] = malloc(length + 1);
+        if (pool[i] == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return 1;
+        }
+        for (size_t c = 0; c < length; c++) {
+            pool[i][c] = (char)('a' + next_random() % 26);
+        }
+        pool[i][length] = '\0';
+    }
+    for (int i = 0; i < LARGE_POOL_SIZE; i++) {
+        large_pool[i] = malloc(LARGE_LENGTH + 1);
+        if (large_pool[i] == NULL) {
+            fprintf(stderr, "Memory allocation failed\n");
+            return 1;
+        }
+        memset(large_pool[i], 'A' + i, LARGE_LENGTH);
+        large_pool[i][LARGE_LENGTH] = '\0';
+    }
+
+    printf("=== String Builder Benchmark ===\n");
+    printf("%zu operations per run\n\n", ops);
+    bench_varargs(ops);
+    bench_array(16, ops / 2);
+    bench_array(256, ops / 50);
+    bench_output("small", pool, POOL_SIZE, 256, ops / 50);
+    bench_output("4 KB", large_pool, LARGE_POOL_SIZE, 64, ops / 200);
+
+    for (int i = 0; i < POOL_SIZE; i++) {
+        free(pool[i]);
+    }
+    for (int i = 0; i < LARGE_POOL_SIZE; i++) {
+        free(large_pool[i]);
+    }
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
@@ -4,6 +4,12 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <unistd.h>
+#include "cmdreg.h"
+#include "fmt.h"
+#include "matrix.h"
+#include "reduce.h"
+#include "strbuild.h"
 
 // Function prototypes
 void demonstrate_basic_variadic(void);
@@ -45,32 +51,47 @@ typedef struct {
     size_t capacity;
 } GenericList;
 
-// Matrix structure
-typedef struct {
-    double* data;
-    int rows, cols;
-} Matrix;
+// Numeric varargs are copied into one array (on the stack up to
+// VARARG_STACK values) and handed to the reduce kernels
+#define VARARG_STACK 32
 
-// Command function pointer type
-typedef void (*CommandFunc)(const char* format, ...);
+static int32_t* collect_ints(int32_t* local, int count, va_list args) {
+    int32_t* values = count <= VARARG_STACK ? local : malloc((size_t)count * sizeof(int32_t));
+    if (values == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        values[i] = va_arg(args, int);
+    }
+    return values;
+}
 
-// Command structure
-typedef struct {
-    const char* name;
-    CommandFunc func;
-} Command;
+static double* collect_doubles(double* local, int count, va_list args) {
+    double* values = count <= VARARG_STACK ? local : malloc((size_t)count * sizeof(double));
+    if (values == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    for (int i = 0; i < count; i++) {
+        values[i] = va_arg(args, double);
+    }
+    return values;
+}
 
 // Basic variadic functions
 int sum_integers(int count, ...) {
+    if (count <= 0) return 0;
+    
+    int32_t local[VARARG_STACK];
     va_list args;
     va_start(args, count);
-    
-    int total = 0;
-    for (int i = 0; i < count; i++) {
-        total += va_arg(args, int);
-    }
-    
+    int32_t* values = collect_ints(local, count, args);
     va_end(args);
+    if (values == NULL) return 0;
+    
+    int total = (int)reduce_sum_i32(values, (size_t)count);
+    if (values != local) free(values);
     return total;
 }
 
@@ -143,11 +164,13 @@ void free_list(GenericList* list) {
 }
 
 // String processing functions
+// Both go through the fmt engine; my_sprintf trusts the caller's buffer
+// size exactly as vsprintf does
 int my_sprintf(char* buffer, const char* format, ...) {
     va_list args;
     va_start(args, format);
     
-    int result = vsprintf(buffer, format, args);
+    int result = fmt_vsnprintf(buffer, SIZE_MAX, format, args);
     
     va_end(args);
     return result;
@@ -157,7 +180,7 @@ int my_snprintf(char* buffer, size_t size, const char* format, ...) {
     va_list args;
     va_start(args, format);
     
-    int result = vsnprintf(buffer, size, format, args);
+    int result = fmt_vsnprintf(buffer, size, format, args);
     
     va_end(args);
     return result;
@@ -167,30 +190,8 @@ char* concat_strings(int count, ...) {
     va_list args;
     va_start(args, count);
     
-    // Calculate total length
-    size_t total_len = 0;
-    va_list args_copy;
-    va_copy(args_copy, args);
-    
-    for (int i = 0; i < count; i++) {
-        const char* str = va_arg(args_copy, const char*);
-        if (str) total_len += strlen(str);
-    }
-    va_end(args_copy);
-    
-    // Allocate and concatenate
-    char* result = malloc(total_len + 1);
-    if (result == NULL) {
-        va_end(args);
-        return NULL;
-    }
-    
-    result[0] = '\0';
-    
-    for (int i = 0; i < count; i++) {
-        const char* str = va_arg(args, const char*);
-        if (str) strcat(result, str);
-    }
+    // One strlen per piece, one allocation, one memcpy per piece
+    char* result = str_vconcat(NULL, NULL, count, args);
     
     va_end(args);
     return result;
@@ -198,53 +199,49 @@ char* concat_strings(int count, ...) {
 
 // Mathematical operations
 double average(int count, ...) {
-    if (count == 0) return 0.0;
+    if (count <= 0) return 0.0;
     
+    double local[VARARG_STACK];
     va_list args;
     va_start(args, count);
-    
-    double sum = 0.0;
-    for (int i = 0; i < count; i++) {
-        sum += va_arg(args, double);
-    }
-    
+    double* values = collect_doubles(local, count, args);
     va_end(args);
-    return sum / count;
+    if (values == NULL) return 0.0;
+    
+    double mean = reduce_mean_f64(values, (size_t)count);
+    if (values != local) free(values);
+    return mean;
 }
 
 double max_value(int count, ...) {
-    if (count == 0) return 0.0;
+    if (count <= 0) return 0.0;
     
+    double local[VARARG_STACK];
     va_list args;
     va_start(args, count);
-    
-    double max = va_arg(args, double);
-    for (int i = 1; i < count; i++) {
-        double val = va_arg(args, double);
-        if (val > max) max = val;
-    }
-    
+    double* values = collect_doubles(local, count, args);
     va_end(args);
+    if (values == NULL) return 0.0;
+    
+    double max = reduce_max_f64(values, (size_t)count);
+    if (values != local) free(values);
     return max;
 }
 
+// Values arrive row by row; the matrix itself is aligned and padded
+// (see matrix.h), so rows are filled through matrix_row
 Matrix* create_matrix_from_values(int rows, int cols, ...) {
-    Matrix* matrix = malloc(sizeof(Matrix));
+    Matrix* matrix = matrix_create(rows, cols);
     if (matrix == NULL) return NULL;
     
-    matrix->rows = rows;
-    matrix->cols = cols;
-    matrix->data = malloc(rows * cols * sizeof(double));
-    if (matrix->data == NULL) {
-        free(matrix);
-        return NULL;
-    }
-    
     va_list args;
     va_start(args, cols);
     
-    for (int i = 0; i < rows * cols; i++) {
-        matrix->data[i] = va_arg(args, double);
+    for (int i = 0; i < rows; i++) {
+        double* row = matrix_row(matrix, i);
+        for (int j = 0; j < cols; j++) {
+            row[j] = va_arg(args, double);
+        }
     }
     
     va_end(args);
@@ -252,18 +249,16 @@ Matrix* create_matrix_from_values(int rows, int cols, ...) {
 }
 
 void free_matrix(Matrix* matrix) {
-    if (matrix) {
-        free(matrix->data);
-        free(matrix);
-    }
+    matrix_destroy(matrix);
 }
 
 void print_matrix(Matrix* matrix) {
     if (matrix == NULL) return;
     
     for (int i = 0; i < matrix->rows; i++) {
+        const double* row = matrix_row(matrix, i);
         for (int j = 0; j < matrix->cols; j++) {
-            printf("%6.2f ", matrix->data[i * matrix->cols + j]);
+            printf("%6.2f ", row[j]);
         }
         printf("\n");
     }
@@ -316,31 +311,32 @@ void cmd_error(const char* format, ...) {
     printf("\n");
 }
 
-// Command array
+// Command array, hashed into command_registry at startup
 Command commands[] = {
     {"print", cmd_print},
-    {"error", cmd_error},
-    {NULL, NULL}
+    {"error", cmd_error}
 };
 
+static CommandRegistry* command_registry = NULL;
+
 void execute_command(const char* cmd_name, const char* format, ...) {
-    for (int i = 0; commands[i].name; i++) {
-        if (strcmp(commands[i].name, cmd_name) == 0) {
-            va_list args;
-            va_start(args, format);
-            
-            // Create a temporary buffer for the formatted string
-            char buffer[1024];
-            vsnprintf(buffer, sizeof(buffer), format, args);
-            
-            // Call the command function with the formatted string
-            commands[i].func("%s", buffer);
-            
-            va_end(args);
-            return;
-        }
+    int slot = cmd_registry_lookup(command_registry, cmd_name, strlen(cmd_name));
+    if (slot < 0) {
+        printf("Unknown command: %s\n", cmd_name);
+        return;
     }
-    printf("Unknown command: %s\n", cmd_name);
+    
+    va_list args;
+    va_start(args, format);
+    
+    // Create a temporary buffer for the formatted string
+    char buffer[1024];
+    fmt_vsnprintf(buffer, sizeof(buffer), format, args);
+    
+    va_end(args);
+    
+    // Call the command function with the formatted string
+    cmd_registry_invoke(command_registry, slot, buffer);
 }
 
 // Error handling functions
@@ -394,93 +390,92 @@ static inline int sum_3(int a, int b, int c) {
 }
 
 int sum_array(const int* values, size_t count) {
-    int sum = 0;
-    for (size_t i = 0; i < count; i++) {
-        sum += values[i];
-    }
-    return sum;
+    return (int)reduce_sum_i32(values, count);
 }
 
 int sum_large(int count, ...) {
-    if (count <= 10) {
-        va_list args;
-        va_start(args, count);
-        int sum = 0;
-        for (int i = 0; i < count; i++) {
-            sum += va_arg(args, int);
-        }
-        va_end(args);
-        return sum;
-    } else {
-        int* temp = malloc(count * sizeof(int));
-        if (temp == NULL) return 0;
-        
-        va_list args;
-        va_start(args, count);
-        for (int i = 0; i < count; i++) {
-            temp[i] = va_arg(args, int);
-        }
-        va_end(args);
-        
-        int result = sum_array(temp, count);
-        free(temp);
-        return result;
-    }
-}
-
-// Format multiple function
-char* format_multiple(int count, ...) {
+    if (count <= 0) return 0;
+    
+    int32_t local[VARARG_STACK];
     va_list args;
     va_start(args, count);
+    int32_t* values = collect_ints(local, count, args);
+    va_end(args);
+    if (values == NULL) return 0;
     
-    size_t total_len = 1;  // Start with 1 for null terminator
-    char* result = malloc(total_len);
-    if (result == NULL) {
-        va_end(args);
-        return NULL;
+    int result = sum_array(values, (size_t)count);
+    if (values != local) free(values);
+    return result;
+}
+
+// Format multiple function
+// Appends text at out + length while it fits and returns the new length
+static size_t append_text(char* out, size_t size, size_t length, const char* text, size_t n) {
+    if (length < size) {
+        size_t room = size - 1 - length;
+        memcpy(out + length, text, n < room ? n : room);
+        out[length + (n < room ? n : room)] = '\0';
     }
-    result[0] = '\0';
-    
+    return length + n;
+}
+
+// Formats the items of format_multiple straight into out, ", "-separated,
+// bounded by size; returns the full length
+static size_t format_items(char* out, size_t size, int count, va_list args) {
+    size_t length = 0;
     for (int i = 0; i < count; i++) {
         const char* format = va_arg(args, const char*);
+        if (i > 0) length = append_text(out, size, length, ", ", 2);
         
-        char buffer[256];
+        char* at = length < size ? out + length : NULL;
+        size_t room = length < size ? size - length : 0;
+        int written;
         if (strstr(format, "%s")) {
-            const char* str_val = va_arg(args, const char*);
-            snprintf(buffer, sizeof(buffer), format, str_val);
+            written = fmt_snprintf(at, room, format, va_arg(args, const char*));
         } else if (strstr(format, "%d")) {
-            int int_val = va_arg(args, int);
-            snprintf(buffer, sizeof(buffer), format, int_val);
+            written = fmt_snprintf(at, room, format, va_arg(args, int));
         } else if (strstr(format, "%f") || strstr(format, "%.")) {
-            double double_val = va_arg(args, double);
-            snprintf(buffer, sizeof(buffer), format, double_val);
+            written = fmt_snprintf(at, room, format, va_arg(args, double));
         } else {
-            strcpy(buffer, format);
+            written = 0;
+            length = append_text(out, size, length, format, strlen(format));
         }
-        
-        size_t buffer_len = strlen(buffer);
-        size_t separator_len = (i > 0) ? 2 : 0;  // ", "
-        size_t new_total = total_len + buffer_len + separator_len;
-        
-        char* new_result = realloc(result, new_total);
-        if (new_result == NULL) {
-            free(result);
-            va_end(args);
-            return NULL;
+        if (written > 0) length += (size_t)written;
+    }
+    return length;
+}
+
+// Formats into a stack buffer and copies into one exact allocation; only
+// output longer than the buffer is formatted a second time
+char* format_multiple(int count, ...) {
+    va_list args, again;
+    va_start(args, count);
+    va_copy(again, args);
+    
+    char scratch[1024];
+    scratch[0] = '\0';
+    size_t length = format_items(scratch, sizeof(scratch), count, args);
+    
+    char* result = malloc(length + 1);
+    if (result != NULL) {
+        if (length < sizeof(scratch)) {
+            memcpy(result, scratch, length + 1);
+        } else {
+            result[0] = '\0';
+            format_items(result, length + 1, count, again);
         }
-        result = new_result;
-        
-        if (i > 0) strcat(result, ", ");
-        strcat(result, buffer);
-        total_len = new_total;
     }
     
+    va_end(again);
     va_end(args);
     return result;
 }
 
 int main(void) {
     printf("=== Variable Arguments Demo ===\n\n");
+    reduce_init();
+    command_registry = cmd_registry_create(commands, sizeof(commands) / sizeof(commands[0]));
+    if (command_registry == NULL) return 1;
     
     demonstrate_basic_variadic();
     demonstrate_type_safe_variadic();
@@ -490,6 +485,7 @@ int main(void) {
     demonstrate_error_handling();
     demonstrate_performance_optimization();
     
+    cmd_registry_destroy(command_registry);
     printf("=== Demo Complete ===\n");
     return 0;
 }
@@ -586,6 +582,24 @@ void demonstrate_string_processing(void) {
         free(path);
     }
     
+    // Slices joined into a caller-owned arena: no malloc at all
+    char arena_buffer[128];
+    StrArena arena;
+    str_arena_init(&arena, arena_buffer, sizeof(arena_buffer));
+    StrSlice parts[] = {str_slice("alpha"), str_slice("beta"), str_slice("gamma")};
+    StrSlice comma = str_slice(", ");
+    size_t joined_length;
+    char* joined = str_join(parts, 3, comma, &arena, &joined_length);
+    if (joined) {
+        printf("  Joined in arena: '%s' (%zu bytes, arena used %zu)\n", joined, joined_length, arena.used);
+    }
+    
+    // Or skip the concatenation and gather the pieces straight into writev
+    StrSlice line[] = {str_slice("  writev: "), str_slice("Hello"), str_slice(" "), str_slice("World"),
+                       str_slice("!\n")};
+    fflush(stdout);
+    str_writev(STDOUT_FILENO, line, 5, str_slice(NULL));
+    
     printf("\n");
 }
 
@@ -607,6 +621,17 @@ void demonstrate_mathematical_operations(void) {
     double max2 = max_value(4, -1.5, -3.2, -0.8, -2.1);
     printf("  max_value(4, -1.5, -3.2, -0.8, -2.1) = %.2f\n", max2);
     
+    // Array reductions
+    printf("\nArray reductions (%s kernels):\n", reduce_kernels()->name);
+    double samples[] = {2.0, 4.0, 4.0, 4.0, 5.0, 5.0, 7.0, 9.0};
+    size_t sample_count = sizeof(samples) / sizeof(samples[0]);
+    printf("  mean = %.2f, variance = %.2f, min = %.2f, max = %.2f\n",
+           reduce_mean_f64(samples, sample_count), reduce_variance_f64(samples, sample_count),
+           reduce_min_f64(samples, sample_count), reduce_max_f64(samples, sample_count));
+    double cancelling[] = {1e16, 1.0, -1e16};
+    printf("  1e16 + 1 - 1e16: plain sum = %.1f, compensated = %.1f\n",
+           reduce_sum_f64(cancelling, 3), reduce_sum_kahan_f64(cancelling, 3));
+    
     // Matrix creation
     printf("\nMatrix creation from values:\n");
     Matrix* matrix = create_matrix_from_values(3, 3,
@@ -616,6 +641,23 @@ void demonstrate_mathematical_operations(void) {
     if (matrix) {
         printf("  3x3 Matrix:\n");
         print_matrix(matrix);
+        
+        // A * A^T through the blocked kernels
+        matrix_init();
+        Matrix* transposed = matrix_create(3, 3);
+        Matrix* product = matrix_create(3, 3);
+        if (transposed && product && matrix_transpose(transposed, matrix) &&
+            matrix_gemm(1.0, matrix, transposed, 0.0, product)) {
+            printf("  A * A^T (%s kernels):\n", matrix_kernels()->name);
+            print_matrix(product);
+        }
+        double x[3] = {1.0, 0.0, -1.0};
+        double y[3];
+        matrix_gemv(1.0, matrix, x, 0.0, y);
+        printf("  A * [1, 0, -1] = [%.2f, %.2f, %.2f]\n", y[0], y[1], y[2]);
+        
+        free_matrix(transposed);
+        free_matrix(product);
         free_matrix(matrix);
     }
     
@@ -652,6 +694,25 @@ void demonstrate_logging_debugging(void) {
     execute_command("error", "Error code: %d", 404);
     execute_command("unknown", "This won't work");
     
+    // Batch mode: one command per line
+    printf("\nCommand script:\n");
+    FILE* script = tmpfile();
+    if (script) {
+        fputs("# admin batch\n"
+              "print Rebuilding index\n"
+              "print Index ready: 3 shards\n"
+              "error Shard 2 is read-only\n", script);
+        rewind(script);
+        CommandScriptResult result;
+        if (cmd_registry_run_script(command_registry, script, &result)) {
+            printf("  %zu lines, %zu commands executed, %zu unknown\n",
+                   result.lines, result.executed, result.unknown);
+        }
+        fclose(script);
+    }
+    printf("\nCommand statistics:\n");
+    cmd_registry_print_stats(command_registry, stdout);
+    
     printf("\n");
 }
 
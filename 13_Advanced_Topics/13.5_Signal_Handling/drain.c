@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "drain.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+
+typedef struct {
+    const char* name;
+    DrainFlushFunc flush;
+    void* data;
+    uint64_t elapsed_ns;
+    bool ok;
+} FlushHook;
+
+struct Drain {
+    uint32_t phase;             // DrainPhase, changed atomically
+    uint64_t in_flight;
+    uint64_t requested_ns;      // 0 until requested
+    uint64_t deadline_ns;
+    bool noticed;
+    int fd;
+    FlushHook hooks[DRAIN_MAX_FLUSH];
+    int hook_count;
+    DrainStats stats;
+};
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// write() on an eventfd is async-signal-safe
+static void notify(Drain* drain) {
+    uint64_t one = 1;
+    ssize_t written = write(drain->fd, &one, sizeof(one));
+    (void)written;
+}
+
+Drain* drain_create(uint64_t deadline_ns) {
+    Drain* drain = calloc(1, sizeof(Drain));
+    if (drain == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    drain->fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (drain->fd == -1) {
+        perror("eventfd");
+        free(drain);
+        return NULL;
+    }
+    drain->phase = DRAIN_RUNNING;
+    drain->deadline_ns = deadline_ns;
+    return drain;
+}
+
+void drain_destroy(Drain* drain) {
+    if (drain == NULL) return;
+    close(drain->fd);
+    free(drain);
+}
+
+int drain_fd(const Drain* drain) {
+    return drain->fd;
+}
+
+DrainPhase drain_phase(const Drain* drain) {
+    return (DrainPhase)__atomic_load_n(&drain->phase, __ATOMIC_ACQUIRE);
+}
+
+void drain_request(Drain* drain) {
+    uint64_t expected = 0;
+    if (!__atomic_compare_exchange_n(&drain->requested_ns, &expected, now_ns(), false, __ATOMIC_SEQ_CST,
+                                     __ATOMIC_SEQ_CST)) {
+        return;
+    }
+    __atomic_store_n(&drain->phase, DRAIN_DRAINING, __ATOMIC_SEQ_CST);
+    notify(drain);
+}
+
+// ---------------------------------------------------------------------
+// In-flight accounting
+
+static void release(Drain* drain) {
+    if (__atomic_fetch_sub(&drain->in_flight, 1, __ATOMIC_SEQ_CST) == 1 &&
+        __atomic_load_n(&drain->phase, __ATOMIC_SEQ_CST) != DRAIN_RUNNING) {
+        notify(drain);
+    }
+}
+
+// The count goes up before the phase is checked and the request changes
+// the phase before the owner reads the count, so either the owner sees
+// the task or the task sees the request
+bool drain_enter(Drain* drain) {
+    if (__atomic_load_n(&drain->phase, __ATOMIC_ACQUIRE) != DRAIN_RUNNING) {
+        __atomic_fetch_add(&drain->stats.rejected, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    __atomic_fetch_add(&drain->in_flight, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&drain->phase, __ATOMIC_SEQ_CST) != DRAIN_RUNNING) {
+        release(drain);
+        __atomic_fetch_add(&drain->stats.rejected, 1, __ATOMIC_RELAXED);
+        return false;
+    }
+    __atomic_fetch_add(&drain->stats.accepted, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+void drain_leave(Drain* drain) {
+    __atomic_fetch_add(&drain->stats.completed, 1, __ATOMIC_RELAXED);
+    release(drain);
+}
+
+uint64_t drain_in_flight(const Drain* drain) {
+    return __atomic_load_n(&drain->in_flight, __ATOMIC_SEQ_CST);
+}
+
+// ---------------------------------------------------------------------
+// Flush hooks
+
+bool drain_add_flush(Drain* drain, const char* name, DrainFlushFunc flush, void* data) {
+    if (drain->hook_count == DRAIN_MAX_FLUSH || drain_phase(drain) != DRAIN_RUNNING) return false;
+    FlushHook* hook = &drain->hooks[drain->hook_count++];
+    hook->name = name;
+    hook->flush = flush;
+    hook->data = data;
+    hook->elapsed_ns = 0;
+    hook->ok = false;
+    return true;
+}
+
+static bool flush_stream(void* data) {
+    FILE* stream = data;
+    if (fflush(stream) != 0) return false;
+    struct stat st;
+    int fd = fileno(stream);
+    if (fd == -1 || fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) return true;
+    return fsync(fd) == 0;
+}
+
+bool drain_add_stream(Drain* drain, const char* name, FILE* stream) {
+    return drain_add_flush(drain, name, flush_stream, stream);
+}
+
+// ---------------------------------------------------------------------
+// Driving the drain
+
+bool drain_step(Drain* drain) {
+    uint64_t value;
+    while (read(drain->fd, &value, sizeof(value)) > 0) {
+    }
+
+    DrainPhase phase = drain_phase(drain);
+    if (phase == DRAIN_RUNNING) return false;
+    if (phase == DRAIN_DONE) return true;
+
+    uint64_t requested = __atomic_load_n(&drain->requested_ns, __ATOMIC_ACQUIRE);
+    uint64_t now = now_ns();
+    if (!drain->noticed) {
+        drain->noticed = true;
+        drain->stats.notice_ns = now - requested;
+    }
+    uint64_t in_flight = drain_in_flight(drain);
+    if (in_flight > 0 && (drain->deadline_ns == 0 || now - requested < drain->deadline_ns)) return false;
+
+    drain->stats.wait_ns = now - requested - drain->stats.notice_ns;
+    drain->stats.abandoned = in_flight;
+    drain->stats.forced = in_flight > 0;
+    __atomic_store_n(&drain->phase, DRAIN_FLUSHING, __ATOMIC_RELEASE);
+
+    for (int i = 0; i < drain->hook_count; i++) {
+        FlushHook* hook = &drain->hooks[i];
+        uint64_t start = now_ns();
+        hook->ok = hook->flush(hook->data);
+        hook->elapsed_ns = now_ns() - start;
+        if (!hook->ok) drain->stats.flush_failures++;
+    }
+    uint64_t end = now_ns();
+    drain->stats.flush_ns = end - now;
+    drain->stats.total_ns = end - requested;
+    __atomic_store_n(&drain->phase, DRAIN_DONE, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool drain_deadline(const Drain* drain, uint64_t* deadline_ns) {
+    uint64_t requested = __atomic_load_n(&drain->requested_ns, __ATOMIC_ACQUIRE);
+    if (requested == 0 || drain->deadline_ns == 0) return false;
+    *deadline_ns = requested + drain->deadline_ns;
+    return true;
+}
+
+bool drain_run(Drain* drain) {
+    while (!drain_step(drain)) {
+        int timeout = -1;
+        uint64_t deadline;
+        if (drain_deadline(drain, &deadline)) {
+            uint64_t now = now_ns();
+            timeout = deadline > now ? (int)((deadline - now + 999999) / 1000000) : 0;
+        }
+        struct pollfd pfd = {drain->fd, POLLIN, 0};
+        if (poll(&pfd, 1, timeout) == -1 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+    }
+    return !drain->stats.forced;
+}
+
+const DrainStats* drain_stats(const Drain* drain) {
+    return &drain->stats;
+}
+
+void drain_print_stats(const Drain* drain) {
+    const DrainStats* stats = &drain->stats;
+    printf("  %-12s %10.3f ms\n", "notice", stats->notice_ns / 1e6);
+    printf("  %-12s %10.3f ms%s\n", "wait", stats->wait_ns / 1e6, stats->forced ? "  (deadline)" : "");
+    printf("  %-12s %10.3f ms\n", "flush", stats->flush_ns / 1e6);
+    for (int i = 0; i < drain->hook_count; i++) {
+        const FlushHook* hook = &drain->hooks[i];
+        printf("    %-10s %10.3f ms%s\n", hook->name, hook->elapsed_ns / 1e6, hook->ok ? "" : "  (failed)");
+    }
+    printf("  %-12s %10.3f ms\n", "total", stats->total_ns / 1e6);
+    printf("  Tasks: %llu accepted, %llu completed, %llu rejected, %llu abandoned\n",
+           (unsigned long long)stats->accepted, (unsigned long long)stats->completed,
+           (unsigned long long)stats->rejected, (unsigned long long)stats->abandoned);
+}
@@ -0,0 +1,84 @@
+#ifndef DRAIN_H
+#define DRAIN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Graceful drain protocol for shutdown. Phases:
+//   running     drain_enter admits work; in-flight tasks are counted
+//               with atomics, so any thread may enter and leave
+//   draining    drain_request (safe in a signal handler) stops
+//               admission at once; the owner waits for the in-flight
+//               count to reach zero or for the deadline to pass
+//   flushing    registered flush hooks run in order (loggers, stdio
+//               streams, files), even when the deadline forced the drain
+//   done        the owner exits; a forced drain reports the tasks it
+//               abandoned
+// The owner drives the protocol with drain_step from an event loop,
+// using drain_fd (an eventfd that becomes readable on the request and
+// when the last in-flight task leaves), or with the blocking drain_run.
+// Every phase is timed.
+
+#define DRAIN_MAX_FLUSH 16
+
+typedef enum {
+    DRAIN_RUNNING,
+    DRAIN_DRAINING,
+    DRAIN_FLUSHING,
+    DRAIN_DONE
+} DrainPhase;
+
+// Returns false if the flush failed; later hooks still run
+typedef bool (*DrainFlushFunc)(void* data);
+
+typedef struct {
+    uint64_t notice_ns;         // request until the owner's first step
+    uint64_t wait_ns;           // until in-flight work finished or the deadline
+    uint64_t flush_ns;          // all flush hooks
+    uint64_t total_ns;          // request until done
+    uint64_t accepted;
+    uint64_t rejected;          // drain_enter calls refused after the request
+    uint64_t completed;
+    uint64_t abandoned;         // still in flight at the deadline
+    int flush_failures;
+    bool forced;
+} DrainStats;
+
+typedef struct Drain Drain;
+
+// deadline_ns counts from the request; 0 waits for in-flight work forever
+Drain* drain_create(uint64_t deadline_ns);      // NULL on failure
+void drain_destroy(Drain* drain);
+
+int drain_fd(const Drain* drain);
+DrainPhase drain_phase(const Drain* drain);
+
+// Async-signal-safe; only the first request counts
+void drain_request(Drain* drain);
+
+// Task accounting, from any thread. drain_enter returns false once the
+// drain was requested; every successful enter needs one leave.
+bool drain_enter(Drain* drain);
+void drain_leave(Drain* drain);
+uint64_t drain_in_flight(const Drain* drain);
+
+// Register before requesting a drain
+bool drain_add_flush(Drain* drain, const char* name, DrainFlushFunc flush, void* data);
+// Flushes the stream's buffer and, for a regular file, syncs it to disk
+bool drain_add_stream(Drain* drain, const char* name, FILE* stream);
+
+// Advances the protocol without blocking. Call it when drain_fd is
+// readable and once the deadline passes; returns true when done.
+bool drain_step(Drain* drain);
+// Absolute CLOCK_MONOTONIC deadline; false before a request or with none
+bool drain_deadline(const Drain* drain, uint64_t* deadline_ns);
+
+// Waits for a request, then drains; returns false if the drain was forced
+bool drain_run(Drain* drain);
+
+const DrainStats* drain_stats(const Drain* drain);
+void drain_print_stats(const Drain* drain);
+
+#endif /* DRAIN_H */
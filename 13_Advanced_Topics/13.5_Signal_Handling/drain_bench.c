@@ -0,0 +1,274 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "evloop.h"
+#include "drain.h"
+
+// Drain protocol costs:
+//   accounting    10^7 drain_enter/drain_leave pairs against a plain
+//                 (unsafe) counter
+//   drain         1000 in-flight tasks finishing at random times up to
+//                 20 ms after the request; the drain must end as soon as
+//                 the last one leaves, with every task completed
+//   deadline      10 tasks that never finish and a 20 ms deadline; the
+//                 drain must be forced at the deadline, not before
+//   exit          a child writes 10^5 lines to a fully buffered file and
+//                 gets SIGTERM, once with the default action and once
+//                 draining; the drained file must be complete
+// The argument scales the operation counts (default 1).
+static int failed = 0;
+
+static double now_seconds(void) {
+    return (double)event_loop_now() / 1e9;
+}
+
+static void report(const char* name, double ops, double seconds, double baseline) {
+    printf("  %-28s %12.0f ops/s  %8.1f ns/op", name, ops / seconds, seconds * 1e9 / ops);
+    if (baseline > 0) printf("  %6.2fx", baseline / seconds);
+    printf("\n");
+}
+
+static void report_ms(const char* name, uint64_t ns) {
+    printf("  %-28s %10.3f ms\n", name, ns / 1e6);
+}
+
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+// ---------------------------------------------------------------------
+// Accounting
+
+static void bench_accounting(size_t count) {
+    volatile uint64_t plain = 0;
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        plain++;
+        plain--;
+    }
+    double baseline = now_seconds() - start;
+
+    Drain* drain = drain_create(0);
+    if (drain == NULL) exit(1);
+    size_t entered = 0;
+    start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        entered += drain_enter(drain);
+        drain_leave(drain);
+    }
+    double seconds = now_seconds() - start;
+
+    report("plain counter", (double)count, baseline, 0);
+    report("drain enter + leave", (double)count, seconds, baseline);
+    failed |= entered != count || drain_in_flight(drain) != 0 || plain != 0;
+
+    // Nothing is admitted once the drain is requested
+    drain_request(drain);
+    failed |= drain_enter(drain) || !drain_step(drain) || drain_stats(drain)->rejected != 1;
+    drain_destroy(drain);
+}
+
+// ---------------------------------------------------------------------
+// Draining in an event loop
+
+typedef struct {
+    EventLoop* loop;
+    Drain* drain;
+    uint64_t done_at;
+} LoopDrain;
+
+static void on_task_done(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    LoopDrain* state = data;
+    drain_leave(state->drain);
+}
+
+static void on_drain_ready(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)fd;
+    (void)events;
+    LoopDrain* state = data;
+    if (drain_step(state->drain)) {
+        state->done_at = event_loop_now();
+        event_loop_stop(loop);
+    }
+}
+
+static void on_deadline(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)timer;
+    LoopDrain* state = data;
+    if (drain_step(state->drain)) {
+        state->done_at = event_loop_now();
+        event_loop_stop(loop);
+    }
+}
+
+// Runs tasks that finish within spread_ns of the request (never, when
+// spread_ns is 0) and returns the time of the last completion
+static uint64_t run_loop_drain(LoopDrain* state, size_t tasks, uint64_t spread_ns, uint64_t deadline_ns) {
+    state->loop = event_loop_create();
+    state->drain = drain_create(deadline_ns);
+    if (state->loop == NULL || state->drain == NULL ||
+        !event_loop_add_fd(state->loop, drain_fd(state->drain), EVENT_READ, on_drain_ready, state)) {
+        fprintf(stderr, "Failed to set up drain\n");
+        exit(1);
+    }
+    uint64_t last = 0;
+    uint64_t start = event_loop_now();
+    for (size_t i = 0; i < tasks; i++) {
+        if (!drain_enter(state->drain)) failed = 1;
+        if (spread_ns == 0) continue;
+        uint64_t delay = next_random() % spread_ns + 1;
+        if (delay > last) last = delay;
+        event_loop_add_timer(state->loop, delay, 0, on_task_done, state);
+    }
+    drain_request(state->drain);
+    if (deadline_ns > 0) event_loop_add_timer(state->loop, deadline_ns, 0, on_deadline, state);
+    event_loop_run(state->loop);
+    return start + last;
+}
+
+static void bench_drain(size_t tasks) {
+    LoopDrain state;
+    uint64_t last = run_loop_drain(&state, tasks, 20000000, 0);
+    const DrainStats* stats = drain_stats(state.drain);
+    report_ms("drain: notice", stats->notice_ns);
+    report_ms("drain: wait for tasks", stats->wait_ns);
+    report_ms("drain: total", stats->total_ns);
+    report_ms("drain: after last task", state.done_at - last);
+    failed |= stats->completed != tasks || stats->abandoned != 0 || stats->forced || drain_in_flight(state.drain);
+    drain_destroy(state.drain);
+    event_loop_destroy(state.loop);
+}
+
+static void bench_deadline(size_t tasks) {
+    const uint64_t deadline = 20000000;
+    LoopDrain state;
+    run_loop_drain(&state, tasks, 0, deadline);
+    const DrainStats* stats = drain_stats(state.drain);
+    report_ms("forced: total", stats->total_ns);
+    report_ms("forced: past the deadline", stats->total_ns - deadline);
+    failed |= !stats->forced || stats->abandoned != tasks || stats->total_ns < deadline;
+    drain_destroy(state.drain);
+    event_loop_destroy(state.loop);
+}
+
+// ---------------------------------------------------------------------
+// Buffered output at exit
+
+static Drain* writer_drain = NULL;
+
+static void writer_sigterm(int sig) {
+    (void)sig;
+    drain_request(writer_drain);
+}
+
+// Child: fills a buffered file, reports ready, then waits for SIGTERM
+static void run_writer(const char* path, size_t lines, bool drained, int ready_fd) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) _exit(2);
+    setvbuf(file, NULL, _IOFBF, 1 << 20);
+    if (drained) {
+        writer_drain = drain_create(1000000000);
+        if (writer_drain == NULL) _exit(2);
+        drain_add_stream(writer_drain, "file", file);
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = writer_sigterm;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGTERM, &sa, NULL);
+    }
+    for (size_t i = 0; i < lines; i++) {
+        fprintf(file, "line %08zu\n", i);
+    }
+    char byte = 1;
+    if (write(ready_fd, &byte, 1) != 1) _exit(2);
+    if (drained) {
+        drain_run(writer_drain);
+        _exit(0);
+    }
+    for (;;) {
+        pause();
+    }
+}
+
+// Returns the bytes that reached the file; *exit_ns is SIGTERM to reaped
+static long run_exit(const char* path, size_t lines, bool drained, uint64_t* exit_ns) {
+    int ready[2];
+    if (pipe(ready) != 0) exit(1);
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(ready[0]);
+        run_writer(path, lines, drained, ready[1]);
+    }
+    close(ready[1]);
+    char byte;
+    if (pid == -1 || read(ready[0], &byte, 1) != 1) exit(1);
+    close(ready[0]);
+
+    uint64_t start = event_loop_now();
+    kill(pid, SIGTERM);
+    waitpid(pid, NULL, 0);
+    *exit_ns = event_loop_now() - start;
+
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void bench_exit(size_t lines) {
+    char path[] = "/tmp/drain_benchXXXXXX";
+    int fd = mkstemp(path);
+    if (fd == -1) {
+        perror("mkstemp");
+        exit(1);
+    }
+    close(fd);
+
+    long expected = (long)(lines * 14);
+    uint64_t abrupt_ns, drained_ns;
+    long abrupt = run_exit(path, lines, false, &abrupt_ns);
+    long drained = run_exit(path, lines, true, &drained_ns);
+    unlink(path);
+
+    printf("  %-28s %10ld of %ld bytes  %8.3f ms\n", "default SIGTERM", abrupt, expected, abrupt_ns / 1e6);
+    printf("  %-28s %10ld of %ld bytes  %8.3f ms\n", "drained SIGTERM", drained, expected, drained_ns / 1e6);
+    failed |= drained != expected || abrupt >= expected;
+}
+
+int main(int argc, char* argv[]) {
+    long scale = argc > 1 ? atol(argv[1]) : 1;
+    if (scale < 1 || scale > 100) {
+        fprintf(stderr, "Usage: %s [scale, 1 .. 100]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== Graceful Drain Benchmark ===\n\n");
+    printf("Accounting:\n");
+    bench_accounting(10000000 * (size_t)scale);
+    printf("Draining:\n");
+    bench_drain(1000 * (size_t)scale);
+    bench_deadline(10);
+    printf("Exit with buffered output:\n");
+    bench_exit(100000 * (size_t)scale);
+    printf("\n");
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
@@ -0,0 +1,448 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "evloop.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#define EVENT_MAX_SIGNAL 64         // Linux signal numbers are 1 .. 64
+#define EVENT_SIGNAL_READ 16        // siginfo records per read
+#define TIMER_FREE UINT32_MAX
+
+typedef struct {
+    EventFdCallback callback;
+    void* data;
+    uint32_t generation;        // bumped on each add, so stale events miss
+} FdHandler;
+
+typedef struct {
+    uint64_t deadline;
+    uint64_t interval;
+    EventTimerCallback callback;
+    void* data;
+    uint32_t generation;        // bumped when the slot is freed, so stale ids miss
+    uint32_t heap_index;        // TIMER_FREE when the slot is unused
+} TimerEntry;
+
+typedef struct {
+    EventDeferCallback callback;
+    void* data;
+} DeferEntry;
+
+struct EventLoop {
+    int epoll_fd;
+    int timer_fd;
+    int signal_fd;
+    bool running;
+
+    FdHandler* handlers;        // indexed by fd
+    size_t handler_capacity;
+
+    TimerEntry* timers;         // pool indexed by slot
+    uint32_t* heap;             // slots, earliest deadline first
+    uint32_t* free_slots;
+    size_t timer_count;
+    size_t free_count;
+    size_t timer_capacity;
+    uint64_t armed_deadline;    // timer_fd setting, 0 when disarmed
+
+    sigset_t signals;           // routed through signal_fd
+    sigset_t saved_mask;
+    EventSignalCallback signal_callbacks[EVENT_MAX_SIGNAL + 1];
+    void* signal_data[EVENT_MAX_SIGNAL + 1];
+
+    DeferEntry* deferred;       // queued for the end of this iteration
+    size_t defer_count;
+    size_t defer_capacity;
+    DeferEntry* running_deferred;
+    size_t running_capacity;
+};
+
+uint64_t event_loop_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Doubles *capacity until index fits; new entries are zeroed
+static bool grow(void** array, size_t* capacity, size_t index, size_t size) {
+    if (index < *capacity) return true;
+    size_t new_capacity = *capacity ? *capacity : 16;
+    while (new_capacity <= index) new_capacity *= 2;
+    void* grown = realloc(*array, new_capacity * size);
+    if (grown == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return false;
+    }
+    memset((char*)grown + *capacity * size, 0, (new_capacity - *capacity) * size);
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+EventLoop* event_loop_create(void) {
+    EventLoop* loop = calloc(1, sizeof(EventLoop));
+    if (loop == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    loop->signal_fd = -1;
+    sigemptyset(&loop->signals);
+    sigprocmask(SIG_BLOCK, NULL, &loop->saved_mask);
+
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct epoll_event ev = {.events = EPOLLIN, .data.u64 = (uint32_t)loop->timer_fd};
+    if (loop->epoll_fd == -1 || loop->timer_fd == -1 ||
+        epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->timer_fd, &ev) != 0) {
+        perror("Failed to create event loop");
+        if (loop->epoll_fd != -1) close(loop->epoll_fd);
+        if (loop->timer_fd != -1) close(loop->timer_fd);
+        free(loop);
+        return NULL;
+    }
+    return loop;
+}
+
+void event_loop_destroy(EventLoop* loop) {
+    if (loop == NULL) return;
+    for (int sig = 1; sig <= EVENT_MAX_SIGNAL; sig++) {
+        if (sigismember(&loop->signals, sig) == 1) event_loop_remove_signal(loop, sig);
+    }
+    if (loop->signal_fd != -1) close(loop->signal_fd);
+    close(loop->timer_fd);
+    close(loop->epoll_fd);
+    free(loop->handlers);
+    free(loop->timers);
+    free(loop->heap);
+    free(loop->free_slots);
+    free(loop->deferred);
+    free(loop->running_deferred);
+    free(loop);
+}
+
+void event_loop_stop(EventLoop* loop) {
+    loop->running = false;
+}
+
+// ---------------------------------------------------------------------
+// File descriptors
+
+// The epoll data carries the fd and its registration's generation
+static uint64_t fd_key(const EventLoop* loop, int fd) {
+    return ((uint64_t)loop->handlers[fd].generation << 32) | (uint32_t)fd;
+}
+
+bool event_loop_add_fd(EventLoop* loop, int fd, uint32_t events, EventFdCallback callback, void* data) {
+    if (fd < 0 || callback == NULL) return false;
+    if (!grow((void**)&loop->handlers, &loop->handler_capacity, (size_t)fd, sizeof(FdHandler))) {
+        return false;
+    }
+    if (loop->handlers[fd].callback != NULL) return false;
+
+    loop->handlers[fd].generation++;
+    struct epoll_event ev = {.events = events, .data.u64 = fd_key(loop, fd)};
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) return false;
+    loop->handlers[fd].callback = callback;
+    loop->handlers[fd].data = data;
+    return true;
+}
+
+bool event_loop_modify_fd(EventLoop* loop, int fd, uint32_t events) {
+    if (fd < 0 || (size_t)fd >= loop->handler_capacity || loop->handlers[fd].callback == NULL) {
+        return false;
+    }
+    struct epoll_event ev = {.events = events, .data.u64 = fd_key(loop, fd)};
+    return epoll_ctl(loop->epoll_fd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+bool event_loop_remove_fd(EventLoop* loop, int fd) {
+    if (fd < 0 || (size_t)fd >= loop->handler_capacity || loop->handlers[fd].callback == NULL) {
+        return false;
+    }
+    loop->handlers[fd].callback = NULL;
+    loop->handlers[fd].data = NULL;
+    return epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, fd, NULL) == 0;
+}
+
+// ---------------------------------------------------------------------
+// Timers: binary min-heap of pool slots
+
+static EventTimerId timer_id(const EventLoop* loop, uint32_t slot) {
+    return ((uint64_t)loop->timers[slot].generation << 32) | (slot + 1);
+}
+
+static void heap_place(EventLoop* loop, size_t index, uint32_t slot) {
+    loop->heap[index] = slot;
+    loop->timers[slot].heap_index = (uint32_t)index;
+}
+
+static void sift_up(EventLoop* loop, size_t index) {
+    uint32_t slot = loop->heap[index];
+    uint64_t deadline = loop->timers[slot].deadline;
+    while (index > 0) {
+        size_t parent = (index - 1) / 2;
+        if (loop->timers[loop->heap[parent]].deadline <= deadline) break;
+        heap_place(loop, index, loop->heap[parent]);
+        index = parent;
+    }
+    heap_place(loop, index, slot);
+}
+
+static void sift_down(EventLoop* loop, size_t index) {
+    uint32_t slot = loop->heap[index];
+    uint64_t deadline = loop->timers[slot].deadline;
+    for (;;) {
+        size_t child = 2 * index + 1;
+        if (child >= loop->timer_count) break;
+        if (child + 1 < loop->timer_count &&
+            loop->timers[loop->heap[child + 1]].deadline < loop->timers[loop->heap[child]].deadline) {
+            child++;
+        }
+        if (loop->timers[loop->heap[child]].deadline >= deadline) break;
+        heap_place(loop, index, loop->heap[child]);
+        index = child;
+    }
+    heap_place(loop, index, slot);
+}
+
+static void heap_remove(EventLoop* loop, size_t index) {
+    uint32_t slot = loop->heap[index];
+    loop->timer_count--;
+    if (index < loop->timer_count) {
+        heap_place(loop, index, loop->heap[loop->timer_count]);
+        sift_down(loop, index);
+        sift_up(loop, index);
+    }
+    loop->timers[slot].heap_index = TIMER_FREE;
+    loop->timers[slot].generation++;
+    loop->free_slots[loop->free_count++] = slot;
+}
+
+// Points timer_fd at the earliest deadline when that moved earlier; a
+// later deadline is picked up after the next (then spurious) expiry
+static void rearm(EventLoop* loop) {
+    if (loop->timer_count == 0) return;
+    uint64_t deadline = loop->timers[loop->heap[0]].deadline;
+    if (loop->armed_deadline != 0 && loop->armed_deadline <= deadline) return;
+
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value.tv_sec = (time_t)(deadline / 1000000000ull);
+    spec.it_value.tv_nsec = (long)(deadline % 1000000000ull);
+    if (timerfd_settime(loop->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) == 0) {
+        loop->armed_deadline = deadline;
+    }
+}
+
+EventTimerId event_loop_add_timer(EventLoop* loop, uint64_t delay_ns, uint64_t interval_ns,
+                                  EventTimerCallback callback, void* data) {
+    if (callback == NULL) return 0;
+    if (loop->free_count == 0) {
+        size_t old_capacity = loop->timer_capacity;
+        if (old_capacity >= TIMER_FREE / 2) return 0;
+        size_t capacity = old_capacity;
+        size_t heap_capacity = old_capacity, free_capacity = old_capacity;
+        if (!grow((void**)&loop->timers, &capacity, old_capacity, sizeof(TimerEntry)) ||
+            !grow((void**)&loop->heap, &heap_capacity, old_capacity, sizeof(uint32_t)) ||
+            !grow((void**)&loop->free_slots, &free_capacity, old_capacity, sizeof(uint32_t))) {
+            return 0;
+        }
+        loop->timer_capacity = capacity;
+        // Lowest slots end up on top of the free stack
+        for (size_t slot = capacity; slot-- > old_capacity;) {
+            loop->timers[slot].heap_index = TIMER_FREE;
+            loop->free_slots[loop->free_count++] = (uint32_t)slot;
+        }
+    }
+
+    uint32_t slot = loop->free_slots[--loop->free_count];
+    TimerEntry* timer = &loop->timers[slot];
+    timer->deadline = event_loop_now() + delay_ns;
+    timer->interval = interval_ns;
+    timer->callback = callback;
+    timer->data = data;
+    loop->heap[loop->timer_count] = slot;
+    sift_up(loop, loop->timer_count++);
+    rearm(loop);
+    return timer_id(loop, slot);
+}
+
+bool event_loop_cancel_timer(EventLoop* loop, EventTimerId timer) {
+    uint64_t slot = (timer & 0xFFFFFFFFull) - 1;
+    if (timer == 0 || slot >= loop->timer_capacity) return false;
+    TimerEntry* entry = &loop->timers[slot];
+    if (entry->heap_index == TIMER_FREE || entry->generation != (uint32_t)(timer >> 32)) return false;
+    heap_remove(loop, entry->heap_index);
+    return true;
+}
+
+// Runs every timer that is due; periodic ones are pushed back by whole
+// intervals, skipping ticks that were missed entirely
+static int run_timers(EventLoop* loop) {
+    uint64_t expirations;
+    while (read(loop->timer_fd, &expirations, sizeof(expirations)) > 0) {
+    }
+    loop->armed_deadline = 0;
+
+    int dispatched = 0;
+    uint64_t now = event_loop_now();
+    while (loop->timer_count > 0) {
+        uint32_t slot = loop->heap[0];
+        TimerEntry* timer = &loop->timers[slot];
+        if (timer->deadline > now) break;
+
+        EventTimerId id = timer_id(loop, slot);
+        EventTimerCallback callback = timer->callback;
+        void* data = timer->data;
+        if (timer->interval > 0) {
+            timer->deadline += timer->interval;
+            if (timer->deadline <= now) {
+                timer->deadline += (now - timer->deadline) / timer->interval * timer->interval + timer->interval;
+            }
+            sift_down(loop, 0);
+        } else {
+            heap_remove(loop, 0);
+        }
+        callback(loop, id, data);
+        dispatched++;
+    }
+    rearm(loop);
+    return dispatched;
+}
+
+// ---------------------------------------------------------------------
+// Signals
+
+bool event_loop_add_signal(EventLoop* loop, int sig, EventSignalCallback callback, void* data) {
+    if (sig < 1 || sig > EVENT_MAX_SIGNAL || callback == NULL) return false;
+    sigset_t one;
+    sigemptyset(&one);
+    if (sigaddset(&one, sig) != 0 || sigprocmask(SIG_BLOCK, &one, NULL) != 0) return false;
+    sigaddset(&loop->signals, sig);
+
+    int fd = signalfd(loop->signal_fd, &loop->signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (fd == -1) {
+        event_loop_remove_signal(loop, sig);
+        return false;
+    }
+    if (loop->signal_fd == -1) {
+        struct epoll_event ev = {.events = EPOLLIN, .data.u64 = (uint32_t)fd};
+        if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            event_loop_remove_signal(loop, sig);
+            return false;
+        }
+        loop->signal_fd = fd;
+    }
+    loop->signal_callbacks[sig] = callback;
+    loop->signal_data[sig] = data;
+    return true;
+}
+
+bool event_loop_remove_signal(EventLoop* loop, int sig) {
+    if (sig < 1 || sig > EVENT_MAX_SIGNAL) return false;
+    sigdelset(&loop->signals, sig);
+    loop->signal_callbacks[sig] = NULL;
+    loop->signal_data[sig] = NULL;
+    if (loop->signal_fd != -1) {
+        signalfd(loop->signal_fd, &loop->signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    }
+    if (sigismember(&loop->saved_mask, sig) == 0) {
+        sigset_t one;
+        sigemptyset(&one);
+        sigaddset(&one, sig);
+        sigprocmask(SIG_UNBLOCK, &one, NULL);
+    }
+    return true;
+}
+
+static int run_signals(EventLoop* loop) {
+    struct signalfd_siginfo infos[EVENT_SIGNAL_READ];
+    int dispatched = 0;
+    ssize_t bytes;
+    while ((bytes = read(loop->signal_fd, infos, sizeof(infos))) > 0) {
+        size_t count = (size_t)bytes / sizeof(infos[0]);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t sig = infos[i].ssi_signo;
+            if (sig <= EVENT_MAX_SIGNAL && loop->signal_callbacks[sig] != NULL) {
+                loop->signal_callbacks[sig](loop, &infos[i], loop->signal_data[sig]);
+                dispatched++;
+            }
+        }
+    }
+    return dispatched;
+}
+
+// ---------------------------------------------------------------------
+// Deferred work and dispatch
+
+bool event_loop_defer(EventLoop* loop, EventDeferCallback callback, void* data) {
+    if (callback == NULL) return false;
+    if (!grow((void**)&loop->deferred, &loop->defer_capacity, loop->defer_count, sizeof(DeferEntry))) {
+        return false;
+    }
+    loop->deferred[loop->defer_count].callback = callback;
+    loop->deferred[loop->defer_count].data = data;
+    loop->defer_count++;
+    return true;
+}
+
+// Swaps the queue out first, so work deferred now waits for the next pass
+static int run_deferred(EventLoop* loop) {
+    DeferEntry* batch = loop->deferred;
+    size_t count = loop->defer_count;
+    size_t capacity = loop->defer_capacity;
+    loop->deferred = loop->running_deferred;
+    loop->defer_capacity = loop->running_capacity;
+    loop->defer_count = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        batch[i].callback(loop, batch[i].data);
+    }
+    loop->running_deferred = batch;
+    loop->running_capacity = capacity;
+    return (int)count;
+}
+
+int event_loop_run_once(EventLoop* loop, int timeout_ms) {
+    struct epoll_event events[EVENT_LOOP_BATCH];
+    if (loop->defer_count > 0) timeout_ms = 0;
+
+    int ready = epoll_wait(loop->epoll_fd, events, EVENT_LOOP_BATCH, timeout_ms);
+    if (ready < 0) return errno == EINTR ? 0 : -1;
+
+    int dispatched = 0;
+    for (int i = 0; i < ready; i++) {
+        // An fd closed and re-added earlier in this batch has a new
+        // generation; the old registration's event must not reach it
+        int fd = (int)(uint32_t)events[i].data.u64;
+        uint32_t generation = (uint32_t)(events[i].data.u64 >> 32);
+        if (fd == loop->timer_fd) {
+            dispatched += run_timers(loop);
+        } else if (fd == loop->signal_fd) {
+            dispatched += run_signals(loop);
+        } else if ((size_t)fd < loop->handler_capacity && loop->handlers[fd].callback != NULL &&
+                   loop->handlers[fd].generation == generation) {
+            loop->handlers[fd].callback(loop, fd, events[i].events, loop->handlers[fd].data);
+            dispatched++;
+        }
+    }
+    return dispatched + run_deferred(loop);
+}
+
+bool event_loop_run(EventLoop* loop) {
+    loop->running = true;
+    while (loop->running) {
+        if (event_loop_run_once(loop, -1) < 0) {
+            perror("epoll_wait");
+            return false;
+        }
+    }
+    return true;
+}
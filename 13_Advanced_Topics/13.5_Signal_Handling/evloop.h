@@ -0,0 +1,71 @@
+#ifndef EVLOOP_H
+#define EVLOOP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+
+// Single-threaded event loop built on epoll. One epoll_wait covers
+//   fd events     readiness callbacks on any descriptor
+//   timers        one-shot and periodic, kept in a min-heap by deadline;
+//                 a single timerfd is armed for the earliest one
+//   signals       delivered through a signalfd instead of a handler, so
+//                 callbacks run in normal context and may call printf,
+//                 malloc and anything else
+//   deferred      work queued to run once the current batch is done
+// Each wait returns up to EVENT_LOOP_BATCH events, all dispatched before
+// the loop waits again. Times are CLOCK_MONOTONIC nanoseconds.
+
+#define EVENT_LOOP_BATCH 256
+
+#define EVENT_READ EPOLLIN
+#define EVENT_WRITE EPOLLOUT
+#define EVENT_ERROR (EPOLLERR | EPOLLHUP)
+
+typedef struct EventLoop EventLoop;
+
+// A timer id; 0 is never a valid id
+typedef uint64_t EventTimerId;
+
+typedef void (*EventFdCallback)(EventLoop* loop, int fd, uint32_t events, void* data);
+typedef void (*EventTimerCallback)(EventLoop* loop, EventTimerId timer, void* data);
+typedef void (*EventSignalCallback)(EventLoop* loop, const struct signalfd_siginfo* info, void* data);
+typedef void (*EventDeferCallback)(EventLoop* loop, void* data);
+
+EventLoop* event_loop_create(void);     // NULL on failure
+void event_loop_destroy(EventLoop* loop);
+
+// Runs until event_loop_stop; returns false if epoll_wait fails
+bool event_loop_run(EventLoop* loop);
+// One wait of at most timeout_ms (-1 for no limit) and its dispatch;
+// returns the number of callbacks run, -1 on error
+int event_loop_run_once(EventLoop* loop, int timeout_ms);
+void event_loop_stop(EventLoop* loop);
+
+uint64_t event_loop_now(void);
+
+// events is a mask of EVENT_READ and EVENT_WRITE; errors are always
+// reported. An fd removed during a batch gets no further callbacks, even
+// if its number is reused and added again before the batch ends.
+bool event_loop_add_fd(EventLoop* loop, int fd, uint32_t events, EventFdCallback callback, void* data);
+bool event_loop_modify_fd(EventLoop* loop, int fd, uint32_t events);
+bool event_loop_remove_fd(EventLoop* loop, int fd);
+
+// First call after delay_ns, then every interval_ns (0 for one-shot).
+// Returns 0 on failure. Cancelling an expired or unknown id is harmless.
+EventTimerId event_loop_add_timer(EventLoop* loop, uint64_t delay_ns, uint64_t interval_ns,
+                                  EventTimerCallback callback, void* data);
+bool event_loop_cancel_timer(EventLoop* loop, EventTimerId timer);
+
+// Blocks sig and routes it to callback until removed or the loop is
+// destroyed, which restores the previous mask
+bool event_loop_add_signal(EventLoop* loop, int sig, EventSignalCallback callback, void* data);
+bool event_loop_remove_signal(EventLoop* loop, int sig);
+
+// Runs callback after the current batch; work deferred from a deferred
+// callback runs on the next iteration
+bool event_loop_defer(EventLoop* loop, EventDeferCallback callback, void* data);
+
+#endif /* EVLOOP_H */
@@ -0,0 +1,441 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "evloop.h"
+
+// Event loop costs:
+//   wakeup      a child process stamps CLOCK_MONOTONIC and wakes the loop
+//               through a pipe or with SIGUSR1, then waits for an ack;
+//               the loop records now - stamp. The signal case is also run
+//               with the old self-pipe handler and a poll() loop
+//   fd events   always-readable pipes, level-triggered: all 64 of 64
+//               active, and 16 active out of 480 (stays under the usual
+//               1024 descriptor limit); epoll loop vs a poll() loop
+//   timers      10^6 timers spread over 10 ms, scheduled and fired
+//   deferred    a chain of 10^6 deferred calls
+// A check also closes and re-adds an fd number in the middle of a batch
+// and makes sure the old registration's event is not delivered to it.
+// The argument scales the sample and event counts (default 1).
+static int failed = 0;
+
+static double now_seconds(void) {
+    return (double)event_loop_now() / 1e9;
+}
+
+static void report(const char* name, double ops, double seconds, double baseline) {
+    printf("  %-28s %12.0f ops/s  %8.1f ns/op", name, ops / seconds, seconds * 1e9 / ops);
+    if (baseline > 0) printf("  %6.2fx", baseline / seconds);
+    printf("\n");
+}
+
+static int compare_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+static void report_latency(const char* name, uint64_t* samples, size_t count) {
+    qsort(samples, count, sizeof(uint64_t), compare_u64);
+    double total = 0;
+    for (size_t i = 0; i < count; i++) {
+        total += (double)samples[i];
+    }
+    printf("  %-28s mean %7.1f us  p50 %7.1f us  p99 %7.1f us\n", name, total / count / 1e3,
+           samples[count / 2] / 1e3, samples[count * 99 / 100] / 1e3);
+}
+
+static bool write_all(int fd, const void* data, size_t size) {
+    return write(fd, data, size) == (ssize_t)size;
+}
+
+static bool read_all(int fd, void* data, size_t size) {
+    return read(fd, data, size) == (ssize_t)size;
+}
+
+// ---------------------------------------------------------------------
+// Wakeup latency
+
+typedef enum { WAKE_PIPE, WAKE_SIGNAL } WakeMode;
+
+typedef struct {
+    int stamp_fd;           // parent reads stamps here
+    int ack_fd;             // parent writes acks here
+    uint64_t* samples;
+    size_t count;
+    size_t target;
+} WakeState;
+
+// The child sends one wakeup at a time and waits for the ack, so no
+// wakeups coalesce
+static pid_t spawn_waker(WakeMode mode, size_t samples, int stamp_pipe[2], int ack_pipe[2]) {
+    pid_t parent = getpid();
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    close(stamp_pipe[0]);
+    close(ack_pipe[1]);
+    for (size_t i = 0; i < samples; i++) {
+        struct timespec pause = {0, 20000};
+        nanosleep(&pause, NULL);
+        uint64_t stamp = event_loop_now();
+        if (!write_all(stamp_pipe[1], &stamp, sizeof(stamp))) _exit(1);
+        if (mode == WAKE_SIGNAL) kill(parent, SIGUSR1);
+        char ack;
+        if (!read_all(ack_pipe[0], &ack, 1)) _exit(1);
+    }
+    _exit(0);
+}
+
+static void record_wakeup(WakeState* state) {
+    uint64_t stamp;
+    if (!read_all(state->stamp_fd, &stamp, sizeof(stamp))) {
+        failed = 1;
+        return;
+    }
+    uint64_t now = event_loop_now();
+    state->samples[state->count++] = now - stamp;
+    char ack = 1;
+    if (!write_all(state->ack_fd, &ack, 1)) failed = 1;
+}
+
+static void on_wake_fd(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)fd;
+    (void)events;
+    WakeState* state = data;
+    record_wakeup(state);
+    if (state->count == state->target) event_loop_stop(loop);
+}
+
+static void on_wake_signal(EventLoop* loop, const struct signalfd_siginfo* info, void* data) {
+    (void)info;
+    WakeState* state = data;
+    record_wakeup(state);
+    if (state->count == state->target) event_loop_stop(loop);
+}
+
+// The self-pipe pattern the demo used before
+static int self_pipe[2] = {-1, -1};
+
+static void self_pipe_handler(int sig) {
+    char byte = (char)sig;
+    write(self_pipe[1], &byte, 1);
+}
+
+static void bench_wakeup(size_t samples) {
+    printf("Wakeup latency, %zu samples:\n", samples);
+    uint64_t* latency = malloc(samples * sizeof(uint64_t));
+    if (latency == NULL) exit(1);
+    static const char* names[] = {"epoll, pipe readable", "epoll, signalfd", "self-pipe handler + poll"};
+
+    for (int variant = 0; variant < 3; variant++) {
+        int stamp_pipe[2], ack_pipe[2];
+        if (pipe(stamp_pipe) != 0 || pipe(ack_pipe) != 0) exit(1);
+        WakeState state = {stamp_pipe[0], ack_pipe[1], latency, 0, samples};
+        WakeMode mode = variant == 0 ? WAKE_PIPE : WAKE_SIGNAL;
+
+        EventLoop* loop = NULL;
+        struct sigaction old_action;
+        if (variant < 2) {
+            loop = event_loop_create();
+            if (loop == NULL) exit(1);
+            bool ok = variant == 0
+                ? event_loop_add_fd(loop, stamp_pipe[0], EVENT_READ, on_wake_fd, &state)
+                : event_loop_add_signal(loop, SIGUSR1, on_wake_signal, &state);
+            if (!ok) exit(1);
+        } else {
+            if (pipe(self_pipe) != 0) exit(1);
+            fcntl(self_pipe[0], F_SETFL, fcntl(self_pipe[0], F_GETFL) | O_NONBLOCK);
+            struct sigaction sa;
+            memset(&sa, 0, sizeof(sa));
+            sa.sa_handler = self_pipe_handler;
+            sigemptyset(&sa.sa_mask);
+            sigaction(SIGUSR1, &sa, &old_action);
+        }
+
+        pid_t child = spawn_waker(mode, samples, stamp_pipe, ack_pipe);
+        if (child < 0) exit(1);
+        close(stamp_pipe[1]);
+        close(ack_pipe[0]);
+
+        if (loop != NULL) {
+            event_loop_run(loop);
+            event_loop_destroy(loop);
+        } else {
+            struct pollfd pfd = {self_pipe[0], POLLIN, 0};
+            while (state.count < samples) {
+                if (poll(&pfd, 1, -1) <= 0) continue;
+                char bytes[64];
+                while (read(self_pipe[0], bytes, sizeof(bytes)) > 0) {
+                }
+                record_wakeup(&state);
+            }
+            sigaction(SIGUSR1, &old_action, NULL);
+            close(self_pipe[0]);
+            close(self_pipe[1]);
+        }
+
+        int status;
+        waitpid(child, &status, 0);
+        failed |= !WIFEXITED(status) || WEXITSTATUS(status) != 0 || state.count != samples;
+        close(stamp_pipe[0]);
+        close(ack_pipe[1]);
+        report_latency(names[variant], latency, samples);
+    }
+    free(latency);
+    printf("\n");
+}
+
+// ---------------------------------------------------------------------
+// Throughput
+
+#define MAX_PIPES 480
+
+typedef struct PipeSet PipeSet;
+
+typedef struct {
+    PipeSet* set;
+    int fds[2];
+} PipeEntry;
+
+struct PipeSet {
+    PipeEntry pipes[MAX_PIPES];
+    size_t events;
+    size_t target;
+};
+
+// Reads one byte and writes it back, so the pipe stays readable
+static bool pump(const PipeEntry* entry) {
+    char byte;
+    return read(entry->fds[0], &byte, 1) == 1 && write(entry->fds[1], &byte, 1) == 1;
+}
+
+static void on_pipe_event(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)fd;
+    (void)events;
+    PipeEntry* entry = data;
+    failed |= !pump(entry);
+    if (++entry->set->events >= entry->set->target) event_loop_stop(loop);
+}
+
+static void bench_fd_events(int count, int active, size_t target) {
+    static PipeSet set;
+    for (int i = 0; i < count; i++) {
+        set.pipes[i].set = &set;
+        if (pipe(set.pipes[i].fds) != 0) exit(1);
+        if (i < active && write(set.pipes[i].fds[1], "x", 1) != 1) exit(1);
+    }
+    printf("Fd events, %d of %d pipes readable:\n", active, count);
+
+    // poll() baseline: every call passes and scans the whole set
+    static struct pollfd pfds[MAX_PIPES];
+    for (int i = 0; i < count; i++) {
+        pfds[i].fd = set.pipes[i].fds[0];
+        pfds[i].events = POLLIN;
+    }
+    size_t events = 0;
+    double start = now_seconds();
+    while (events < target) {
+        int ready = poll(pfds, (nfds_t)count, -1);
+        for (int i = 0; i < count && ready > 0; i++) {
+            if (pfds[i].revents & POLLIN) {
+                failed |= !pump(&set.pipes[i]);
+                events++;
+                ready--;
+            }
+        }
+    }
+    double baseline = now_seconds() - start;
+    report("poll()", (double)events, baseline, 0);
+
+    EventLoop* loop = event_loop_create();
+    if (loop == NULL) exit(1);
+    for (int i = 0; i < count; i++) {
+        if (!event_loop_add_fd(loop, set.pipes[i].fds[0], EVENT_READ, on_pipe_event, &set.pipes[i])) exit(1);
+    }
+    set.events = 0;
+    set.target = target;
+    start = now_seconds();
+    event_loop_run(loop);
+    double seconds = now_seconds() - start;
+    report("event loop", (double)set.events, seconds, baseline);
+    failed |= set.events != target;
+
+    event_loop_destroy(loop);
+    for (int i = 0; i < count; i++) {
+        close(set.pipes[i].fds[0]);
+        close(set.pipes[i].fds[1]);
+    }
+    printf("\n");
+}
+
+typedef struct {
+    uint64_t deadline;
+    size_t* fired;
+} TimerCheck;
+
+static size_t timers_early = 0;
+
+static void on_timer(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    TimerCheck* check = data;
+    if (event_loop_now() < check->deadline) timers_early++;
+    (*check->fired)++;
+}
+
+static void bench_timers(size_t count) {
+    EventLoop* loop = event_loop_create();
+    TimerCheck* checks = malloc(count * sizeof(TimerCheck));
+    if (loop == NULL || checks == NULL) exit(1);
+    size_t fired = 0, cancelled = 0;
+    uint64_t rng = 0x853C49E6748FEA9Bull;
+
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        uint64_t delay = rng % 10000000;
+        checks[i].deadline = event_loop_now() + delay;
+        checks[i].fired = &fired;
+        EventTimerId id = event_loop_add_timer(loop, delay, 0, on_timer, &checks[i]);
+        failed |= id == 0;
+        if (i % 10 == 0) cancelled += event_loop_cancel_timer(loop, id);
+    }
+    while (fired + cancelled < count) {
+        event_loop_run_once(loop, -1);
+    }
+    double seconds = now_seconds() - start;
+    report("timers (add, 10% cancel, fire)", (double)count, seconds, 0);
+    failed |= fired + cancelled != count || timers_early != 0;
+    event_loop_destroy(loop);
+    free(checks);
+}
+
+typedef struct {
+    size_t remaining;
+    size_t calls;
+} DeferChain;
+
+static void on_defer(EventLoop* loop, void* data) {
+    DeferChain* chain = data;
+    chain->calls++;
+    if (--chain->remaining == 0) {
+        event_loop_stop(loop);
+    } else {
+        event_loop_defer(loop, on_defer, chain);
+    }
+}
+
+static void bench_deferred(size_t count) {
+    EventLoop* loop = event_loop_create();
+    if (loop == NULL) exit(1);
+    // 16 chains, so each iteration has a batch of deferred work
+    DeferChain chain = {count, 0};
+    for (int i = 0; i < 16; i++) {
+        event_loop_defer(loop, on_defer, &chain);
+    }
+    double start = now_seconds();
+    event_loop_run(loop);
+    double seconds = now_seconds() - start;
+    report("deferred calls", (double)chain.calls, seconds, 0);
+    failed |= chain.calls < count;
+    event_loop_destroy(loop);
+}
+
+typedef struct {
+    int fds[2];                 // read ends, both readable
+    int reused;                 // fd number given to a fresh, empty pipe
+    size_t first_calls;
+    size_t stale_calls;
+} ReuseState;
+
+static void on_reused_fd(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)loop;
+    (void)fd;
+    (void)events;
+    ((ReuseState*)data)->stale_calls++;
+}
+
+// Whichever pipe is dispatched first closes the other and puts a new
+// pipe under its number, while the other's event is still in the batch
+static void on_reuse_first(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)events;
+    ReuseState* state = data;
+    state->first_calls++;
+    if (state->reused != -1) return;
+    int other = fd == state->fds[0] ? state->fds[1] : state->fds[0];
+    int fresh[2];
+    event_loop_remove_fd(loop, other);
+    if (pipe(fresh) != 0 || dup2(fresh[0], other) == -1) {
+        failed = 1;
+        return;
+    }
+    close(fresh[0]);
+    close(fresh[1]);        // no writer: the reused fd reports EPOLLHUP
+    state->reused = other;
+    failed |= !event_loop_add_fd(loop, other, EVENT_READ, on_reused_fd, state);
+}
+
+static void check_fd_reuse(void) {
+    EventLoop* loop = event_loop_create();
+    if (loop == NULL) exit(1);
+    int a[2], b[2];
+    if (pipe(a) != 0 || pipe(b) != 0) {
+        perror("pipe");
+        exit(1);
+    }
+    ReuseState state = {{a[0], b[0]}, -1, 0, 0};
+    failed |= !write_all(a[1], "x", 1) || !write_all(b[1], "x", 1);
+    failed |= !event_loop_add_fd(loop, a[0], EVENT_READ, on_reuse_first, &state);
+    failed |= !event_loop_add_fd(loop, b[0], EVENT_READ, on_reuse_first, &state);
+
+    // Both events arrive in one batch; only the first may be dispatched
+    event_loop_run_once(loop, 1000);
+    bool ok = state.first_calls == 1 && state.stale_calls == 0;
+    // The new registration still gets its own events afterwards
+    event_loop_run_once(loop, 1000);
+    ok = ok && state.stale_calls == 1;
+    printf("  fd reused within a batch: %s\n", ok ? "ok" : "stale event delivered");
+    failed |= !ok;
+
+    event_loop_destroy(loop);
+    close(a[0]);
+    close(a[1]);
+    close(b[0]);
+    close(b[1]);
+}
+
+int main(int argc, char* argv[]) {
+    long scale = argc > 1 ? atol(argv[1]) : 1;
+    if (scale < 1 || scale > 100) {
+        fprintf(stderr, "Usage: %s [scale, 1 .. 100]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== Event Loop Benchmark ===\n\n");
+    bench_wakeup(20000 * (size_t)scale);
+    bench_fd_events(64, 64, 2000000 * (size_t)scale);
+    bench_fd_events(MAX_PIPES, 16, 1000000 * (size_t)scale);
+    printf("Timers and deferred work:\n");
+    bench_timers(1000000 * (size_t)scale);
+    bench_deferred(1000000 * (size_t)scale);
+    check_fd_reuse();
+    printf("\n");
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}
@@ -1,12 +1,20 @@
+// sigaction and siginfo_t are hidden by -std=c99 without a feature macro;
+// usleep left POSIX in 2008, so _POSIX_C_SOURCE alone is not enough
+#define _DEFAULT_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <unistd.h>
 #include <string.h>
 #include <sys/wait.h>
-#include <sys/time.h>
+#include <sys/stat.h>
 #include <errno.h>
 #include <fcntl.h>
+#include "evloop.h"
+#include "timerwheel.h"
+#include "supervisor.h"
+#include "drain.h"
 
 // Function prototypes
 void demonstrate_basic_signals(void);
@@ -23,10 +31,9 @@ volatile sig_atomic_t signal_type = 0;
 volatile sig_atomic_t alarm_fired = 0;
 volatile sig_atomic_t child_exited = 0;
 volatile sig_atomic_t shutdown_requested = 0;
-volatile sig_atomic_t timer_count = 0;
 
-// Signal pipe for self-pipe trick
-int signal_pipe[2] = {-1, -1};
+// Drain started by shutdown_handler; drain_request is async-signal-safe
+static Drain* shutdown_drain = NULL;
 
 // Basic signal handler
 void basic_handler(int sig) {
@@ -85,18 +92,6 @@ void alarm_handler(int sig) {
     alarm_fired = 1;
 }
 
-// Interval timer handler
-void interval_handler(int sig) {
-    (void)sig; // Unused parameter
-    timer_count++;
-    
-    char buffer[64];
-    int len = snprintf(buffer, sizeof(buffer), "\n[TIMER] Tick %d\n", (int)timer_count);
-    if (len > 0 && len < (int)sizeof(buffer)) {
-        write(STDERR_FILENO, buffer, len);
-    }
-}
-
 // Child process handler
 void sigchld_handler(int sig) {
     (void)sig; // Unused parameter
@@ -111,13 +106,224 @@ void shutdown_handler(int sig) {
     const char msg[] = "\n[SHUTDOWN] Graceful shutdown requested\n";
     write(STDERR_FILENO, msg, sizeof(msg) - 1);
     shutdown_requested = 1;
+    if (shutdown_drain != NULL) {
+        drain_request(shutdown_drain);
+    }
+}
+
+// Timer wheel state for the interval timer demo
+typedef struct {
+    EventLoop* loop;
+    TimerWheel wheel;
+    WheelTimer ticker;
+    WheelTimer* bulk;
+    int ticks;
+    int bulk_fired;
+} WheelDemo;
+
+// Wheel callbacks run from timer_wheel_dispatch inside the event loop,
+// replacing the SIGALRM handler that setitimer needed
+static void on_wheel_tick(TimerWheel* wheel, WheelTimer* timer, void* data) {
+    WheelDemo* demo = data;
+    demo->ticks++;
+    printf("[TIMER] Tick %d\n", demo->ticks);
+    if (demo->ticks == 3) {
+        timer_wheel_cancel(wheel, timer);
+        event_loop_stop(demo->loop);
+    }
+}
+
+static void on_wheel_bulk(TimerWheel* wheel, WheelTimer* timer, void* data) {
+    (void)wheel;
+    (void)timer;
+    WheelDemo* demo = data;
+    demo->bulk_fired++;
+}
+
+static void on_wheel_fd(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)loop;
+    (void)fd;
+    (void)events;
+    WheelDemo* demo = data;
+    timer_wheel_dispatch(&demo->wheel);
+}
+
+// Event loop state for the signal safety demo
+typedef struct {
+    int pipe_fds[2];
+    int ticks;
+    int signals_seen;
+    int bytes_read;
+    int deferred_runs;
+} LoopDemo;
+
+// Event loop callbacks run from event_loop_run, never inside a signal
+// handler, so stdio is safe in all of them
+static void on_pipe_readable(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)loop;
+    (void)events;
+    LoopDemo* demo = data;
+    char buffer[64];
+    ssize_t bytes;
+    while ((bytes = read(fd, buffer, sizeof(buffer))) > 0) {
+        demo->bytes_read += (int)bytes;
+        printf("  [fd] read %d bytes: %.*s\n", (int)bytes, (int)bytes, buffer);
+    }
+}
+
+static void on_deferred(EventLoop* loop, void* data) {
+    (void)loop;
+    LoopDemo* demo = data;
+    demo->deferred_runs++;
+    printf("  [deferred] ran after the batch that queued it\n");
+}
+
+static void on_loop_signal(EventLoop* loop, const struct signalfd_siginfo* info, void* data) {
+    LoopDemo* demo = data;
+    demo->signals_seen++;
+    printf("  [signal] %d from PID %d, outside signal context\n", (int)info->ssi_signo, (int)info->ssi_pid);
+    event_loop_defer(loop, on_deferred, demo);
+}
+
+static void on_loop_tick(EventLoop* loop, EventTimerId timer, void* data) {
+    LoopDemo* demo = data;
+    demo->ticks++;
+    printf("  [timer] tick %d\n", demo->ticks);
+    if (demo->ticks == 1) {
+        write(demo->pipe_fds[1], "ping", 4);
+        kill(getpid(), SIGUSR1);
+    } else if (demo->ticks == 3) {
+        event_loop_cancel_timer(loop, timer);
+        event_loop_stop(loop);
+    }
+}
+
+// Prefork worker for the process signals demo: works through the shared
+// job queue in batches. The first incarnation of crash_worker dies in the
+// middle of its first batch; with stop_after set, worker 0 sends SIGTERM
+// to the supervisor once it has processed that many jobs.
+typedef struct {
+    int crash_worker;
+    uint64_t stop_after;
+} PreforkDemo;
+
+static int prefork_worker(SupervisorWorker* worker, void* data) {
+    PreforkDemo* demo = data;
+    uint64_t begin, end;
+    while (supervisor_claim(worker, 1000, &begin, &end)) {
+        if (worker->index == demo->crash_worker && worker->slot->restarts == 0) {
+            printf("  [worker %d] crashing with jobs %llu..%llu claimed\n", worker->index,
+                   (unsigned long long)begin, (unsigned long long)end - 1);
+            fflush(stdout);
+            raise(SIGKILL);
+        }
+        usleep(1000);  // 1ms of simulated work per batch
+        supervisor_complete(worker);
+        if (demo->stop_after > 0 && worker->index == 0 && worker->slot->processed >= demo->stop_after) {
+            kill(getppid(), SIGTERM);
+            demo->stop_after = 0;
+        }
+    }
+    return 0;
+}
+
+static uint64_t total_processed(const SupervisorPage* page) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < page->worker_count; i++) {
+        total += page->slots[i].processed;
+    }
+    return total;
+}
+
+// Server state for the graceful shutdown demo. Requests arrive every
+// 10ms and take 30-150ms; with stuck set, one never finishes in time.
+#define SHUTDOWN_MAX_REQUESTS 64
+
+typedef struct ShutdownDemo ShutdownDemo;
+
+typedef struct {
+    ShutdownDemo* demo;
+    int id;
+} DemoRequest;
+
+struct ShutdownDemo {
+    EventLoop* loop;
+    Drain* drain;
+    FILE* log;
+    EventTimerId accept_timer;
+    bool stuck;
+    int next_request;
+    DemoRequest requests[SHUTDOWN_MAX_REQUESTS];
+};
+
+static long log_bytes_on_disk(FILE* log) {
+    struct stat st;
+    return fstat(fileno(log), &st) == 0 ? (long)st.st_size : -1;
+}
+
+static void on_request_done(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    DemoRequest* request = data;
+    fprintf(request->demo->log, "request %d done\n", request->id);
+    drain_leave(request->demo->drain);
+}
+
+static void on_accept(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)timer;
+    ShutdownDemo* demo = data;
+    if (demo->next_request == SHUTDOWN_MAX_REQUESTS || !drain_enter(demo->drain)) {
+        return;
+    }
+    DemoRequest* request = &demo->requests[demo->next_request];
+    request->demo = demo;
+    request->id = demo->next_request++;
+    uint64_t duration_ms = 30 + (uint64_t)(request->id * 37 % 120);
+    if (demo->stuck && request->id == 3) {
+        duration_ms = 5000;
+    }
+    fprintf(demo->log, "request %d accepted\n", request->id);
+    if (event_loop_add_timer(loop, duration_ms * 1000000, 0, on_request_done, request) == 0) {
+        drain_leave(demo->drain);
+    }
 }
 
-// Pipe handler for self-pipe trick
-void pipe_handler(int sig) {
-    char byte = (char)sig;
-    if (signal_pipe[1] != -1) {
-        write(signal_pipe[1], &byte, 1);
+static void on_send_sigterm(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    (void)data;
+    printf("Sending SIGTERM to trigger shutdown...\n");
+    fflush(stdout);
+    kill(getpid(), SIGTERM);
+}
+
+static void on_drain_deadline(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)timer;
+    ShutdownDemo* demo = data;
+    if (drain_step(demo->drain)) {
+        event_loop_stop(loop);
+    }
+}
+
+// Readable on the request and when the last in-flight request leaves
+static void on_drain_fd(EventLoop* loop, int fd, uint32_t events, void* data) {
+    (void)fd;
+    (void)events;
+    ShutdownDemo* demo = data;
+    if (drain_step(demo->drain)) {
+        event_loop_stop(loop);
+        return;
+    }
+    if (demo->accept_timer != 0 && drain_phase(demo->drain) == DRAIN_DRAINING) {
+        event_loop_cancel_timer(loop, demo->accept_timer);
+        demo->accept_timer = 0;
+        printf("Stopped accepting: %llu in flight, log has %ld bytes on disk of %ld written\n",
+               (unsigned long long)drain_in_flight(demo->drain), log_bytes_on_disk(demo->log), ftell(demo->log));
+        uint64_t deadline;
+        if (drain_deadline(demo->drain, &deadline)) {
+            uint64_t now = event_loop_now();
+            event_loop_add_timer(loop, deadline > now ? deadline - now : 0, 0, on_drain_deadline, demo);
+        }
     }
 }
 
@@ -304,88 +510,97 @@ void demonstrate_timer_signals(void) {
     
     // Demonstrate interval timer
     printf("\nSetting up interval timer (3 ticks)...\n");
-    if (setup_signal(SIGALRM, interval_handler) != 0) {
-        perror("Failed to setup interval handler");
+    EventLoop* loop = event_loop_create();
+    if (loop == NULL) {
         return;
     }
     
-    struct itimerval timer;
-    timer_count = 0;
+    WheelDemo demo;
+    demo.loop = loop;
+    demo.ticks = 0;
+    demo.bulk_fired = 0;
+    demo.bulk = NULL;
+    if (!timer_wheel_init(&demo.wheel, 1000000)) {  // 1ms ticks
+        event_loop_destroy(loop);
+        return;
+    }
     
-    // Set timer: 1 second initial, then every 500ms
-    timer.it_value.tv_sec = 1;
-    timer.it_value.tv_usec = 0;
-    timer.it_interval.tv_sec = 0;
-    timer.it_interval.tv_usec = 500000;  // 500ms
+    // 1 second initial, then every 500ms; no SIGALRM involved
+    wheel_timer_init(&demo.ticker, on_wheel_tick, &demo);
+    timer_wheel_add(&demo.wheel, &demo.ticker, 1000000000, 500000000);
+    
+    // Many short timers cost O(1) each to add and cancel
+    const int bulk_count = 10000;
+    demo.bulk = malloc(bulk_count * sizeof(WheelTimer));
+    if (demo.bulk != NULL) {
+        for (int i = 0; i < bulk_count; i++) {
+            wheel_timer_init(&demo.bulk[i], on_wheel_bulk, &demo);
+            timer_wheel_add(&demo.wheel, &demo.bulk[i], (uint64_t)(i % 500 + 1) * 1000000, 0);
+        }
+        for (int i = 0; i < bulk_count; i += 2) {
+            timer_wheel_cancel(&demo.wheel, &demo.bulk[i]);
+        }
+        printf("Scheduled %d timers, cancelled half (%zu pending)\n", bulk_count, demo.wheel.count - 1);
+    }
     
-    if (setitimer(ITIMER_REAL, &timer, NULL) != 0) {
-        perror("Failed to set interval timer");
-        return;
+    int fd = timer_wheel_open_fd(&demo.wheel);
+    if (fd == -1 || !event_loop_add_fd(loop, fd, EVENT_READ, on_wheel_fd, &demo)) {
+        perror("Failed to set up timer wheel");
+    } else {
+        event_loop_run(loop);
     }
     
-    // Wait for a few ticks
-    wait_count = 0;
-    while (timer_count < 3 && wait_count < 50) {  // Max 5 seconds
-        usleep(100000);  // 100ms
-        wait_count++;
+    if (demo.bulk != NULL) {
+        printf("Short timers fired: %d\n", demo.bulk_fired);
     }
     
-    // Stop timer
-    timer.it_value.tv_sec = 0;
-    timer.it_value.tv_usec = 0;
-    timer.it_interval.tv_sec = 0;
-    timer.it_interval.tv_usec = 0;
-    setitimer(ITIMER_REAL, &timer, NULL);
+    // Cleanup; pending timers must leave the wheel before their storage goes
+    timer_wheel_cancel(&demo.wheel, &demo.ticker);
+    event_loop_destroy(loop);
+    timer_wheel_destroy(&demo.wheel);
+    free(demo.bulk);
     
-    printf("Interval timer demonstrated (%d ticks)\n\n", (int)timer_count);
+    printf("Interval timer demonstrated (%d ticks)\n\n", demo.ticks);
 }
 
 void demonstrate_signal_safety(void) {
-    printf("5. SIGNAL SAFETY AND SELF-PIPE TRICK\n");
+    printf("5. SIGNAL SAFETY AND EVENT LOOP\n");
     printf("----------------------------------------\n");
     
-    // Create pipe for self-pipe trick
-    if (pipe(signal_pipe) != 0) {
-        perror("Failed to create signal pipe");
+    EventLoop* loop = event_loop_create();
+    if (loop == NULL) {
         return;
     }
     
-    // Make read end non-blocking
-    int flags = fcntl(signal_pipe[0], F_GETFL);
-    if (flags != -1) {
-        fcntl(signal_pipe[0], F_SETFL, flags | O_NONBLOCK);
-    }
-    
-    // Setup pipe handler
-    if (setup_signal(SIGUSR1, pipe_handler) != 0) {
-        perror("Failed to setup pipe handler");
-        close(signal_pipe[0]);
-        close(signal_pipe[1]);
+    LoopDemo demo = {{-1, -1}, 0, 0, 0, 0};
+    if (pipe(demo.pipe_fds) != 0) {
+        perror("Failed to create pipe");
+        event_loop_destroy(loop);
         return;
     }
     
-    printf("Using self-pipe trick for signal safety...\n");
-    
-    // Send signal
-    kill(getpid(), SIGUSR1);
-    
-    // Check pipe for signal
-    usleep(100000);  // Give handler time to write
-    
-    char sig_byte;
-    ssize_t bytes_read = read(signal_pipe[0], &sig_byte, 1);
+    // Make read end non-blocking
+    int flags = fcntl(demo.pipe_fds[0], F_GETFL);
+    if (flags != -1) {
+        fcntl(demo.pipe_fds[0], F_SETFL, flags | O_NONBLOCK);
+    }
     
-    if (bytes_read > 0) {
-        printf("Received signal %d via self-pipe trick\n", (int)sig_byte);
-        printf("This method allows safe signal handling in main loop\n");
+    // SIGUSR1 is blocked and read from a signalfd instead of a handler
+    if (!event_loop_add_fd(loop, demo.pipe_fds[0], EVENT_READ, on_pipe_readable, &demo) ||
+        !event_loop_add_signal(loop, SIGUSR1, on_loop_signal, &demo) ||
+        event_loop_add_timer(loop, 50000000, 50000000, on_loop_tick, &demo) == 0) {
+        perror("Failed to set up event loop");
     } else {
-        printf("No signal received via pipe\n");
+        printf("Running event loop (fd, signal, timer, deferred work)...\n");
+        event_loop_run(loop);
+        printf("Loop stopped: %d ticks, %d signal(s), %d bytes read, %d deferred call(s)\n",
+               demo.ticks, demo.signals_seen, demo.bytes_read, demo.deferred_runs);
     }
     
-    // Cleanup
-    close(signal_pipe[0]);
-    close(signal_pipe[1]);
-    signal_pipe[0] = signal_pipe[1] = -1;
+    // Cleanup; destroying the loop unblocks SIGUSR1 again
+    event_loop_destroy(loop);
+    close(demo.pipe_fds[0]);
+    close(demo.pipe_fds[1]);
     
     printf("Signal safety demonstrated\n\n");
 }
@@ -403,6 +618,7 @@ void demonstrate_process_signals(void) {
     child_exited = 0;
     
     printf("Creating child process...\n");
+    fflush(stdout);  // otherwise the child writes the parent's buffer again
     pid_t pid = fork();
     
     if (pid == 0) {
@@ -440,9 +656,75 @@ void demonstrate_process_signals(void) {
         return;
     }
     
+    // Prefork pool: SIGCHLD drives restarts, SIGTERM is forwarded
+    printf("\nPrefork supervisor, 4 workers, 200000 jobs...\n");
+    PreforkDemo prefork = {1, 0};
+    SupervisorConfig config = {4, true, 200000, 50000000, 1000000000, 2000000000, 1000000000,
+                               prefork_worker, &prefork};
+    Supervisor* supervisor = supervisor_create(&config);
+    if (supervisor != NULL && supervisor_run(supervisor)) {
+        supervisor_print_stats(supervisor);
+        printf("Jobs processed: %llu of 200000\n", (unsigned long long)total_processed(supervisor_stats(supervisor)));
+    }
+    supervisor_destroy(supervisor);
+    
+    printf("\nPrefork supervisor, endless queue, SIGTERM after 20000 jobs...\n");
+    prefork.crash_worker = -1;
+    prefork.stop_after = 20000;
+    config.jobs = UINT64_MAX;
+    supervisor = supervisor_create(&config);
+    if (supervisor != NULL && supervisor_run(supervisor)) {
+        supervisor_print_stats(supervisor);
+        printf("Stopped by SIGTERM after %llu jobs\n", (unsigned long long)total_processed(supervisor_stats(supervisor)));
+    }
+    supervisor_destroy(supervisor);
+    
     printf("Process signal communication demonstrated\n\n");
 }
 
+// One server run: SIGTERM after 200ms, then drain with a 500ms deadline
+static void run_shutdown_drain(bool stuck) {
+    ShutdownDemo demo;
+    memset(&demo, 0, sizeof(demo));
+    demo.stuck = stuck;
+    demo.loop = event_loop_create();
+    demo.drain = drain_create(500000000);
+    demo.log = tmpfile();
+    if (demo.loop == NULL || demo.drain == NULL || demo.log == NULL) {
+        perror("Failed to set up server");
+    } else {
+        // A fully buffered log loses its tail if the process just exits
+        setvbuf(demo.log, NULL, _IOFBF, 1 << 16);
+        drain_add_stream(demo.drain, "log", demo.log);
+        drain_add_stream(demo.drain, "stdout", stdout);
+        shutdown_drain = demo.drain;
+        
+        demo.accept_timer = event_loop_add_timer(demo.loop, 10000000, 10000000, on_accept, &demo);
+        if (demo.accept_timer == 0 ||
+            !event_loop_add_fd(demo.loop, drain_fd(demo.drain), EVENT_READ, on_drain_fd, &demo)) {
+            perror("Failed to set up server");
+        } else {
+            // Serve for 200ms, then the shutdown signal arrives
+            event_loop_add_timer(demo.loop, 200000000, 0, on_send_sigterm, NULL);
+            event_loop_run(demo.loop);
+            
+            const DrainStats* stats = drain_stats(demo.drain);
+            printf("%s shutdown, log has %ld bytes on disk\n", stats->forced ? "Forced" : "Graceful",
+                   log_bytes_on_disk(demo.log));
+            drain_print_stats(demo.drain);
+        }
+        shutdown_drain = NULL;
+    }
+    
+    if (demo.log != NULL) {
+        fclose(demo.log);
+    }
+    drain_destroy(demo.drain);
+    if (demo.loop != NULL) {
+        event_loop_destroy(demo.loop);
+    }
+}
+
 void demonstrate_graceful_shutdown(void) {
     printf("7. GRACEFUL SHUTDOWN PATTERN\n");
     printf("----------------------------------------\n");
@@ -456,26 +738,13 @@ void demonstrate_graceful_shutdown(void) {
     shutdown_requested = 0;
     
     printf("Simulating server with graceful shutdown...\n");
-    printf("Sending SIGTERM to trigger shutdown...\n");
-    
-    // Simulate server startup
-    usleep(100000);
-    
-    // Send shutdown signal
-    kill(getpid(), SIGTERM);
+    run_shutdown_drain(false);
     
-    // Give handler time to execute
-    usleep(100000);
+    printf("\nSame server with a request stuck past the deadline...\n");
+    shutdown_requested = 0;
+    run_shutdown_drain(true);
     
     if (shutdown_requested) {
-        printf("Shutdown signal received, cleaning up...\n");
-        
-        // Simulate cleanup work
-        for (int i = 0; i < 3; i++) {
-            printf("Cleanup step %d...\n", i + 1);
-            usleep(200000);  // 200ms
-        }
-        
         printf("Graceful shutdown complete\n");
     } else {
         printf("Shutdown signal not received\n");
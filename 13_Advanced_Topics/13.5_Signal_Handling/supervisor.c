@@ -0,0 +1,382 @@
+// sched_setaffinity and the CPU_SET macros are GNU extensions
+#define _GNU_SOURCE
+
+#include "supervisor.h"
+#include "evloop.h"
+#include <errno.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+// Parent side bookkeeping per slot; not shared with workers
+typedef struct {
+    Supervisor* owner;
+    int index;
+    EventTimerId restart_timer;
+    uint32_t failures;          // crashes since the slot last made progress
+    uint64_t processed_at_start;
+} SlotControl;
+
+struct Supervisor {
+    SupervisorConfig config;
+    SupervisorPage* page;
+    size_t page_size;
+    SlotControl* controls;
+    int* cpus;
+    int cpu_count;
+    sigset_t saved_mask;
+    EventLoop* loop;
+    EventTimerId grace_timer;
+    int active;                 // slots running or in backoff
+    bool ran;
+};
+
+// Set by the worker's SIGTERM/SIGINT handler, in the child only
+static volatile sig_atomic_t worker_stop_requested = 0;
+
+static void worker_stop_handler(int sig) {
+    (void)sig;
+    worker_stop_requested = 1;
+}
+
+Supervisor* supervisor_create(const SupervisorConfig* config) {
+    if (config->main == NULL || config->workers < 0) return NULL;
+    Supervisor* supervisor = calloc(1, sizeof(Supervisor));
+    if (supervisor == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        return NULL;
+    }
+    supervisor->config = *config;
+    if (supervisor->config.backoff_max_ns < supervisor->config.backoff_min_ns) {
+        supervisor->config.backoff_max_ns = supervisor->config.backoff_min_ns;
+    }
+
+    // CPUs this process may run on, in order
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) CPU_SET(0, &allowed);
+    supervisor->cpus = malloc(CPU_SETSIZE * sizeof(int));
+    if (supervisor->cpus == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        free(supervisor);
+        return NULL;
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) supervisor->cpus[supervisor->cpu_count++] = cpu;
+    }
+    if (supervisor->config.workers == 0) supervisor->config.workers = supervisor->cpu_count;
+
+    int workers = supervisor->config.workers;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t size = sizeof(SupervisorPage) + (size_t)workers * sizeof(SupervisorSlot);
+    supervisor->page_size = (size + page - 1) / page * page;
+    supervisor->page = mmap(NULL, supervisor->page_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    supervisor->controls = calloc((size_t)workers, sizeof(SlotControl));
+    if (supervisor->page == MAP_FAILED || supervisor->controls == NULL) {
+        fprintf(stderr, "Memory allocation failed\n");
+        if (supervisor->page != MAP_FAILED) munmap(supervisor->page, supervisor->page_size);
+        free(supervisor->controls);
+        free(supervisor->cpus);
+        free(supervisor);
+        return NULL;
+    }
+
+    // Anonymous shared mappings start zeroed
+    supervisor->page->job_count = config->jobs;
+    supervisor->page->worker_count = (uint32_t)workers;
+    for (int i = 0; i < workers; i++) {
+        supervisor->page->slots[i].index = (uint32_t)i;
+        supervisor->page->slots[i].cpu = -1;
+        supervisor->controls[i].owner = supervisor;
+        supervisor->controls[i].index = i;
+    }
+    return supervisor;
+}
+
+void supervisor_destroy(Supervisor* supervisor) {
+    if (supervisor == NULL) return;
+    munmap(supervisor->page, supervisor->page_size);
+    free(supervisor->controls);
+    free(supervisor->cpus);
+    free(supervisor);
+}
+
+const SupervisorPage* supervisor_stats(const Supervisor* supervisor) {
+    return supervisor->page;
+}
+
+// ---------------------------------------------------------------------
+// Workers
+
+static void run_worker(Supervisor* supervisor, int index) {
+    // The stop flag follows the shutdown_handler pattern; the handlers go
+    // in before the mask inherited from the supervisor's loop is lifted,
+    // so an early SIGTERM waits for them instead of killing the worker
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = worker_stop_handler;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sa.sa_handler = SIG_DFL;
+    sigaction(SIGCHLD, &sa, NULL);
+    sigprocmask(SIG_SETMASK, &supervisor->saved_mask, NULL);
+
+    SupervisorSlot* slot = &supervisor->page->slots[index];
+    int cpu = -1;
+    if (supervisor->config.pin_cpus && supervisor->cpu_count > 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(supervisor->cpus[index % supervisor->cpu_count], &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == 0) cpu = supervisor->cpus[index % supervisor->cpu_count];
+    }
+    __atomic_store_n(&slot->cpu, cpu, __ATOMIC_RELAXED);
+
+    SupervisorWorker worker = {supervisor->page, slot, index, cpu};
+    int status = supervisor->config.main(&worker, supervisor->config.data);
+    fflush(NULL);
+    _exit(status & 0xff);
+}
+
+static void schedule_restart(Supervisor* supervisor, int index);
+
+static void spawn_worker(Supervisor* supervisor, int index) {
+    SupervisorSlot* slot = &supervisor->page->slots[index];
+    uint64_t now = event_loop_now();
+    slot->started_ns = now;
+    __atomic_store_n(&slot->heartbeat_ns, now, __ATOMIC_RELAXED);
+    supervisor->controls[index].processed_at_start = __atomic_load_n(&slot->processed, __ATOMIC_RELAXED);
+
+    // Unflushed stdio would otherwise be written by both processes
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) run_worker(supervisor, index);
+    if (pid == -1) {
+        perror("fork");
+        schedule_restart(supervisor, index);
+        return;
+    }
+    slot->pid = pid;
+    slot->state = SLOT_RUNNING;
+}
+
+static void finish_slot(Supervisor* supervisor, int index) {
+    supervisor->page->slots[index].state = SLOT_DONE;
+    if (--supervisor->active == 0) event_loop_stop(supervisor->loop);
+}
+
+static void on_restart(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    SlotControl* control = data;
+    control->restart_timer = 0;
+    control->owner->page->slots[control->index].restarts++;
+    spawn_worker(control->owner, control->index);
+}
+
+// Backoff doubles with each crash that made no progress since the last
+static void schedule_restart(Supervisor* supervisor, int index) {
+    SlotControl* control = &supervisor->controls[index];
+    SupervisorSlot* slot = &supervisor->page->slots[index];
+    if (__atomic_load_n(&slot->processed, __ATOMIC_RELAXED) > control->processed_at_start) control->failures = 0;
+    control->failures++;
+
+    uint64_t delay = supervisor->config.backoff_max_ns;
+    if (control->failures <= 32) {
+        uint64_t scaled = supervisor->config.backoff_min_ns << (control->failures - 1);
+        bool overflowed = scaled >> (control->failures - 1) != supervisor->config.backoff_min_ns;
+        if (!overflowed && scaled < delay) delay = scaled;
+    }
+    slot->state = SLOT_BACKOFF;
+    control->restart_timer = event_loop_add_timer(supervisor->loop, delay, 0, on_restart, control);
+    if (control->restart_timer == 0) finish_slot(supervisor, index);
+}
+
+// ---------------------------------------------------------------------
+// Supervision
+
+static void on_child(EventLoop* loop, const struct signalfd_siginfo* info, void* data) {
+    (void)loop;
+    (void)info;
+    Supervisor* supervisor = data;
+
+    // SIGCHLDs coalesce, so every running worker is checked
+    for (int i = 0; i < supervisor->config.workers; i++) {
+        SupervisorSlot* slot = &supervisor->page->slots[i];
+        if (slot->state != SLOT_RUNNING) continue;
+        int status;
+        if (waitpid(slot->pid, &status, WNOHANG) != slot->pid) continue;
+        slot->pid = 0;
+        bool clean = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        if (!clean) slot->crashes++;
+        if (clean || supervisor->page->stopping) {
+            finish_slot(supervisor, i);
+        } else {
+            schedule_restart(supervisor, i);
+        }
+    }
+}
+
+static void on_grace_expired(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    Supervisor* supervisor = data;
+    supervisor->grace_timer = 0;
+    for (int i = 0; i < supervisor->config.workers; i++) {
+        SupervisorSlot* slot = &supervisor->page->slots[i];
+        if (slot->state == SLOT_RUNNING) kill(slot->pid, SIGKILL);
+    }
+}
+
+static void on_shutdown(EventLoop* loop, const struct signalfd_siginfo* info, void* data) {
+    Supervisor* supervisor = data;
+    if (supervisor->page->stopping) return;
+    __atomic_store_n(&supervisor->page->stopping, 1, __ATOMIC_RELEASE);
+
+    for (int i = 0; i < supervisor->config.workers; i++) {
+        SupervisorSlot* slot = &supervisor->page->slots[i];
+        if (slot->state == SLOT_RUNNING) {
+            kill(slot->pid, (int)info->ssi_signo);
+        } else if (slot->state == SLOT_BACKOFF) {
+            event_loop_cancel_timer(loop, supervisor->controls[i].restart_timer);
+            supervisor->controls[i].restart_timer = 0;
+            finish_slot(supervisor, i);
+        }
+    }
+    if (supervisor->active > 0 && supervisor->config.grace_ns > 0) {
+        supervisor->grace_timer = event_loop_add_timer(loop, supervisor->config.grace_ns, 0, on_grace_expired,
+                                                       supervisor);
+    }
+}
+
+static void on_watchdog(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    Supervisor* supervisor = data;
+    if (supervisor->page->stopping) return;
+    uint64_t now = event_loop_now();
+    for (int i = 0; i < supervisor->config.workers; i++) {
+        SupervisorSlot* slot = &supervisor->page->slots[i];
+        if (slot->state != SLOT_RUNNING) continue;
+        uint64_t heartbeat = __atomic_load_n(&slot->heartbeat_ns, __ATOMIC_RELAXED);
+        if (now > heartbeat && now - heartbeat > supervisor->config.stall_ns) kill(slot->pid, SIGKILL);
+    }
+}
+
+bool supervisor_run(Supervisor* supervisor) {
+    if (supervisor->ran) return false;
+    supervisor->ran = true;
+
+    // Workers get back the mask from before the loop blocked its signals
+    sigprocmask(SIG_BLOCK, NULL, &supervisor->saved_mask);
+    supervisor->loop = event_loop_create();
+    if (supervisor->loop == NULL) return false;
+    bool ok = event_loop_add_signal(supervisor->loop, SIGCHLD, on_child, supervisor) &&
+              event_loop_add_signal(supervisor->loop, SIGTERM, on_shutdown, supervisor) &&
+              event_loop_add_signal(supervisor->loop, SIGINT, on_shutdown, supervisor);
+    if (ok && supervisor->config.stall_ns > 0) {
+        uint64_t period = supervisor->config.stall_ns / 2 > 1000000 ? supervisor->config.stall_ns / 2 : 1000000;
+        ok = event_loop_add_timer(supervisor->loop, period, period, on_watchdog, supervisor) != 0;
+    }
+    if (!ok) {
+        perror("Failed to set up supervisor");
+        event_loop_destroy(supervisor->loop);
+        supervisor->loop = NULL;
+        return false;
+    }
+
+    supervisor->page->started_ns = event_loop_now();
+    supervisor->active = supervisor->config.workers;
+    for (int i = 0; i < supervisor->config.workers; i++) {
+        spawn_worker(supervisor, i);
+    }
+    if (supervisor->active > 0) event_loop_run(supervisor->loop);
+
+    // Destroying the loop restores the signal mask
+    event_loop_destroy(supervisor->loop);
+    supervisor->loop = NULL;
+    return true;
+}
+
+void supervisor_print_stats(const Supervisor* supervisor) {
+    static const char* states[] = {"idle", "running", "backoff", "done"};
+    const SupervisorPage* page = supervisor->page;
+    printf("  %-6s %-8s %4s %-8s %12s %9s %8s\n", "Worker", "PID", "CPU", "State", "Processed", "Restarts",
+           "Crashes");
+    for (uint32_t i = 0; i < page->worker_count; i++) {
+        const SupervisorSlot* slot = &page->slots[i];
+        printf("  %-6u %-8d %4d %-8s %12llu %9llu %8llu\n", (unsigned)i, (int)slot->pid, (int)slot->cpu,
+               states[slot->state], (unsigned long long)__atomic_load_n(&slot->processed, __ATOMIC_RELAXED),
+               (unsigned long long)slot->restarts, (unsigned long long)slot->crashes);
+    }
+}
+
+// ---------------------------------------------------------------------
+// Worker side
+
+bool supervisor_worker_stopping(const SupervisorWorker* worker) {
+    return worker_stop_requested || __atomic_load_n(&worker->page->stopping, __ATOMIC_ACQUIRE);
+}
+
+void supervisor_heartbeat(SupervisorWorker* worker) {
+    __atomic_store_n(&worker->slot->heartbeat_ns, event_loop_now(), __ATOMIC_RELAXED);
+}
+
+bool supervisor_claim(SupervisorWorker* worker, uint64_t batch, uint64_t* begin, uint64_t* end) {
+    if (supervisor_worker_stopping(worker)) return false;
+    SupervisorSlot* slot = worker->slot;
+    SupervisorPage* page = worker->page;
+    supervisor_heartbeat(worker);
+
+    // Left over by a crashed predecessor in this slot
+    uint64_t first = __atomic_load_n(&slot->claim_begin, __ATOMIC_ACQUIRE);
+    uint64_t last = __atomic_load_n(&slot->claim_end, __ATOMIC_ACQUIRE);
+    if (first < last) {
+        *begin = first;
+        *end = last;
+        return true;
+    }
+
+    // The range is recorded before the cursor moves past it, so a crash
+    // at any point can repeat jobs but never lose them. claim_begin is
+    // stored first because start never moves backwards: on the first
+    // attempt the old claim_end is at or below start, so a crash between
+    // the two stores leaves an empty range, and after a lost CAS it leaves
+    // part of the range already recorded. Storing claim_end first would
+    // briefly record [old claim_end, stop), which covers jobs other
+    // workers claimed since this slot's last batch
+    if (batch == 0) batch = 1;
+    uint64_t start = __atomic_load_n(&page->next_job, __ATOMIC_ACQUIRE);
+    for (;;) {
+        if (start >= page->job_count) {
+            // A range recorded before a lost CAS belongs to another worker
+            uint64_t recorded = __atomic_load_n(&slot->claim_end, __ATOMIC_RELAXED);
+            __atomic_store_n(&slot->claim_begin, recorded, __ATOMIC_RELEASE);
+            return false;
+        }
+        uint64_t stop = page->job_count - start < batch ? page->job_count : start + batch;
+        __atomic_store_n(&slot->claim_begin, start, __ATOMIC_RELEASE);
+        __atomic_store_n(&slot->claim_end, stop, __ATOMIC_RELEASE);
+        if (__atomic_compare_exchange_n(&page->next_job, &start, stop, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *begin = start;
+            *end = stop;
+            return true;
+        }
+    }
+}
+
+void supervisor_complete(SupervisorWorker* worker) {
+    SupervisorSlot* slot = worker->slot;
+    uint64_t first = __atomic_load_n(&slot->claim_begin, __ATOMIC_RELAXED);
+    uint64_t last = __atomic_load_n(&slot->claim_end, __ATOMIC_RELAXED);
+    if (first >= last) return;
+    __atomic_store_n(&slot->claim_begin, last, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&slot->processed, last - first, __ATOMIC_RELAXED);
+    supervisor_heartbeat(worker);
+}
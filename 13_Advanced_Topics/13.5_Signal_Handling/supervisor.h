@@ -0,0 +1,113 @@
+#ifndef SUPERVISOR_H
+#define SUPERVISOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Prefork supervisor. The parent forks N workers, pins each to a CPU and
+// watches them from an event loop:
+//   SIGCHLD       workers are reaped through a signalfd; one that exits
+//                 with status 0 is done, any other exit is a crash and
+//                 the slot is refilled after an exponential backoff
+//   SIGTERM/INT   forwarded to every worker, which sees it through a
+//                 flag set by its handler and stops between batches;
+//                 stragglers are killed after a grace period
+//   stalls        a worker whose heartbeat goes stale is killed and
+//                 restarted like a crash
+// Workers inherit every descriptor opened before supervisor_run, so a
+// listening socket can be shared by simply opening it first. For batch
+// work there is a shared job queue: the numbers 0 .. jobs - 1, handed
+// out in ranges from one atomic cursor. A claimed range is recorded in
+// the worker's slot, and a replacement for a crashed worker finishes its
+// predecessor's range first, so every job runs at least once.
+//
+// All state the workers report lives in one MAP_SHARED stats page that
+// the parent (or anything else mapping it) can read at any time.
+
+// One cache line pair per worker, so workers never share a line
+typedef struct {
+    int32_t pid;                // 0 when not running
+    int32_t cpu;                // -1 when not pinned
+    uint32_t state;             // SupervisorSlotState
+    uint32_t index;
+    uint64_t started_ns;        // current incarnation
+    uint64_t heartbeat_ns;
+    uint64_t processed;         // jobs completed by all incarnations
+    uint64_t claim_begin;       // range in progress; empty when equal
+    uint64_t claim_end;
+    uint64_t restarts;
+    uint64_t crashes;
+    uint64_t reserved[7];
+} SupervisorSlot;
+
+typedef enum {
+    SLOT_IDLE,
+    SLOT_RUNNING,
+    SLOT_BACKOFF,               // crashed, waiting to be restarted
+    SLOT_DONE                   // exited cleanly or stopped
+} SupervisorSlotState;
+
+typedef struct {
+    uint64_t next_job;          // shared cursor, alone on its line
+    uint64_t pad0[7];
+    uint64_t job_count;
+    uint64_t started_ns;
+    uint32_t worker_count;
+    uint32_t stopping;          // set once shutdown begins
+    uint64_t pad1[5];
+    SupervisorSlot slots[];
+} SupervisorPage;
+
+// Worker side handle, passed to the worker function
+typedef struct {
+    SupervisorPage* page;
+    SupervisorSlot* slot;
+    int index;
+    int cpu;
+} SupervisorWorker;
+
+// Runs in the child; the return value becomes its exit status, and only
+// 0 counts as a clean exit
+typedef int (*SupervisorWorkerMain)(SupervisorWorker* worker, void* data);
+
+typedef struct {
+    int workers;                // 0 for one per available CPU
+    bool pin_cpus;
+    uint64_t jobs;              // size of the job queue, 0 for none
+    uint64_t backoff_min_ns;    // first restart delay, doubled per crash
+    uint64_t backoff_max_ns;
+    uint64_t stall_ns;          // heartbeat age that counts as hung, 0 off
+    uint64_t grace_ns;          // SIGTERM to SIGKILL during shutdown
+    SupervisorWorkerMain main;
+    void* data;
+} SupervisorConfig;
+
+typedef struct Supervisor Supervisor;
+
+Supervisor* supervisor_create(const SupervisorConfig* config);     // NULL on failure
+void supervisor_destroy(Supervisor* supervisor);
+
+// Forks the workers and supervises them until every slot is done: all
+// exited cleanly, or SIGTERM/SIGINT arrived and they have stopped. Runs
+// once per supervisor. Returns false if supervision could not start.
+bool supervisor_run(Supervisor* supervisor);
+
+const SupervisorPage* supervisor_stats(const Supervisor* supervisor);
+void supervisor_print_stats(const Supervisor* supervisor);
+
+// ---------------------------------------------------------------------
+// Worker side
+
+// True once this worker got SIGTERM/SIGINT or shutdown has begun
+bool supervisor_worker_stopping(const SupervisorWorker* worker);
+
+// Next range of at most batch jobs, or false when the queue is empty or
+// the worker should stop. A range left by a crashed predecessor comes
+// first.
+bool supervisor_claim(SupervisorWorker* worker, uint64_t batch, uint64_t* begin, uint64_t* end);
+// Marks the claimed range done and counts it as processed
+void supervisor_complete(SupervisorWorker* worker);
+void supervisor_heartbeat(SupervisorWorker* worker);
+
+#endif /* SUPERVISOR_H */
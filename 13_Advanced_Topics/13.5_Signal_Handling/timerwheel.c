@@ -0,0 +1,249 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "timerwheel.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#define SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+#define MAX_DELTA (1ull << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS))
+#define NO_TICK UINT64_MAX
+
+uint64_t timer_wheel_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+bool timer_wheel_init(TimerWheel* wheel, uint64_t tick_ns) {
+    if (tick_ns == 0) return false;
+    memset(wheel, 0, sizeof(*wheel));
+    wheel->tick_ns = tick_ns;
+    wheel->origin_ns = timer_wheel_now();
+    wheel->fd = -1;
+    wheel->armed_tick = NO_TICK;
+    return true;
+}
+
+void timer_wheel_destroy(TimerWheel* wheel) {
+    if (wheel->fd != -1) close(wheel->fd);
+    wheel->fd = -1;
+}
+
+void wheel_timer_init(WheelTimer* timer, WheelCallback callback, void* data) {
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->interval = 0;
+    timer->callback = callback;
+    timer->data = data;
+}
+
+// ---------------------------------------------------------------------
+// Slot lists
+
+// Links the timer into the slot covering its expiry: level 0 holds the
+// next 64 ticks, level k the next 64^(k+1). Expiries further out than
+// the top level are parked in its farthest slot and placed again when
+// that slot cascades.
+static void place(TimerWheel* wheel, WheelTimer* timer) {
+    if (timer->expires < wheel->now_tick) timer->expires = wheel->now_tick;
+    uint64_t delta = timer->expires - wheel->now_tick;
+    uint64_t position = timer->expires;
+    if (delta >= MAX_DELTA) {
+        delta = MAX_DELTA - 1;
+        position = wheel->now_tick + delta;
+    }
+    int level = 0;
+    while (delta >= (1ull << (TIMER_WHEEL_BITS * (level + 1)))) level++;
+    int slot = (int)((position >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK);
+
+    WheelTimer** head = &wheel->slots[level][slot];
+    timer->next = *head;
+    if (*head != NULL) (*head)->pprev = &timer->next;
+    *head = timer;
+    timer->pprev = head;
+    wheel->occupied[level] |= 1ull << slot;
+    wheel->count++;
+}
+
+// Only a slot's first timer points back into the slot array; when it
+// leaves an emptied slot, the slot's occupancy bit is cleared
+static void unlink_timer(TimerWheel* wheel, WheelTimer* timer) {
+    WheelTimer** pprev = timer->pprev;
+    *pprev = timer->next;
+    if (timer->next != NULL) {
+        timer->next->pprev = pprev;
+    } else {
+        uintptr_t first = (uintptr_t)&wheel->slots[0][0];
+        uintptr_t at = (uintptr_t)pprev;
+        if (at >= first && at < first + sizeof(wheel->slots) && *pprev == NULL) {
+            size_t index = (at - first) / sizeof(WheelTimer*);
+            wheel->occupied[index / TIMER_WHEEL_SLOTS] &= ~(1ull << (index % TIMER_WHEEL_SLOTS));
+        }
+    }
+    timer->next = NULL;
+    timer->pprev = NULL;
+    wheel->count--;
+}
+
+// Moves a whole slot to a local list whose head is *list
+static void detach_slot(TimerWheel* wheel, int level, int slot, WheelTimer** list) {
+    *list = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+    wheel->occupied[level] &= ~(1ull << slot);
+    if (*list != NULL) (*list)->pprev = list;
+}
+
+// Sets the timerfd for the start of tick; NO_TICK disarms it
+static void arm_fd(TimerWheel* wheel, uint64_t tick) {
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    if (tick != NO_TICK) {
+        uint64_t deadline = wheel->origin_ns + tick * wheel->tick_ns;
+        spec.it_value.tv_sec = (time_t)(deadline / 1000000000ull);
+        spec.it_value.tv_nsec = (long)(deadline % 1000000000ull);
+    }
+    if (timerfd_settime(wheel->fd, TFD_TIMER_ABSTIME, &spec, NULL) == 0) {
+        wheel->armed_tick = tick;
+    }
+}
+
+void timer_wheel_add(TimerWheel* wheel, WheelTimer* timer, uint64_t delay_ns, uint64_t interval_ns) {
+    if (wheel_timer_pending(timer)) unlink_timer(wheel, timer);
+    uint64_t now = timer_wheel_now();
+    uint64_t elapsed = now > wheel->origin_ns ? now - wheel->origin_ns : 0;
+    timer->expires = (elapsed + delay_ns + wheel->tick_ns - 1) / wheel->tick_ns;
+    timer->interval = interval_ns == 0 ? 0 : (interval_ns + wheel->tick_ns - 1) / wheel->tick_ns;
+    place(wheel, timer);
+
+    if (wheel->fd != -1 && timer->expires < wheel->armed_tick) arm_fd(wheel, timer->expires);
+}
+
+bool timer_wheel_cancel(TimerWheel* wheel, WheelTimer* timer) {
+    if (!wheel_timer_pending(timer)) return false;
+    unlink_timer(wheel, timer);
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// Advancing
+
+// Distance from start to the first set bit, going round; -1 if none
+static int first_set_from(uint64_t bits, int start) {
+    if (bits == 0) return -1;
+    uint64_t rotated = start == 0 ? bits : (bits >> start) | (bits << (64 - start));
+#if defined(__GNUC__)
+    return __builtin_ctzll(rotated);
+#else
+    int distance = 0;
+    while ((rotated & 1) == 0) {
+        rotated >>= 1;
+        distance++;
+    }
+    return distance;
+#endif
+}
+
+// First tick, from now_tick on, that fires a level 0 slot or cascades a
+// coarser one. Level k slot s cascades when the tick reaches the start
+// of the 64^k span it covers.
+static uint64_t next_pending_tick(const TimerWheel* wheel) {
+    uint64_t best = NO_TICK;
+    for (int level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if (wheel->occupied[level] == 0) continue;
+        int shift = TIMER_WHEEL_BITS * level;
+        uint64_t span = wheel->now_tick >> shift;
+        int position = (int)(span & SLOT_MASK);
+        uint64_t tick;
+        if (level == 0) {
+            tick = wheel->now_tick + (uint64_t)first_set_from(wheel->occupied[0], position);
+        } else {
+            // The current slot is due only at the very start of its span
+            uint64_t offset = (wheel->now_tick & ((1ull << shift) - 1)) == 0 ? 0 : 1;
+            int start = (int)((position + offset) & SLOT_MASK);
+            tick = (span + offset + (uint64_t)first_set_from(wheel->occupied[level], start)) << shift;
+        }
+        if (tick < best) best = tick;
+    }
+    return best;
+}
+
+static size_t run_tick(TimerWheel* wheel, uint64_t tick) {
+    wheel->now_tick = tick;
+
+    // Cascade coarse slots whose span starts now, finest first
+    for (int level = 1; level < TIMER_WHEEL_LEVELS && (tick & ((1ull << (TIMER_WHEEL_BITS * level)) - 1)) == 0;
+         level++) {
+        int slot = (int)((tick >> (TIMER_WHEEL_BITS * level)) & SLOT_MASK);
+        WheelTimer* list;
+        detach_slot(wheel, level, slot, &list);
+        while (list != NULL) {
+            WheelTimer* timer = list;
+            unlink_timer(wheel, timer);
+            place(wheel, timer);
+        }
+    }
+
+    // Timers added by callbacks land on later ticks
+    WheelTimer* list;
+    detach_slot(wheel, 0, (int)(tick & SLOT_MASK), &list);
+    wheel->now_tick = tick + 1;
+    size_t fired = 0;
+    while (list != NULL) {
+        WheelTimer* timer = list;
+        unlink_timer(wheel, timer);
+        if (timer->interval > 0) {
+            timer->expires += timer->interval;
+            place(wheel, timer);
+        }
+        timer->callback(wheel, timer, timer->data);
+        fired++;
+    }
+    return fired;
+}
+
+size_t timer_wheel_advance(TimerWheel* wheel, uint64_t now_ns) {
+    if (now_ns < wheel->origin_ns) return 0;
+    uint64_t target = (now_ns - wheel->origin_ns) / wheel->tick_ns;
+    size_t fired = 0;
+    for (;;) {
+        uint64_t tick = next_pending_tick(wheel);
+        if (tick == NO_TICK || tick > target) break;
+        fired += run_tick(wheel, tick);
+    }
+    if (wheel->now_tick <= target) wheel->now_tick = target + 1;
+    return fired;
+}
+
+bool timer_wheel_next_deadline(const TimerWheel* wheel, uint64_t* deadline_ns) {
+    uint64_t tick = next_pending_tick(wheel);
+    if (tick == NO_TICK) return false;
+    *deadline_ns = wheel->origin_ns + tick * wheel->tick_ns;
+    return true;
+}
+
+// ---------------------------------------------------------------------
+// timerfd driver
+
+int timer_wheel_open_fd(TimerWheel* wheel) {
+    if (wheel->fd != -1) return wheel->fd;
+    wheel->fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (wheel->fd == -1) {
+        perror("timerfd_create");
+        return -1;
+    }
+    arm_fd(wheel, next_pending_tick(wheel));
+    return wheel->fd;
+}
+
+size_t timer_wheel_dispatch(TimerWheel* wheel) {
+    uint64_t expirations;
+    while (read(wheel->fd, &expirations, sizeof(expirations)) > 0) {
+    }
+    size_t fired = timer_wheel_advance(wheel, timer_wheel_now());
+    arm_fd(wheel, next_pending_tick(wheel));
+    return fired;
+}
@@ -0,0 +1,83 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hierarchical timer wheel for large numbers of timers. Time is counted
+// in ticks of tick_ns on CLOCK_MONOTONIC. Six levels of 64 slots form
+// the resolution tiers:
+//   level 0   one tick per slot (fine), the next 64 ticks
+//   level k   64^k ticks per slot (coarse), up to 64^(k+1) ticks ahead
+// A timer is linked into the slot that covers its expiry, so adding and
+// cancelling are O(1). When time reaches a coarse slot its timers cascade
+// into finer levels, and each timer fires on the first tick at or after
+// its expiry, never before. Occupancy bitmaps let advancing skip over
+// empty stretches instead of visiting every tick.
+//
+// Nothing runs in signal context: callbacks run from timer_wheel_advance,
+// called directly or through the wheel's timerfd from an event loop.
+
+#define TIMER_WHEEL_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_BITS)
+#define TIMER_WHEEL_LEVELS 6
+
+typedef struct TimerWheel TimerWheel;
+typedef struct WheelTimer WheelTimer;
+
+typedef void (*WheelCallback)(TimerWheel* wheel, WheelTimer* timer, void* data);
+
+// Caller-owned, so scheduling never allocates
+struct WheelTimer {
+    WheelTimer* next;
+    WheelTimer** pprev;         // NULL when not scheduled
+    uint64_t expires;           // tick
+    uint64_t interval;          // ticks, 0 for one-shot
+    WheelCallback callback;
+    void* data;
+};
+
+struct TimerWheel {
+    WheelTimer* slots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    uint64_t occupied[TIMER_WHEEL_LEVELS];     // bit per non-empty slot
+    uint64_t now_tick;          // next tick to process
+    uint64_t tick_ns;
+    uint64_t origin_ns;         // time of tick 0
+    size_t count;
+    int fd;                     // timerfd, -1 until timer_wheel_open_fd
+    uint64_t armed_tick;        // tick the timerfd is set for
+};
+
+bool timer_wheel_init(TimerWheel* wheel, uint64_t tick_ns);
+void timer_wheel_destroy(TimerWheel* wheel);    // closes the timerfd; timers are the caller's
+
+void wheel_timer_init(WheelTimer* timer, WheelCallback callback, void* data);
+
+static inline bool wheel_timer_pending(const WheelTimer* timer) {
+    return timer->pprev != NULL;
+}
+
+// First expiry delay_ns from now (rounded up to a tick), then every
+// interval_ns (0 for one-shot, otherwise at least one tick). A pending
+// timer is rescheduled.
+void timer_wheel_add(TimerWheel* wheel, WheelTimer* timer, uint64_t delay_ns, uint64_t interval_ns);
+// Returns false if the timer was not pending
+bool timer_wheel_cancel(TimerWheel* wheel, WheelTimer* timer);
+
+// Runs every timer due at now_ns; returns the number of callbacks
+size_t timer_wheel_advance(TimerWheel* wheel, uint64_t now_ns);
+
+// Earliest time at which advancing can do work (a firing or a cascade);
+// false when no timer is pending
+bool timer_wheel_next_deadline(const TimerWheel* wheel, uint64_t* deadline_ns);
+
+// A timerfd that becomes readable when the wheel has work. On readiness
+// call timer_wheel_dispatch, which advances to the current time and
+// re-arms the fd.
+int timer_wheel_open_fd(TimerWheel* wheel);
+size_t timer_wheel_dispatch(TimerWheel* wheel);
+
+uint64_t timer_wheel_now(void);
+
+#endif /* TIMERWHEEL_H */
@@ -0,0 +1,275 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "evloop.h"
+#include "timerwheel.h"
+
+// Timer wheel costs against the event loop's binary heap:
+//   schedule + cancel   10^6 timers with delays up to 60 s, all added
+//                       then all cancelled
+//   reschedule          10^6 pushes of a pending timer to a new expiry,
+//                       the connection-timeout pattern; the heap has to
+//                       cancel and add
+//   schedule + fire     10^6 timers over 10 s of 1 ms ticks, driven by a
+//                       synthetic clock so every timer must fire exactly
+//                       on its tick
+//   periodic            1000 periodic timers for 100 s of ticks; fire
+//                       counts are checked against the expected number
+// The argument scales the timer counts (default 1).
+static int failed = 0;
+
+static double now_seconds(void) {
+    return (double)timer_wheel_now() / 1e9;
+}
+
+static void report(const char* name, double ops, double seconds, double baseline) {
+    printf("  %-28s %12.0f ops/s  %8.1f ns/op", name, ops / seconds, seconds * 1e9 / ops);
+    if (baseline > 0) printf("  %6.2fx", baseline / seconds);
+    printf("\n");
+}
+
+static uint64_t rng_state = 0x853C49E6748FEA9Bull;
+
+static uint64_t next_random(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return rng_state;
+}
+
+static const uint64_t TICK_NS = 1000000;
+
+// Tick being advanced to, for checking when callbacks run
+static uint64_t current_tick = 0;
+static size_t fired = 0;
+static size_t misfired = 0;
+
+static void on_fire(TimerWheel* wheel, WheelTimer* timer, void* data) {
+    (void)wheel;
+    (void)data;
+    if (timer->interval == 0 && timer->expires != current_tick) misfired++;
+    fired++;
+}
+
+static void on_cancelled(TimerWheel* wheel, WheelTimer* timer, void* data) {
+    (void)wheel;
+    (void)timer;
+    (void)data;
+    misfired++;
+}
+
+static void on_heap_timer(EventLoop* loop, EventTimerId timer, void* data) {
+    (void)loop;
+    (void)timer;
+    (void)data;
+}
+
+static void advance_to(TimerWheel* wheel, uint64_t tick) {
+    current_tick = tick;
+    timer_wheel_advance(wheel, wheel->origin_ns + tick * TICK_NS);
+}
+
+// ---------------------------------------------------------------------
+// Scheduling
+
+static void bench_schedule_cancel(size_t count) {
+    EventLoop* loop = event_loop_create();
+    EventTimerId* ids = malloc(count * sizeof(EventTimerId));
+    WheelTimer* timers = malloc(count * sizeof(WheelTimer));
+    uint64_t* delays = malloc(count * sizeof(uint64_t));
+    TimerWheel wheel;
+    if (loop == NULL || ids == NULL || timers == NULL || delays == NULL || !timer_wheel_init(&wheel, TICK_NS)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        delays[i] = next_random() % 60000000000ull + 1;
+    }
+
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        ids[i] = event_loop_add_timer(loop, delays[i], 0, on_heap_timer, NULL);
+    }
+    size_t heap_cancelled = 0;
+    for (size_t i = 0; i < count; i++) {
+        heap_cancelled += event_loop_cancel_timer(loop, ids[i]);
+    }
+    double heap = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        wheel_timer_init(&timers[i], on_cancelled, NULL);
+        timer_wheel_add(&wheel, &timers[i], delays[i], 0);
+    }
+    size_t scheduled = wheel.count;
+    size_t wheel_cancelled = 0;
+    for (size_t i = 0; i < count; i++) {
+        wheel_cancelled += timer_wheel_cancel(&wheel, &timers[i]);
+    }
+    double seconds = now_seconds() - start;
+
+    report("heap schedule + cancel", (double)count, heap, 0);
+    report("wheel schedule + cancel", (double)count, seconds, heap);
+
+    // Nothing is left to fire, even far in the future
+    misfired = 0;
+    advance_to(&wheel, 120000);
+    uint64_t deadline;
+    failed |= heap_cancelled != count || wheel_cancelled != count || scheduled != count || wheel.count != 0 ||
+              timer_wheel_next_deadline(&wheel, &deadline) || misfired != 0;
+
+    timer_wheel_destroy(&wheel);
+    event_loop_destroy(loop);
+    free(ids);
+    free(timers);
+    free(delays);
+}
+
+static void bench_reschedule(size_t count) {
+    const size_t live = 10000;
+    EventLoop* loop = event_loop_create();
+    EventTimerId* ids = malloc(live * sizeof(EventTimerId));
+    WheelTimer* timers = malloc(live * sizeof(WheelTimer));
+    uint64_t* delays = malloc(count * sizeof(uint64_t));
+    TimerWheel wheel;
+    if (loop == NULL || ids == NULL || timers == NULL || delays == NULL || !timer_wheel_init(&wheel, TICK_NS)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+    for (size_t i = 0; i < count; i++) {
+        delays[i] = 30000000000ull + next_random() % 1000000000ull;
+    }
+    for (size_t i = 0; i < live; i++) {
+        ids[i] = event_loop_add_timer(loop, delays[i], 0, on_heap_timer, NULL);
+        wheel_timer_init(&timers[i], on_cancelled, NULL);
+        timer_wheel_add(&wheel, &timers[i], delays[i], 0);
+    }
+
+    double start = now_seconds();
+    size_t heap_ok = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t slot = i % live;
+        heap_ok += event_loop_cancel_timer(loop, ids[slot]);
+        ids[slot] = event_loop_add_timer(loop, delays[i], 0, on_heap_timer, NULL);
+    }
+    double heap = now_seconds() - start;
+
+    start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        timer_wheel_add(&wheel, &timers[i % live], delays[i], 0);
+    }
+    double seconds = now_seconds() - start;
+
+    report("heap reschedule", (double)count, heap, 0);
+    report("wheel reschedule", (double)count, seconds, heap);
+    failed |= heap_ok != count || wheel.count != live;
+
+    for (size_t i = 0; i < live; i++) {
+        timer_wheel_cancel(&wheel, &timers[i]);
+    }
+    timer_wheel_destroy(&wheel);
+    event_loop_destroy(loop);
+    free(ids);
+    free(timers);
+    free(delays);
+}
+
+// ---------------------------------------------------------------------
+// Firing
+
+static void bench_fire(size_t count) {
+    const uint64_t span = 10000;
+    WheelTimer* timers = malloc(count * sizeof(WheelTimer));
+    TimerWheel wheel;
+    if (timers == NULL || !timer_wheel_init(&wheel, TICK_NS)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
+    double start = now_seconds();
+    for (size_t i = 0; i < count; i++) {
+        wheel_timer_init(&timers[i], on_fire, NULL);
+        timer_wheel_add(&wheel, &timers[i], next_random() % (span * TICK_NS), 0);
+    }
+    fired = 0;
+    misfired = 0;
+    uint64_t last = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (timers[i].expires > last) last = timers[i].expires;
+    }
+    for (uint64_t tick = wheel.now_tick; tick <= last; tick++) {
+        advance_to(&wheel, tick);
+    }
+    double seconds = now_seconds() - start;
+
+    report("wheel schedule + fire", (double)count, seconds, 0);
+    failed |= fired != count || misfired != 0 || wheel.count != 0;
+
+    timer_wheel_destroy(&wheel);
+    free(timers);
+}
+
+static void bench_periodic(size_t count) {
+    const uint64_t span = 100000;
+    WheelTimer* timers = malloc(count * sizeof(WheelTimer));
+    TimerWheel wheel;
+    if (timers == NULL || !timer_wheel_init(&wheel, TICK_NS)) {
+        fprintf(stderr, "Memory allocation failed\n");
+        exit(1);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        wheel_timer_init(&timers[i], on_fire, NULL);
+        timer_wheel_add(&wheel, &timers[i], (next_random() % 100) * TICK_NS, (next_random() % 5000 + 1) * TICK_NS);
+    }
+    uint64_t first = wheel.now_tick;
+    uint64_t last = first + span;
+    size_t expected = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (timers[i].expires <= last) expected += (last - timers[i].expires) / timers[i].interval + 1;
+    }
+
+    fired = 0;
+    misfired = 0;
+    double start = now_seconds();
+    for (uint64_t tick = first; tick <= last; tick++) {
+        advance_to(&wheel, tick);
+    }
+    double seconds = now_seconds() - start;
+
+    report("wheel periodic fire", (double)fired, seconds, 0);
+    failed |= fired != expected || misfired != 0 || wheel.count != count;
+
+    for (size_t i = 0; i < count; i++) {
+        timer_wheel_cancel(&wheel, &timers[i]);
+    }
+    timer_wheel_destroy(&wheel);
+    free(timers);
+}
+
+int main(int argc, char* argv[]) {
+    long scale = argc > 1 ? atol(argv[1]) : 1;
+    if (scale < 1 || scale > 100) {
+        fprintf(stderr, "Usage: %s [scale, 1 .. 100]\n", argv[0]);
+        return 1;
+    }
+
+    printf("=== Timer Wheel Benchmark ===\n\n");
+    printf("Scheduling:\n");
+    bench_schedule_cancel(1000000 * (size_t)scale);
+    bench_reschedule(1000000 * (size_t)scale);
+    printf("Firing:\n");
+    bench_fire(1000000 * (size_t)scale);
+    bench_periodic(1000 * (size_t)scale);
+    printf("\n");
+
+    if (failed) {
+        printf("Result mismatch!\n");
+        return 1;
+    }
+    printf("All results verified\n");
+    return 0;
+}